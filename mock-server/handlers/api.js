@@ -435,6 +435,46 @@ function handleAPI(req, res, pathname, ctx) {
     return true;
   }
 
+  if (pathname === "/api/previous-boot-log") {
+    sendJSON(res, {
+      reset_reason: "Task watchdog",
+      count: 3,
+      lines: [
+        { uptime_ms: 5402211, level: "NOTICE", component: "MQTT", message: "Published status (fingerprint 3fa2c1d0)" },
+        { uptime_ms: 5405874, level: "WARNING", component: "WEB", message: "Slow request /api/news: 4210 ms" },
+        { uptime_ms: 5406002, level: "ERROR", component: "PRINTER", message: "Printer busy for 5000 ms - ?" },
+      ],
+    });
+    return true;
+  }
+
+  if (pathname === "/api/logs") {
+    // One new line every 2 seconds since the mock started, so following with since shows progress
+    const url = new URL(req.url, `http://${req.headers.host}`);
+    const levels = ["SILENT", "FATAL", "ERROR", "WARNING", "NOTICE", "TRACE", "VERBOSE"];
+    const maxLevel = levels.indexOf((url.searchParams.get("level") || "VERBOSE").toUpperCase());
+    const component = (url.searchParams.get("component") || "").toUpperCase();
+    const next = Math.floor(process.uptime() / 2) + 5;
+    const since = url.searchParams.has("since") ? Number(url.searchParams.get("since")) : Math.max(0, next - 50);
+    const samples = [
+      ["NOTICE", "MQTT", "Published status (fingerprint 3fa2c1d0)"],
+      ["VERBOSE", "WEB", "GET /api/diagnostics 200 in 38 ms"],
+      ["WARNING", "WEB", "Slow request /api/news: 4210 ms"],
+      ["NOTICE", "PRINTER", "Printed 212 characters"],
+      ["ERROR", "MQTT", "Broker connection lost - retrying in 5 s"],
+    ];
+    let body = "";
+    for (let seq = since; seq < next; seq++) {
+      const [level, comp, message] = samples[seq % samples.length];
+      if (levels.indexOf(level) > maxLevel || (component && component !== comp)) continue;
+      body += JSON.stringify({ seq, uptime_ms: seq * 2000, level, component: comp, message }) + "\n";
+    }
+    body += JSON.stringify({ next, missed: 0, skipped: 0 }) + "\n";
+    res.writeHead(200, { "Content-Type": "application/x-ndjson", "Cache-Control": "no-store" });
+    res.end(body);
+    return true;
+  }
+
   if (pathname === "/api/routes") {
     // Load mock routes from mock-server/data (not firmware data/)
     const routesPath = path.join(__dirname, "..", "data", "mock-routes.json");
@@ -481,14 +521,91 @@ function handleAPI(req, res, pathname, ctx) {
     let body = "";
     req.on("data", (chunk) => (body += chunk));
     req.on("end", () => {
+      let payload = {};
+      try {
+        payload = JSON.parse(body || "{}");
+      } catch (e) {
+        // Real device validates; mock just echoes defaults
+      }
       setTimeout(() => {
-        res.writeHead(200);
-        res.end();
+        const response = {
+          id: `mock-${Date.now().toString(16)}`,
+          ack_requested: payload.group ? true : payload.ack !== false,
+          path: "mqtt",
+        };
+        if (payload.group) {
+          // Device picks the least busy group member; mock always picks itself
+          response.topic = "scribe/mock/print";
+          response.printer_id = "mock123456";
+        }
+        sendJSON(res, response);
       }, 800);
     });
     return true;
   }
 
+  if (pathname === "/api/print-mqtt/latency" && req.method === "GET") {
+    sendJSON(res, {
+      jobs: [
+        {
+          id: "a1b2c3d4e5f6-1f3d11-8",
+          topic: "scribe/pharkie/print",
+          path: "lan",
+          age_ms: 12000,
+          status: "accepted",
+          printer_id: "f6e5d4c3b2a1",
+          round_trip_ms: 24,
+          print_start_ms: 0,
+          print_done_ms: 0,
+          network_ms: 24,
+        },
+        {
+          id: "a1b2c3d4e5f6-1f3a9c-7",
+          topic: "scribe/pharkie/print",
+          path: "mqtt",
+          age_ms: 42000,
+          status: "printed",
+          printer_id: "f6e5d4c3b2a1",
+          round_trip_ms: 1840,
+          print_start_ms: 12,
+          print_done_ms: 1490,
+          network_ms: 350,
+        },
+        {
+          id: "a1b2c3d4e5f6-1f2b04-6",
+          topic: "scribe/group/kitchen",
+          path: "mqtt",
+          age_ms: 95000,
+          status: "timeout",
+        },
+      ],
+      summary: {
+        acked: 2,
+        pending: 0,
+        timed_out: 1,
+        avg_round_trip_ms: 932,
+        max_round_trip_ms: 1840,
+        avg_network_ms: 187,
+      },
+      paths: {
+        mqtt: { acked: 1, avg_round_trip_ms: 1840, avg_network_ms: 350 },
+        lan: { acked: 1, avg_round_trip_ms: 24, avg_network_ms: 24 },
+        lan_fallback: { acked: 0, avg_round_trip_ms: 0, avg_network_ms: 0 },
+      },
+    });
+    return true;
+  }
+
+  if (pathname === "/api/discovered-printers" && req.method === "GET") {
+    const data = ctx.mockPrinterDiscovery;
+    sendJSON(res, {
+      ...data,
+      discovered_printers: data.discovered_printers || [],
+      version: data.version || 1,
+    });
+    return true;
+  }
+
   // /api/test-mqtt (POST) — validate payload and simulate success/busy/long
   if (pathname === "/api/test-mqtt" && req.method === "POST") {
     let body = "";
@@ -9,10 +9,14 @@ function handleSSE(req, res, mockPrinterDiscovery) {
     "Access-Control-Allow-Headers": "Cache-Control",
   });
 
-  const data = { ...mockPrinterDiscovery };
+  // Shared with /api/discovered-printers so resync snapshots line up with deltas
+  const data = mockPrinterDiscovery;
   if (!Array.isArray(data.discovered_printers)) {
     data.discovered_printers = [];
   }
+  if (typeof data.version !== "number") {
+    data.version = 1;
+  }
 
   // Send initial data immediately
   const initialPayload = `event: printer-update\ndata: ${JSON.stringify(data)}\n\n`;
@@ -25,15 +29,22 @@ function handleSSE(req, res, mockPrinterDiscovery) {
       console.log("📡 Mock: SSE connection destroyed, clearing interval");
       return clearInterval(interval);
     }
-    if (
-      Array.isArray(data.discovered_printers) &&
-      data.discovered_printers.length > 0
-    ) {
-      data.discovered_printers[0].last_power_on = new Date().toISOString();
+    if (data.discovered_printers.length === 0) {
+      return; // Plain heartbeats produce no event
     }
-    const updatePayload = `event: printer-update\ndata: ${JSON.stringify(data)}\n\n`;
-    console.log("📡 Mock: Sending SSE update");
-    res.write(updatePayload);
+    // Changed entries only, like the firmware's printer-delta events
+    const fromVersion = data.version;
+    data.version += 1;
+    data.discovered_printers[0].last_power_on = new Date().toISOString();
+    const delta = {
+      from_version: fromVersion,
+      version: data.version,
+      printers: [data.discovered_printers[0]],
+      removed: [],
+    };
+    const deltaPayload = `event: printer-delta\ndata: ${JSON.stringify(delta)}\n\n`;
+    console.log("📡 Mock: Sending SSE delta");
+    res.write(deltaPayload);
   }, 30000);
 
   req.on("close", () => {
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""
+Decode Scribe binary log files - no device connection required!
+
+With logFileBinaryRecords enabled, the printer writes /logs/scribe.bin.N as
+compact binary records: a format string address plus raw argument bytes
+(see src/core/log_record.h). The format strings themselves live in flash,
+so decoding needs the firmware ELF from the same build:
+
+    .pio/build/<env>/firmware.elf
+
+Download the log segments from the device (e.g. the file manager) and pass
+them oldest first - scribe.bin.idx names the active (newest) segment:
+
+Usage:
+    python3 scripts/bin/decode_log.py .pio/build/main/firmware.elf scribe.bin.1 scribe.bin.2 scribe.bin.3 scribe.bin.0
+    python3 scripts/bin/decode_log.py firmware.elf scribe.bin.0 --level WARNING --component MQTT
+"""
+
+import argparse
+import datetime
+import re
+import struct
+import sys
+
+# Mirrors src/core/log_record.h
+RECORD_SIZE_MASK = 0x0000FFFF
+FILE_COMPONENT_NAME = 0x20000000
+FILE_CLOCK = 0x10000000
+RECORD_TRUNCATED = 0x01
+FILE_MAGIC = b"SLG1"
+
+LEVEL_NAMES = ["SILENT", "FATAL", "ERROR", "WARNING", "NOTICE", "TRACE", "VERBOSE"]
+
+SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diuxXocfFeEgGaAspn%])")
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings from the loadable sections of an ELF file."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+
+        self.sections = []
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            if is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(endian + "IIQQQQ", self.data, base)
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(endian + "IIIIII", self.data, base)
+            SHT_NOBITS, SHF_ALLOC = 8, 0x2
+            if flags & SHF_ALLOC and sh_type != SHT_NOBITS and size:
+                self.sections.append((addr, size, offset))
+
+    def string_at(self, address):
+        for addr, size, offset in self.sections:
+            if addr <= address < addr + size:
+                start = offset + (address - addr)
+                end = self.data.find(b"\0", start)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+class ArgReader:
+    def __init__(self, data, sizes):
+        self.data = data
+        self.pos = 0
+        self.sizes = sizes
+
+    def _unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            return None
+        value, = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def integer(self, length, signed):
+        width = {"": 4, "hh": 4, "h": 4, "l": self.sizes["long"], "ll": 8, "j": 8,
+                 "z": self.sizes["size_t"], "t": self.sizes["size_t"]}.get(length or "", 4)
+        code = {4: "i", 8: "q"}[width]
+        return self._unpack("<" + (code if signed else code.upper()))
+
+    def double(self):
+        return self._unpack("<d")
+
+    def pointer(self):
+        return self._unpack("<" + {4: "I", 8: "Q"}[self.sizes["pointer"]])
+
+    def string(self):
+        end = self.data.find(b"\0", self.pos)
+        if end < 0:
+            return None
+        text = self.data[self.pos:end].decode("utf-8", "replace")
+        self.pos = end + 1
+        return text
+
+
+def format_message(fmt, args):
+    """printf-style formatting from the record's argument bytes, as formatLogMessage() does."""
+    out = []
+    pos = 0
+    exhausted = False
+    for match in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:match.start()])
+        pos = match.end()
+        flags, width, precision, length, conv = match.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if exhausted or conv == "n":
+            out.append("?")
+            exhausted = True
+            continue
+
+        if width == "*":
+            width = args.integer("", True)
+        if precision == "*":
+            precision = args.integer("", True)
+        if width is None and match.group(2) == "*" or precision is None and match.group(3) == "*":
+            out.append("?")
+            exhausted = True
+            continue
+
+        spec = "%" + flags + (str(width) if width is not None else "")
+        if precision is not None:
+            spec += "." + str(precision)
+
+        if conv in "di":
+            value = args.integer(length, True)
+        elif conv in "uxXoc":
+            value = args.integer(length, False)
+        elif conv in "fFeEgGaA":
+            value = args.double()
+            conv = {"a": "e", "A": "E"}.get(conv, conv)
+        elif conv == "s":
+            value = args.string()
+        else:  # p
+            value = args.pointer()
+            spec, conv = "0x%", "x"
+
+        if value is None:
+            out.append("?")
+            exhausted = True
+            continue
+        out.append((spec + conv) % value)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode_file(path, elf, options):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != FILE_MAGIC:
+        print(f"{path}: not a Scribe binary log", file=sys.stderr)
+        return
+    pointer_size, long_size, size_t_size, args_offset = data[4:8]
+    sizes = {"pointer": pointer_size, "long": long_size, "size_t": size_t_size}
+    pointer_code = {4: "I", 8: "Q"}[pointer_size]
+
+    components = {}
+    clock = None  # (millis, utc seconds) from the latest clock record
+    pos = 8
+    while pos + 4 <= len(data):
+        control, = struct.unpack_from("<I", data, pos)
+        size = control & RECORD_SIZE_MASK
+        if size < 4 or pos + size > len(data):
+            print(f"{path}: stopped at corrupt or partial record (offset {pos})", file=sys.stderr)
+            break
+        body = data[pos + 4:pos + size]
+        pos += size
+
+        if control & FILE_COMPONENT_NAME:
+            components[body[0]] = body[1:].split(b"\0", 1)[0].decode("utf-8", "replace")
+            continue
+        if control & FILE_CLOCK:
+            millis, utc = struct.unpack_from("<II", body)
+            if clock is not None and millis < clock[0]:
+                print("----- reboot -----")
+            clock = (millis, utc)
+            continue
+
+        timestamp_ms, = struct.unpack_from("<I", body, 0)
+        format_address, = struct.unpack_from("<" + pointer_code, body, 4)
+        level, component_id, arg_length, flags = struct.unpack_from("<BBBB", body, 4 + pointer_size)
+        args = body[args_offset - 4:args_offset - 4 + arg_length]
+
+        level_name = LEVEL_NAMES[level] if level < len(LEVEL_NAMES) else str(level)
+        component = components.get(component_id, "?")
+        if options.level and LEVEL_NAMES.index(options.level) < level:
+            continue
+        if options.component and component != options.component:
+            continue
+
+        fmt = elf.string_at(format_address)
+        if fmt is None:
+            message = f"<format 0x{format_address:x} not in ELF - wrong firmware build?>"
+        else:
+            message = format_message(fmt, ArgReader(args, sizes))
+        if flags & RECORD_TRUNCATED:
+            message += " [truncated]"
+
+        if clock and clock[1]:
+            when = datetime.datetime.fromtimestamp(clock[1] + (timestamp_ms - clock[0]) / 1000, datetime.timezone.utc)
+            stamp = when.strftime("%Y-%m-%d %H:%M:%S.") + f"{when.microsecond // 1000:03d}"
+        else:
+            stamp = f"+{timestamp_ms / 1000:.3f}s"
+        print(f"[{stamp}] [{level_name}] [{component}] {message}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Scribe binary log files")
+    parser.add_argument("elf", help="firmware.elf from the build that wrote the logs")
+    parser.add_argument("logs", nargs="+", help="Binary log files, oldest first")
+    parser.add_argument("--level", choices=LEVEL_NAMES[1:], help="Only show this level and more severe")
+    parser.add_argument("--component", help="Only show this component")
+    args = parser.parse_args()
+
+    elf = ElfStrings(args.elf)
+    for path in args.logs:
+        decode_file(path, elf, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Scribe discovery heartbeat traffic simulator - no broker required!
+
+Estimates broker messages per hour for a fleet of N printers, comparing the old
+fixed heartbeat (full retained status every minute) with the adaptive scheme:
+retained status only on a real change, otherwise a tiny liveness ping whose
+interval backs off from 1 to 15 minutes with +/-20% jitter.
+
+Every printer subscribes to every other printer's status/ping topic, so each
+published message is delivered N times (including to its sender).
+
+Usage:
+    python3 scripts/bin/heartbeat_traffic_sim.py
+    python3 scripts/bin/heartbeat_traffic_sim.py --printers 5 20 100 --changes-per-day 4 --hours 48
+"""
+
+import argparse
+import random
+
+# Mirrors src/config/system_constants.h
+FIXED_INTERVAL_S = 60
+PING_FIRST_INTERVAL_S = 60
+PING_MAX_INTERVAL_S = 15 * 60
+PING_JITTER_PERCENT = 20
+
+STATUS_PAYLOAD_BYTES = 220  # Typical retained status JSON
+PING_PAYLOAD_BYTES = 8  # Status fingerprint, hex
+TOPIC_BYTES = 35  # "scribe/printer-status/<id>" and similar
+
+
+def jittered(interval_s, rng):
+    span = interval_s * PING_JITTER_PERCENT / 100
+    return interval_s + rng.uniform(-span, span)
+
+
+def simulate_fixed(hours):
+    """Old scheme: one retained status per printer per minute."""
+    statuses = hours * 3600 // FIXED_INTERVAL_S
+    return statuses, 0
+
+
+def simulate_adaptive(hours, changes_per_day, rng):
+    """New scheme for one printer: returns (status publishes, pings)."""
+    duration = hours * 3600
+    change_rate = changes_per_day / 86400.0
+
+    # Boot/connect publishes the retained status once
+    statuses, pings = 1, 0
+    now = 0.0
+    interval = PING_FIRST_INTERVAL_S
+    next_ping = jittered(interval, rng)
+    next_change = rng.expovariate(change_rate) if change_rate > 0 else float("inf")
+
+    while True:
+        if next_change < next_ping:
+            now = next_change
+            if now >= duration:
+                break
+            statuses += 1
+            interval = PING_FIRST_INTERVAL_S  # Status publish resets the back-off
+            next_ping = now + jittered(interval, rng)
+            next_change = now + rng.expovariate(change_rate)
+        else:
+            now = next_ping
+            if now >= duration:
+                break
+            pings += 1
+            interval = min(interval * 2, PING_MAX_INTERVAL_S)
+            next_ping = now + jittered(interval, rng)
+
+    return statuses, pings
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate discovery heartbeat broker traffic")
+    parser.add_argument("--printers", type=int, nargs="+", default=[2, 5, 10, 25, 50, 100], help="Fleet sizes to simulate")
+    parser.add_argument("--changes-per-day", type=float, default=2.0, help="Real status changes per printer per day (IP, timezone, name, firmware)")
+    parser.add_argument("--hours", type=int, default=24, help="Simulated duration in hours")
+    parser.add_argument("--seed", type=int, default=1, help="Random seed")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+
+    print(f"Simulating {args.hours}h, {args.changes_per_day:g} status changes/printer/day\n")
+    print(f"{'Printers':>8}  {'Fixed pub/h':>11}  {'Fixed dlv/h':>11}  {'Fixed KB/h':>10}  "
+          f"{'Adapt pub/h':>11}  {'Adapt dlv/h':>11}  {'Adapt KB/h':>10}  {'Saving':>6}")
+
+    for n in args.printers:
+        fixed_status, _ = simulate_fixed(args.hours)
+        fixed_pub = n * fixed_status / args.hours
+        fixed_bytes = fixed_pub * (STATUS_PAYLOAD_BYTES + TOPIC_BYTES)
+
+        total_status, total_pings = 0, 0
+        for _ in range(n):
+            statuses, pings = simulate_adaptive(args.hours, args.changes_per_day, rng)
+            total_status += statuses
+            total_pings += pings
+        adapt_pub = (total_status + total_pings) / args.hours
+        adapt_bytes = (total_status * (STATUS_PAYLOAD_BYTES + TOPIC_BYTES) +
+                       total_pings * (PING_PAYLOAD_BYTES + TOPIC_BYTES)) / args.hours
+
+        # Deliveries: each publish fans out to all n subscribers
+        fixed_dlv = fixed_pub * n
+        adapt_dlv = adapt_pub * n
+        saving = 100.0 * (1 - adapt_dlv / fixed_dlv) if fixed_dlv else 0.0
+
+        print(f"{n:>8}  {fixed_pub:>11.0f}  {fixed_dlv:>11.0f}  {fixed_bytes * n / 1024:>10.1f}  "
+              f"{adapt_pub:>11.1f}  {adapt_dlv:>11.0f}  {adapt_bytes * n / 1024:>10.1f}  {saving:>5.0f}%")
+
+
+if __name__ == "__main__":
+    main()
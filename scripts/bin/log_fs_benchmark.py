@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""
+Scribe log file benchmark on a host LittleFS image - no device required!
+
+Replays the same stream of log lines through two file sink strategies on an
+in-memory LittleFS with the ESP32 geometry, counting flash programs, erases
+and reads:
+
+  legacy    - per line: exists, open to read the size, close, open to append,
+              write, close; one .old backup on rotation
+  buffered  - LogFileWriter: file kept open, one-block RAM buffer written out
+              on block boundaries, after logFileFlushIntervalMs, or straight
+              away for WARNING and worse; segments rotated through in place
+
+Needs littlefs-python (pip install littlefs-python).
+
+Usage:
+    python3 scripts/bin/log_fs_benchmark.py
+    python3 scripts/bin/log_fs_benchmark.py --lines 50000 --interval-ms 100 --warning-percent 5
+"""
+
+import argparse
+import random
+import time
+
+try:
+    from littlefs import LittleFS
+    from littlefs.context import UserContext
+except ImportError:
+    raise SystemExit("littlefs-python is required: pip install littlefs-python")
+
+# ESP32 esp_littlefs defaults, and the littlefs partition in partitions_no_ota.csv
+BLOCK_SIZE = 4096
+BLOCK_COUNT = 0x1F0000 // BLOCK_SIZE
+READ_SIZE = 128
+PROG_SIZE = 128
+CACHE_SIZE = 512
+LOOKAHEAD_SIZE = 128
+
+# Mirrors src/config/system_constants.h
+LEGACY_MAX_FILE_SIZE = 100000
+SEGMENT_COUNT = 4
+SEGMENT_BYTES = 32768
+BUFFER_BYTES = 4096
+FLUSH_INTERVAL_MS = 5000
+
+
+class CountingContext(UserContext):
+    """Block device that counts what LittleFS asks of the flash."""
+
+    def __init__(self, size):
+        super().__init__(size)
+        self.reset()
+
+    def reset(self):
+        self.progs = 0
+        self.prog_bytes = 0
+        self.erases = 0
+        self.read_bytes = 0
+
+    def read(self, cfg, block, off, size):
+        self.read_bytes += size
+        return super().read(cfg, block, off, size)
+
+    def prog(self, cfg, block, off, data):
+        self.progs += 1
+        self.prog_bytes += len(data)
+        return super().prog(cfg, block, off, data)
+
+    def erase(self, cfg, block):
+        self.erases += 1
+        return super().erase(cfg, block)
+
+
+def make_fs():
+    context = CountingContext(BLOCK_SIZE * BLOCK_COUNT)
+    fs = LittleFS(context=context, mount=False, block_size=BLOCK_SIZE, block_count=BLOCK_COUNT,
+                  read_size=READ_SIZE, prog_size=PROG_SIZE, cache_size=CACHE_SIZE, lookahead_size=LOOKAHEAD_SIZE)
+    fs.format()
+    fs.mount()
+    fs.mkdir("/logs")
+    context.reset()
+    return fs, context
+
+
+def exists(fs, path):
+    try:
+        fs.stat(path)
+        return True
+    except Exception:
+        return False
+
+
+def run_legacy(fs, lines):
+    path = "/logs/scribe.log"
+    for _, line, _ in lines:
+        if exists(fs, path):
+            with fs.open(path, "rb"):
+                size = fs.stat(path).size
+            if size > LEGACY_MAX_FILE_SIZE:
+                if exists(fs, path + ".old"):
+                    fs.remove(path + ".old")
+                fs.rename(path, path + ".old")
+        with fs.open(path, "ab") as f:
+            f.write(line)
+
+
+class BufferedWriter:
+    """Python mirror of src/core/log_file_writer.cpp."""
+
+    def __init__(self, fs, base):
+        self.fs = fs
+        self.base = base
+        self.active = 0
+        self.sequence = 0
+        self.file = fs.open(f"{base}.{self.active}", "ab")
+        self.segment_size = 0
+        self.buffer = bytearray()
+        self.first_buffered_at = 0
+        self.writes = 0
+
+    def prepare(self, length):
+        used = self.segment_size + len(self.buffer)
+        if used and used + length > SEGMENT_BYTES:
+            self.rotate()
+
+    def write(self, data, now):
+        if not self.buffer:
+            self.first_buffered_at = now
+        while data:
+            to_boundary = BUFFER_BYTES - self.segment_size % BUFFER_BYTES
+            chunk = to_boundary - len(self.buffer)
+            self.buffer += data[:chunk]
+            data = data[chunk:]
+            if len(self.buffer) == to_boundary:
+                self.flush()
+                self.first_buffered_at = now
+
+    def flush(self):
+        if self.buffer:
+            self.file.write(bytes(self.buffer))
+            self.file.flush()
+            self.segment_size += len(self.buffer)
+            self.buffer.clear()
+            self.writes += 1
+
+    def flush_if_due(self, now):
+        if self.buffer and now - self.first_buffered_at >= FLUSH_INTERVAL_MS:
+            self.flush()
+
+    def rotate(self):
+        self.flush()
+        self.file.close()
+        self.active = (self.active + 1) % SEGMENT_COUNT
+        self.sequence += 1
+        self.file = self.fs.open(f"{self.base}.{self.active}", "wb")
+        self.segment_size = 0
+        with self.fs.open(f"{self.base}.idx", "wb") as f:
+            f.write(b"SLI1" + self.sequence.to_bytes(4, "little") + self.active.to_bytes(4, "little"))
+
+    def close(self):
+        self.flush()
+        self.file.close()
+
+
+def run_buffered(fs, lines):
+    writer = BufferedWriter(fs, "/logs/scribe.log")
+    for now, line, urgent in lines:
+        writer.flush_if_due(now)  # The sink task checks on every wake-up
+        writer.prepare(len(line))
+        writer.write(line, now)
+        if urgent:
+            writer.flush()
+    writer.close()
+
+
+def make_lines(count, interval_ms, warning_percent, rng):
+    lines = []
+    now = 0
+    for i in range(count):
+        now += rng.expovariate(1.0 / interval_ms)
+        urgent = rng.random() * 100 < warning_percent
+        level = "WARNING" if urgent else "NOTICE"
+        text = "x" * rng.randint(40, 120)
+        line = f"[2025-01-01 12:00:00.000] [{level}] [scribe] [MQTT] {i} {text}\r\n".encode()
+        lines.append((int(now), line, urgent))
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare log file sink strategies on a host LittleFS image")
+    parser.add_argument("--lines", type=int, default=20000, help="Log lines to write (default 20000)")
+    parser.add_argument("--interval-ms", type=float, default=200, help="Mean time between lines (default 200)")
+    parser.add_argument("--warning-percent", type=float, default=2, help="Lines that flush straight away (default 2)")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    lines = make_lines(args.lines, args.interval_ms, args.warning_percent, random.Random(args.seed))
+    payload = sum(len(line) for _, line, _ in lines)
+    print(f"{args.lines} lines, {payload / 1024:.0f} KB of log text, "
+          f"{args.warning_percent:g}% WARNING or worse, a line every {args.interval_ms:g} ms on average\n")
+    print(f"{'strategy':<10} {'programs':>10} {'prog KB':>10} {'erases':>8} {'read KB':>10} {'write amp':>10} {'host s':>8}")
+
+    for name, run in (("legacy", run_legacy), ("buffered", run_buffered)):
+        fs, context = make_fs()
+        start = time.perf_counter()
+        run(fs, lines)
+        elapsed = time.perf_counter() - start
+        print(f"{name:<10} {context.progs:>10} {context.prog_bytes / 1024:>10.0f} {context.erases:>8} "
+              f"{context.read_bytes / 1024:>10.0f} {context.prog_bytes / payload:>10.2f} {elapsed:>8.2f}")
+
+    print("\nWrite amplification is flash bytes programmed per byte of log text. Erases track wear;"
+          "\nreads and host time are a rough guide to the latency each line costs on the device.")
+
+
+if __name__ == "__main__":
+    main()
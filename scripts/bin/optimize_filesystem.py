@@ -3,6 +3,8 @@
 import os
 import gzip
 import glob
+import hashlib
+import re
 import shutil
 
 # Uncompressed files to keep on device filesystem
@@ -25,6 +27,136 @@ readme_assets = [
 
 keep_uncompressed = set(ap_essentials + readme_assets)
 
+# Asset manifest read by the web server at boot (src/web/asset_index.h)
+MANIFEST_NAME = "assets.manifest"
+ETAG_LENGTH = 16  # Hex digits of SHA-256; must match assetEtagLength
+MAX_ASSET_PATH_LENGTH = 64  # Must match maxAssetPathLength
+manifest_excluded = {MANIFEST_NAME, "AGENTS.md"}
+
+
+# JS and CSS bundles get a content hash in their name ("app-common.1a2b3c4d.js"), so they
+# can be cached as immutable; HTML references are rewritten to match
+FINGERPRINT_DIRS = ["js", "css"]
+FINGERPRINT_LENGTH = 8  # Must match assetFingerprintLength
+FINGERPRINTED_NAME = re.compile(r"^(?P<stem>.+)\.[0-9a-f]{%d}(?P<ext>\.(?:js|css))(?:\.gz)?$" % FINGERPRINT_LENGTH)
+ASSET_REFERENCE = re.compile(r'(?P<attr>(?:src|href)=")(?P<path>/(?:%s)/[^"]+)"' % "|".join(FINGERPRINT_DIRS))
+
+
+def unfingerprinted_path(relative_path):
+    """Path a fingerprinted file was built as ("js/app.1a2b3c4d.js" -> "js/app.js")."""
+    directory, name = os.path.split(relative_path)
+    match = FINGERPRINTED_NAME.match(name)
+    if not match:
+        return relative_path
+    return os.path.join(directory, match.group("stem") + match.group("ext")).replace(os.sep, "/")
+
+
+def fingerprint_bundles(data_dir):
+    """Rename freshly built bundles to include their content hash.
+
+    Earlier fingerprinted copies of the same bundle are removed. Bundles that
+    were already renamed by an earlier run (no fresh build since) are kept.
+
+    Returns:
+        Map of URL path as built to URL path as stored, e.g. "/js/app.js" -> "/js/app.1a2b3c4d.js"
+    """
+    renames = {}
+    for directory in FINGERPRINT_DIRS:
+        dir_path = os.path.join(data_dir, directory)
+        if not os.path.isdir(dir_path):
+            continue
+
+        # Fresh build output first: hash it and clear out older versions
+        for file_name in sorted(os.listdir(dir_path)):
+            stem, ext = os.path.splitext(file_name)
+            if ext not in (".js", ".css") or FINGERPRINTED_NAME.match(file_name):
+                continue
+            file_path = os.path.join(dir_path, file_name)
+            with open(file_path, "rb") as f:
+                digest = hashlib.sha256(f.read()).hexdigest()[:FINGERPRINT_LENGTH]
+            hashed_name = f"{stem}.{digest}{ext}"
+
+            for old_name in os.listdir(dir_path):
+                match = FINGERPRINTED_NAME.match(old_name)
+                is_stale = match and match.group("stem") == stem and match.group("ext") == ext
+                if old_name == f"{file_name}.gz" or (is_stale and not old_name.startswith(hashed_name)):
+                    os.remove(os.path.join(dir_path, old_name))
+            if os.path.exists(os.path.join(dir_path, hashed_name)):
+                os.remove(file_path)  # Unchanged - keep the existing file (and its .gz)
+            else:
+                os.rename(file_path, os.path.join(dir_path, hashed_name))
+
+        # Map every bundle, fresh or from an earlier run
+        for file_name in os.listdir(dir_path):
+            match = FINGERPRINTED_NAME.match(file_name)
+            if match:
+                built = f"/{directory}/{match.group('stem')}{match.group('ext')}"
+                stored = f"/{directory}/{file_name[:-3] if file_name.endswith('.gz') else file_name}"
+                renames[built] = stored
+    return renames
+
+
+def rewrite_asset_references(data_dir, renames):
+    """Point script and stylesheet references in the HTML at the fingerprinted names.
+
+    Returns:
+        Number of HTML files changed
+    """
+    changed = 0
+    for root, _, files in os.walk(data_dir):
+        for file_name in files:
+            if not file_name.endswith(".html"):
+                continue
+            file_path = os.path.join(root, file_name)
+            with open(file_path, encoding="utf-8") as f:
+                html = f.read()
+            rewritten = ASSET_REFERENCE.sub(
+                lambda m: f'{m.group("attr")}{renames.get(m.group("path"), m.group("path"))}"', html
+            )
+            missing = [m.group("path") for m in ASSET_REFERENCE.finditer(rewritten) if m.group("path") not in renames.values()]
+            for path in missing:
+                print(f"  ⚠️ {os.path.relpath(file_path, data_dir)} references {path}, which was not built")
+            if rewritten != html:
+                with open(file_path, "w", encoding="utf-8") as f:
+                    f.write(rewritten)
+                changed += 1
+    return changed
+
+
+def file_etag(path):
+    """Content hash of a stored file, as used for its ETag."""
+    with open(path, "rb") as f:
+        return hashlib.sha256(f.read()).hexdigest()[:ETAG_LENGTH]
+
+
+def write_asset_manifest(data_dir):
+    """List every asset with the ETag of its plain and gzipped forms.
+
+    Lines are "<plain etag|-> <gzip etag|-> <url path>", sorted by path.
+
+    Returns:
+        Number of assets listed
+    """
+    assets = {}
+    for root, _, files in os.walk(data_dir):
+        for file_name in files:
+            relative_path = os.path.relpath(os.path.join(root, file_name), data_dir).replace(os.sep, "/")
+            is_gzip = relative_path.endswith(".gz")
+            url_path = "/" + (relative_path[:-3] if is_gzip else relative_path)
+            if os.path.basename(url_path) in manifest_excluded:
+                continue
+            if len(url_path) > MAX_ASSET_PATH_LENGTH or " " in url_path:
+                print(f"  ⚠️ Not in manifest (path too long or has spaces): {url_path}")
+                continue
+            entry = assets.setdefault(url_path, ["-", "-"])
+            entry[1 if is_gzip else 0] = file_etag(os.path.join(root, file_name))
+
+    with open(os.path.join(data_dir, MANIFEST_NAME), "w", encoding="ascii", newline="\n") as manifest:
+        for url_path in sorted(assets):
+            plain_etag, gzip_etag = assets[url_path]
+            manifest.write(f"{plain_etag} {gzip_etag} {url_path}\n")
+    return len(assets)
+
 
 def build_optimized_filesystem(source, target, pio_env):
     """Optimize existing data directory: copy static assets, compress files, protect AP essentials.
@@ -66,6 +198,11 @@ def build_optimized_filesystem(source, target, pio_env):
 
     print("✓ Static assets copied")
 
+    # Content-hashed bundle names, before compression so the .gz follows the new name
+    renames = fingerprint_bundles(data_dir)
+    rewritten_count = rewrite_asset_references(data_dir, renames)
+    print(f"✓ Fingerprinted {len(renames)} bundles, updated {rewritten_count} HTML files")
+
     # Copy warning file from template
     warning_template = "scripts/templates/data_warning.md"
     warning_dest = os.path.join(data_dir, "AGENTS.md")
@@ -106,15 +243,20 @@ def build_optimized_filesystem(source, target, pio_env):
                     should_compress = src_mtime > gz_mtime
                 
                 if should_compress:
+                    # mtime=0 so unchanged content compresses to the same bytes (and ETag)
                     with open(file_path, "rb") as f_in:
-                        with gzip.open(gz_path, "wb", compresslevel=9) as f_out:
-                            f_out.write(f_in.read())
+                        with open(gz_path, "wb") as gz_file:
+                            with gzip.GzipFile(
+                                filename="", mode="wb", fileobj=gz_file, compresslevel=9, mtime=0
+                            ) as f_out:
+                                f_out.write(f_in.read())
                     compressed_count += 1
 
                 # Remove uncompressed version if not essential for AP mode
                 relative_path = os.path.relpath(file_path, data_dir)
+                built_path = unfingerprinted_path(relative_path)
                 is_protected = any(
-                    relative_path == essential or relative_path.endswith(f"/{essential}")
+                    built_path == essential or built_path.endswith(f"/{essential}")
                     for essential in keep_uncompressed
                 )
                 
@@ -129,6 +271,9 @@ def build_optimized_filesystem(source, target, pio_env):
     print(f"✓ Kept {len(ap_essentials)} AP essentials uncompressed")
     print(f"✓ Kept {len(readme_assets)} README assets uncompressed")
 
+    asset_count = write_asset_manifest(data_dir)
+    print(f"✓ Asset manifest lists {asset_count} files ({MANIFEST_NAME})")
+
 
 # Can be called directly or from PlatformIO
 def main():
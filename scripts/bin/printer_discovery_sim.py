@@ -195,15 +195,27 @@ class KeyboardListener:
 
 class ScribePrinterSimulator:
     def __init__(
-        self, broker_host, broker_port, username=None, password=None, use_tls=False
+        self,
+        broker_host,
+        broker_port,
+        username=None,
+        password=None,
+        use_tls=False,
+        scope="",
     ):
         self.broker_host = broker_host
         self.broker_port = broker_port
         self.username = username
         self.password = password
         self.use_tls = use_tls
+        self.scope = scope
         self.clients = {}
 
+    def status_topic(self, name):
+        """Status topic, under scribe/site/<scope>/ when a discovery scope is set"""
+        root = f"scribe/site/{self.scope}/" if self.scope else "scribe/"
+        return f"{root}printer-status/{name.lower()}"
+
     def create_printer_payload(
         self, name, ip_suffix, firmware="1.0.0", status="online"
     ):
@@ -261,7 +273,7 @@ class ScribePrinterSimulator:
                     client.tls_set()
 
         # Setup LWT (Last Will & Testament) with simple offline payload
-        topic = f"scribe/printer-status/{printer_name.lower()}"
+        topic = self.status_topic(printer_name)
         lwt_payload = self.create_offline_payload(printer_name)
         client.will_set(topic, json.dumps(lwt_payload), qos=1, retain=True)
 
@@ -299,7 +311,7 @@ class ScribePrinterSimulator:
             time.sleep(1)
 
             # Publish initial status
-            topic = f"scribe/printer-status/{name.lower()}"
+            topic = self.status_topic(name)
             payload = self.create_printer_payload(name, ip_suffix, firmware, "online")
 
             result = client.publish(topic, json.dumps(payload), qos=1, retain=True)
@@ -352,7 +364,7 @@ class ScribePrinterSimulator:
             time.sleep(1)
 
             # Publish initial status
-            topic = f"scribe/printer-status/{name.lower()}"
+            topic = self.status_topic(name)
             payload = self.create_printer_payload(name, ip_suffix, firmware, "online")
 
             result = client.publish(topic, json.dumps(payload), qos=1, retain=True)
@@ -378,7 +390,7 @@ class ScribePrinterSimulator:
             if graceful:
                 # Graceful shutdown: publish offline status first, then clean disconnect
                 print(f"👋 {name}: Publishing graceful offline status")
-                topic = f"scribe/printer-status/{name.lower()}"
+                topic = self.status_topic(name)
 
                 # Create simple offline payload using helper method
                 offline_payload = self.create_offline_payload(name)
@@ -422,7 +434,7 @@ class ScribePrinterSimulator:
             print(f"❌ Printer {name} not found")
             return
 
-        topic = f"scribe/printer-status/{name.lower()}"
+        topic = self.status_topic(name)
 
         # Get current payload and update status
         ip_suffix = 100 + len(self.clients)  # Simple IP assignment
@@ -622,6 +634,11 @@ def main():
     parser.add_argument(
         "--scenario", help="Run a specific scenario (office, home, mixed, chaos)"
     )
+    parser.add_argument(
+        "--scope",
+        default="",
+        help="Discovery scope (matches mqtt.discoveryScope; empty = unscoped)",
+    )
 
     args = parser.parse_args()
 
@@ -650,7 +667,7 @@ def main():
 
     # Create simulator
     simulator = ScribePrinterSimulator(
-        args.host, broker_port, args.username, args.password, use_tls
+        args.host, broker_port, args.username, args.password, use_tls, args.scope
     )
 
     try:
@@ -4,6 +4,7 @@ Pre-build script to build frontend assets (CSS and JS) before compiling firmware
 This ensures production builds always have the latest frontend assets.
 """
 
+import os
 import subprocess
 import sys
 
@@ -24,9 +25,20 @@ def build_frontend(source, target, env):  # pylint: disable=unused-argument
         )
 
         if result.returncode == 0:
+            # optimize_filesystem.py writes the manifest the web server uses for ETags
+            manifest_path = os.path.join(env.get("PROJECT_DATA_DIR", "data"), "assets.manifest")
+            if not os.path.exists(manifest_path):
+                print("=" * 60)
+                print(f"❌ FRONTEND BUILD DID NOT WRITE {manifest_path}")
+                print("=" * 60)
+                sys.exit(1)
+            with open(manifest_path, encoding="ascii") as manifest:
+                asset_count = sum(1 for _ in manifest)
+
             print("=" * 60)
             print("✅ FRONTEND BUILD COMPLETED SUCCESSFULLY")
             print("   CSS + JavaScript assets are ready for ESP32")
+            print(f"   Asset manifest lists {asset_count} files")
             print("=" * 60)
         else:
             print("=" * 60)
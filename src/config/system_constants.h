@@ -46,13 +46,60 @@ static const char *sessionCookieName = "ScribeSession";
 static const char *sessionCookieOptions = "HttpOnly; Secure; SameSite=Strict";        // Cookie security options
 
 // MQTT connection and retry settings
-static const int mqttMaxConsecutiveFailures = 3;                               // Max failures before cooldown
+static const int mqttMaxConsecutiveFailures = 3;                               // Failures on the last usable broker before cooldown
+static const int mqttFailoverThreshold = 2;                                    // Failures on one broker before failing over to another
 static const unsigned long mqttReconnectIntervalMs = ScribeTime::Seconds(5);   // Normal reconnect interval (5s)
-static const unsigned long mqttFailureCooldownMs = ScribeTime::Minutes(1);     // Cooldown after max failures (60s)
+static const unsigned long mqttFailureCooldownMs = ScribeTime::Minutes(1);     // Cooldown once every broker has failed (60s)
 static const unsigned long mqttConnectionTimeoutMs = ScribeTime::Seconds(7);   // Connection timeout (7s)
 static const unsigned long mqttTlsHandshakeTimeoutMs = ScribeTime::Seconds(6); // TLS handshake timeout (< watchdog)
 static const int mqttBufferSize = 512;                                         // MQTT message buffer size
 
+// MQTT broker failover (primary server plus mqtt.fallbackServers, in preference order)
+static const char *defaultMqttFallbackServers = "";                            // "host:port,host:port" (none by default)
+static const int maxMqttBrokers = 4;                                           // Primary + up to 3 fallbacks
+static const unsigned long mqttPreferredProbeIntervalMs = ScribeTime::Minutes(5); // Check if preferred broker is back (on a fallback only)
+static const unsigned long mqttPreferredProbeMaxIntervalMs = ScribeTime::Hours(2); // Probe interval cap; doubles after each failed switch-back
+static const unsigned long mqttBrokerProbeTimeoutMs = 1500;                    // TCP probe timeout; blocks the main loop this long (DNS is resolved beforehand)
+
+// MQTT multipart messages (payloads larger than mqttBufferSize are split into parts)
+static const int mqttMultipartPartSize = 352;                                  // Max serialized part payload (leaves room for topic + header)
+static const int mqttMultipartMaxParts = 32;                                   // Max parts per message
+static const int mqttMultipartMaxMessageSize = 8192;                           // Max reassembled message size (8KB)
+static const int mqttMultipartMaxPending = 2;                                  // Partial messages held at once (oldest dropped first)
+static const int mqttMultipartIdLength = 32;                                   // Max message ID length (including terminator)
+static const unsigned long mqttMultipartTimeoutMs = ScribeTime::Seconds(30);   // Drop partial messages not completed within 30s
+
+// MQTT group and broadcast print topics (one publish reaches every subscribed printer)
+static const char *mqttGroupTopicPrefix = "scribe/group/";                     // Group topic is prefix + group name
+static const char *mqttBroadcastTopic = "scribe/broadcast";                    // Printed by every printer
+static const char *defaultMqttGroups = "";                                     // Comma-separated group names (none by default)
+static const int maxMqttGroups = 8;                                            // Max groups a printer subscribes to
+static const int maxMqttGroupNameLength = 32;                                  // Max characters per group name
+
+// Duplicate message suppression (optional "id" field on MQTT and HTTP prints)
+static const int messageDedupCapacity = 32;                                    // Recent message IDs remembered
+static const int messageDedupTableSize = 64;                                   // Hash slots (power of 2, > capacity)
+static const unsigned long messageDedupWindowMs = ScribeTime::Minutes(10);     // Repeat within this window is dropped
+static const int maxMessageIdLength = 64;                                      // Max message ID length
+
+// Remote print delivery acknowledgements ("reply_to" on MQTT print messages)
+static const char *mqttAckTopicPrefix = "scribe/ack/";                         // Ack topic is prefix + printer ID
+static const int deliveryTrackerCapacity = 16;                                 // Recent remote jobs kept for latency reporting
+static const unsigned long deliveryAckTimeoutMs = ScribeTime::Seconds(30);     // Job without ack after this is reported as timed out
+
+// Runtime log levels over MQTT ({"level": "NOTICE", "componentLevels": "MQTT=VERBOSE"})
+static const char *mqttLogLevelTopicPrefix = "scribe/log-level/";              // Topic is prefix + printer ID
+
+// Direct LAN printing between peers (POST /api/peer-print, HMAC-SHA256 signed with mqtt.peerKey)
+static const char *peerPrintPath = "/api/peer-print";                          // Receiving endpoint on every printer
+static const char *defaultMqttPeerKey = "";                                    // Shared fleet key (empty = LAN printing off)
+static const int minPeerKeyLength = 16;                                        // Shortest accepted shared key
+static const int maxPeerKeyLength = 64;                                        // Longest accepted shared key
+static const long peerPrintMaxClockSkewSeconds = 60;                           // Signed timestamp must be within this of our clock
+static const unsigned long peerPrintTimeoutMs = 1500;                          // No 202 within this and the job falls back to MQTT
+static const int peerPrintMaxInFlight = 2;                                     // Outgoing LAN jobs at once (more go straight to MQTT)
+static const int peerPrintMaxQueued = 2;                                       // Received LAN jobs waiting for the main loop
+
 // Unbidden Ink prompt presets (autoprompts)
 static const char *unbiddenInkPromptCreative = "Generate creative, artistic content - poetry, short stories, or imaginative scenarios. Keep it engaging and printable.";
 static const char *unbiddenInkPromptWisdom = "Share philosophical insights, life wisdom, or thought-provoking reflections. Keep it meaningful and contemplative.";
@@ -125,15 +172,66 @@ static const int ntpSyncIntervalSeconds = 3600; // Re-sync interval (1 hour)
 
 // Logging Configuration
 // Logging levels: LOG_LEVEL_VERBOSE, LOG_LEVEL_NOTICE, LOG_LEVEL_WARN, LOG_LEVEL_ERROR
-static const int logLevel = LOG_LEVEL_NOTICE;
+static const int logLevel = LOG_LEVEL_NOTICE;              // Default runtime level (logging.level in /api/config)
+static const char *defaultLogComponentLevels = "";         // Per-component runtime levels, e.g. "MQTT=VERBOSE,WEB=WARNING"
+static const int maxLogLevelOverrides = 16;                // Components with their own runtime level
+static const int logLevelComponentNameLength = 15;         // Longest component name in an override
+static const int maxLogComponentLevelsLength = 256;        // Longest logging.componentLevels text
+
+// Compile-time log filtering: LOG_* calls above these levels generate no code at all,
+// arguments included. Builds set SCRIBE_LOG_COMPILE_LEVEL in platformio.ini.
+#ifndef SCRIBE_LOG_COMPILE_LEVEL
+#define SCRIBE_LOG_COMPILE_LEVEL LOG_LEVEL_VERBOSE
+#endif
+static constexpr int logCompileLevel = SCRIBE_LOG_COMPILE_LEVEL;
+
+// Per-component caps below logCompileLevel (component names must match the LOG_* literal)
+struct LogComponentLevel
+{
+    const char *component;
+    int maxLevel;
+};
+static constexpr LogComponentLevel logComponentCompileLevels[] = {
+    {"LEDS", LOG_LEVEL_NOTICE}, // Per-cycle effect logging runs inside the animation loop
+};
+
 static const esp_log_level_t espLogLevel = ESP_LOG_WARN;
 static const bool enableSerialLogging = true;       // Serial console
 static const bool enableFileLogging = false;        // LittleFS file (untested)
 static const bool enableMQTTLogging = false;        // MQTT topic
-static const bool enableBetterStackLogging = false; // BetterStack (slow but useful for debugging)
+static const bool enableBetterStackLogging = false; // BetterStack (batched HTTPS)
 static const char *mqttLogTopic = "scribe/log";
-static const char *logFileName = "/logs/scribe.log";
-static const size_t maxLogFileSize = 100000; // 100KB
+static const char *logFileName = "/logs/scribe.log";     // Segments are logFileName.0, .1, ... (index in .idx)
+static const bool logFileBinaryRecords = false;          // File log as binary records (scripts/bin/decode_log.py)
+static const char *logBinaryFileName = "/logs/scribe.bin";
+static const int logFileSegmentCount = 4;                // Log file segments; the oldest is reused
+static const size_t logFileSegmentBytes = 32768;         // Segment size before moving to the next one
+static const int logFileBufferBytes = 4096;              // RAM write buffer - one LittleFS block
+static const int logFileFlushIntervalMs = 5000;          // Longest a line waits in RAM
+static const int logFileFlushLevel = LOG_LEVEL_WARNING;  // This level and more severe is written straight away
+static const int logRingBytes = 8192;          // Binary log records queued for the sink task (power of 2)
+static const int logRecordMaxArgBytes = 200;   // Argument bytes per record; longer %s text is truncated
+static const int logMessageMaxLength = 256;    // Formatted message length at the sinks
+static const int logComponentTableSize = 128;  // Distinct component names (power of 2)
+static const int logComponentNameLength = 15;  // Component name characters kept; longer names are cut
+static const int logSinkTaskStackSize = 8192;  // Sink task stack: TLS handshake for BetterStack plus message buffers
+static const int logSinkTaskPriority = 1;      // Same as loopTask; the sink blocks between records
+static const int logSinkIdleWaitMs = 250;      // Sink wake-up when no producer has notified it
+static const int logMqttQueueLength = 8;       // MQTT log payloads waiting for the main loop
+static const int logFlushTimeoutMs = 500;      // Longest flushLogs() waits before a restart
+static const int logHistoryBytes = 8192;       // Recent records kept for /api/logs (power of 2)
+static const size_t logQueryLineBytes = 1024;  // /api/logs output line buffer; longer lines are skipped
+static const int defaultLogRateLimitPerMinute = 60; // Lines a minute per component and level once the burst is used (0 = off)
+static const int defaultLogRateLimitBurst = 20;     // Lines per component and level before limiting starts
+static const int maxLogRateLimitPerMinute = 6000;
+static const int maxLogRateLimitBurst = 100;
+static const int logRateLimitSlots = 64;            // Component/level pairs tracked (power of 2)
+static const unsigned long logRateLimitSummaryIntervalMs = 30000; // How often suppressed counts are logged
+static const int crashLogSlotCount = 32;       // Log lines kept in no-init RAM across resets (power of 2)
+static const int crashLogComponentBytes = 12;  // Component name bytes kept per line, terminator included
+static const int crashLogSlotArgBytes = 36;    // Argument bytes kept per line (64-byte slots on the ESP32)
+static const bool crashLogPublishMqtt = false; // Publish the previous boot's lines once after a reset
+static const char *crashLogMqttTopic = "scribe/log/previous-boot";
 
 // External API endpoints
 static const char *jokeAPI = "https://icanhazdadjoke.com/";
@@ -145,6 +243,13 @@ static const char *chatgptApiTestEndpoint = "https://api.openai.com/v1/models";
 
 // BetterStack configuration
 static const char *betterStackEndpoint = "https://s1451477.eu-nbg-2.betterstackdata.com/";
+static const int betterStackBatchMaxRecords = 25;              // Records per POST (JSON array)
+static const size_t betterStackBatchMaxBytes = 6144;           // Batch buffer; records that don't fit are dropped
+static const unsigned long betterStackFlushIntervalMs = 5000;  // Oldest record waits at most this long
+static const unsigned long betterStackRetryBaseMs = 2000;      // First retry delay after a failed POST (doubles)
+static const unsigned long betterStackRetryMaxMs = 60000;      // Retry delay cap
+static const int betterStackMaxAttempts = 4;                   // Failed POSTs before the batch is dropped
+static const int betterStackHttpTimeoutMs = 5000;              // Connect/response timeout per POST
 
 // Application Settings
 static const int maxCharacters = 1000;      // Max characters per message (single source of truth)
@@ -168,8 +273,39 @@ static const int statusLEDPin = 8;    // ESP32-C3 has built-in LED on GPIO8
 static const int webServerPort = 80;  // HTTP port for web server
 const int watchdogTimeoutSeconds = 8; // Watchdog timeout in seconds
 
+// Static assets (manifest written by scripts/bin/optimize_filesystem.py)
+static const char *assetManifestPath = "/assets.manifest"; // One line per asset: plain ETag, gzip ETag, path
+static const int assetEtagLength = 16;                      // Hex digits of SHA-256 kept as the ETag
+static const int maxAssetPathLength = 64;                   // Longer paths in the manifest are skipped
+static const int assetFingerprintLength = 8;                // Hex digits of the content hash in bundle names (app.1a2b3c4d.js)
+static const char *assetCacheFingerprinted = "public, max-age=31536000, immutable"; // Name changes with content
+static const char *assetCacheHtml = "no-cache";             // Always revalidated (304 via ETag), so deploys show at once
+static const char *assetCacheDefault = "max-age=86400";     // Images, fonts, resources - unversioned names
+
 // Printer Discovery Heartbeat
-static const unsigned long printerDiscoveryHeartbeatIntervalMs = ScribeTime::Minutes(1); // 1 minute heartbeat interval
+// Retained status is published on connect and whenever it changes; otherwise only a tiny
+// liveness ping is sent, backing off from the first interval to the max. Offline detection relies on the LWT.
+static const char *printerStatusTopicLevel = "printer-status/";                          // Retained status topic is <root> + level + printer ID
+static const char *printerPingTopicLevel = "printer-ping/";                              // Liveness ping topic is <root> + level + printer ID
+static const unsigned long printerDiscoveryHeartbeatIntervalMs = ScribeTime::Minutes(1); // First ping after a status publish
+static const unsigned long printerPingMaxIntervalMs = ScribeTime::Minutes(15);          // Ping interval doubles up to this
+static const int printerPingJitterPercent = 20;                                          // +/- jitter so printers don't ping in step
+static const unsigned long printerStatusCheckIntervalMs = ScribeTime::Seconds(10);       // How often to look for status changes
+static const unsigned long discoveredPrinterTtlMs = ScribeTime::Minutes(40);             // Forget printers silent for > 2 max ping intervals
+
+// Discovery scope - printers only exchange status with others in the same site/group
+// Root is "scribe/" when unscoped, "scribe/site/<scope>/" when scoped
+static const char *discoveryRootTopic = "scribe/";                                       // Unscoped discovery root (legacy topics)
+static const char *discoverySiteTopicPrefix = "scribe/site/";                            // Scoped root is prefix + scope + "/"
+static const char *discoverySummaryTopicLevel = "discovery-summary";                     // Retained per-scope printer counts: <root> + level
+static const char *defaultMqttDiscoveryScope = "";                                       // Empty = unscoped
+static const bool defaultMqttDiscoverySummary = false;                                   // Publish the per-scope summary
+
+// LAN discovery over mDNS (_scribe._tcp with id/name/version/scope TXT records) - works without MQTT
+static const char *mdnsServiceName = "scribe";                                           // Advertised as _scribe._tcp
+static const unsigned long mdnsBrowseIntervalMs = ScribeTime::Minutes(2);                // Min time between browses
+static const unsigned long mdnsBrowseTimeoutMs = ScribeTime::Seconds(3);                 // Browse runs in the background for this long
+static const unsigned long mdnsPrinterTtlMs = ScribeTime::Minutes(7);                    // mDNS-only printers missing from 3 browses are dropped
 
 // Input Validation Limits
 static const unsigned long minRequestIntervalMs = 100;                 // 100ms minimum between requests
@@ -177,14 +313,18 @@ static const unsigned long maxRequestsPerMinute = 60;                  // 60 req
 static const unsigned long rateLimitWindowMs = ScribeTime::Minutes(1); // 1 minute rate limit window
 static const int maxControlCharPercent = 10;                           // Max control characters as percentage of message length
 static const int maxJsonPayloadSize = 8192;                            // 8KB max JSON payload size
+static const int requestBodyBufferCount = 3;                           // Pooled POST body buffers (maxJsonPayloadSize each), allocated on first use
 static const int maxMqttTopicLength = 128;                             // Max MQTT topic length
 static const int maxParameterLength = 1000;                            // Default max parameter length
 static const int maxRemoteParameterLength = 100;                       // Max length for remote parameter
 static const int maxUriDisplayLength = 200;                            // Max URI length for display (truncated after this)
 static const int jsonDocumentSize = 1024;                              // Standard JSON document buffer size
-static const int largeJsonDocumentSize = 6144;                         // Large JSON document buffer size (6KB for config with GPIO info and memos)
+static const int largeJsonDocumentSize = 6144;                         // Large JSON document buffer size (6KB for config POST bodies and API replies)
+static const size_t jsonStreamBufferBytes = 256;                       // JsonStreamWriter buffer, flushed to its output when full
+static const size_t jsonStreamPendingBytes = 512;                      // Streamed response step buffer; grows to the largest single step
+static const int jsonStreamMaxDepth = 32;                              // Deepest object/array nesting JsonStreamWriter tracks
 static const int maxValidationErrors = 10;                             // Max validation errors to store
-static const int maxOtherPrinters = 10;                                // Max other printers to track
+static const int maxOtherPrinters = 10;                                // Max other printers to track (discovered printer table capacity)
 static const int stringBufferSize = 64;                                // Standard string buffer size
 static const int topicBufferSize = 64;                                 // MQTT topic buffer size
 static const int maxWifiPasswordLength = 64;                           // Max WiFi password length
@@ -16,6 +16,7 @@
 #include <core/config_utils.h>
 #include <core/nvs_keys.h>
 #include <core/logging.h>
+#include <core/message_dedup.h>
 #include <utils/time_utils.h>
 #include <utils/json_helpers.h>
 #include <utils/content_actions.h>
@@ -255,18 +256,14 @@ void handlePrintLocal(AsyncWebServerRequest *request)
         return;
     }
 
-    // Get and validate JSON body
-    extern String getRequestBody(AsyncWebServerRequest * request);
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON in place - the message text stays in the body buffer rather than being copied into doc
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeRequestBody(request, doc);
+    if (error == DeserializationError::EmptyInput)
     {
         sendValidationError(request, ValidationResult(false, "No JSON body provided"));
         return;
     }
-
-    // Parse JSON
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, body);
     if (error)
     {
         sendValidationError(request, ValidationResult(false, "Invalid JSON format: " + String(error.c_str())));
@@ -280,6 +277,14 @@ void handlePrintLocal(AsyncWebServerRequest *request)
         return;
     }
 
+    // Optional message ID - a retried request with the same ID is acknowledged but not printed again
+    const char *messageId = doc["id"] | "";
+    if (strlen(messageId) > maxMessageIdLength)
+    {
+        sendValidationError(request, ValidationResult(false, "Message ID too long (max " + String(maxMessageIdLength) + " characters)"));
+        return;
+    }
+
     String message = doc["message"].as<String>();
 
     // Debug: Log message details
@@ -294,6 +299,14 @@ void handlePrintLocal(AsyncWebServerRequest *request)
         return;
     }
 
+    // Checked after validation so a rejected request doesn't claim its ID
+    if (isDuplicateMessage(messageId))
+    {
+        LOG_NOTICE("WEB", "Dropped duplicate message: %s", messageId);
+        request->send(200);
+        return;
+    }
+
     // Set up message data for local printing - content should already be formatted with action headers
     currentMessage.message = message;
     currentMessage.timestamp = getFormattedDateTime();
@@ -145,6 +145,11 @@ bool loadNVSConfig()
     g_runtimeConfig.mqttPort = getNVSInt(prefs, NVS_MQTT_PORT, defaultMqttPort, 1, 65535);
     g_runtimeConfig.mqttUsername = getNVSString(prefs, NVS_MQTT_USERNAME, defaultMqttUsername, 100);
     g_runtimeConfig.mqttPassword = getNVSString(prefs, NVS_MQTT_PASSWORD, defaultMqttPassword, 100);
+    g_runtimeConfig.mqttGroups = getNVSString(prefs, NVS_MQTT_GROUPS, defaultMqttGroups, 255);
+    g_runtimeConfig.mqttFallbackServers = getNVSString(prefs, NVS_MQTT_FALLBACKS, defaultMqttFallbackServers, 255);
+    g_runtimeConfig.mqttDiscoveryScope = getNVSString(prefs, NVS_MQTT_DISC_SCOPE, defaultMqttDiscoveryScope, maxMqttGroupNameLength);
+    g_runtimeConfig.mqttDiscoverySummary = getNVSBool(prefs, NVS_MQTT_DISC_SUMMARY, defaultMqttDiscoverySummary);
+    g_runtimeConfig.mqttPeerKey = getNVSString(prefs, NVS_MQTT_PEER_KEY, defaultMqttPeerKey, maxPeerKeyLength);
 
     // Load API configuration (non-user configurable APIs remain as constants)
     g_runtimeConfig.jokeAPI = jokeAPI;
@@ -158,6 +163,19 @@ bool loadNVSConfig()
     // Load validation configuration (hardcoded from config.h)
     g_runtimeConfig.maxCharacters = maxCharacters;
 
+    // Load logging configuration
+    g_runtimeConfig.logRateLimitPerMinute = getNVSInt(prefs, NVS_LOG_RATE_LIMIT, defaultLogRateLimitPerMinute, 0, maxLogRateLimitPerMinute);
+    g_runtimeConfig.logRateLimitBurst = getNVSInt(prefs, NVS_LOG_RATE_BURST, defaultLogRateLimitBurst, 1, maxLogRateLimitBurst);
+    setLogRateLimit(g_runtimeConfig.logRateLimitPerMinute, g_runtimeConfig.logRateLimitBurst);
+    g_runtimeConfig.logLevel = getNVSInt(prefs, NVS_LOG_LEVEL, logLevel, LOG_LEVEL_SILENT, LOG_LEVEL_VERBOSE);
+    g_runtimeConfig.logComponentLevels = getNVSString(prefs, NVS_LOG_COMP_LEVELS, defaultLogComponentLevels, maxLogComponentLevelsLength);
+    if (!setLogLevels(g_runtimeConfig.logLevel, g_runtimeConfig.logComponentLevels.c_str()))
+    {
+        LOG_WARNING("CONFIG", "Ignoring invalid log component levels: %s", g_runtimeConfig.logComponentLevels.c_str());
+        g_runtimeConfig.logComponentLevels = defaultLogComponentLevels;
+        setLogLevels(g_runtimeConfig.logLevel, defaultLogComponentLevels);
+    }
+
     // Load Unbidden Ink settings
     LOG_VERBOSE("CONFIG", "DEBUG: Default values - startHour=%d, endHour=%d, frequency=%d",
                 defaultUnbiddenInkStartHour, defaultUnbiddenInkEndHour, defaultUnbiddenInkFrequencyMinutes);
@@ -236,6 +254,11 @@ void loadDefaultConfig()
     g_runtimeConfig.mqttPort = defaultMqttPort;
     g_runtimeConfig.mqttUsername = defaultMqttUsername;
     g_runtimeConfig.mqttPassword = defaultMqttPassword;
+    g_runtimeConfig.mqttGroups = defaultMqttGroups;
+    g_runtimeConfig.mqttFallbackServers = defaultMqttFallbackServers;
+    g_runtimeConfig.mqttDiscoveryScope = defaultMqttDiscoveryScope;
+    g_runtimeConfig.mqttDiscoverySummary = defaultMqttDiscoverySummary;
+    g_runtimeConfig.mqttPeerKey = defaultMqttPeerKey;
 
     g_runtimeConfig.jokeAPI = jokeAPI;
     g_runtimeConfig.quoteAPI = quoteAPI;
@@ -247,6 +270,13 @@ void loadDefaultConfig()
 
     g_runtimeConfig.maxCharacters = maxCharacters;
 
+    g_runtimeConfig.logRateLimitPerMinute = defaultLogRateLimitPerMinute;
+    g_runtimeConfig.logRateLimitBurst = defaultLogRateLimitBurst;
+    setLogRateLimit(g_runtimeConfig.logRateLimitPerMinute, g_runtimeConfig.logRateLimitBurst);
+    g_runtimeConfig.logLevel = logLevel;
+    g_runtimeConfig.logComponentLevels = defaultLogComponentLevels;
+    setLogLevels(g_runtimeConfig.logLevel, defaultLogComponentLevels);
+
     LOG_VERBOSE("CONFIG", "DEBUG: Setting defaults - startHour=%d, endHour=%d, frequency=%d",
                 defaultUnbiddenInkStartHour, defaultUnbiddenInkEndHour, defaultUnbiddenInkFrequencyMinutes);
 
@@ -313,10 +343,21 @@ bool saveNVSConfig(const RuntimeConfig &config)
     prefs.putInt(NVS_MQTT_PORT, config.mqttPort);
     prefs.putString(NVS_MQTT_USERNAME, config.mqttUsername);
     prefs.putString(NVS_MQTT_PASSWORD, config.mqttPassword);
+    prefs.putString(NVS_MQTT_GROUPS, config.mqttGroups);
+    prefs.putString(NVS_MQTT_FALLBACKS, config.mqttFallbackServers);
+    prefs.putString(NVS_MQTT_DISC_SCOPE, config.mqttDiscoveryScope);
+    prefs.putBool(NVS_MQTT_DISC_SUMMARY, config.mqttDiscoverySummary);
+    prefs.putString(NVS_MQTT_PEER_KEY, config.mqttPeerKey);
 
     // Save ChatGPT API token (other APIs are constants)
     prefs.putString(NVS_CHATGPT_TOKEN, config.chatgptApiToken);
 
+    // Save logging configuration
+    prefs.putInt(NVS_LOG_RATE_LIMIT, config.logRateLimitPerMinute);
+    prefs.putInt(NVS_LOG_RATE_BURST, config.logRateLimitBurst);
+    prefs.putInt(NVS_LOG_LEVEL, config.logLevel);
+    prefs.putString(NVS_LOG_COMP_LEVELS, config.logComponentLevels);
+
     // Save Unbidden Ink configuration
     prefs.putBool(NVS_UNBIDDEN_ENABLED, config.unbiddenInkEnabled);
     prefs.putInt(NVS_UNBIDDEN_START_HOUR, config.unbiddenInkStartHour);
@@ -380,6 +421,8 @@ void setRuntimeConfig(const RuntimeConfig &config)
 {
     g_runtimeConfig = config;
     g_configLoaded = true;
+    setLogRateLimit(config.logRateLimitPerMinute, config.logRateLimitBurst);
+    setLogLevels(config.logLevel, config.logComponentLevels.c_str());
 }
 
 bool initializeNVSConfig()
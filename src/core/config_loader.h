@@ -37,6 +37,11 @@ struct RuntimeConfig
     int mqttPort;
     String mqttUsername;
     String mqttPassword;
+    String mqttGroups; // Comma-separated group names (scribe/group/<name>)
+    String mqttFallbackServers; // Comma-separated "host:port" brokers tried after mqttServer
+    String mqttDiscoveryScope;  // Site/group for printer discovery (empty = unscoped)
+    bool mqttDiscoverySummary;  // Publish retained per-scope printer counts
+    String mqttPeerKey;         // Shared key signing direct LAN prints (empty = off)
 
     // API Configuration
     String jokeAPI;
@@ -51,6 +56,12 @@ struct RuntimeConfig
     // Validation Configuration (only user-configurable parts)
     int maxCharacters;
 
+    // Logging Configuration
+    int logRateLimitPerMinute; // Lines a minute per component and level after the burst (0 = unlimited)
+    int logRateLimitBurst;     // Lines per component and level before limiting starts
+    int logLevel;              // Runtime level for components without an override
+    String logComponentLevels; // Per-component overrides, e.g. "MQTT=VERBOSE,WEB=WARNING"
+
     // Unbidden Ink Configuration
     bool unbiddenInkEnabled;
     int unbiddenInkStartHour;
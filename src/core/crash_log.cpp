@@ -0,0 +1,136 @@
+/**
+ * @file crash_log.cpp
+ * @brief Implementation of the reset-surviving log ring
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "crash_log.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <soc/soc_memory_layout.h>
+#endif
+
+static const uint32_t crashLogMagic = 0x53434C31; // "SCL1"
+
+// Format pointers must point at flash literals of this build
+static bool isTrustedString(const char *text)
+{
+#ifdef ARDUINO_ARCH_ESP32
+    return esp_ptr_in_drom(text);
+#else
+    return text != nullptr;
+#endif
+}
+
+CrashLog::CrashLog() : bank(nullptr), previous(nullptr), previousCount(0)
+{
+}
+
+void CrashLog::begin(CrashLogStorage *storage, const uint8_t *firmwareId, bool keepPrevious)
+{
+    if (bank)
+    {
+        return; // Already attached - a second begin would discard this boot's lines
+    }
+
+    previous = nullptr;
+    previousCount = 0;
+
+    bool trusted = keepPrevious && storage->magic == crashLogMagic && storage->activeBank < 2 &&
+                   memcmp(storage->firmwareId, firmwareId, crashLogFirmwareIdBytes) == 0;
+    if (trusted)
+    {
+        previous = &storage->banks[storage->activeBank];
+
+        // Slots overwritten mid-crash don't carry the sequence expected for their place
+        uint32_t next = previous->next;
+        uint32_t first = next > crashLogSlotCount ? next - crashLogSlotCount + 1 : 1;
+        for (uint32_t sequence = first; sequence <= next; sequence++)
+        {
+            uint32_t index = (sequence - 1) & (crashLogSlotCount - 1);
+            const CrashLogSlot &slot = previous->slots[index];
+            if (slot.sequence == sequence && slot.argLength <= crashLogSlotArgBytes)
+            {
+                previousSlots[previousCount++] = (uint8_t)index;
+            }
+        }
+        storage->activeBank ^= 1;
+    }
+    else
+    {
+        memset(storage, 0, sizeof(*storage));
+        storage->magic = crashLogMagic;
+        memcpy(storage->firmwareId, firmwareId, crashLogFirmwareIdBytes);
+    }
+
+    bank = &storage->banks[storage->activeBank];
+    memset(bank, 0, sizeof(*bank));
+}
+
+void CrashLog::add(const char *component, const LogRecord &record)
+{
+    if (!bank)
+    {
+        return;
+    }
+
+    uint32_t sequence = __atomic_add_fetch(&bank->next, 1, __ATOMIC_RELAXED);
+    CrashLogSlot &slot = bank->slots[(sequence - 1) & (crashLogSlotCount - 1)];
+
+    // Invalidate first, so a slot cut off by a reset part-way through is skipped
+    __atomic_store_n(&slot.sequence, 0, __ATOMIC_RELAXED);
+    uint8_t argLength = min(record.argLength, (uint8_t)crashLogSlotArgBytes);
+    slot.timestampMs = record.timestampMs;
+
+    // A plain bounded copy - names are short and this runs on every log call
+    size_t length = 0;
+    while (component && component[length] && length < sizeof(slot.component) - 1)
+    {
+        slot.component[length] = component[length];
+        length++;
+    }
+    slot.component[length] = '\0';
+
+    slot.format = record.format;
+    slot.level = record.level;
+    slot.argLength = argLength;
+    slot.flags = record.flags | (argLength < record.argLength ? LOG_RECORD_TRUNCATED : 0);
+    memcpy(slot.args, record.args, argLength);
+    __atomic_store_n(&slot.sequence, sequence, __ATOMIC_RELEASE);
+}
+
+const CrashLogSlot &CrashLog::getPrevious(int index) const
+{
+    return previous->slots[previousSlots[index]];
+}
+
+const char *CrashLog::getPreviousComponent(int index) const
+{
+    const CrashLogSlot &slot = getPrevious(index);
+    bool valid = slot.component[0] && memchr(slot.component, '\0', sizeof(slot.component));
+    return valid ? slot.component : "?";
+}
+
+size_t CrashLog::formatPrevious(int index, char *out, size_t outSize) const
+{
+    const CrashLogSlot &slot = getPrevious(index);
+    if (!isTrustedString(slot.format))
+    {
+        return snprintf(out, outSize, "?");
+    }
+
+    alignas(LogRecord) uint8_t scratch[sizeof(LogRecord) + crashLogSlotArgBytes];
+    LogRecord *record = reinterpret_cast<LogRecord *>(scratch);
+    record->control = 0;
+    record->timestampMs = slot.timestampMs;
+    record->format = slot.format;
+    record->level = slot.level;
+    record->componentId = logUnknownComponentId;
+    record->argLength = slot.argLength;
+    record->flags = slot.flags;
+    memcpy(record->args, slot.args, slot.argLength);
+    return formatLogMessage(*record, out, outSize);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file crash_log.h
+ * @brief Log ring in no-init RAM that survives soft resets
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Every log call also copies its binary record (log_record.h) into a small
+ * ring of fixed-size slots that the bootloader doesn't clear, so the last
+ * lines before a panic, watchdog or software reset can be read on the next
+ * boot. Adding a record is one atomic increment and one memcpy - no locks,
+ * no formatting. Arguments beyond crashLogSlotArgBytes are cut, and print as
+ * "?" like any other truncated record.
+ *
+ * The storage holds two banks. At boot the bank written by the previous run
+ * becomes read-only and logging switches to the other, so the previous
+ * boot's lines stay available for the whole of this run.
+ *
+ * Slots keep the format pointer rather than the text, so they are only trusted
+ * when the storage was written by this same firmware build. The component name
+ * is copied in, cut to crashLogComponentBytes - 1 characters: names built at
+ * run time don't live in flash, so a pointer to them means nothing after a reset.
+ */
+
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include "log_record.h"
+
+static const size_t crashLogFirmwareIdBytes = 8;
+
+struct CrashLogSlot
+{
+    uint32_t sequence; // Write number (from 1) that filled the slot; written last
+    uint32_t timestampMs;
+    const char *format;
+    uint8_t level;
+    uint8_t argLength;
+    uint8_t flags;
+    uint8_t reserved;
+    char component[crashLogComponentBytes];
+    uint8_t args[crashLogSlotArgBytes];
+};
+
+struct CrashLogBank
+{
+    uint32_t next; // Writes so far
+    CrashLogSlot slots[crashLogSlotCount];
+};
+
+/**
+ * @brief Place in no-init RAM (__NOINIT_ATTR); contents are random after power-on
+ */
+struct CrashLogStorage
+{
+    uint32_t magic;
+    uint8_t firmwareId[crashLogFirmwareIdBytes];
+    uint32_t activeBank;
+    CrashLogBank banks[2];
+};
+
+class CrashLog
+{
+public:
+    CrashLog();
+
+    /**
+     * @brief Attach to the storage, keeping what the previous boot wrote if it can be trusted
+     * @param firmwareId Identity of this build (e.g. the start of the ELF SHA-256)
+     * @param keepPrevious false after a power-on reset, when the storage is random
+     */
+    void begin(CrashLogStorage *storage, const uint8_t *firmwareId, bool keepPrevious);
+
+    /**
+     * @brief Copy a record in, overwriting the oldest (any task; no-op before begin())
+     */
+    void add(const char *component, const LogRecord &record);
+
+    /**
+     * @brief Lines kept from the previous boot, oldest first
+     */
+    int getPreviousCount() const { return previousCount; }
+    const CrashLogSlot &getPrevious(int index) const;
+
+    /**
+     * @brief Component name of a previous-boot line ("?" if it doesn't look valid)
+     */
+    const char *getPreviousComponent(int index) const;
+
+    /**
+     * @brief Message text of a previous-boot line
+     */
+    size_t formatPrevious(int index, char *out, size_t outSize) const;
+
+private:
+    static_assert((crashLogSlotCount & (crashLogSlotCount - 1)) == 0, "crashLogSlotCount must be a power of 2");
+
+    CrashLogBank *bank; // Written this boot
+    const CrashLogBank *previous;
+    uint8_t previousSlots[crashLogSlotCount]; // Complete slots, oldest first
+    int previousCount;
+};
+
+#endif // CRASH_LOG_H
@@ -0,0 +1,306 @@
+/**
+ * @file delivery_tracker.cpp
+ * @brief Implementation of remote print delivery tracking
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "delivery_tracker.h"
+#include <config/config.h>
+#include <vector>
+
+struct DeliveryRecord
+{
+    bool inUse;
+    bool acked;
+    DeliveryPath path;
+    char messageId[maxMessageIdLength + 1];
+    char topic[topicBufferSize];
+    char printerId[16];
+    char status[12];
+    unsigned long sentAt;
+    unsigned long roundTripMs;
+    unsigned long printStartMs;
+    unsigned long printDoneMs;
+};
+
+static DeliveryRecord deliveries[deliveryTrackerCapacity];
+static int nextDelivery = 0;
+
+// Written from the web server and MQTT tasks, read by the latency endpoint
+static portMUX_TYPE deliveryMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void copyField(char *dest, size_t destSize, const char *src)
+{
+    strncpy(dest, src ? src : "", destSize - 1);
+    dest[destSize - 1] = '\0';
+}
+
+// Caller holds deliveryMux
+static DeliveryRecord &claimRecord()
+{
+    DeliveryRecord &record = deliveries[nextDelivery];
+    nextDelivery = (nextDelivery + 1) % deliveryTrackerCapacity;
+    memset(&record, 0, sizeof(record));
+    record.inUse = true;
+    return record;
+}
+
+static const char *deliveryPathName(DeliveryPath path)
+{
+    switch (path)
+    {
+    case DeliveryPath::LAN:
+        return "lan";
+    case DeliveryPath::LAN_FALLBACK:
+        return "lan_fallback";
+    default:
+        return "mqtt";
+    }
+}
+
+void trackRemoteDelivery(const String &messageId, const String &topic, DeliveryPath path)
+{
+    portENTER_CRITICAL(&deliveryMux);
+    DeliveryRecord &record = claimRecord();
+    copyField(record.messageId, sizeof(record.messageId), messageId.c_str());
+    copyField(record.topic, sizeof(record.topic), topic.c_str());
+    record.path = path;
+    record.sentAt = millis();
+    portEXIT_CRITICAL(&deliveryMux);
+}
+
+void setDeliveryPath(const char *messageId, DeliveryPath path)
+{
+    portENTER_CRITICAL(&deliveryMux);
+    for (int i = 0; i < deliveryTrackerCapacity; i++)
+    {
+        DeliveryRecord &record = deliveries[i];
+        if (record.inUse && !record.acked && strcmp(record.messageId, messageId) == 0)
+        {
+            record.path = path;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&deliveryMux);
+}
+
+bool recordDeliveryAck(const char *messageId, const char *printerId, const char *status,
+                       unsigned long printStartMs, unsigned long printDoneMs)
+{
+    if (!messageId || messageId[0] == '\0')
+    {
+        return false;
+    }
+
+    unsigned long now = millis();
+    bool found = false;
+
+    portENTER_CRITICAL(&deliveryMux);
+
+    DeliveryRecord *pending = nullptr;
+    DeliveryRecord *original = nullptr;
+    for (int i = 0; i < deliveryTrackerCapacity; i++)
+    {
+        DeliveryRecord &record = deliveries[i];
+        if (record.inUse && strcmp(record.messageId, messageId) == 0)
+        {
+            original = &record;
+            if (!record.acked)
+            {
+                pending = &record;
+                break;
+            }
+        }
+    }
+
+    if (original)
+    {
+        // Further acks for a group/broadcast message get their own record
+        if (!pending)
+        {
+            DeliveryRecord copy = *original;
+            pending = &claimRecord();
+            copyField(pending->messageId, sizeof(pending->messageId), copy.messageId);
+            copyField(pending->topic, sizeof(pending->topic), copy.topic);
+            pending->path = copy.path;
+            pending->sentAt = copy.sentAt;
+        }
+
+        pending->acked = true;
+        pending->roundTripMs = now - pending->sentAt;
+        pending->printStartMs = printStartMs;
+        pending->printDoneMs = printDoneMs;
+        copyField(pending->printerId, sizeof(pending->printerId), printerId);
+        copyField(pending->status, sizeof(pending->status), status);
+        found = true;
+    }
+
+    portEXIT_CRITICAL(&deliveryMux);
+    return found;
+}
+
+int countPendingDeliveries(const char *topic)
+{
+    unsigned long now = millis();
+    int count = 0;
+
+    portENTER_CRITICAL(&deliveryMux);
+    for (int i = 0; i < deliveryTrackerCapacity; i++)
+    {
+        const DeliveryRecord &record = deliveries[i];
+        if (record.inUse && !record.acked && now - record.sentAt <= deliveryAckTimeoutMs &&
+            strcmp(record.topic, topic) == 0)
+        {
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&deliveryMux);
+    return count;
+}
+
+// Per-path totals for comparing LAN and broker latency
+static const int deliveryPathCount = (int)DeliveryPath::LAN_FALLBACK + 1;
+
+// Offsets come from another device - clamp so bad data can't underflow
+static unsigned long networkMsOf(const DeliveryRecord &record)
+{
+    return record.roundTripMs > record.printDoneMs ? record.roundTripMs - record.printDoneMs : 0;
+}
+
+DeliveryLatencyReport::DeliveryLatencyReport()
+{
+    // Snapshot under the lock, write JSON outside it
+    jobs.reserve(deliveryTrackerCapacity);
+
+    portENTER_CRITICAL(&deliveryMux);
+    for (int i = 0; i < deliveryTrackerCapacity; i++)
+    {
+        // Newest first
+        int index = (nextDelivery - 1 - i + deliveryTrackerCapacity) % deliveryTrackerCapacity;
+        if (deliveries[index].inUse)
+        {
+            jobs.push_back(deliveries[index]);
+        }
+    }
+    portEXIT_CRITICAL(&deliveryMux);
+
+    now = millis();
+}
+
+DeliveryLatencyReport::~DeliveryLatencyReport() = default;
+
+bool DeliveryLatencyReport::writeStep(JsonStreamWriter &json, int step)
+{
+    int jobCount = (int)jobs.size();
+    if (step > jobCount)
+    {
+        return false;
+    }
+
+    if (step == 0)
+    {
+        json.beginArray("jobs");
+    }
+    if (step < jobCount)
+    {
+        writeJob(json, jobs[step]);
+        return true;
+    }
+
+    json.endArray();
+    writeSummary(json);
+    return true;
+}
+
+void DeliveryLatencyReport::writeJob(JsonStreamWriter &json, const DeliveryRecord &record)
+{
+    json.beginObject();
+    json.field("id", record.messageId);
+    json.field("topic", record.topic);
+    json.field("path", deliveryPathName(record.path));
+    json.field("age_ms", now - record.sentAt);
+
+    if (record.acked)
+    {
+        json.field("status", record.status);
+        json.field("printer_id", record.printerId);
+        json.field("round_trip_ms", record.roundTripMs);
+        json.field("print_start_ms", record.printStartMs);
+        json.field("print_done_ms", record.printDoneMs);
+        json.field("network_ms", networkMsOf(record));
+    }
+    else if (now - record.sentAt > deliveryAckTimeoutMs)
+    {
+        json.field("status", "timeout");
+    }
+    else
+    {
+        json.field("status", "pending");
+    }
+    json.endObject();
+}
+
+void DeliveryLatencyReport::writeSummary(JsonStreamWriter &json)
+{
+    int acked = 0;
+    int pending = 0;
+    int timedOut = 0;
+    unsigned long totalRoundTrip = 0;
+    unsigned long maxRoundTrip = 0;
+    unsigned long totalNetwork = 0;
+
+    int pathAcked[deliveryPathCount] = {0};
+    unsigned long pathRoundTrip[deliveryPathCount] = {0};
+    unsigned long pathNetwork[deliveryPathCount] = {0};
+
+    for (const DeliveryRecord &record : jobs)
+    {
+        if (record.acked)
+        {
+            unsigned long networkMs = networkMsOf(record);
+            acked++;
+            totalRoundTrip += record.roundTripMs;
+            totalNetwork += networkMs;
+            if (record.roundTripMs > maxRoundTrip)
+            {
+                maxRoundTrip = record.roundTripMs;
+            }
+
+            int path = (int)record.path;
+            pathAcked[path]++;
+            pathRoundTrip[path] += record.roundTripMs;
+            pathNetwork[path] += networkMs;
+        }
+        else if (now - record.sentAt > deliveryAckTimeoutMs)
+        {
+            timedOut++;
+        }
+        else
+        {
+            pending++;
+        }
+    }
+
+    json.beginObject("summary");
+    json.field("acked", acked);
+    json.field("pending", pending);
+    json.field("timed_out", timedOut);
+    json.field("avg_round_trip_ms", acked ? totalRoundTrip / acked : 0UL);
+    json.field("max_round_trip_ms", maxRoundTrip);
+    json.field("avg_network_ms", acked ? totalNetwork / acked : 0UL);
+    json.endObject();
+
+    json.beginObject("paths");
+    for (int path = 0; path < deliveryPathCount; path++)
+    {
+        json.beginObject(deliveryPathName((DeliveryPath)path));
+        json.field("acked", pathAcked[path]);
+        json.field("avg_round_trip_ms", pathAcked[path] ? pathRoundTrip[path] / pathAcked[path] : 0UL);
+        json.field("avg_network_ms", pathAcked[path] ? pathNetwork[path] / pathAcked[path] : 0UL);
+        json.endObject();
+    }
+    json.endObject();
+}
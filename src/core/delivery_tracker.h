@@ -0,0 +1,106 @@
+/**
+ * @file delivery_tracker.h
+ * @brief Tracks remote print jobs and their delivery acknowledgements
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * A remote print that asks for an ack is recorded here when published. The
+ * receiving printer replies with print-start/print-done offsets measured on its
+ * own clock, so latency figures never depend on clocks being in sync:
+ *
+ *   round trip = ack arrival - publish time (sender clock)
+ *   network    = round trip - print done offset (broker hops both ways)
+ *
+ * Jobs sent directly over the LAN are acked by the peer's HTTP 202 instead,
+ * so their round trip is all network. Each job records the path it took and
+ * the summary is broken down per path for comparison.
+ *
+ * The last deliveryTrackerCapacity jobs are kept in a ring.
+ */
+
+#ifndef DELIVERY_TRACKER_H
+#define DELIVERY_TRACKER_H
+
+#include <Arduino.h>
+#include <utils/json_stream_writer.h>
+#include <vector>
+
+/**
+ * @brief Route a remote print took to reach the printer
+ */
+enum class DeliveryPath : uint8_t
+{
+    MQTT,        // Published to the broker
+    LAN,         // Direct HTTP to the peer
+    LAN_FALLBACK // LAN attempt failed, then published to the broker
+};
+
+/**
+ * @brief Record a published remote print awaiting acknowledgement
+ * @param messageId ID sent with the message
+ * @param topic Topic the message was published to
+ * @param path Route the message was sent on
+ */
+void trackRemoteDelivery(const String &messageId, const String &topic, DeliveryPath path = DeliveryPath::MQTT);
+
+/**
+ * @brief Change the route of a tracked job that has not been acked yet
+ * @param messageId ID of the tracked job
+ * @param path New route (e.g. LAN_FALLBACK once the LAN attempt has failed)
+ */
+void setDeliveryPath(const char *messageId, DeliveryPath path);
+
+/**
+ * @brief Record an acknowledgement for a tracked job
+ * @param messageId ID from the ack
+ * @param printerId Printer that sent the ack
+ * @param status Receiver status ("printed" or "duplicate")
+ * @param printStartMs Receive-to-print-start offset on the receiver
+ * @param printDoneMs Receive-to-print-done offset on the receiver
+ * @return false if the ID is not tracked (expired from the ring or not ours)
+ *
+ * Group and broadcast topics produce one ack per printer; each extra ack is
+ * recorded as its own job with the original publish time.
+ */
+bool recordDeliveryAck(const char *messageId, const char *printerId, const char *status,
+                       unsigned long printStartMs, unsigned long printDoneMs);
+
+/**
+ * @brief Count jobs sent to a topic that are still waiting for an ack
+ * @param topic Topic the jobs were sent to
+ * @return Unacked jobs younger than deliveryAckTimeoutMs
+ */
+int countPendingDeliveries(const char *topic);
+
+struct DeliveryRecord;
+
+/**
+ * @brief Recent jobs and a latency summary, written a job per step
+ *
+ * The jobs are copied out of the ring when the report is made, so every step
+ * and the summary describe the same moment. Steps fit beginJsonStreamResponse:
+ * a job each under "jobs", then "summary" and the per-path "paths".
+ */
+class DeliveryLatencyReport
+{
+public:
+    DeliveryLatencyReport();
+    ~DeliveryLatencyReport();
+
+    /**
+     * @brief Write step number `step` (from 0) inside the caller's open object
+     * @return false once there are no more steps; nothing is written then
+     */
+    bool writeStep(JsonStreamWriter &json, int step);
+
+private:
+    void writeJob(JsonStreamWriter &json, const DeliveryRecord &record);
+    void writeSummary(JsonStreamWriter &json);
+
+    std::vector<DeliveryRecord> jobs; // Newest first
+    unsigned long now;
+};
+
+#endif // DELIVERY_TRACKER_H
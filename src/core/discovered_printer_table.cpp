@@ -0,0 +1,213 @@
+/**
+ * @file discovered_printer_table.cpp
+ * @brief Implementation of the fixed-capacity discovered printer table
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "discovered_printer_table.h"
+
+bool copyPrinterField(char *dest, size_t destSize, const char *src)
+{
+    if (!src)
+    {
+        src = "";
+    }
+
+    size_t length = strlen(src);
+    if (length >= destSize)
+    {
+        length = destSize - 1;
+        // Don't leave half a UTF-8 sequence at the end
+        while (length > 0 && ((unsigned char)src[length] & 0xC0) == 0x80)
+        {
+            length--;
+        }
+    }
+
+    if (strncmp(dest, src, length) == 0 && dest[length] == '\0')
+    {
+        return false; // Unchanged (also covers src == dest)
+    }
+
+    memmove(dest, src, length);
+    dest[length] = '\0';
+    return true;
+}
+
+DiscoveredPrinterTable::DiscoveredPrinterTable()
+    : version(0)
+{
+    clear();
+}
+
+void DiscoveredPrinterTable::clear()
+{
+    memset(index, -1, sizeof(index));
+    count = 0;
+    evictions = 0;
+    tombstoneCount = 0;
+    tombstoneNext = 0;
+    tombstoneFloor = ++version; // Removals aren't recorded, so force a full snapshot
+}
+
+void DiscoveredPrinterTable::markChanged(DiscoveredPrinter *printer)
+{
+    printer->version = ++version;
+}
+
+// 32-bit FNV-1a
+uint32_t DiscoveredPrinterTable::hashId(const char *printerId)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *p = printerId; *p; p++)
+    {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Slot holding printerId, or -1
+int DiscoveredPrinterTable::findSlot(const char *printerId) const
+{
+    int slot = hashId(printerId) & (indexSize - 1);
+    while (index[slot] >= 0)
+    {
+        if (strcmp(entries[index[slot]].printerId, printerId) == 0)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & (indexSize - 1);
+    }
+    return -1;
+}
+
+DiscoveredPrinter *DiscoveredPrinterTable::find(const char *printerId)
+{
+    int slot = findSlot(printerId);
+    return slot >= 0 ? &entries[index[slot]] : nullptr;
+}
+
+const DiscoveredPrinter *DiscoveredPrinterTable::find(const char *printerId) const
+{
+    int slot = findSlot(printerId);
+    return slot >= 0 ? &entries[index[slot]] : nullptr;
+}
+
+DiscoveredPrinter *DiscoveredPrinterTable::findOrAdd(const char *printerId, unsigned long now, bool &added)
+{
+    added = false;
+    if (!printerId || printerId[0] == '\0' || strlen(printerId) >= sizeof(entries[0].printerId))
+    {
+        return nullptr;
+    }
+
+    DiscoveredPrinter *existing = find(printerId);
+    if (existing)
+    {
+        return existing;
+    }
+
+    if (count >= maxOtherPrinters)
+    {
+        // Evict the least recently seen printer
+        int oldest = 0;
+        for (int i = 1; i < count; i++)
+        {
+            if ((long)(entries[i].lastSeen - entries[oldest].lastSeen) < 0)
+            {
+                oldest = i;
+            }
+        }
+        removeAt(oldest);
+        evictions++;
+    }
+
+    int position = count++;
+    DiscoveredPrinter &printer = entries[position];
+    memset(&printer, 0, sizeof(printer));
+    copyPrinterField(printer.printerId, printerId);
+    printer.lastSeen = now;
+    markChanged(&printer);
+
+    int slot = hashId(printerId) & (indexSize - 1);
+    while (index[slot] >= 0)
+    {
+        slot = (slot + 1) & (indexSize - 1);
+    }
+    index[slot] = position;
+
+    added = true;
+    return &printer;
+}
+
+bool DiscoveredPrinterTable::remove(const char *printerId)
+{
+    int slot = findSlot(printerId);
+    if (slot < 0)
+    {
+        return false;
+    }
+    removeAt(index[slot]);
+    return true;
+}
+
+void DiscoveredPrinterTable::removeAt(int position)
+{
+    // Clear the index slot, shifting later entries of the probe chain back
+    int hole = findSlot(entries[position].printerId);
+    int next = (hole + 1) & (indexSize - 1);
+    while (index[next] >= 0)
+    {
+        int home = hashId(entries[index[next]].printerId) & (indexSize - 1);
+        // Move back unless the entry's home lies cyclically in (hole, next]
+        bool homeAfterHole = ((next - home) & (indexSize - 1)) < ((next - hole) & (indexSize - 1));
+        if (!homeAfterHole)
+        {
+            index[hole] = index[next];
+            hole = next;
+        }
+        next = (next + 1) & (indexSize - 1);
+    }
+    index[hole] = -1;
+
+    // Leave a tombstone; overwriting the oldest one means older deltas are no longer exact
+    DiscoveredPrinterTombstone &tombstone = tombstones[tombstoneNext];
+    if (tombstoneCount == maxOtherPrinters)
+    {
+        tombstoneFloor = tombstone.version;
+    }
+    else
+    {
+        tombstoneCount++;
+    }
+    memcpy(tombstone.printerId, entries[position].printerId, sizeof(tombstone.printerId));
+    tombstone.version = ++version;
+    tombstoneNext = (tombstoneNext + 1) % maxOtherPrinters;
+
+    // Keep entries dense - move the last entry into the gap
+    int last = count - 1;
+    if (position != last)
+    {
+        entries[position] = entries[last];
+        index[findSlot(entries[position].printerId)] = position;
+    }
+    count--;
+}
+
+int DiscoveredPrinterTable::expire(unsigned long now, unsigned long ttlMs)
+{
+    int removed = 0;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        if (now - entries[i].lastSeen > ttlMs)
+        {
+            removeAt(i);
+            removed++;
+        }
+    }
+    return removed;
+}
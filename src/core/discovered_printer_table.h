@@ -0,0 +1,146 @@
+/**
+ * @file discovered_printer_table.h
+ * @brief Fixed-capacity table of printers seen via discovery
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Holds at most maxOtherPrinters entries in a dense array, indexed by an
+ * open-addressing hash of the printer ID. When full, the least recently seen
+ * printer is evicted; entries not heard from within a TTL are expired.
+ * The table has no lock of its own; printer_discovery.h guards the shared
+ * one. The main loop reads it in place, and other tasks work on a heap copy
+ * taken under that lock (copyDiscoveredPrinters()), so the lock is held only
+ * for a plain struct copy of the whole table.
+ *
+ * Every visible change stamps the entry with a new table version, and
+ * removals leave a tombstone, so callers can send only what changed since a
+ * version they have already published.
+ */
+
+#ifndef DISCOVERED_PRINTER_TABLE_H
+#define DISCOVERED_PRINTER_TABLE_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include "shared_types.h"
+
+/**
+ * @brief Copy a string into a fixed-size printer field, truncating on a UTF-8 boundary
+ * @param dest Destination buffer
+ * @param destSize Size of dest in bytes (including terminator)
+ * @param src Source string (nullptr treated as empty)
+ * @return true if the field's value changed
+ */
+bool copyPrinterField(char *dest, size_t destSize, const char *src);
+
+template <size_t N>
+inline bool copyPrinterField(char (&dest)[N], const char *src)
+{
+    return copyPrinterField(dest, N, src);
+}
+
+/**
+ * @brief Record of a removed printer, kept so deltas can report the removal
+ */
+struct DiscoveredPrinterTombstone
+{
+    char printerId[sizeof(DiscoveredPrinter::printerId)];
+    uint32_t version;
+};
+
+class DiscoveredPrinterTable
+{
+public:
+    DiscoveredPrinterTable();
+
+    /**
+     * @brief Find a printer by ID
+     * @return Entry, or nullptr if not present
+     */
+    DiscoveredPrinter *find(const char *printerId);
+    const DiscoveredPrinter *find(const char *printerId) const;
+
+    /**
+     * @brief Find a printer, adding an empty entry if it is not present
+     * @param printerId Printer ID (max sizeof(DiscoveredPrinter::printerId) - 1 chars)
+     * @param now Current millis(), stored as lastSeen on new entries
+     * @param added Set to true if a new entry was created
+     * @return Entry, or nullptr if the ID is invalid
+     *
+     * When the table is full, the least recently seen printer is evicted.
+     * New entries are stamped with a new version.
+     */
+    DiscoveredPrinter *findOrAdd(const char *printerId, unsigned long now, bool &added);
+
+    /**
+     * @brief Stamp an entry with a new version after a visible change
+     */
+    void markChanged(DiscoveredPrinter *printer);
+
+    /**
+     * @brief Remove a printer by ID
+     * @return true if an entry was removed
+     */
+    bool remove(const char *printerId);
+
+    /**
+     * @brief Remove printers whose lastSeen is older than ttlMs
+     * @return Number of entries removed
+     */
+    int expire(unsigned long now, unsigned long ttlMs);
+
+    /**
+     * @brief Remove everything; deltas from earlier versions are no longer possible
+     */
+    void clear();
+
+    /**
+     * @brief Version of the most recent change (monotonic, never reset)
+     */
+    uint32_t getVersion() const { return version; }
+
+    /**
+     * @brief Whether every change after sinceVersion can still be listed
+     * @return false if tombstones newer than sinceVersion have been overwritten
+     */
+    bool canDeltaFrom(uint32_t sinceVersion) const { return sinceVersion >= tombstoneFloor && sinceVersion <= version; }
+
+    int getTombstoneCount() const { return tombstoneCount; }
+    const DiscoveredPrinterTombstone &getTombstone(int index) const { return tombstones[index]; }
+
+    int size() const { return count; }
+    int capacity() const { return maxOtherPrinters; }
+    unsigned long getEvictionCount() const { return evictions; }
+
+    /**
+     * @brief Read-only access in no particular order (indices shift on removal)
+     */
+    const DiscoveredPrinter &operator[](int index) const { return entries[index]; }
+    const DiscoveredPrinter *begin() const { return entries; }
+    const DiscoveredPrinter *end() const { return entries + count; }
+
+private:
+    // Index slots hold entry positions; at least 2x capacity keeps probe chains short
+    static const int indexSize = 32;
+    static_assert((indexSize & (indexSize - 1)) == 0, "indexSize must be a power of two");
+    static_assert(indexSize >= maxOtherPrinters * 2, "indexSize must be at least twice maxOtherPrinters");
+
+    DiscoveredPrinter entries[maxOtherPrinters];
+    int8_t index[indexSize];
+    int count;
+    unsigned long evictions;
+
+    uint32_t version;
+    uint32_t tombstoneFloor; // Deltas are exact only from this version onwards
+    DiscoveredPrinterTombstone tombstones[maxOtherPrinters];
+    int tombstoneCount;
+    int tombstoneNext;
+
+    static uint32_t hashId(const char *printerId);
+    int findSlot(const char *printerId) const;
+    void removeAt(int position);
+};
+
+#endif // DISCOVERED_PRINTER_TABLE_H
@@ -0,0 +1,53 @@
+/**
+ * @file fleet_balancer.cpp
+ * @brief Implementation of group print load balancing
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "fleet_balancer.h"
+
+int pickLeastLoadedPrinter(const FleetCandidate *candidates, int count)
+{
+    int best = -1;
+    int bestLoad = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int load = candidates[i].queueDepth + candidates[i].pendingJobs;
+        if (best < 0 || load < bestLoad ||
+            (load == bestLoad && strcmp(candidates[i].printerId, candidates[best].printerId) < 0))
+        {
+            best = i;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+bool isInGroupList(const char *groupList, const char *group)
+{
+    if (!groupList || !group || group[0] == '\0')
+    {
+        return false;
+    }
+
+    size_t groupLength = strlen(group);
+    const char *start = groupList;
+    while (*start)
+    {
+        const char *end = strchr(start, ',');
+        size_t length = end ? (size_t)(end - start) : strlen(start);
+        if (length == groupLength && strncmp(start, group, length) == 0)
+        {
+            return true;
+        }
+        if (!end)
+        {
+            break;
+        }
+        start = end + 1;
+    }
+    return false;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file fleet_balancer.h
+ * @brief Pick the least busy printer in a group for a balanced print
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * A printer's load is the queue depth it last advertised in its discovery
+ * status plus the jobs this sender has handed it that are still awaiting an
+ * ack. The advertised depth can be a few seconds old; the pending count is
+ * what spreads a burst of jobs while the status catches up. Equal loads go to
+ * the lowest printer ID so every sender makes the same choice.
+ */
+
+#ifndef FLEET_BALANCER_H
+#define FLEET_BALANCER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief One online printer that could take a group print
+ */
+struct FleetCandidate
+{
+    const char *printerId;
+    int queueDepth;  // Advertised in the printer's status
+    int pendingJobs; // Sent by us, not yet acked
+};
+
+/**
+ * @brief Choose the least loaded candidate
+ * @param candidates Online group members
+ * @param count Number of candidates
+ * @return Index of the chosen candidate, or -1 if count is 0
+ */
+int pickLeastLoadedPrinter(const FleetCandidate *candidates, int count);
+
+/**
+ * @brief Check a comma-separated group list for a group name
+ * @param groupList Groups as advertised in a status ("kitchen,office")
+ * @param group Group name to look for (exact match)
+ */
+bool isInGroupList(const char *groupList, const char *group);
+
+#endif // FLEET_BALANCER_H
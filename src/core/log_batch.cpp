@@ -0,0 +1,104 @@
+/**
+ * @file log_batch.cpp
+ * @brief Implementation of log record batching and retry policy
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_batch.h"
+
+// Room kept free so a batch is sent before typical entries stop fitting
+static const size_t nearlyFullBytes = betterStackBatchMaxBytes - logMessageMaxLength * 2;
+
+LogBatch::LogBatch() : closed(false), count(0), oldestAt(0), failures(0), retryAt(0), sent(0), dropped(0)
+{
+    clear();
+}
+
+void LogBatch::clear()
+{
+    buffer = "[";
+    closed = false;
+    count = 0;
+    failures = 0;
+}
+
+bool LogBatch::add(const char *entryJson, size_t length, unsigned long now)
+{
+    if (closed)
+    {
+        buffer.remove(buffer.length() - 1); // Reopen after a failed send
+        closed = false;
+    }
+
+    // Separator plus the closing bracket must still fit
+    if (count >= betterStackBatchMaxRecords || buffer.length() + length + 2 > betterStackBatchMaxBytes)
+    {
+        dropped++;
+        return false;
+    }
+
+    if (buffer.length() == 1)
+    {
+        buffer.reserve(betterStackBatchMaxBytes); // One allocation for the life of the batch buffer
+    }
+    if (count > 0)
+    {
+        buffer += ',';
+    }
+    else
+    {
+        oldestAt = now;
+    }
+    buffer.concat(entryJson, length);
+    count++;
+    return true;
+}
+
+bool LogBatch::isDue(unsigned long now) const
+{
+    if (count == 0)
+    {
+        return false;
+    }
+    if (failures > 0 && (long)(now - retryAt) < 0)
+    {
+        return false;
+    }
+    return count >= betterStackBatchMaxRecords ||
+           buffer.length() >= nearlyFullBytes ||
+           now - oldestAt >= betterStackFlushIntervalMs ||
+           failures > 0;
+}
+
+const String &LogBatch::getPayload()
+{
+    if (!closed)
+    {
+        buffer += ']';
+        closed = true;
+    }
+    return buffer;
+}
+
+void LogBatch::onSent()
+{
+    sent += count;
+    clear();
+}
+
+void LogBatch::onSendFailed(unsigned long now)
+{
+    failures++;
+    if (failures >= betterStackMaxAttempts)
+    {
+        dropped += count;
+        clear();
+        return;
+    }
+
+    unsigned long backoffMs = betterStackRetryBaseMs << (failures - 1);
+    retryAt = now + (backoffMs < betterStackRetryMaxMs ? backoffMs : betterStackRetryMaxMs);
+}
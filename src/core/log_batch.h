@@ -0,0 +1,72 @@
+/**
+ * @file log_batch.h
+ * @brief Batching and retry policy for shipping log records over HTTP
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Collects JSON log entries into one JSON array payload. A batch is due once
+ * it holds betterStackBatchMaxRecords entries, is nearly out of buffer, or its
+ * oldest entry has waited betterStackFlushIntervalMs. A failed send keeps the
+ * batch and backs off exponentially; after betterStackMaxAttempts failures
+ * the batch is dropped. Entries that arrive while the buffer is full are
+ * dropped too, so a dead endpoint costs a fixed amount of memory.
+ */
+
+#ifndef LOG_BATCH_H
+#define LOG_BATCH_H
+
+#include <Arduino.h>
+#include <config/config.h>
+
+class LogBatch
+{
+public:
+    LogBatch();
+
+    /**
+     * @brief Append one JSON object to the batch
+     * @return false if it didn't fit (counted as dropped)
+     */
+    bool add(const char *entryJson, size_t length, unsigned long now);
+
+    /**
+     * @brief Whether the batch should be sent now (false while backing off)
+     */
+    bool isDue(unsigned long now) const;
+
+    /**
+     * @brief The batch as a JSON array
+     */
+    const String &getPayload();
+
+    /**
+     * @brief Batch was delivered - start a new one
+     */
+    void onSent();
+
+    /**
+     * @brief Send failed - back off, or drop the batch after too many attempts
+     */
+    void onSendFailed(unsigned long now);
+
+    int getCount() const { return count; }
+    int getFailures() const { return failures; }
+    uint32_t getSentCount() const { return sent; }
+    uint32_t getDroppedCount() const { return dropped; }
+
+private:
+    void clear();
+
+    String buffer; // "[" + entries joined by "," (+ "]" while closed)
+    bool closed;
+    int count;
+    unsigned long oldestAt;
+    int failures;
+    unsigned long retryAt;
+    uint32_t sent;
+    uint32_t dropped;
+};
+
+#endif // LOG_BATCH_H
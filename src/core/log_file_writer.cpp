@@ -0,0 +1,220 @@
+/**
+ * @file log_file_writer.cpp
+ * @brief Implementation of the buffered, segmented log file writer
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_file_writer.h"
+
+struct LogFileIndex
+{
+    char magic[4];
+    uint32_t sequence;
+    uint32_t active;
+};
+
+static const char logFileIndexMagic[4] = {'S', 'L', 'I', '1'};
+
+LogFileWriter::LogFileWriter(fs::FS &fs, const char *baseName, int segmentCount, size_t segmentBytes)
+    : fs(fs), baseName(baseName), segmentCount(segmentCount), segmentBytes(segmentBytes),
+      buffer(nullptr), buffered(0), segmentSize(0), active(0), sequence(0), firstBufferedAt(0), flashWrites(0)
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    end();
+}
+
+String LogFileWriter::getSegmentName(int segment) const
+{
+    return baseName + "." + String(segment);
+}
+
+bool LogFileWriter::begin()
+{
+    if (buffer)
+    {
+        return true;
+    }
+
+    // Single file and .old backup from before segments existed
+    for (const String &legacy : {baseName, baseName + ".old"})
+    {
+        if (fs.exists(legacy.c_str()))
+        {
+            fs.remove(legacy.c_str());
+        }
+    }
+
+    loadIndex();
+    openSegment(false);
+    if (!file)
+    {
+        return false;
+    }
+
+    buffer = (uint8_t *)malloc(logFileBufferBytes);
+    if (!buffer)
+    {
+        file.close();
+        return false;
+    }
+    buffered = 0;
+
+    if (segmentSize >= segmentBytes)
+    {
+        rotate();
+    }
+    return true;
+}
+
+void LogFileWriter::end()
+{
+    if (!buffer)
+    {
+        return;
+    }
+    flush();
+    file.close();
+    free(buffer);
+    buffer = nullptr;
+}
+
+bool LogFileWriter::prepare(size_t length)
+{
+    if (!buffer)
+    {
+        return false;
+    }
+
+    size_t used = segmentSize + buffered;
+    if (used > 0 && used + length > segmentBytes)
+    {
+        rotate();
+        used = 0;
+    }
+    return used == 0;
+}
+
+void LogFileWriter::write(const uint8_t *data, size_t length, unsigned long now)
+{
+    if (!buffer || length == 0)
+    {
+        return;
+    }
+
+    if (buffered == 0)
+    {
+        firstBufferedAt = now;
+    }
+
+    while (length > 0)
+    {
+        // Fill up to the next block boundary of the file, then write it out
+        size_t toBoundary = logFileBufferBytes - (segmentSize % logFileBufferBytes);
+        size_t chunk = min(length, toBoundary - buffered);
+        memcpy(buffer + buffered, data, chunk);
+        buffered += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if (buffered == toBoundary)
+        {
+            flush();
+            if (length > 0)
+            {
+                firstBufferedAt = now;
+            }
+        }
+    }
+}
+
+void LogFileWriter::flush()
+{
+    if (!buffer || buffered == 0)
+    {
+        return;
+    }
+
+    file.write(buffer, buffered);
+    file.flush();
+    segmentSize += buffered;
+    buffered = 0;
+    flashWrites++;
+}
+
+bool LogFileWriter::isFlushDue(unsigned long now) const
+{
+    return buffered > 0 && now - firstBufferedAt >= (unsigned long)logFileFlushIntervalMs;
+}
+
+void LogFileWriter::rotate()
+{
+    if (!buffer)
+    {
+        return;
+    }
+
+    flush();
+    file.close();
+    active = (active + 1) % segmentCount;
+    sequence++;
+    openSegment(true);
+    saveIndex();
+}
+
+void LogFileWriter::openSegment(bool truncate)
+{
+    String name = getSegmentName(active);
+    file = fs.open(name.c_str(), truncate ? "w" : "a");
+    segmentSize = file ? file.size() : 0;
+}
+
+void LogFileWriter::loadIndex()
+{
+    active = 0;
+    sequence = 0;
+
+    String name = baseName + ".idx";
+    if (!fs.exists(name.c_str()))
+    {
+        return;
+    }
+    fs::File indexFile = fs.open(name.c_str(), "r");
+    if (!indexFile)
+    {
+        return;
+    }
+
+    LogFileIndex index;
+    bool valid = indexFile.read((uint8_t *)&index, sizeof(index)) == sizeof(index) &&
+                 memcmp(index.magic, logFileIndexMagic, sizeof(index.magic)) == 0 &&
+                 index.active < (uint32_t)segmentCount;
+    indexFile.close();
+
+    if (valid)
+    {
+        active = index.active;
+        sequence = index.sequence;
+    }
+}
+
+void LogFileWriter::saveIndex()
+{
+    LogFileIndex index;
+    memcpy(index.magic, logFileIndexMagic, sizeof(index.magic));
+    index.sequence = sequence;
+    index.active = active;
+
+    String name = baseName + ".idx";
+    fs::File indexFile = fs.open(name.c_str(), "w");
+    if (indexFile)
+    {
+        indexFile.write((const uint8_t *)&index, sizeof(index));
+        indexFile.close();
+    }
+}
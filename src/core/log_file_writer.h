@@ -0,0 +1,99 @@
+/**
+ * @file log_file_writer.h
+ * @brief Buffered, segmented log file writer for LittleFS
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Keeps the active log file open and collects lines in a one-block RAM
+ * buffer. A full buffer is written out so the file ends on a LittleFS block
+ * boundary, which lets LittleFS program whole blocks instead of copying a
+ * partly-filled last block on every append. The owner flushes earlier on
+ * time or severity (see logging.cpp).
+ *
+ * Logs rotate through a fixed ring of segments, baseName.0 .. baseName.N-1.
+ * Starting a segment truncates it, so the oldest segment is reused rather
+ * than deleted and recreated. A small index file, baseName.idx, records the
+ * active segment and is only rewritten on rotation.
+ *
+ * Not thread-safe: the log sink task is the only writer.
+ */
+
+#ifndef LOG_FILE_WRITER_H
+#define LOG_FILE_WRITER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <config/config.h>
+
+class LogFileWriter
+{
+public:
+    LogFileWriter(fs::FS &fs, const char *baseName,
+                  int segmentCount = logFileSegmentCount, size_t segmentBytes = logFileSegmentBytes);
+    ~LogFileWriter();
+
+    /**
+     * @brief Allocate the buffer and reopen the active segment from the index
+     * @return false if the segment couldn't be opened (writes are then ignored)
+     */
+    bool begin();
+
+    /**
+     * @brief Write out buffered bytes, close the file and free the buffer
+     */
+    void end();
+
+    bool isOpen() const { return buffer != nullptr; }
+
+    /**
+     * @brief Make room for length bytes, starting the next segment if they won't fit
+     * @return true if the active segment is empty - write any per-file header first
+     */
+    bool prepare(size_t length);
+
+    void write(const uint8_t *data, size_t length, unsigned long now);
+
+    /**
+     * @brief Write buffered bytes to the file now
+     */
+    void flush();
+
+    /**
+     * @brief Whether buffered bytes have waited logFileFlushIntervalMs
+     */
+    bool isFlushDue(unsigned long now) const;
+
+    /**
+     * @brief Start the next segment, discarding its old contents
+     */
+    void rotate();
+
+    int getActiveSegment() const { return active; }
+    uint32_t getSequence() const { return sequence; }
+    size_t getBufferedBytes() const { return buffered; }
+    uint32_t getFlashWrites() const { return flashWrites; }
+    String getSegmentName(int segment) const;
+
+private:
+    void openSegment(bool truncate);
+    void loadIndex();
+    void saveIndex();
+
+    fs::FS &fs;
+    String baseName;
+    const int segmentCount;
+    const size_t segmentBytes;
+
+    fs::File file;
+    uint8_t *buffer;
+    size_t buffered;
+    size_t segmentSize; // Bytes already in the file
+    int active;
+    uint32_t sequence; // Segments started since the index was created
+    unsigned long firstBufferedAt;
+    uint32_t flashWrites;
+};
+
+#endif // LOG_FILE_WRITER_H
@@ -0,0 +1,122 @@
+/**
+ * @file log_history.cpp
+ * @brief Implementation of the in-RAM log history
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_history.h"
+
+static const uint32_t historyMask = logHistoryBytes - 1;
+
+LogHistory::LogHistory()
+    : firstPosition(0), writePosition(0), firstSequence(0), nextSequence(0)
+{
+}
+
+void LogHistory::copyIn(uint32_t position, const void *data, size_t length)
+{
+    // Records may wrap past the end of the buffer
+    size_t offset = position & historyMask;
+    size_t first = min(length, (size_t)logHistoryBytes - offset);
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, (const uint8_t *)data + first, length - first);
+}
+
+void LogHistory::copyOut(uint32_t position, void *data, size_t length) const
+{
+    size_t offset = position & historyMask;
+    size_t first = min(length, (size_t)logHistoryBytes - offset);
+    memcpy(data, buffer + offset, first);
+    memcpy((uint8_t *)data + first, buffer, length - first);
+}
+
+uint32_t LogHistory::sizeAt(uint32_t position) const
+{
+    uint32_t control;
+    copyOut(position, &control, sizeof(control));
+    return control & LOG_RECORD_SIZE_MASK;
+}
+
+uint32_t LogHistory::add(const LogRecord &record)
+{
+    uint32_t size = record.control & LOG_RECORD_SIZE_MASK;
+
+    portENTER_CRITICAL(&mux);
+    while (writePosition + size - firstPosition > (uint32_t)logHistoryBytes)
+    {
+        firstPosition += sizeAt(firstPosition);
+        firstSequence++;
+    }
+    copyIn(writePosition, &record, size);
+    writePosition += size;
+    uint32_t sequence = nextSequence++;
+    portEXIT_CRITICAL(&mux);
+
+    return sequence;
+}
+
+bool LogHistory::read(LogHistoryCursor &cursor, LogRecord *out, size_t outSize) const
+{
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    if (cursor.sequence > nextSequence)
+    {
+        cursor.sequence = firstSequence;
+        cursor.positioned = false;
+    }
+    else if (cursor.sequence < firstSequence)
+    {
+        cursor.missed += firstSequence - cursor.sequence;
+        cursor.sequence = firstSequence;
+        cursor.positioned = false;
+    }
+
+    if (!cursor.positioned)
+    {
+        // Walk once from the oldest record; after that the cursor keeps its place
+        cursor.position = firstPosition;
+        for (uint32_t sequence = firstSequence; sequence < cursor.sequence; sequence++)
+        {
+            cursor.position += sizeAt(cursor.position);
+        }
+        cursor.positioned = true;
+    }
+
+    if (cursor.sequence < nextSequence)
+    {
+        uint32_t size = sizeAt(cursor.position);
+        size_t copied = size <= outSize ? size : sizeof(LogRecord);
+        copyOut(cursor.position, out, copied);
+        if (copied < size)
+        {
+            out->argLength = 0;
+            out->flags |= LOG_RECORD_TRUNCATED;
+        }
+        cursor.position += size;
+        cursor.sequence++;
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+uint32_t LogHistory::getFirstSequence() const
+{
+    portENTER_CRITICAL(&mux);
+    uint32_t sequence = firstSequence;
+    portEXIT_CRITICAL(&mux);
+    return sequence;
+}
+
+uint32_t LogHistory::getNextSequence() const
+{
+    portENTER_CRITICAL(&mux);
+    uint32_t sequence = nextSequence;
+    portEXIT_CRITICAL(&mux);
+    return sequence;
+}
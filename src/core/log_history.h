@@ -0,0 +1,79 @@
+/**
+ * @file log_history.h
+ * @brief Recent log records kept in RAM for reading back over HTTP
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * The log ring (log_ring.h) gives records back to producers as soon as the
+ * sink has written them, so the sink also copies each one here. Records are
+ * stored back to back in the same binary form and the oldest are overwritten
+ * as new ones arrive.
+ *
+ * Every record gets a sequence number, counting from 0 at boot. Readers hold
+ * a cursor - the next sequence they want - so a client following the log
+ * only reads what is new since its last request. A cursor that has fallen
+ * behind the oldest record kept moves forward and counts what it missed.
+ */
+
+#ifndef LOG_HISTORY_H
+#define LOG_HISTORY_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include "log_record.h"
+
+struct LogHistoryCursor
+{
+    explicit LogHistoryCursor(uint32_t sequence = 0)
+        : sequence(sequence), position(0), positioned(false), missed(0) {}
+
+    uint32_t sequence; // Next record wanted
+    uint32_t position; // Where that record starts, once found
+    bool positioned;
+    uint32_t missed;   // Records overwritten before this cursor reached them
+};
+
+class LogHistory
+{
+public:
+    LogHistory();
+
+    /**
+     * @brief Copy a record in, overwriting the oldest if there isn't room
+     * @return The record's sequence number
+     */
+    uint32_t add(const LogRecord &record);
+
+    /**
+     * @brief Copy out the record at the cursor and move the cursor past it
+     * @param out Room for sizeof(LogRecord) + logRecordMaxArgBytes
+     * @return false if there is no record at or after the cursor yet
+     *
+     * A cursor ahead of every record (e.g. from before a reboot) starts again
+     * from the oldest.
+     */
+    bool read(LogHistoryCursor &cursor, LogRecord *out, size_t outSize) const;
+
+    uint32_t getFirstSequence() const;
+    uint32_t getNextSequence() const;
+
+private:
+    static_assert((logHistoryBytes & (logHistoryBytes - 1)) == 0, "logHistoryBytes must be a power of 2");
+
+    void copyIn(uint32_t position, const void *data, size_t length);
+    void copyOut(uint32_t position, void *data, size_t length) const;
+    uint32_t sizeAt(uint32_t position) const;
+
+    uint8_t buffer[logHistoryBytes];
+    uint32_t firstPosition; // Positions count bytes since boot; buffer index is position % logHistoryBytes
+    uint32_t writePosition;
+    uint32_t firstSequence;
+    uint32_t nextSequence;
+
+    // Written by the sink task, read by the web server
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif // LOG_HISTORY_H
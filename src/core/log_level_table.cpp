@@ -0,0 +1,185 @@
+/**
+ * @file log_level_table.cpp
+ * @brief Implementation of runtime log level thresholds per component
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_level_table.h"
+#include <strings.h>
+
+static const uint8_t unresolvedLevel = 0xFF;
+
+static const char *const logLevelNames[] = {"SILENT", "FATAL", "ERROR", "WARNING", "NOTICE", "TRACE", "VERBOSE"};
+static const int logLevelNameCount = sizeof(logLevelNames) / sizeof(logLevelNames[0]);
+
+int parseLogLevel(const char *value)
+{
+    if (!value || !*value)
+    {
+        return -1;
+    }
+    if (isdigit((unsigned char)value[0]))
+    {
+        char *end;
+        long level = strtol(value, &end, 10);
+        return *end == '\0' && level < logLevelNameCount ? (int)level : -1;
+    }
+    for (int level = 0; level < logLevelNameCount; level++)
+    {
+        if (strcasecmp(value, logLevelNames[level]) == 0)
+        {
+            return level;
+        }
+    }
+    return -1;
+}
+
+const char *getLogLevelName(int level)
+{
+    return level >= 0 && level < logLevelNameCount ? logLevelNames[level] : "UNKNOWN";
+}
+
+// Copy text[start, end) into out without surrounding spaces; false if it won't fit
+static bool copyTrimmed(const char *start, const char *end, char *out, size_t outSize)
+{
+    while (start < end && isspace((unsigned char)*start))
+    {
+        start++;
+    }
+    while (end > start && isspace((unsigned char)end[-1]))
+    {
+        end--;
+    }
+    size_t length = end - start;
+    if (length >= outSize)
+    {
+        return false;
+    }
+    memcpy(out, start, length);
+    out[length] = '\0';
+    return true;
+}
+
+LogLevelTable::LogLevelTable()
+    : defaultLevel(logLevel), maxLevel(logLevel), overrideCount(0)
+{
+    for (std::atomic<uint8_t> &threshold : thresholds)
+    {
+        threshold.store(unresolvedLevel, std::memory_order_relaxed);
+    }
+}
+
+bool LogLevelTable::parse(const char *componentLevels, LogLevelOverride *out, int maxOut, int *count)
+{
+    int found = 0;
+    const char *p = componentLevels ? componentLevels : "";
+
+    while (*p)
+    {
+        const char *end = strchr(p, ',');
+        if (!end)
+        {
+            end = p + strlen(p);
+        }
+
+        const char *equals = (const char *)memchr(p, '=', end - p);
+        char component[logLevelComponentNameLength + 1];
+        char levelText[12];
+        if (equals)
+        {
+            if (!copyTrimmed(p, equals, component, sizeof(component)) ||
+                !copyTrimmed(equals + 1, end, levelText, sizeof(levelText)) ||
+                component[0] == '\0')
+            {
+                return false;
+            }
+
+            int level = parseLogLevel(levelText);
+            if (level < 0 || found == maxLogLevelOverrides || (out && found == maxOut))
+            {
+                return false;
+            }
+            if (out)
+            {
+                strcpy(out[found].component, component);
+                out[found].level = (uint8_t)level;
+            }
+            found++;
+        }
+        else if (!copyTrimmed(p, end, levelText, sizeof(levelText)) || levelText[0] != '\0')
+        {
+            return false; // Only empty entries ("A=1,,B=2" or a trailing comma) may lack '='
+        }
+
+        p = *end ? end + 1 : end;
+    }
+
+    if (count)
+    {
+        *count = found;
+    }
+    return true;
+}
+
+bool LogLevelTable::configure(int defaultLevel, const char *componentLevels)
+{
+    LogLevelOverride parsed[maxLogLevelOverrides];
+    int parsedCount = 0;
+    if (defaultLevel < LOG_LEVEL_SILENT || defaultLevel > LOG_LEVEL_VERBOSE ||
+        !parse(componentLevels, parsed, maxLogLevelOverrides, &parsedCount))
+    {
+        return false;
+    }
+
+    uint8_t highest = (uint8_t)defaultLevel;
+    for (int i = 0; i < parsedCount; i++)
+    {
+        highest = max(highest, parsed[i].level);
+    }
+
+    portENTER_CRITICAL(&mux);
+    memcpy(overrides, parsed, sizeof(LogLevelOverride) * parsedCount);
+    overrideCount = parsedCount;
+    this->defaultLevel.store((uint8_t)defaultLevel, std::memory_order_relaxed);
+    maxLevel.store(highest, std::memory_order_relaxed);
+    for (std::atomic<uint8_t> &threshold : thresholds)
+    {
+        threshold.store(unresolvedLevel, std::memory_order_relaxed);
+    }
+    portEXIT_CRITICAL(&mux);
+    return true;
+}
+
+uint8_t LogLevelTable::resolve(uint8_t componentId, const char *component)
+{
+    portENTER_CRITICAL(&mux);
+    uint8_t level = defaultLevel.load(std::memory_order_relaxed);
+    for (int i = 0; i < overrideCount; i++)
+    {
+        if (strcasecmp(overrides[i].component, component) == 0)
+        {
+            level = overrides[i].level; // Last one for a name wins
+        }
+    }
+    thresholds[componentId].store(level, std::memory_order_relaxed);
+    portEXIT_CRITICAL(&mux);
+    return level;
+}
+
+bool LogLevelTable::allows(uint8_t componentId, const char *component, int level)
+{
+    if (componentId >= logComponentTableSize)
+    {
+        return level <= getDefaultLevel(); // Component table full - no ID to hold a threshold
+    }
+
+    uint8_t threshold = thresholds[componentId].load(std::memory_order_relaxed);
+    if (threshold == unresolvedLevel)
+    {
+        threshold = resolve(componentId, component ? component : "");
+    }
+    return level <= threshold;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file log_level_table.h
+ * @brief Runtime log level thresholds per component
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Each component ID (log_record.h) has a one-byte threshold, so the check in
+ * structuredLog() is an array load, made before the rate limiter and before
+ * anything is encoded or formatted. Overrides are given by name, e.g.
+ * "MQTT=VERBOSE,WEB=WARNING"; components without one use the default level.
+ *
+ * Component IDs are assigned on first use, so a threshold is worked out from
+ * the overrides the first time a component logs after each configure(). The
+ * highest level anything can log at is kept too, so lines above it return
+ * before their component name is even looked up.
+ *
+ * Only calls compiled in (logCompileLevel, logComponentCompileLevels) can be
+ * turned up here - VERBOSE at runtime needs a build that kept VERBOSE calls.
+ */
+
+#ifndef LOG_LEVEL_TABLE_H
+#define LOG_LEVEL_TABLE_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include <atomic>
+
+struct LogLevelOverride
+{
+    char component[logLevelComponentNameLength + 1];
+    uint8_t level;
+};
+
+/**
+ * @brief Level from a name ("WARNING", any case) or a number ("3")
+ * @return Level, or -1 if it is neither
+ */
+int parseLogLevel(const char *value);
+
+/**
+ * @brief Name of a level ("UNKNOWN" if out of range)
+ */
+const char *getLogLevelName(int level);
+
+class LogLevelTable
+{
+public:
+    LogLevelTable();
+
+    /**
+     * @brief Parse "COMPONENT=LEVEL,..." (empty is valid - no overrides)
+     * @param out Where to put the overrides; nullptr just checks the text
+     * @return false on a malformed pair, unknown level, overlong name or too many pairs
+     */
+    static bool parse(const char *componentLevels, LogLevelOverride *out, int maxOut, int *count);
+
+    /**
+     * @brief Replace the default level and every override
+     * @return false, leaving the table unchanged, if componentLevels doesn't parse
+     */
+    bool configure(int defaultLevel, const char *componentLevels);
+
+    /**
+     * @brief Cheap first check (any task): false if no component logs at this level
+     */
+    bool mayLog(int level) const { return level <= maxLevel.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether a line at this level from this component passes (any task)
+     * @param component Name the ID was interned from, used the first time the ID is seen
+     */
+    bool allows(uint8_t componentId, const char *component, int level);
+
+    int getDefaultLevel() const { return defaultLevel.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t resolve(uint8_t componentId, const char *component);
+
+    std::atomic<uint8_t> thresholds[logComponentTableSize]; // unresolvedLevel until the ID next logs
+    std::atomic<uint8_t> defaultLevel;
+    std::atomic<uint8_t> maxLevel;
+    LogLevelOverride overrides[maxLogLevelOverrides];
+    int overrideCount;
+
+    // Held while overrides change and while an ID's threshold is worked out from them
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif // LOG_LEVEL_TABLE_H
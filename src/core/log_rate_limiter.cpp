@@ -0,0 +1,115 @@
+/**
+ * @file log_rate_limiter.cpp
+ * @brief Implementation of per-component log rate limiting
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_rate_limiter.h"
+
+static const uint16_t emptyKey = 0xFFFF;
+static const uint32_t tokenScale = 60000; // One line; a bucket gains perMinute of these a millisecond
+
+LogRateLimiter::LogRateLimiter()
+    : perMinute(0), burst(1), suppressedTotal(0)
+{
+    for (Bucket &bucket : buckets)
+    {
+        bucket.key = emptyKey;
+    }
+}
+
+void LogRateLimiter::configure(int perMinute, int burst)
+{
+    portENTER_CRITICAL(&mux);
+    this->perMinute = perMinute > 0 ? perMinute : 0;
+    this->burst = burst > 0 ? burst : 1;
+    portEXIT_CRITICAL(&mux);
+}
+
+LogRateLimiter::Bucket *LogRateLimiter::findBucket(uint16_t key)
+{
+    // Linear probing; the key mixes component and level, so spread it a little
+    const uint32_t mask = logRateLimitSlots - 1;
+    for (uint32_t i = 0, slot = (key * 37u) & mask; i < (uint32_t)logRateLimitSlots; i++, slot = (slot + 1) & mask)
+    {
+        if (buckets[slot].key == key || buckets[slot].key == emptyKey)
+        {
+            return &buckets[slot];
+        }
+    }
+    return nullptr;
+}
+
+bool LogRateLimiter::allow(uint8_t componentId, int level, unsigned long now)
+{
+    if (perMinute == 0)
+    {
+        return true;
+    }
+
+    uint16_t key = componentId * 8 + (level & 7);
+    bool allowed = true;
+
+    portENTER_CRITICAL(&mux);
+    Bucket *bucket = findBucket(key);
+    if (bucket)
+    {
+        uint32_t capacity = burst * tokenScale;
+        if (bucket->key == emptyKey)
+        {
+            bucket->key = key;
+            bucket->tokens = capacity;
+            bucket->refilledAt = now;
+            bucket->suppressed = 0;
+        }
+
+        uint64_t tokens = bucket->tokens + (uint64_t)(now - bucket->refilledAt) * perMinute;
+        bucket->tokens = tokens < capacity ? (uint32_t)tokens : capacity;
+        bucket->refilledAt = now;
+
+        if (bucket->tokens >= tokenScale)
+        {
+            bucket->tokens -= tokenScale;
+        }
+        else
+        {
+            if (bucket->suppressed == 0)
+            {
+                bucket->suppressedSince = now;
+            }
+            bucket->suppressed++;
+            suppressedTotal++;
+            allowed = false;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return allowed;
+}
+
+int LogRateLimiter::takeSuppressions(LogSuppression *out, int maxOut)
+{
+    int count = 0;
+    portENTER_CRITICAL(&mux);
+    for (Bucket &bucket : buckets)
+    {
+        if (count == maxOut)
+        {
+            break;
+        }
+        if (bucket.key != emptyKey && bucket.suppressed > 0)
+        {
+            out[count].componentId = bucket.key / 8;
+            out[count].level = bucket.key % 8;
+            out[count].count = bucket.suppressed;
+            out[count].sinceMs = bucket.suppressedSince;
+            bucket.suppressed = 0;
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+    return count;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file log_rate_limiter.h
+ * @brief Token-bucket limits on log lines per component and level
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Each component/level pair (e.g. WEB at WARNING) has its own bucket holding
+ * up to burst lines, refilled at perMinute lines a minute. A line that finds
+ * its bucket empty is counted and dropped before any encoding or formatting,
+ * so a flooding component can't swamp the sinks or the ring. The counts are
+ * collected periodically and logged as one "suppressed N messages" line per
+ * bucket. Other pairs, including the same component at another level, are
+ * unaffected.
+ *
+ * Buckets live in a small open-addressing table and are never removed; if it
+ * fills up, lines for new pairs are let through unlimited.
+ */
+
+#ifndef LOG_RATE_LIMITER_H
+#define LOG_RATE_LIMITER_H
+
+#include <Arduino.h>
+#include <config/config.h>
+
+struct LogSuppression
+{
+    uint8_t componentId;
+    uint8_t level;
+    uint32_t count;
+    unsigned long sinceMs; // When the first of them was dropped
+};
+
+class LogRateLimiter
+{
+public:
+    LogRateLimiter();
+
+    /**
+     * @brief Set the limit for every bucket (takes effect on each bucket's next line)
+     * @param perMinute Lines a minute per bucket once the burst is used; 0 turns limiting off
+     * @param burst Lines a bucket can send at once after being quiet
+     */
+    void configure(int perMinute, int burst);
+
+    /**
+     * @brief Take a token for one line (any task)
+     * @return false if the line should be dropped; it is counted for the next summary
+     */
+    bool allow(uint8_t componentId, int level, unsigned long now);
+
+    /**
+     * @brief Hand over and reset the drop counts
+     * @return Number of entries written to out; counts that don't fit wait for the next call
+     */
+    int takeSuppressions(LogSuppression *out, int maxOut);
+
+    uint32_t getSuppressedCount() const { return suppressedTotal; }
+
+private:
+    static_assert((logRateLimitSlots & (logRateLimitSlots - 1)) == 0, "logRateLimitSlots must be a power of 2");
+
+    struct Bucket
+    {
+        uint16_t key; // componentId * 8 + level; emptyKey when unused
+        uint32_t tokens; // Scaled by tokenScale
+        unsigned long refilledAt;
+        uint32_t suppressed;
+        unsigned long suppressedSince;
+    };
+
+    Bucket *findBucket(uint16_t key);
+
+    Bucket buckets[logRateLimitSlots];
+    uint32_t perMinute;
+    uint32_t burst;
+    volatile uint32_t suppressedTotal;
+
+    // Called by every logging task and by the sink
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif // LOG_RATE_LIMITER_H
@@ -0,0 +1,495 @@
+/**
+ * @file log_record.cpp
+ * @brief Implementation of binary log record encoding and formatting
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_record.h"
+
+enum class LogArgKind : uint8_t
+{
+    NONE,    // "%%"
+    INT,     // d i u x X o c, with h/hh (promoted to int)
+    LONG,    // l
+    LLONG,   // ll j
+    SIZE,    // z t
+    DOUBLE,  // f F e E g G a A
+    STRING,  // s
+    POINTER, // p
+    UNSUPPORTED
+};
+
+struct LogFormatSpec
+{
+    const char *start; // At the '%'
+    size_t length;     // Through the conversion character
+    bool widthStar;
+    bool precisionStar;
+    int precision; // -1 if none or '*'
+    LogArgKind kind;
+};
+
+// Parse the conversion starting at p (which points at '%'); returns the character after it
+static const char *parseSpec(const char *p, LogFormatSpec &spec)
+{
+    spec.start = p;
+    spec.widthStar = false;
+    spec.precisionStar = false;
+    spec.precision = -1;
+    p++;
+
+    while (*p && strchr("-+ #0", *p))
+    {
+        p++;
+    }
+    if (*p == '*')
+    {
+        spec.widthStar = true;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        p++;
+    }
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            spec.precisionStar = true;
+            p++;
+        }
+        else
+        {
+            spec.precision = 0;
+            while (*p >= '0' && *p <= '9')
+            {
+                spec.precision = spec.precision * 10 + (*p - '0');
+                p++;
+            }
+        }
+    }
+
+    int longs = 0;
+    bool sizeLength = false;
+    bool longDouble = false;
+    while (*p && strchr("hlzjtL", *p))
+    {
+        longs += *p == 'l' ? 1 : (*p == 'j' ? 2 : 0);
+        sizeLength |= *p == 'z' || *p == 't';
+        longDouble |= *p == 'L';
+        p++;
+    }
+
+    switch (*p)
+    {
+    case '%':
+        spec.kind = LogArgKind::NONE;
+        break;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        spec.kind = longs >= 2 ? LogArgKind::LLONG : (longs == 1 ? LogArgKind::LONG : (sizeLength ? LogArgKind::SIZE : LogArgKind::INT));
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec.kind = longDouble ? LogArgKind::UNSUPPORTED : LogArgKind::DOUBLE;
+        break;
+    case 's':
+        spec.kind = longs ? LogArgKind::UNSUPPORTED : LogArgKind::STRING; // No wide strings
+        break;
+    case 'p':
+        spec.kind = LogArgKind::POINTER;
+        break;
+    default:
+        spec.kind = LogArgKind::UNSUPPORTED; // %n, or a malformed spec
+        break;
+    }
+
+    if (*p)
+    {
+        p++;
+    }
+    spec.length = p - spec.start;
+    return p;
+}
+
+// ========================================
+// ENCODING (caller's thread)
+// ========================================
+
+template <typename T>
+static bool putArg(uint8_t *out, size_t outSize, size_t &used, T value)
+{
+    if (used + sizeof(T) > outSize)
+    {
+        return false;
+    }
+    memcpy(out + used, &value, sizeof(T));
+    used += sizeof(T);
+    return true;
+}
+
+size_t encodeLogArgs(const char *format, va_list args, uint8_t *out, size_t outSize, bool &truncated)
+{
+    truncated = false;
+    size_t used = 0;
+    if (!format)
+    {
+        return 0;
+    }
+
+    const char *p = format;
+    while ((p = strchr(p, '%')) != nullptr)
+    {
+        LogFormatSpec spec;
+        p = parseSpec(p, spec);
+
+        bool fits = true;
+        if (spec.widthStar)
+        {
+            fits &= putArg(out, outSize, used, va_arg(args, int));
+        }
+        if (spec.precisionStar)
+        {
+            fits &= putArg(out, outSize, used, va_arg(args, int));
+        }
+
+        switch (spec.kind)
+        {
+        case LogArgKind::NONE:
+            break;
+        case LogArgKind::INT:
+            fits &= putArg(out, outSize, used, va_arg(args, int));
+            break;
+        case LogArgKind::LONG:
+            fits &= putArg(out, outSize, used, va_arg(args, long));
+            break;
+        case LogArgKind::LLONG:
+            fits &= putArg(out, outSize, used, va_arg(args, long long));
+            break;
+        case LogArgKind::SIZE:
+            fits &= putArg(out, outSize, used, va_arg(args, size_t));
+            break;
+        case LogArgKind::DOUBLE:
+            fits &= putArg(out, outSize, used, va_arg(args, double));
+            break;
+        case LogArgKind::POINTER:
+            fits &= putArg(out, outSize, used, va_arg(args, void *));
+            break;
+        case LogArgKind::STRING:
+        {
+            const char *text = va_arg(args, const char *);
+            if (!text)
+            {
+                text = "(null)";
+            }
+            // A precision caps what's printed, so there's no point keeping more
+            size_t length = spec.precision >= 0 ? strnlen(text, spec.precision) : strlen(text);
+            size_t room = outSize - used;
+            if (room == 0)
+            {
+                fits = false;
+                break;
+            }
+            if (length + 1 > room)
+            {
+                length = room - 1;
+                fits = false;
+            }
+            memcpy(out + used, text, length);
+            out[used + length] = '\0';
+            used += length + 1;
+            break;
+        }
+        case LogArgKind::UNSUPPORTED:
+            fits = false; // Can't tell how far to advance args
+            break;
+        }
+
+        if (!fits)
+        {
+            truncated = true;
+            break; // Later arguments would be misread, so stop here
+        }
+    }
+    return used;
+}
+
+// ========================================
+// FORMATTING (sink side)
+// ========================================
+
+template <typename T>
+static bool getArg(const LogRecord &record, size_t &offset, T &value)
+{
+    if (offset + sizeof(T) > record.argLength)
+    {
+        return false;
+    }
+    memcpy(&value, record.args + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+template <typename T>
+static int formatArg(char *out, size_t outSize, const char *spec, const LogFormatSpec &parsed, int width, int precision, T value)
+{
+    if (parsed.widthStar && parsed.precisionStar)
+    {
+        return snprintf(out, outSize, spec, width, precision, value);
+    }
+    if (parsed.widthStar || parsed.precisionStar)
+    {
+        return snprintf(out, outSize, spec, parsed.widthStar ? width : precision, value);
+    }
+    return snprintf(out, outSize, spec, value);
+}
+
+uint32_t buildLogRecord(LogRecord *record, uint8_t componentId, int level, uint32_t timestampMs,
+                        const char *format, va_list args)
+{
+    bool truncated;
+    record->argLength = (uint8_t)encodeLogArgs(format, args, record->args, logRecordMaxArgBytes, truncated);
+    record->timestampMs = timestampMs;
+    record->format = format;
+    record->level = (uint8_t)level;
+    record->componentId = componentId;
+    record->flags = truncated ? LOG_RECORD_TRUNCATED : 0;
+    record->control = getLogRecordSize(record->argLength);
+    return record->control;
+}
+
+size_t formatLogMessage(const LogRecord &record, char *out, size_t outSize)
+{
+    if (outSize == 0)
+    {
+        return 0;
+    }
+
+    size_t pos = 0;
+    size_t offset = 0;
+    bool argsLeft = true;
+    const char *p = record.format ? record.format : "";
+
+    auto append = [&](const char *text, size_t length)
+    {
+        size_t room = outSize - 1 - pos;
+        length = length < room ? length : room;
+        memcpy(out + pos, text, length);
+        pos += length;
+    };
+
+    while (*p && pos < outSize - 1)
+    {
+        const char *percent = strchr(p, '%');
+        if (!percent)
+        {
+            append(p, strlen(p));
+            break;
+        }
+        append(p, percent - p);
+
+        LogFormatSpec parsed;
+        p = parseSpec(percent, parsed);
+        if (parsed.kind == LogArgKind::NONE)
+        {
+            append("%", 1);
+            continue;
+        }
+
+        char spec[24];
+        if (parsed.length >= sizeof(spec) || parsed.kind == LogArgKind::UNSUPPORTED)
+        {
+            argsLeft = false;
+        }
+
+        int width = 0;
+        int precision = 0;
+        if (argsLeft && parsed.widthStar)
+        {
+            argsLeft = getArg(record, offset, width);
+        }
+        if (argsLeft && parsed.precisionStar)
+        {
+            argsLeft = getArg(record, offset, precision);
+        }
+        if (!argsLeft)
+        {
+            append("?", 1); // Argument didn't fit in the record
+            continue;
+        }
+
+        memcpy(spec, parsed.start, parsed.length);
+        spec[parsed.length] = '\0';
+
+        char *dest = out + pos;
+        size_t room = outSize - pos;
+        int written = 0;
+        switch (parsed.kind)
+        {
+        case LogArgKind::INT:
+        {
+            int value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::LONG:
+        {
+            long value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::LLONG:
+        {
+            long long value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::SIZE:
+        {
+            size_t value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::DOUBLE:
+        {
+            double value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::POINTER:
+        {
+            void *value;
+            argsLeft = getArg(record, offset, value);
+            written = argsLeft ? formatArg(dest, room, spec, parsed, width, precision, value) : 0;
+            break;
+        }
+        case LogArgKind::STRING:
+        {
+            const char *text = (const char *)record.args + offset;
+            size_t length = offset < record.argLength ? strnlen(text, record.argLength - offset) : 0;
+            argsLeft = offset + length < record.argLength; // Terminator present
+            if (argsLeft)
+            {
+                offset += length + 1;
+                written = formatArg(dest, room, spec, parsed, width, precision, text);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (!argsLeft)
+        {
+            append("?", 1);
+            continue;
+        }
+        if (written > 0)
+        {
+            pos += (size_t)written < room ? (size_t)written : room - 1;
+        }
+    }
+
+    out[pos] = '\0';
+    return pos;
+}
+
+// ========================================
+// COMPONENT TABLE
+// ========================================
+
+enum : uint8_t
+{
+    componentSlotEmpty,
+    componentSlotWriting,
+    componentSlotReady
+};
+
+LogComponentTable::LogComponentTable()
+{
+    for (int i = 0; i < logComponentTableSize; i++)
+    {
+        states[i].store(componentSlotEmpty, std::memory_order_relaxed);
+        names[i][0] = '\0';
+    }
+}
+
+uint8_t LogComponentTable::intern(const char *name)
+{
+    if (!name)
+    {
+        name = "";
+    }
+
+    // Hash the text as it will be kept, so the same name from different buffers shares one ID
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < logComponentNameLength && name[i]; i++)
+    {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+
+    for (int probe = 0; probe < logComponentTableSize; probe++)
+    {
+        int index = (hash + probe) & (logComponentTableSize - 1);
+        uint8_t state = states[index].load(std::memory_order_acquire);
+        if (state == componentSlotEmpty)
+        {
+            if (states[index].compare_exchange_strong(state, componentSlotWriting, std::memory_order_acq_rel))
+            {
+                strncpy(names[index], name, logComponentNameLength);
+                names[index][logComponentNameLength] = '\0';
+                states[index].store(componentSlotReady, std::memory_order_release);
+                return (uint8_t)index;
+            }
+            // Lost the race - state now holds the winner's progress
+        }
+        // A slot still being written is passed over; at worst its name gets a second ID
+        if (state == componentSlotReady && strncmp(names[index], name, logComponentNameLength) == 0)
+        {
+            return (uint8_t)index;
+        }
+    }
+    return logUnknownComponentId;
+}
+
+const char *LogComponentTable::getName(uint8_t id) const
+{
+    if (id >= logComponentTableSize || states[id].load(std::memory_order_acquire) != componentSlotReady)
+    {
+        return "?";
+    }
+    return names[id];
+}
+
+int LogComponentTable::size() const
+{
+    int count = 0;
+    for (int i = 0; i < logComponentTableSize; i++)
+    {
+        if (states[i].load(std::memory_order_relaxed) != componentSlotEmpty)
+        {
+            count++;
+        }
+    }
+    return count;
+}
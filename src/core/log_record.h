@@ -0,0 +1,125 @@
+/**
+ * @file log_record.h
+ * @brief Compact binary log records with deferred formatting
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * A log call stores its format string pointer (a literal in flash) and the
+ * raw argument bytes instead of the formatted text. The format string says
+ * how wide each argument is, so nothing else needs recording: integers and
+ * pointers are copied at their C size, floating point as double, and %s
+ * arguments as NUL-terminated copies (the caller's buffer may be gone by the
+ * time the record is formatted). Text is produced only when a sink consumes
+ * the record, or on a PC by scripts/bin/decode_log.py using the firmware ELF.
+ *
+ * Record layout (little-endian, 16-byte header and 4-byte alignment on the ESP32):
+ *   u32 control      size in bytes (low 16 bits) and LOG_RECORD_* flags
+ *   u32 timestampMs  millis() at the call
+ *   ptr format       format string address
+ *   u8  level, u8 componentId, u8 argLength, u8 flags
+ *   u8  args[argLength]
+ *
+ * Component names are interned to one-byte IDs (LogComponentTable), which
+ * keeps its own copy of each name. The format is kept by address, so it must
+ * be a string literal or otherwise live forever.
+ */
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include <atomic>
+#include <stdarg.h>
+
+// control word flags
+static const uint32_t LOG_RECORD_COMMITTED = 0x80000000; // Fully written (ring only)
+static const uint32_t LOG_RECORD_PADDING = 0x40000000;   // Filler up to the end of the ring
+static const uint32_t LOG_RECORD_SIZE_MASK = 0x0000FFFF;
+
+// control word flags in binary log files (logFileBinaryRecords)
+static const uint32_t LOG_FILE_COMPONENT_NAME = 0x20000000; // u8 id, NUL-terminated name
+static const uint32_t LOG_FILE_CLOCK = 0x10000000;          // u32 millis, u32 UTC seconds (0 if unsynced)
+
+// flags byte
+static const uint8_t LOG_RECORD_TRUNCATED = 0x01; // Some argument bytes didn't fit
+
+static const uint8_t logUnknownComponentId = 0xFF; // Component table full
+
+struct LogRecord
+{
+    uint32_t control;
+    uint32_t timestampMs;
+    const char *format;
+    uint8_t level;
+    uint8_t componentId;
+    uint8_t argLength;
+    uint8_t flags;
+    uint8_t args[];
+};
+
+/**
+ * @brief Size of a record with argLength argument bytes, padded to keep records aligned
+ */
+inline size_t getLogRecordSize(size_t argLength)
+{
+    return (sizeof(LogRecord) + argLength + alignof(LogRecord) - 1) & ~(alignof(LogRecord) - 1);
+}
+
+/**
+ * @brief Copy the arguments described by format out of args
+ * @param out Destination for up to outSize argument bytes
+ * @param truncated Set when a string was cut short or arguments were left out
+ * @return Number of bytes written
+ */
+size_t encodeLogArgs(const char *format, va_list args, uint8_t *out, size_t outSize, bool &truncated);
+
+/**
+ * @brief Fill in a record from a log call (control holds just the size; the ring adds its flags)
+ * @param record Room for sizeof(LogRecord) + logRecordMaxArgBytes
+ * @return The record's size, as getLogRecordSize()
+ */
+uint32_t buildLogRecord(LogRecord *record, uint8_t componentId, int level, uint32_t timestampMs,
+                        const char *format, va_list args);
+
+/**
+ * @brief Produce the text of a record's message
+ * @return Length written (excluding the terminator)
+ */
+size_t formatLogMessage(const LogRecord &record, char *out, size_t outSize);
+
+/**
+ * @brief Interns component names to one-byte IDs
+ * Names are copied (up to logComponentNameLength characters), so a runtime
+ * name may go away after the call. Lock-free: any task may intern; names are
+ * never removed.
+ */
+class LogComponentTable
+{
+public:
+    LogComponentTable();
+
+    /**
+     * @brief ID for a component name, adding it if new
+     * @return ID, or logUnknownComponentId if the table is full
+     */
+    uint8_t intern(const char *name);
+
+    /**
+     * @brief Name for an ID ("?" if unknown)
+     */
+    const char *getName(uint8_t id) const;
+
+    int size() const;
+
+private:
+    static_assert((logComponentTableSize & (logComponentTableSize - 1)) == 0 && logComponentTableSize <= 255,
+                  "logComponentTableSize must be a power of 2 that fits a one-byte ID");
+
+    std::atomic<uint8_t> states[logComponentTableSize]; // Empty, being written, or ready
+    char names[logComponentTableSize][logComponentNameLength + 1];
+};
+
+#endif // LOG_RECORD_H
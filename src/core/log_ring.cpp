@@ -0,0 +1,120 @@
+/**
+ * @file log_ring.cpp
+ * @brief Implementation of the lock-free log record ring
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "log_ring.h"
+
+// Positions are free-running byte counts; the offset in buffer is position mod logRingBytes.
+
+LogRing::LogRing() : writePos(0), readPos(0), pushed(0), released(0), dropped(0)
+{
+    memset(buffer, 0, sizeof(buffer));
+}
+
+uint32_t *LogRing::controlAt(uint32_t position)
+{
+    return reinterpret_cast<uint32_t *>(buffer + (position & (logRingBytes - 1)));
+}
+
+bool LogRing::push(uint8_t componentId, int level, uint32_t timestampMs, const char *format, va_list args)
+{
+    // Build the record on the stack first so the claimed space is known exactly
+    alignas(LogRecord) uint8_t scratch[sizeof(LogRecord) + logRecordMaxArgBytes];
+    LogRecord *record = reinterpret_cast<LogRecord *>(scratch);
+    buildLogRecord(record, componentId, level, timestampMs, format, args);
+    return push(*record);
+}
+
+bool LogRing::push(const LogRecord &record)
+{
+    uint32_t size = getLogRecordSize(record.argLength);
+
+    uint32_t pos = writePos.load(std::memory_order_relaxed);
+    uint32_t padding;
+    for (;;)
+    {
+        uint32_t tail = logRingBytes - (pos & (logRingBytes - 1));
+        padding = tail < size ? tail : 0; // Don't wrap a record round the end
+        uint32_t read = readPos.load(std::memory_order_acquire);
+        if (pos + padding + size - read > (uint32_t)logRingBytes)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (writePos.compare_exchange_weak(pos, pos + padding + size, std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    if (padding)
+    {
+        __atomic_store_n(controlAt(pos), LOG_RECORD_COMMITTED | LOG_RECORD_PADDING | padding, __ATOMIC_RELEASE);
+        pos += padding;
+    }
+
+    uint32_t *control = controlAt(pos);
+    memcpy(reinterpret_cast<uint8_t *>(control) + sizeof(uint32_t), reinterpret_cast<const uint8_t *>(&record) + sizeof(uint32_t),
+           size - sizeof(uint32_t));
+    __atomic_store_n(control, LOG_RECORD_COMMITTED | size, __ATOMIC_RELEASE);
+
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool LogRing::push(uint8_t componentId, int level, uint32_t timestampMs, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool result = push(componentId, level, timestampMs, format, args);
+    va_end(args);
+    return result;
+}
+
+void LogRing::consume(uint32_t size)
+{
+    uint32_t read = readPos.load(std::memory_order_relaxed);
+    memset(controlAt(read), 0, size); // Unfinished records must read as uncommitted next lap
+    readPos.store(read + size, std::memory_order_release);
+}
+
+const LogRecord *LogRing::peek()
+{
+    for (;;)
+    {
+        uint32_t *control = controlAt(readPos.load(std::memory_order_relaxed));
+        uint32_t value = __atomic_load_n(control, __ATOMIC_ACQUIRE);
+        if (!(value & LOG_RECORD_COMMITTED))
+        {
+            return nullptr; // Empty, or the producer is still writing it
+        }
+        if (value & LOG_RECORD_PADDING)
+        {
+            consume(value & LOG_RECORD_SIZE_MASK);
+            continue;
+        }
+        return reinterpret_cast<const LogRecord *>(control);
+    }
+}
+
+void LogRing::release()
+{
+    uint32_t value = *controlAt(readPos.load(std::memory_order_relaxed));
+    consume(value & LOG_RECORD_SIZE_MASK);
+    released.fetch_add(1, std::memory_order_relaxed);
+}
+
+int LogRing::size() const
+{
+    return (int)(pushed.load(std::memory_order_relaxed) - released.load(std::memory_order_relaxed));
+}
+
+size_t LogRing::getUsedBytes() const
+{
+    return writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file log_ring.h
+ * @brief Lock-free ring of binary log records between callers and the log sink task
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Any task can push (multi-producer); only the sink task reads (single
+ * consumer). Records (log_record.h) are variable length, so a typical line
+ * takes 16-40 bytes rather than a fixed text slot. A push encodes the
+ * arguments on the stack, claims space with one compare-and-swap and copies
+ * the record in - no locks, no heap, no formatting. A record that would run
+ * past the end of the buffer is placed at the start, behind a padding
+ * record. When the ring is full the record is dropped and counted rather
+ * than blocking the caller.
+ *
+ * The consumer zeroes what it has read before handing it back, so a claimed
+ * but unfinished record always reads as not yet committed.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include <atomic>
+#include <stdarg.h>
+#include "log_record.h"
+
+class LogRing
+{
+public:
+    LogRing();
+
+    /**
+     * @brief Encode a record into the ring
+     * @param componentId ID from LogComponentTable
+     * @param format Format string - stored by pointer, so it must be a literal
+     * @return false if there was no room (the record is counted as dropped)
+     */
+    bool push(uint8_t componentId, int level, uint32_t timestampMs, const char *format, va_list args);
+    bool push(uint8_t componentId, int level, uint32_t timestampMs, const char *format, ...);
+
+    /**
+     * @brief Copy a record made by buildLogRecord() into the ring
+     */
+    bool push(const LogRecord &record);
+
+    /**
+     * @brief Oldest fully written record, or nullptr if there is none yet
+     * Consumer only. The record stays valid until release().
+     */
+    const LogRecord *peek();
+
+    /**
+     * @brief Hand the record returned by peek() back to producers
+     */
+    void release();
+
+    uint32_t getPushedCount() const { return pushed.load(std::memory_order_relaxed); }
+    uint32_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records pushed but not yet released
+     */
+    int size() const;
+
+    /**
+     * @brief Bytes claimed by producers and not yet released (including padding)
+     */
+    size_t getUsedBytes() const;
+
+private:
+    static_assert((logRingBytes & (logRingBytes - 1)) == 0, "logRingBytes must be a power of 2");
+    static_assert(logRecordMaxArgBytes <= 255, "argLength is one byte");
+
+    uint32_t *controlAt(uint32_t position);
+    void consume(uint32_t size);
+
+    alignas(LogRecord) uint8_t buffer[logRingBytes];
+    std::atomic<uint32_t> writePos;
+    std::atomic<uint32_t> readPos; // Written by the consumer only
+    std::atomic<uint32_t> pushed;
+    std::atomic<uint32_t> released;
+    std::atomic<uint32_t> dropped;
+};
+
+#endif // LOG_RING_H
@@ -1,18 +1,63 @@
 #include "logging.h"
+#include "log_ring.h"
+#include "log_batch.h"
+#include "log_file_writer.h"
+#include "log_history.h"
+#include "log_rate_limiter.h"
+#include "log_level_table.h"
+#include "crash_log.h"
 #include <utils/time_utils.h>
 #include "config_utils.h"
-#include <esp_task_wdt.h>
-
-// Global instance of multi-output printer
-MultiOutputPrint multiOutput;
-
-size_t MultiOutputPrint::write(uint8_t c)
-{
-    String message = String((char)c);
-    return write((const uint8_t *)message.c_str(), message.length());
-}
-
-#include "config_utils.h"
+#include <ezTime.h>
+#include <esp_ota_ops.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+static void logToFileSystem(const char *line, int level, uint32_t sequence);
+static void queueMQTTLog(const String &message, const String &level, const String &component, const String &timestamp);
+static void logToBinaryFile(const LogRecord &record);
+static void queueBetterStackLog(const char *message, const String &level, const char *component,
+                                const String &timestamp);
+static void shipBetterStackBatch();
+static void serviceLogFiles();
+static void queueLogRecord(const char *component, uint8_t componentId, int level, const char *format, ...);
+
+// Records waiting for the sink task, and the component names they refer to by ID
+static LogRing logRing;
+static LogComponentTable logComponents;
+static LogLevelTable logLevels;
+static LogRateLimiter logRateLimiter;
+static unsigned long lastSuppressionReportMs = 0; // Sink task only
+static TaskHandle_t logSinkTaskHandle = nullptr;
+static bool drainInline = false; // Sink task couldn't be started
+static std::atomic<bool> inlineDrainBusy(false);
+
+// MQTT log payloads (String*) waiting for the main loop
+static QueueHandle_t mqttLogQueue = nullptr;
+static volatile uint32_t mqttLogsDropped = 0;
+
+// Log files, kept open and buffered (sink task only); only the enabled one allocates a buffer
+static LogFileWriter textLogFile(LittleFS, logFileName);
+static LogFileWriter binaryLogFile(LittleFS, logBinaryFileName);
+static std::atomic<bool> logFileFlushRequested(false);
+static std::atomic<bool> logFileRotateRequested(false);
+
+// Recent records for /api/logs, and how far the text file has reached flash in the same numbering
+static LogHistory logHistory;
+static std::atomic<uint32_t> logFileFlushedSequence(0);
+static uint32_t logFileNextSequence = 0; // Sink task only
+
+// Copy of every record in RAM the bootloader leaves alone, read back after a reset
+static __NOINIT_ATTR CrashLogStorage crashLogStorage;
+static CrashLog crashLog;
+static bool crashLogPublished = false;
+
+// BetterStack batch and its kept-alive connection (sink task only)
+static LogBatch betterStackBatch;
+static WiFiClientSecure *betterStackClient = nullptr;
+static HTTPClient *betterStackHttp = nullptr;
 
 // Safe device owner accessor for logging - avoids recursive calls during initialization
 static const char *getSafeDeviceOwner()
@@ -28,250 +73,623 @@ static const char *getSafeDeviceOwner()
     return getDeviceOwnerKey();
 }
 
-size_t MultiOutputPrint::write(const uint8_t *buffer, size_t size)
+// Send one record to every enabled sink (sink task, or the caller if there is none)
+static void writeLogRecord(const LogRecord &record)
 {
-    String message;
-    for (size_t i = 0; i < size; i++)
+    uint32_t sequence = logHistory.add(record);
+
+    if (enableFileLogging && logFileBinaryRecords)
     {
-        message += (char)buffer[i];
+        logToBinaryFile(record); // Stays binary - decoded on a PC
     }
 
-    // Output to Serial if enabled
-    if (enableSerialLogging)
+    const bool textFile = enableFileLogging && !logFileBinaryRecords;
+    if (!enableSerialLogging && !textFile && !enableMQTTLogging && !enableBetterStackLogging)
+    {
+        return;
+    }
+
+    // Formatting happens here, off the caller's thread
+    char message[logMessageMaxLength];
+    formatLogMessage(record, message, sizeof(message));
+    const char *component = logComponents.getName(record.componentId);
+    String levelStr = getLogLevelString(record.level);
+
+    // When the call was made, not when the sink got to it - records can wait behind a slow sink
+    String timestamp = getFormattedDateTime(UTC.now() - (time_t)((millis() - record.timestampMs) / 1000));
+
+    if (enableSerialLogging || textFile)
     {
-        Serial.print(message);
+        char line[logMessageMaxLength + 128];
+        snprintf(line, sizeof(line), "[%s] [%s] [%s] [%s] %s\r\n",
+                 timestamp.c_str(), levelStr.c_str(), getSafeDeviceOwner(), component, message);
+
+        if (enableSerialLogging)
+        {
+            Serial.print(line);
+        }
+        if (textFile)
+        {
+            logToFileSystem(line, record.level, sequence);
+        }
     }
 
-    // Output to file if enabled
-    if (enableFileLogging && message.length() > 0)
+    if (enableMQTTLogging)
     {
-        logToFile(message.c_str());
+        queueMQTTLog(message, levelStr, component, timestamp);
     }
 
-    return size;
+    if (enableBetterStackLogging)
+    {
+        queueBetterStackLog(message, levelStr, component, timestamp);
+    }
+}
+
+// One line per component/level that hit its rate limit since the last report
+static void reportSuppressedLogs()
+{
+    unsigned long now = millis();
+    if (now - lastSuppressionReportMs < logRateLimitSummaryIntervalMs)
+    {
+        return;
+    }
+    lastSuppressionReportMs = now;
+
+    LogSuppression suppressions[8];
+    int count;
+    while ((count = logRateLimiter.takeSuppressions(suppressions, 8)) > 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const LogSuppression &s = suppressions[i];
+            queueLogRecord(logComponents.getName(s.componentId), s.componentId, s.level,
+                           "Rate limit: suppressed %u messages in %lu s", (unsigned)s.count, (now - s.sinceMs) / 1000 + 1);
+        }
+    }
+}
+
+static void drainLogRing()
+{
+    reportSuppressedLogs(); // Queued first, so this drain writes them too
+
+    const LogRecord *record;
+    while ((record = logRing.peek()) != nullptr)
+    {
+        writeLogRecord(*record);
+        logRing.release();
+
+        // Ship a batch as soon as it fills, or a long drain (the boot log) overflows it
+        if (enableBetterStackLogging && betterStackBatch.isDue(millis()))
+        {
+            shipBetterStackBatch();
+        }
+    }
+
+    if (enableFileLogging)
+    {
+        serviceLogFiles();
+    }
+
+    if (enableBetterStackLogging)
+    {
+        shipBetterStackBatch(); // Also runs on idle wake-ups, so old records don't wait on new ones
+    }
+}
+
+static void logSinkTask(void *parameter)
+{
+    for (;;)
+    {
+        // Producers notify after each record; the timeout catches any notify that raced the drain
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(logSinkIdleWaitMs));
+        drainLogRing();
+    }
 }
 
 void setupLogging()
 {
-    // Initialize ArduinoLog with our custom multi-output
-    Log.begin(logLevel, &multiOutput);
-
-    // Set prefixes and suffixes for clean formatting
-    Log.setPrefix([](Print *_logOutput, int logLevel)
-                  {
-        String timestamp = getFormattedDateTime();
-        String levelStr = getLogLevelString(logLevel);
-        _logOutput->print("[");
-        _logOutput->print(timestamp);
-        _logOutput->print("] [");
-        _logOutput->print(levelStr);
-        _logOutput->print("] "); });
-
-    Log.setSuffix([](Print *_logOutput, int logLevel)
-                  {
-        // Add newline at end of each log message
-        _logOutput->println(); });
+    // Only the same build can make sense of the stored format pointers
+    const esp_app_desc_t *app = esp_ota_get_app_description();
+    crashLog.begin(&crashLogStorage, app->app_elf_sha256, esp_reset_reason() != ESP_RST_POWERON);
 
     // Create logs directory if logging to file
     if (enableFileLogging)
     {
         // LittleFS is already mounted in main.cpp
         LittleFS.mkdir("/logs");
+        LogFileWriter &writer = logFileBinaryRecords ? binaryLogFile : textLogFile;
+        if (!writer.begin())
+        {
+            Serial.println("[LOGGING] Failed to open log file - file logging disabled");
+        }
+    }
+
+    if (enableMQTTLogging && !mqttLogQueue)
+    {
+        mqttLogQueue = xQueueCreate(logMqttQueueLength, sizeof(String *));
+    }
+
+    if (!logSinkTaskHandle &&
+        xTaskCreate(logSinkTask, "LogSink", logSinkTaskStackSize, nullptr, logSinkTaskPriority, &logSinkTaskHandle) != pdPASS)
+    {
+        // Still log, just on the caller's thread as before
+        logSinkTaskHandle = nullptr;
+        drainInline = true;
+        Serial.println("[LOGGING] Failed to start log sink task - logging synchronously");
+        drainLogRing();
+    }
+}
+
+// Previous boot's lines, one message each, the first time MQTT is up after boot (main loop only)
+static void publishPreviousBootLog()
+{
+    crashLogPublished = true;
+    const char *resetReason = getResetReasonString();
+    char message[logMessageMaxLength];
+    for (int i = 0; i < crashLog.getPreviousCount(); i++)
+    {
+        const CrashLogSlot &slot = crashLog.getPrevious(i);
+        crashLog.formatPrevious(i, message, sizeof(message));
+
+        DynamicJsonDocument doc(1024);
+        doc["device"] = String(getMdnsHostname());
+        doc["reset_reason"] = resetReason;
+        doc["uptime_ms"] = slot.timestampMs;
+        doc["level"] = getLogLevelString(slot.level);
+        doc["component"] = crashLog.getPreviousComponent(i);
+        doc["message"] = message;
+
+        String payload;
+        serializeJson(doc, payload);
+        mqttClient.publish(crashLogMqttTopic, payload.c_str());
     }
 }
 
-void logToFileSystem(const String &message)
+void handleLogging()
 {
-    // LittleFS is already mounted in main.cpp, no need to call begin() again
+    if (crashLogPublishMqtt && !crashLogPublished && crashLog.getPreviousCount() > 0 && mqttClient.connected())
+    {
+        publishPreviousBootLog();
+    }
 
-    // Check if log rotation is needed
-    if (LittleFS.exists(logFileName))
+    String *payload = nullptr;
+    while (mqttLogQueue && xQueueReceive(mqttLogQueue, &payload, 0) == pdTRUE)
     {
-        File logFile = LittleFS.open(logFileName, "r");
-        if (logFile && logFile.size() > maxLogFileSize)
+        if (mqttClient.connected())
+        {
+            mqttClient.publish(mqttLogTopic, payload->c_str());
+        }
+        else
         {
-            logFile.close();
-            rotateLogFile();
+            mqttLogsDropped++;
         }
-        else if (logFile)
+        delete payload;
+    }
+}
+
+void flushLogs()
+{
+    logFileFlushRequested.store(enableFileLogging);
+    if (!logSinkTaskHandle)
+    {
+        if (drainInline && !inlineDrainBusy.exchange(true))
         {
-            logFile.close();
+            drainLogRing();
+            inlineDrainBusy.store(false);
         }
+        return;
     }
 
-    // Append to log file
-    File logFile = LittleFS.open(logFileName, "a");
-    if (logFile)
+    unsigned long start = millis();
+    while ((logRing.size() > 0 || logFileFlushRequested.load()) && millis() - start < logFlushTimeoutMs)
     {
-        logFile.print(message);
-        logFile.close();
+        xTaskNotifyGive(logSinkTaskHandle);
+        delay(5);
     }
 }
 
-void logToMQTT(const String &message, const String &level, const String &component)
+LoggingStats getLoggingStats()
 {
-    if (mqttClient.connected() && message.length() > 0)
+    LoggingStats stats;
+    stats.recordsWritten = logRing.getPushedCount();
+    stats.recordsDropped = logRing.getDroppedCount();
+    stats.mqttDropped = mqttLogsDropped;
+    stats.recordsQueued = logRing.size();
+    stats.betterStackSent = betterStackBatch.getSentCount();
+    stats.betterStackDropped = betterStackBatch.getDroppedCount();
+    stats.fileWrites = textLogFile.getFlashWrites() + binaryLogFile.getFlashWrites();
+    stats.recordsSuppressed = logRateLimiter.getSuppressedCount();
+    stats.sinkStackFree = logSinkTaskHandle ? uxTaskGetStackHighWaterMark(logSinkTaskHandle) : 0;
+    return stats;
+}
+
+static void logToFileSystem(const char *line, int level, uint32_t sequence)
+{
+    size_t length = strlen(line);
+    uint32_t flashWrites = textLogFile.getFlashWrites();
+    textLogFile.prepare(length);
+    textLogFile.write((const uint8_t *)line, length, millis());
+    logFileNextSequence = sequence + 1;
+
+    if (level <= logFileFlushLevel)
     {
-        // Feed watchdog before potentially slow network operation
-        esp_task_wdt_reset();
+        textLogFile.flush(); // Problems reach flash straight away, in case a crash follows
+    }
 
-        // Create JSON log entry
-        DynamicJsonDocument doc(1024);
-        doc["device_timestamp"] = getFormattedDateTime();
-        doc["device"] = String(getMdnsHostname());
-        doc["device_owner"] = getSafeDeviceOwner();
-        doc["level"] = level;
-        doc["message"] = message;
+    if (textLogFile.getBufferedBytes() == 0)
+    {
+        logFileFlushedSequence.store(sequence + 1);
+    }
+    else if (textLogFile.getFlashWrites() != flashWrites)
+    {
+        logFileFlushedSequence.store(sequence); // A block was written out part-way through this line
+    }
+}
 
-        // Add component if provided
-        if (component.length() > 0)
+// Time-based flushes, and flush/rotate requests from other tasks (sink task only)
+static void serviceLogFiles()
+{
+    if (logFileRotateRequested.exchange(false))
+    {
+        textLogFile.rotate();
+        binaryLogFile.rotate();
+    }
+
+    // A flush request is for everything queued before it, so wait for the ring to empty
+    bool flushRequested = logRing.size() == 0 && logFileFlushRequested.exchange(false);
+    unsigned long now = millis();
+    for (LogFileWriter *writer : {&textLogFile, &binaryLogFile})
+    {
+        if (flushRequested || writer->isFlushDue(now))
         {
-            doc["component"] = component;
+            writer->flush();
         }
+    }
 
-        String payload;
-        serializeJson(doc, payload);
+    if (textLogFile.getBufferedBytes() == 0)
+    {
+        logFileFlushedSequence.store(logFileNextSequence);
+    }
+}
+
+// Binary file state: names and clock are written once per boot, and again in each new segment
+static bool binaryFileBootMarked = false;
+static bool binaryFileClockSynced = false;
+static uint8_t binaryFileNamedComponents[(logComponentTableSize + 7) / 8];
+
+static const size_t binaryFileHeaderBytes = 8;
+static const size_t binaryClockRecordBytes = 12;
+static const size_t binaryComponentRecordBytes = 40; // Largest; shorter names write less
+
+static void writeBinaryClockRecord()
+{
+    uint32_t words[3];
+    words[0] = LOG_FILE_CLOCK | sizeof(words);
+    words[1] = millis();
+    words[2] = timeStatus() == timeSet ? (uint32_t)UTC.now() : 0; // 0 until NTP has synced
+    binaryLogFile.write((const uint8_t *)words, sizeof(words), millis());
+}
+
+static void writeBinaryComponentRecord(uint8_t id)
+{
+    const char *name = logComponents.getName(id);
+    uint8_t entry[binaryComponentRecordBytes] = {0};
+    size_t nameLength = strnlen(name, sizeof(entry) - 6);
+    uint32_t size = (4 + 1 + nameLength + 1 + 3) & ~3u;
+    uint32_t control = LOG_FILE_COMPONENT_NAME | size;
+    memcpy(entry, &control, sizeof(control));
+    entry[4] = id;
+    memcpy(entry + 5, name, nameLength);
+    binaryLogFile.write(entry, size, millis());
+}
+
+static void logToBinaryFile(const LogRecord &record)
+{
+    uint32_t size = record.control & LOG_RECORD_SIZE_MASK;
+
+    // Room for the record plus anything that may have to precede it, so a segment never splits them
+    bool newSegment = binaryLogFile.prepare(binaryFileHeaderBytes + binaryClockRecordBytes + binaryComponentRecordBytes + size);
+    if (!binaryLogFile.isOpen())
+    {
+        return;
+    }
+
+    if (newSegment)
+    {
+        // Sizes let the decoder read pointers and longs the way this build wrote them
+        const uint8_t header[binaryFileHeaderBytes] = {'S', 'L', 'G', '1', sizeof(void *), sizeof(long), sizeof(size_t), offsetof(LogRecord, args)};
+        binaryLogFile.write(header, sizeof(header), millis());
+    }
+    if (newSegment || !binaryFileBootMarked || (!binaryFileClockSynced && timeStatus() == timeSet))
+    {
+        if (newSegment || !binaryFileBootMarked)
+        {
+            memset(binaryFileNamedComponents, 0, sizeof(binaryFileNamedComponents)); // IDs are per boot
+        }
+        writeBinaryClockRecord();
+        binaryFileBootMarked = true;
+        binaryFileClockSynced = timeStatus() == timeSet;
+    }
+
+    uint8_t id = record.componentId;
+    if (id < logComponentTableSize && !(binaryFileNamedComponents[id / 8] & (1 << (id % 8))))
+    {
+        writeBinaryComponentRecord(id);
+        binaryFileNamedComponents[id / 8] |= 1 << (id % 8);
+    }
 
-        mqttClient.publish(mqttLogTopic, payload.c_str());
+    // The record as it sits in the ring, minus the ring-only flags
+    binaryLogFile.write((const uint8_t *)&size, sizeof(size), millis());
+    binaryLogFile.write((const uint8_t *)&record + sizeof(uint32_t), size - sizeof(uint32_t), millis());
+
+    if (record.level <= logFileFlushLevel)
+    {
+        binaryLogFile.flush();
     }
 }
 
-void logToBetterStack(const String &message, const String &level, const String &component)
+// Sink task side: build the JSON here, publish from the main loop
+static void queueMQTTLog(const String &message, const String &level, const String &component, const String &timestamp)
 {
-    if (strlen(betterStackToken) == 0 || WiFi.status() != WL_CONNECTED)
+    if (!mqttLogQueue || message.length() == 0)
     {
         return;
     }
 
-    WiFiClientSecure client;
-    client.setInsecure();
-    HTTPClient http;
+    // Create JSON log entry
+    DynamicJsonDocument doc(1024);
+    doc["device_timestamp"] = timestamp;
+    doc["device"] = String(getMdnsHostname());
+    doc["device_owner"] = getSafeDeviceOwner();
+    doc["level"] = level;
+    doc["message"] = message;
 
-    http.begin(client, betterStackEndpoint);
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("Authorization", "Bearer " + String(betterStackToken));
+    // Add component if provided
+    if (component.length() > 0)
+    {
+        doc["component"] = component;
+    }
 
-    String cleanMessage = message;
-    String finalComponent = component;
+    String *payload = new String();
+    serializeJson(doc, *payload);
 
-    // If no component provided, try to extract from message (format: [COMPONENT] message)
-    if (component.length() == 0 && message.startsWith("[") && message.indexOf("] ") > 0)
+    if (xQueueSend(mqttLogQueue, &payload, 0) != pdTRUE)
     {
-        int endBracket = message.indexOf("] ");
-        finalComponent = message.substring(1, endBracket);
-        cleanMessage = message.substring(endBracket + 2);
+        mqttLogsDropped++;
+        delete payload;
     }
+}
 
+// Sink task side: add the record to the current batch
+static void queueBetterStackLog(const char *message, const String &level, const char *component,
+                                const String &timestamp)
+{
     // Create BetterStack log entry with structured tags
     DynamicJsonDocument doc(1024);
     doc["device_owner"] = getSafeDeviceOwner();
     doc["level"] = level;
-    doc["message"] = cleanMessage;
-    doc["device_timestamp"] = getFormattedDateTime();
+    doc["message"] = message;
+    doc["device_timestamp"] = timestamp;
 
     // Add component as a structured tag if present
-    if (finalComponent.length() > 0)
+    if (component[0] != '\0')
+    {
+        doc["component"] = component;
+    }
+
+    char entry[logMessageMaxLength * 2 + 256];
+    size_t length = measureJson(doc);
+    if (length >= sizeof(entry))
+    {
+        return; // Only possible with a message full of escapes
+    }
+    serializeJson(doc, entry, sizeof(entry));
+    betterStackBatch.add(entry, length, millis());
+}
+
+// POST the batch once it's due, over a TLS connection kept open between batches
+static void shipBetterStackBatch()
+{
+    unsigned long now = millis();
+    if (!betterStackBatch.isDue(now) || strlen(betterStackToken) == 0 || WiFi.status() != WL_CONNECTED)
     {
-        doc["component"] = finalComponent;
+        return;
     }
 
-    String payload;
-    serializeJson(doc, payload);
+    if (!betterStackClient)
+    {
+        betterStackClient = new WiFiClientSecure();
+        betterStackClient->setInsecure();
+        betterStackHttp = new HTTPClient();
+        betterStackHttp->setReuse(true);
+        betterStackHttp->setConnectTimeout(betterStackHttpTimeoutMs);
+        betterStackHttp->setTimeout(betterStackHttpTimeoutMs);
+    }
 
-    http.POST(payload);
-    http.end();
+    const String &payload = betterStackBatch.getPayload();
+    int status = -1;
+    if (betterStackHttp->begin(*betterStackClient, betterStackEndpoint))
+    {
+        betterStackHttp->addHeader("Content-Type", "application/json");
+        betterStackHttp->addHeader("Authorization", "Bearer " + String(betterStackToken));
+        status = betterStackHttp->POST((uint8_t *)payload.c_str(), payload.length());
+        betterStackHttp->end(); // Keeps the connection if the server allows it
+    }
+
+    if (status >= 200 && status < 300)
+    {
+        betterStackBatch.onSent();
+        return;
+    }
+
+    if (enableSerialLogging)
+    {
+        // Not through LOG_* - a failing sink mustn't feed itself
+        Serial.printf("[LOGGING] BetterStack POST failed (%d), %d records, attempt %d of %d\r\n",
+                      status, betterStackBatch.getCount(), betterStackBatch.getFailures() + 1, betterStackMaxAttempts);
+    }
+
+    // Start the next attempt from a fresh connection
+    betterStackClient->stop();
+    betterStackBatch.onSendFailed(millis());
 }
 
 void rotateLogFile()
 {
-    // LittleFS is already mounted in main.cpp, no need to call begin() again
+    // The sink task owns the files - ask it to start new segments
+    logFileRotateRequested.store(true);
+    if (logSinkTaskHandle)
+    {
+        xTaskNotifyGive(logSinkTaskHandle);
+    }
+}
+
+const CrashLog &getCrashLog()
+{
+    return crashLog;
+}
+
+const LogHistory &getLogHistory()
+{
+    return logHistory;
+}
+
+const char *getLogComponentName(uint8_t componentId)
+{
+    return logComponents.getName(componentId);
+}
 
-    // Remove old backup if it exists
-    String backupName = String(logFileName) + ".old";
-    if (LittleFS.exists(backupName))
+int getLogFileSegmentNames(String *names, int maxNames)
+{
+    if (!enableFileLogging || logFileBinaryRecords)
     {
-        LittleFS.remove(backupName);
+        return 0;
     }
 
-    // Rename current log to backup
-    if (LittleFS.exists(logFileName))
+    // Oldest first: the segment after the active one was written longest ago
+    int count = 0;
+    int active = textLogFile.getActiveSegment();
+    for (int i = 1; i <= logFileSegmentCount && count < maxNames; i++)
     {
-        LittleFS.rename(logFileName, backupName);
+        String name = textLogFile.getSegmentName((active + i) % logFileSegmentCount);
+        if (LittleFS.exists(name.c_str()))
+        {
+            names[count++] = name;
+        }
     }
+    return count;
 }
 
-String getLogLevelString(int level)
+uint32_t getLogFileFlushedSequence()
+{
+    return logFileFlushedSequence.load();
+}
+
+const char *getResetReasonString()
 {
-    switch (level)
-    {
-    case LOG_LEVEL_SILENT:
-        return "SILENT";
-    case LOG_LEVEL_FATAL:
-        return "FATAL";
-    case LOG_LEVEL_ERROR:
-        return "ERROR";
-    case LOG_LEVEL_WARNING:
-        return "WARNING";
-    case LOG_LEVEL_NOTICE:
-        return "NOTICE";
-    case LOG_LEVEL_TRACE:
-        return "TRACE";
-    case LOG_LEVEL_VERBOSE:
-        return "VERBOSE";
+    switch (esp_reset_reason())
+    {
+    case ESP_RST_POWERON:
+        return "Power-on";
+    case ESP_RST_EXT:
+        return "External reset";
+    case ESP_RST_SW:
+        return "Software reset";
+    case ESP_RST_PANIC:
+        return "Panic/exception";
+    case ESP_RST_INT_WDT:
+        return "Interrupt watchdog";
+    case ESP_RST_TASK_WDT:
+        return "Task watchdog";
+    case ESP_RST_WDT:
+        return "Other watchdog";
+    case ESP_RST_DEEPSLEEP:
+        return "Deep sleep";
+    case ESP_RST_BROWNOUT:
+        return "Brownout";
+    case ESP_RST_SDIO:
+        return "SDIO reset";
     default:
-        return "UNKNOWN";
+        return "Unknown";
     }
 }
 
-void structuredLog(const char *component, int level, const char *format, ...)
+String getLogLevelString(int level)
+{
+    return getLogLevelName(level);
+}
+
+// Copy a log call into the crash log and the ring, and wake the sink
+static void queueLogRecordV(const char *component, uint8_t componentId, int level, const char *format, va_list args)
 {
-    // Check if this log level should be processed
-    if (level > logLevel)
+    // Only the raw arguments are copied here; a full ring drops the record rather than blocking
+    alignas(LogRecord) uint8_t scratch[sizeof(LogRecord) + logRecordMaxArgBytes];
+    LogRecord *record = reinterpret_cast<LogRecord *>(scratch);
+    buildLogRecord(record, componentId, level, millis(), format, args);
+
+    crashLog.add(component, *record); // Kept even if a reset comes before the sink task
+    bool queued = logRing.push(*record);
+
+    if (!queued)
     {
-        return; // Skip logging if level is higher than configured threshold
+        return;
     }
 
-    // Format the message
+    if (logSinkTaskHandle)
+    {
+        xTaskNotifyGive(logSinkTaskHandle);
+    }
+    else if (drainInline && !inlineDrainBusy.exchange(true))
+    {
+        // Ring has one consumer - whoever is already draining picks this record up too
+        drainLogRing();
+        inlineDrainBusy.store(false);
+    }
+}
+
+static void queueLogRecord(const char *component, uint8_t componentId, int level, const char *format, ...)
+{
     va_list args;
     va_start(args, format);
-    char buffer[512];
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    queueLogRecordV(component, componentId, level, format, args);
     va_end(args);
+}
 
-    String message = String(buffer);
-    String levelStr = getLogLevelString(level);
-
-    // Log to Serial/File with component tag (if enabled)
-    if (enableSerialLogging || enableFileLogging)
+void structuredLog(const char *component, int level, const char *format, ...)
+{
+    // Above every component's threshold - don't even look the name up
+    if (!logLevels.mayLog(level))
     {
-        String formattedMessage = "[" + String(getSafeDeviceOwner()) + "] [" + String(component) + "] " + message;
-
-        // Use ArduinoLog for Serial/File outputs
-        switch (level)
-        {
-        case LOG_LEVEL_ERROR:
-            Log.error(formattedMessage.c_str());
-            break;
-        case LOG_LEVEL_WARNING:
-            Log.warning(formattedMessage.c_str());
-            break;
-        case LOG_LEVEL_VERBOSE:
-            Log.verbose(formattedMessage.c_str());
-            break;
-        default:
-            Log.notice(formattedMessage.c_str());
-            break;
-        }
+        return;
     }
 
-    // Send structured logs to MQTT/BetterStack
-    if (enableMQTTLogging && mqttClient.connected())
+    uint8_t componentId = logComponents.intern(component);
+    if (!logLevels.allows(componentId, component, level))
     {
-        logToMQTT(message, levelStr, component);
+        return;
     }
-
-    if (enableBetterStackLogging && WiFi.status() == WL_CONNECTED)
+    if (!logRateLimiter.allow(componentId, level, millis()))
     {
-        logToBetterStack(message, levelStr, component);
+        return; // Counted, and reported by the sink task
     }
+
+    va_list args;
+    va_start(args, format);
+    queueLogRecordV(component, componentId, level, format, args);
+    va_end(args);
+}
+
+void setLogRateLimit(int perMinute, int burst)
+{
+    logRateLimiter.configure(perMinute, burst);
+}
+
+bool setLogLevels(int defaultLevel, const char *componentLevels)
+{
+    return logLevels.configure(defaultLevel, componentLevels);
+}
+
+int getLogLevel()
+{
+    return logLevels.getDefaultLevel();
 }
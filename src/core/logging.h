@@ -27,6 +27,8 @@
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
 #include <config/config.h>
+#include "crash_log.h"
+#include "log_history.h"
 
 /**
  * @file logging.h
@@ -37,38 +39,164 @@
  * - LittleFS file
  * - MQTT topic
  * - BetterStack telemetry
+ *
+ * LOG_* calls only copy the format pointer and raw arguments into a lock-free
+ * ring of binary records (log_record.h, log_ring.h) and return; the text is
+ * formatted later, by whichever sink consumes the record. A low-priority sink task drains the ring to Serial, file and
+ * BetterStack. PubSubClient isn't thread-safe, so MQTT lines are handed back
+ * to the main loop and published from handleLogging(). BetterStack records
+ * are batched into JSON arrays and POSTed over a kept-alive TLS connection
+ * (log_batch.h has the flush and retry policy). The POST blocks the sink task
+ * (up to betterStackHttpTimeoutMs to connect and again for the response), so
+ * Serial and file output stall behind a slow or unreachable BetterStack while
+ * records wait in the ring. The log file is kept open, buffered a block at a
+ * time and rotated across segments (log_file_writer.h).
+ * Each record is also copied to a no-init RAM ring (crash_log.h), so the last
+ * lines before a crash or watchdog reset can be read on the next boot. The
+ * sink keeps recent records in a history (log_history.h) for /api/logs.
+ * Each component and level has its own rate limit (log_rate_limiter.h), so
+ * one flooding component can't swamp the sinks. The level each component logs
+ * at can be changed at runtime (log_level_table.h) without reflashing.
  */
 
 // External MQTT client reference
 extern PubSubClient mqttClient;
 
 /**
- * @brief Initialize the logging system with configured outputs
+ * @brief Initialize the logging system and start the sink task
  */
 void setupLogging();
 
+/**
+ * @brief Publish MQTT log lines queued by the sink task
+ * Call from the main loop. Lines queued while MQTT is down are discarded.
+ */
+void handleLogging();
+
+/**
+ * @brief Wait (up to logFlushTimeoutMs) for the sink task to write queued records and the file buffer
+ * Call before a deliberate restart so its reason reaches the logs.
+ */
+void flushLogs();
+
 /**
  * @brief ESP32-style component logging functions with structured logging support
  */
 void structuredLog(const char *component, int level, const char *format, ...);
 
-#define LOG_NOTICE(component, format, ...) structuredLog(component, LOG_LEVEL_NOTICE, format, ##__VA_ARGS__)
-#define LOG_ERROR(component, format, ...) structuredLog(component, LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
-#define LOG_WARNING(component, format, ...) structuredLog(component, LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
-#define LOG_VERBOSE(component, format, ...) structuredLog(component, LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
+constexpr bool logComponentNamesEqual(const char *a, const char *b)
+{
+    while (*a && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Highest level compiled in for a component (logCompileLevel, or lower per component)
+ */
+constexpr int getLogCompileLevel(const char *component)
+{
+    for (const LogComponentLevel &entry : logComponentCompileLevels)
+    {
+        if (logComponentNamesEqual(entry.component, component))
+        {
+            return entry.maxLevel < logCompileLevel ? entry.maxLevel : logCompileLevel;
+        }
+    }
+    return logCompileLevel;
+}
 
-void logToFile(const char *message);
+// if constexpr discards filtered calls before code generation, even at -O0, so their
+// arguments (String temporaries, getters) are never evaluated. The component must be a
+// string literal - a runtime name fails to compile; call structuredLog() directly for those
+// (the name is copied when interned, so a String or stack buffer is fine there).
+#define LOG_AT_LEVEL(component, level, format, ...)                          \
+    do                                                                       \
+    {                                                                        \
+        if constexpr ((level) <= getLogCompileLevel(component))              \
+        {                                                                    \
+            structuredLog(component, level, format, ##__VA_ARGS__);          \
+        }                                                                    \
+    } while (0)
+
+#define LOG_NOTICE(component, format, ...) LOG_AT_LEVEL(component, LOG_LEVEL_NOTICE, format, ##__VA_ARGS__)
+#define LOG_ERROR(component, format, ...) LOG_AT_LEVEL(component, LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_WARNING(component, format, ...) LOG_AT_LEVEL(component, LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#define LOG_VERBOSE(component, format, ...) LOG_AT_LEVEL(component, LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
 
 /**
- * @brief Log message to MQTT topic with optional component metadata
+ * @brief Log pipeline counters for diagnostics
  */
-void logToMQTT(const char *message, const char *level, const char *component = "");
+struct LoggingStats
+{
+    uint32_t recordsWritten;     // Accepted into the ring
+    uint32_t recordsDropped;     // Ring full - sinks falling behind
+    uint32_t mqttDropped;        // MQTT queue full or MQTT disconnected
+    int recordsQueued;           // Waiting for the sink task
+    uint32_t betterStackSent;    // Delivered in a batch
+    uint32_t betterStackDropped; // Batch full, or batch given up after repeated failures
+    uint32_t fileWrites;         // Buffered writes to the log file
+    uint32_t recordsSuppressed;  // Dropped by the per-component rate limit
+    uint32_t sinkStackFree;      // Least free sink task stack so far, in bytes (0 when logging inline)
+};
+
+LoggingStats getLoggingStats();
 
 /**
- * @brief Log message to BetterStack with component metadata
+ * @brief Log lines kept in no-init RAM, including those from before the last reset
  */
-void logToBetterStack(const char *message, const char *level, const char *component = "");
+const CrashLog &getCrashLog();
 
+/**
+ * @brief Recent records, numbered from boot, for reading back over HTTP
+ */
+const LogHistory &getLogHistory();
+
+/**
+ * @brief Name of an interned log component ("?" if unknown)
+ */
+const char *getLogComponentName(uint8_t componentId);
+
+/**
+ * @brief Text log segments that exist, oldest first (none when logging to binary or not to file)
+ * @return Number of names filled in
+ */
+int getLogFileSegmentNames(String *names, int maxNames);
+
+/**
+ * @brief History sequence of the first record whose text line may not be in the log file yet
+ */
+uint32_t getLogFileFlushedSequence();
+
+/**
+ * @brief Why the chip last reset, e.g. "Panic/exception"
+ */
+const char *getResetReasonString();
+
+/**
+ * @brief Limit each component/level pair to perMinute lines after a burst (0 = no limit)
+ * Dropped lines are reported as "Rate limit: suppressed N messages" every logRateLimitSummaryIntervalMs.
+ */
+void setLogRateLimit(int perMinute, int burst);
+
+/**
+ * @brief Set the runtime level, and per-component overrides such as "MQTT=VERBOSE,WEB=WARNING"
+ * Calls compiled out by logCompileLevel stay out whatever the level.
+ * @return false, changing nothing, if a level or the override text is invalid
+ */
+bool setLogLevels(int defaultLevel, const char *componentLevels);
+
+/**
+ * @brief Runtime level for components without an override
+ */
+int getLogLevel();
+
+/**
+ * @brief Start a new log file segment (done by the sink task)
+ */
 void rotateLogFile();
 
 /**
@@ -76,12 +204,4 @@ void rotateLogFile();
  */
 String getLogLevelString(int level);
 
-// Custom print class for multi-output logging
-class MultiOutputPrint : public Print
-{
-public:
-    size_t write(uint8_t c) override;
-    size_t write(const uint8_t *buffer, size_t size) override;
-};
-
 #endif // LOGGING_H
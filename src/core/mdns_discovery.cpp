@@ -0,0 +1,145 @@
+/**
+ * @file mdns_discovery.cpp
+ * @brief Implementation of mDNS service advertisement and background browsing
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "mdns_discovery.h"
+#include "mdns_record_merge.h"
+#include "printer_discovery.h"
+#include "config_utils.h"
+#include "logging.h"
+#include <config/config.h>
+#include <ESPmDNS.h>
+#include <mdns.h>
+
+static const int mdnsBrowseMaxResults = maxOtherPrinters + 1; // Room for ourselves
+
+static bool serviceAdvertised = false;
+static mdns_search_once_t *activeBrowse = nullptr;
+static unsigned long lastBrowseAt = 0;
+static bool browsedOnce = false;
+
+static void setServiceTxt()
+{
+    MDNS.addServiceTxt(mdnsServiceName, "tcp", "id", getPrinterId().c_str());
+    MDNS.addServiceTxt(mdnsServiceName, "tcp", "name", getLocalPrinterName());
+    MDNS.addServiceTxt(mdnsServiceName, "tcp", "version", getFirmwareVersion().c_str());
+    MDNS.addServiceTxt(mdnsServiceName, "tcp", "scope", getRuntimeConfig().mqttDiscoveryScope.c_str());
+    MDNS.addServiceTxt(mdnsServiceName, "tcp", "groups", getAdvertisedGroups().c_str());
+}
+
+void setupMdnsDiscovery()
+{
+    if (!MDNS.addService(mdnsServiceName, "tcp", webServerPort))
+    {
+        LOG_WARNING("DISCOVERY", "Failed to advertise _%s._tcp", mdnsServiceName);
+        return;
+    }
+
+    serviceAdvertised = true;
+    setServiceTxt();
+    LOG_VERBOSE("DISCOVERY", "Advertising _%s._tcp for LAN discovery", mdnsServiceName);
+}
+
+void updateMdnsServiceTxt()
+{
+    if (serviceAdvertised)
+    {
+        setServiceTxt();
+    }
+}
+
+static const char *findTxtValue(const mdns_result_t *result, const char *key)
+{
+    for (size_t i = 0; i < result->txt_count; i++)
+    {
+        if (strcmp(result->txt[i].key, key) == 0)
+        {
+            return result->txt[i].value ? result->txt[i].value : "";
+        }
+    }
+    return nullptr;
+}
+
+bool handleMdnsDiscovery(DiscoveredPrinterTable &table)
+{
+    unsigned long now = millis();
+
+    if (!activeBrowse)
+    {
+        if (!serviceAdvertised || (browsedOnce && now - lastBrowseAt < mdnsBrowseIntervalMs))
+        {
+            return false;
+        }
+
+        // Runs in the mDNS task; results are collected on a later loop
+        lastBrowseAt = now;
+        browsedOnce = true;
+        String service = String("_") + mdnsServiceName;
+        activeBrowse = mdns_query_async_new(nullptr, service.c_str(), "_tcp", MDNS_TYPE_PTR,
+                                            mdnsBrowseTimeoutMs, mdnsBrowseMaxResults);
+        if (!activeBrowse)
+        {
+            LOG_WARNING("DISCOVERY", "Failed to start mDNS browse");
+        }
+        return false;
+    }
+
+    mdns_result_t *results = nullptr;
+    if (!mdns_query_async_get_results(activeBrowse, 0, &results))
+    {
+        return false; // Still browsing
+    }
+    mdns_query_async_delete(activeBrowse);
+    activeBrowse = nullptr;
+
+    MdnsServiceRecord records[mdnsBrowseMaxResults];
+    char ipAddresses[mdnsBrowseMaxResults][16];
+    int count = 0;
+
+    for (mdns_result_t *result = results; result && count < mdnsBrowseMaxResults; result = result->next)
+    {
+        MdnsServiceRecord &record = records[count];
+        record.printerId = findTxtValue(result, "id");
+        if (!record.printerId)
+        {
+            continue; // Not a Scribe, or TXT not resolved yet
+        }
+        record.name = findTxtValue(result, "name");
+        record.version = findTxtValue(result, "version");
+        record.scope = findTxtValue(result, "scope");
+        record.groups = findTxtValue(result, "groups");
+        record.hostname = result->hostname;
+        record.ipAddress = nullptr;
+
+        for (mdns_ip_addr_t *address = result->addr; address; address = address->next)
+        {
+            if (address->addr.type == ESP_IPADDR_TYPE_V4)
+            {
+                snprintf(ipAddresses[count], sizeof(ipAddresses[count]), IPSTR, IP2STR(&address->addr.u_addr.ip4));
+                record.ipAddress = ipAddresses[count];
+                break;
+            }
+        }
+        count++;
+    }
+
+    unsigned long mergedAt = millis();
+    const char *scope = getRuntimeConfig().mqttDiscoveryScope.c_str();
+    lockDiscoveredPrinters();
+    int changed = mergeMdnsServiceRecords(table, records, count, scope, mergedAt);
+    int expired = expireMdnsOnlyPrinters(table, mergedAt, mdnsPrinterTtlMs);
+    unlockDiscoveredPrinters();
+
+    if (results)
+    {
+        mdns_query_results_free(results);
+    }
+
+    LOG_VERBOSE("DISCOVERY", "mDNS browse found %d printer(s): %d changed, %d expired", count, changed, expired);
+    return changed > 0 || expired > 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file mdns_discovery.h
+ * @brief Broker-less LAN printer discovery via mDNS service records
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Each printer advertises _scribe._tcp with "id", "name", "version" and
+ * "scope" TXT records. A rate-limited background browse merges the printers
+ * it finds into the discovered printer table, so LAN-only installs get
+ * discovery without MQTT.
+ */
+
+#ifndef MDNS_DISCOVERY_H
+#define MDNS_DISCOVERY_H
+
+#include <Arduino.h>
+
+class DiscoveredPrinterTable;
+
+/**
+ * @brief Advertise the _scribe._tcp service (call after MDNS.begin())
+ */
+void setupMdnsDiscovery();
+
+/**
+ * @brief Refresh the TXT records after the name, firmware, scope or groups change
+ */
+void updateMdnsServiceTxt();
+
+/**
+ * @brief Start a browse when due and merge finished results (non-blocking)
+ * @param table Table to merge into
+ * @return true if the table changed
+ */
+bool handleMdnsDiscovery(DiscoveredPrinterTable &table);
+
+#endif // MDNS_DISCOVERY_H
@@ -0,0 +1,96 @@
+/**
+ * @file mdns_record_merge.cpp
+ * @brief Implementation of mDNS browse result merging
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "mdns_record_merge.h"
+
+static const char *orEmpty(const char *value)
+{
+    return value ? value : "";
+}
+
+int mergeMdnsServiceRecords(DiscoveredPrinterTable &table, const MdnsServiceRecord *records, int count,
+                            const char *ourScope, unsigned long now)
+{
+    int changedCount = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        const MdnsServiceRecord &record = records[i];
+
+        if (strcmp(orEmpty(record.scope), orEmpty(ourScope)) != 0)
+        {
+            continue; // Another site's printer on the same LAN
+        }
+
+        bool added = false;
+        DiscoveredPrinter *printer = table.findOrAdd(record.printerId, now, added);
+        if (!printer)
+        {
+            continue; // Missing or oversized ID
+        }
+
+        bool changed = added || !printer->online;
+        if (record.name && record.name[0])
+        {
+            changed |= copyPrinterField(printer->name, record.name);
+        }
+        else if (added)
+        {
+            copyPrinterField(printer->name, "Unknown");
+        }
+        if (record.version && record.version[0])
+        {
+            changed |= copyPrinterField(printer->firmwareVersion, record.version);
+        }
+        if (record.groups)
+        {
+            changed |= copyPrinterField(printer->groups, record.groups);
+        }
+        if (record.hostname && record.hostname[0])
+        {
+            char mdns[sizeof(printer->mdns)];
+            snprintf(mdns, sizeof(mdns), "%s.local", record.hostname);
+            changed |= copyPrinterField(printer->mdns, mdns);
+        }
+        if (record.ipAddress && record.ipAddress[0])
+        {
+            changed |= copyPrinterField(printer->ipAddress, record.ipAddress);
+        }
+
+        printer->online = true;
+        printer->lastSeen = now;
+        printer->sources |= DISCOVERY_SOURCE_MDNS;
+
+        if (changed)
+        {
+            if (!added)
+            {
+                table.markChanged(printer);
+            }
+            changedCount++;
+        }
+    }
+
+    return changedCount;
+}
+
+int expireMdnsOnlyPrinters(DiscoveredPrinterTable &table, unsigned long now, unsigned long ttlMs)
+{
+    int removed = 0;
+    for (int i = table.size() - 1; i >= 0; i--)
+    {
+        const DiscoveredPrinter &printer = table[i];
+        if (printer.sources == DISCOVERY_SOURCE_MDNS && now - printer.lastSeen > ttlMs)
+        {
+            table.remove(printer.printerId);
+            removed++;
+        }
+    }
+    return removed;
+}
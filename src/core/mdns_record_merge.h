@@ -0,0 +1,57 @@
+/**
+ * @file mdns_record_merge.h
+ * @brief Merge mDNS service browse results into the discovered printer table
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Kept free of mDNS/IDF dependencies so the merge rules can be tested on host.
+ */
+
+#ifndef MDNS_RECORD_MERGE_H
+#define MDNS_RECORD_MERGE_H
+
+#include <Arduino.h>
+#include "discovered_printer_table.h"
+
+/**
+ * @brief One _scribe._tcp browse result (TXT records plus resolved address)
+ *
+ * Pointers only need to stay valid for the duration of the merge call.
+ */
+struct MdnsServiceRecord
+{
+    const char *printerId; // TXT "id"
+    const char *name;      // TXT "name"
+    const char *version;   // TXT "version"
+    const char *scope;     // TXT "scope" (empty or nullptr = unscoped)
+    const char *groups;    // TXT "groups", comma-separated (nullptr = not advertised)
+    const char *hostname;  // mDNS hostname without ".local"
+    const char *ipAddress; // First IPv4 address, or nullptr
+};
+
+/**
+ * @brief Merge browse results into the table
+ * @param table Discovered printer table
+ * @param records Browse results
+ * @param count Number of records
+ * @param ourScope This printer's discovery scope (records from other scopes are skipped)
+ * @param now Current millis()
+ * @return Number of entries added or visibly changed
+ *
+ * Only fields mDNS knows about (name, version, groups, mdns, IP) are updated, so
+ * richer MQTT status fields are kept. A printer answering mDNS is online.
+ */
+int mergeMdnsServiceRecords(DiscoveredPrinterTable &table, const MdnsServiceRecord *records, int count,
+                            const char *ourScope, unsigned long now);
+
+/**
+ * @brief Remove printers only ever seen via mDNS that have not answered within ttlMs
+ * @return Number of entries removed
+ *
+ * Printers also seen via MQTT are left to the MQTT LWT and the table TTL.
+ */
+int expireMdnsOnlyPrinters(DiscoveredPrinterTable &table, unsigned long now, unsigned long ttlMs);
+
+#endif // MDNS_RECORD_MERGE_H
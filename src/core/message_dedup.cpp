@@ -0,0 +1,176 @@
+/**
+ * @file message_dedup.cpp
+ * @brief Implementation of recent message ID tracking
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "message_dedup.h"
+#include <config/config.h>
+
+static_assert((messageDedupTableSize & (messageDedupTableSize - 1)) == 0, "messageDedupTableSize must be a power of 2");
+static_assert(messageDedupTableSize > messageDedupCapacity, "messageDedupTableSize must exceed messageDedupCapacity");
+static_assert(messageDedupCapacity <= 127, "ring indices are stored as int8_t");
+
+struct RecentMessageId
+{
+    uint64_t hash;
+    unsigned long seenAt;
+};
+
+// Ring of recent IDs (oldest overwritten first) plus hash slots pointing into it
+static RecentMessageId recentIds[messageDedupCapacity];
+static int8_t hashSlots[messageDedupTableSize];
+static int recentCount = 0;
+static int nextRecent = 0;
+static unsigned long duplicateCount = 0;
+static bool slotsInitialized = false;
+
+// Called from both the MQTT (main loop) and web server (async_tcp) tasks
+static portMUX_TYPE dedupMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const int slotMask = messageDedupTableSize - 1;
+
+// 64-bit FNV-1a - collisions between 32 live IDs are negligible
+static uint64_t hashMessageId(const char *messageId)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = messageId; *p; p++)
+    {
+        hash ^= (uint8_t)*p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int homeSlot(uint64_t hash)
+{
+    return (int)(hash & slotMask);
+}
+
+static void clearSlots()
+{
+    for (int i = 0; i < messageDedupTableSize; i++)
+    {
+        hashSlots[i] = -1;
+    }
+    slotsInitialized = true;
+}
+
+// Returns the hash slot holding this hash, or -1
+static int findSlot(uint64_t hash)
+{
+    for (int slot = homeSlot(hash);; slot = (slot + 1) & slotMask)
+    {
+        int8_t entry = hashSlots[slot];
+        if (entry < 0)
+        {
+            return -1;
+        }
+        if (recentIds[entry].hash == hash)
+        {
+            return slot;
+        }
+    }
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void removeSlot(int slot)
+{
+    int hole = slot;
+    for (int next = (hole + 1) & slotMask; hashSlots[next] >= 0; next = (next + 1) & slotMask)
+    {
+        int home = homeSlot(recentIds[hashSlots[next]].hash);
+        // Move the entry back if its home is not cyclically within (hole, next]
+        bool homeBetween = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!homeBetween)
+        {
+            hashSlots[hole] = hashSlots[next];
+            hole = next;
+        }
+    }
+    hashSlots[hole] = -1;
+}
+
+bool isDuplicateMessage(const char *messageId)
+{
+    if (!messageId || messageId[0] == '\0')
+    {
+        return false;
+    }
+
+    uint64_t hash = hashMessageId(messageId);
+    unsigned long now = millis();
+    bool duplicate = false;
+
+    portENTER_CRITICAL(&dedupMux);
+
+    if (!slotsInitialized)
+    {
+        clearSlots();
+    }
+
+    int slot = findSlot(hash);
+    if (slot >= 0)
+    {
+        RecentMessageId &entry = recentIds[hashSlots[slot]];
+        duplicate = (now - entry.seenAt) < messageDedupWindowMs;
+        if (duplicate)
+        {
+            duplicateCount++;
+        }
+        else
+        {
+            entry.seenAt = now; // Outside the window - treat as new and restart it
+        }
+    }
+    else
+    {
+        // Evict the oldest ID when the ring is full
+        if (recentCount == messageDedupCapacity)
+        {
+            removeSlot(findSlot(recentIds[nextRecent].hash));
+        }
+        else
+        {
+            recentCount++;
+        }
+
+        recentIds[nextRecent].hash = hash;
+        recentIds[nextRecent].seenAt = now;
+
+        int insertAt = homeSlot(hash);
+        while (hashSlots[insertAt] >= 0)
+        {
+            insertAt = (insertAt + 1) & slotMask;
+        }
+        hashSlots[insertAt] = nextRecent;
+
+        nextRecent = (nextRecent + 1) % messageDedupCapacity;
+    }
+
+    portEXIT_CRITICAL(&dedupMux);
+    return duplicate;
+}
+
+void resetMessageDedup()
+{
+    portENTER_CRITICAL(&dedupMux);
+    clearSlots();
+    recentCount = 0;
+    nextRecent = 0;
+    duplicateCount = 0;
+    portEXIT_CRITICAL(&dedupMux);
+}
+
+unsigned long getDuplicateMessageCount()
+{
+    return duplicateCount;
+}
+
+int getTrackedMessageIdCount()
+{
+    return recentCount;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file message_dedup.h
+ * @brief Duplicate suppression for print messages carrying a message ID
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Senders that retry (QoS 1 redelivery, Shortcuts/Pipedream retries) can attach
+ * an "id" to a message. The last messageDedupCapacity IDs are kept in a ring,
+ * indexed by an open-addressing hash table, so a repeat within
+ * messageDedupWindowMs is dropped before any processing or printing.
+ */
+
+#ifndef MESSAGE_DEDUP_H
+#define MESSAGE_DEDUP_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Check a message ID and remember it
+ * @param messageId Sender-supplied ID (empty IDs are never duplicates)
+ * @return true if the same ID was seen within messageDedupWindowMs
+ */
+bool isDuplicateMessage(const char *messageId);
+
+/**
+ * @brief Forget all remembered IDs and reset counters
+ */
+void resetMessageDedup();
+
+/**
+ * @brief Number of messages dropped as duplicates since boot
+ */
+unsigned long getDuplicateMessageCount();
+
+/**
+ * @brief Number of message IDs currently remembered
+ */
+int getTrackedMessageIdCount();
+
+#endif // MESSAGE_DEDUP_H
@@ -0,0 +1,310 @@
+/**
+ * @file mqtt_broker_pool.cpp
+ * @brief Implementation of MQTT broker failover and health scoring
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "mqtt_broker_pool.h"
+#include "logging.h"
+#include <WiFiClient.h>
+#include <lwip/dns.h>
+#include <atomic>
+
+MqttBrokerPool::MqttBrokerPool()
+    : brokerCount(0), activeIndex(0), coolingDown(false), cooldownStartedAt(0), lastProbeAt(0),
+      probeIntervalMs(mqttPreferredProbeIntervalMs), failbackPending(false)
+{
+}
+
+void MqttBrokerPool::addBroker(const String &host, int port)
+{
+    if (brokerCount >= maxMqttBrokers)
+    {
+        LOG_WARNING("MQTT", "Broker list full (%d) - ignoring %s:%d", maxMqttBrokers, host.c_str(), port);
+        return;
+    }
+
+    MqttBrokerHealth &broker = brokers[brokerCount++];
+    broker = MqttBrokerHealth();
+    broker.host = host;
+    broker.port = port;
+}
+
+int MqttBrokerPool::configure(const String &primaryHost, int primaryPort, const String &fallbackList)
+{
+    brokerCount = 0;
+    activeIndex = 0;
+    coolingDown = false;
+    cooldownStartedAt = 0;
+    lastProbeAt = 0;
+    probeIntervalMs = mqttPreferredProbeIntervalMs;
+    failbackPending = false;
+
+    addBroker(primaryHost, primaryPort);
+
+    int start = 0;
+    while (start < (int)fallbackList.length())
+    {
+        int comma = fallbackList.indexOf(',', start);
+        if (comma < 0)
+        {
+            comma = fallbackList.length();
+        }
+
+        String entry = fallbackList.substring(start, comma);
+        entry.trim();
+        start = comma + 1;
+        if (entry.length() == 0)
+        {
+            continue;
+        }
+
+        String host = entry;
+        int port = primaryPort;
+        int colon = entry.lastIndexOf(':');
+        if (colon > 0)
+        {
+            host = entry.substring(0, colon);
+            port = entry.substring(colon + 1).toInt();
+        }
+
+        if (host.length() == 0 || port < 1 || port > 65535)
+        {
+            LOG_WARNING("MQTT", "Ignoring invalid fallback broker: %s", entry.c_str());
+            continue;
+        }
+        addBroker(host, port);
+    }
+
+    return brokerCount;
+}
+
+int MqttBrokerPool::getHealthScore(int index) const
+{
+    const MqttBrokerHealth &broker = brokers[index];
+    int score = 100;
+
+    // Recent failures dominate
+    score -= min(broker.consecutiveFailures * 25, 75);
+
+    // Slow brokers lose up to 20 points (4s+ average connect)
+    if (broker.avgConnectMs > 0)
+    {
+        score -= (int)min(broker.avgConnectMs / 200, 20UL);
+    }
+
+    // A broker never seen working ranks below one that has
+    if (!broker.hasSucceeded)
+    {
+        score -= 5;
+    }
+
+    return max(score, 0);
+}
+
+int MqttBrokerPool::selectHealthiest() const
+{
+    int best = -1;
+    for (int i = 0; i < brokerCount; i++)
+    {
+        if (brokers[i].roundFailures >= mqttFailoverThreshold)
+        {
+            continue;
+        }
+        // Strictly greater keeps the earlier (more preferred) broker on ties
+        if (best < 0 || getHealthScore(i) > getHealthScore(best))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void MqttBrokerPool::startRound()
+{
+    for (int i = 0; i < brokerCount; i++)
+    {
+        brokers[i].roundFailures = 0;
+    }
+}
+
+void MqttBrokerPool::recordSuccess(unsigned long connectMs, unsigned long now)
+{
+    MqttBrokerHealth &broker = brokers[activeIndex];
+    broker.avgConnectMs = broker.avgConnectMs == 0 ? max(connectMs, 1UL) : (broker.avgConnectMs * 3 + connectMs) / 4;
+    broker.consecutiveFailures = 0;
+    broker.totalSuccesses++;
+    broker.lastSuccessAt = now;
+    broker.hasSucceeded = true;
+
+    coolingDown = false;
+    startRound();
+
+    if (failbackPending)
+    {
+        failbackPending = false;
+        probeIntervalMs = mqttPreferredProbeIntervalMs;
+    }
+}
+
+MqttFailoverAction MqttBrokerPool::recordFailure(unsigned long now)
+{
+    MqttBrokerHealth &broker = brokers[activeIndex];
+    broker.consecutiveFailures++;
+    broker.roundFailures++;
+    broker.totalFailures++;
+    broker.lastFailureAt = now;
+
+    if (failbackPending)
+    {
+        // Took TCP but not MQTT (TLS or credentials) - back to a fallback now, and probe less often
+        failbackPending = false;
+        probeIntervalMs = min(probeIntervalMs * 2, mqttPreferredProbeMaxIntervalMs);
+        broker.roundFailures = max(broker.roundFailures, mqttFailoverThreshold);
+    }
+
+    if (broker.roundFailures < getFailureLimit())
+    {
+        return MqttFailoverAction::RETRY_SAME;
+    }
+
+    int next = selectHealthiest();
+    if (next >= 0)
+    {
+        LOG_WARNING("MQTT", "Broker %s:%d failed %d times - failing over to %s:%d",
+                    broker.host.c_str(), broker.port, broker.roundFailures,
+                    brokers[next].host.c_str(), brokers[next].port);
+        activeIndex = next;
+        lastProbeAt = now; // First probe of the preferred broker after a full interval
+        return MqttFailoverAction::FAILED_OVER;
+    }
+
+    coolingDown = true;
+    cooldownStartedAt = now;
+    return MqttFailoverAction::COOLDOWN;
+}
+
+int MqttBrokerPool::getFailureLimit() const
+{
+    for (int i = 0; i < brokerCount; i++)
+    {
+        if (i != activeIndex && brokers[i].roundFailures < mqttFailoverThreshold)
+        {
+            return mqttFailoverThreshold; // Somewhere to fail over to - move on sooner
+        }
+    }
+    return mqttMaxConsecutiveFailures;
+}
+
+bool MqttBrokerPool::isInCooldown(unsigned long now)
+{
+    if (!coolingDown)
+    {
+        return false;
+    }
+    if (now - cooldownStartedAt < mqttFailureCooldownMs)
+    {
+        return true;
+    }
+
+    // Cooldown over - give every broker a fresh round, best first
+    coolingDown = false;
+    startRound();
+    activeIndex = selectHealthiest();
+    LOG_NOTICE("MQTT", "Broker cooldown expired - retrying with %s:%d",
+               brokers[activeIndex].host.c_str(), brokers[activeIndex].port);
+    return false;
+}
+
+bool MqttBrokerPool::isProbeDue(unsigned long now) const
+{
+    return activeIndex != 0 && !coolingDown && now - lastProbeAt >= probeIntervalMs;
+}
+
+bool MqttBrokerPool::recordProbe(bool reachable, unsigned long now)
+{
+    lastProbeAt = now;
+    if (!reachable || activeIndex == 0)
+    {
+        return false;
+    }
+
+    brokers[0].roundFailures = 0;
+    activeIndex = 0;
+    failbackPending = true;
+    return true;
+}
+
+// Result of the lookup in flight, written by lwIP's DNS callback on the tcpip task
+enum : uint8_t
+{
+    lookupIdle,
+    lookupPending,
+    lookupFound,
+    lookupFailed
+};
+static std::atomic<uint8_t> lookupState(lookupIdle);
+static uint32_t lookupAddress;
+
+static void onBrokerDnsFound(const char *name, const ip_addr_t *found, void *arg)
+{
+    if (found && IP_IS_V4(found))
+    {
+        lookupAddress = ip_2_ip4(found)->addr;
+        lookupState.store(lookupFound, std::memory_order_release);
+    }
+    else
+    {
+        lookupState.store(lookupFailed, std::memory_order_release);
+    }
+}
+
+BrokerLookup resolveBrokerAddress(const char *host, IPAddress &address)
+{
+    if (address.fromString(host))
+    {
+        return BrokerLookup::FOUND;
+    }
+
+    switch (lookupState.load(std::memory_order_acquire))
+    {
+    case lookupPending:
+        return BrokerLookup::PENDING;
+    case lookupFound:
+        address = IPAddress(lookupAddress);
+        lookupState.store(lookupIdle);
+        return BrokerLookup::FOUND;
+    case lookupFailed:
+        lookupState.store(lookupIdle);
+        return BrokerLookup::FAILED;
+    default:
+        break;
+    }
+
+    // Answered from lwIP's cache, or queued with the callback run later
+    ip_addr_t cached;
+    lookupState.store(lookupPending);
+    err_t err = dns_gethostbyname(host, &cached, onBrokerDnsFound, nullptr);
+    if (err == ERR_INPROGRESS)
+    {
+        return BrokerLookup::PENDING;
+    }
+    lookupState.store(lookupIdle);
+    if (err == ERR_OK && IP_IS_V4(&cached))
+    {
+        address = IPAddress(ip_2_ip4(&cached)->addr);
+        return BrokerLookup::FOUND;
+    }
+    return BrokerLookup::FAILED;
+}
+
+bool probeBrokerReachable(const IPAddress &address, int port, unsigned long timeoutMs)
+{
+    WiFiClient probe;
+    bool reachable = probe.connect(address, port, timeoutMs);
+    probe.stop();
+    return reachable;
+}
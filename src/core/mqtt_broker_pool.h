@@ -0,0 +1,145 @@
+/**
+ * @file mqtt_broker_pool.h
+ * @brief Ordered MQTT broker list with health scoring and failover
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * The primary broker (mqtt.server/mqtt.port) is preferred, followed by the
+ * fallbacks in mqtt.fallbackServers. After mqttFailoverThreshold failures on
+ * one broker the pool fails over to the healthiest broker not yet exhausted
+ * this round. The last broker left - the only one, without fallbacks - gets
+ * mqttMaxConsecutiveFailures attempts before the pool cools down for
+ * mqttFailureCooldownMs. While on a fallback the preferred broker is probed
+ * every mqttPreferredProbeIntervalMs so the device can return to it. The
+ * probe only proves TCP, so a switch back counts once MQTT connects there; if
+ * that fails the pool returns to a fallback at once and doubles the probe
+ * interval (up to mqttPreferredProbeMaxIntervalMs). The broker's name is
+ * resolved without blocking first (resolveBrokerAddress), leaving a TCP
+ * connect of up to mqttBrokerProbeTimeoutMs as the only wait.
+ *
+ * The pool holds no network state - callers report outcomes and timestamps,
+ * which keeps the policy testable without a broker.
+ */
+
+#ifndef MQTT_BROKER_POOL_H
+#define MQTT_BROKER_POOL_H
+
+#include <Arduino.h>
+#include <config/config.h>
+
+struct MqttBrokerHealth
+{
+    String host;
+    int port;
+    unsigned long avgConnectMs;  // EWMA of successful connect time (0 = never connected)
+    int consecutiveFailures;     // Failures since last success
+    int roundFailures;           // Failures in the current failover round
+    unsigned long totalSuccesses;
+    unsigned long totalFailures;
+    unsigned long lastSuccessAt; // millis() of last successful connect
+    unsigned long lastFailureAt;
+    bool hasSucceeded;
+};
+
+enum class MqttFailoverAction
+{
+    RETRY_SAME,  // Keep trying the current broker
+    FAILED_OVER, // Switched to another broker - retry immediately
+    COOLDOWN     // Every broker failed - wait mqttFailureCooldownMs
+};
+
+class MqttBrokerPool
+{
+public:
+    MqttBrokerPool();
+
+    /**
+     * @brief Rebuild the broker list and reset health
+     * @param primaryHost Preferred broker host
+     * @param primaryPort Preferred broker port
+     * @param fallbackList Comma-separated "host:port" entries (port defaults to primaryPort)
+     * @return Number of brokers configured
+     */
+    int configure(const String &primaryHost, int primaryPort, const String &fallbackList);
+
+    int getBrokerCount() const { return brokerCount; }
+    int getActiveIndex() const { return activeIndex; }
+    const MqttBrokerHealth &getBroker(int index) const { return brokers[index]; }
+    const MqttBrokerHealth &getActiveBroker() const { return brokers[activeIndex]; }
+
+    /**
+     * @brief Record a successful connect to the active broker
+     */
+    void recordSuccess(unsigned long connectMs, unsigned long now);
+
+    /**
+     * @brief Record a failed connect to the active broker and apply failover policy
+     */
+    MqttFailoverAction recordFailure(unsigned long now);
+
+    /**
+     * @brief Failed attempts the active broker gets before the pool moves on
+     * @return mqttFailoverThreshold while another broker is left this round, else mqttMaxConsecutiveFailures
+     */
+    int getFailureLimit() const;
+
+    /**
+     * @brief Whether all brokers failed recently; ends the round once the cooldown expires
+     */
+    bool isInCooldown(unsigned long now);
+
+    /**
+     * @brief Health score 0-100 from failures, connect latency and success history
+     */
+    int getHealthScore(int index) const;
+
+    /**
+     * @brief Whether the preferred broker should be probed (only while on a fallback)
+     */
+    bool isProbeDue(unsigned long now) const;
+
+    /**
+     * @brief Record a probe of the preferred broker
+     * @return true if the caller should reconnect to the preferred broker
+     */
+    bool recordProbe(bool reachable, unsigned long now);
+
+    unsigned long getProbeIntervalMs() const { return probeIntervalMs; }
+
+private:
+    MqttBrokerHealth brokers[maxMqttBrokers];
+    int brokerCount;
+    int activeIndex;
+    bool coolingDown;
+    unsigned long cooldownStartedAt;
+    unsigned long lastProbeAt;
+    unsigned long probeIntervalMs;
+    bool failbackPending; // Switched back on a probe; no MQTT connect there yet
+
+    void addBroker(const String &host, int port);
+    int selectHealthiest() const;
+    void startRound();
+};
+
+enum class BrokerLookup
+{
+    PENDING, // Lookup running - ask again on a later loop
+    FOUND,
+    FAILED
+};
+
+/**
+ * @brief Resolve a broker host without blocking (one lookup at a time)
+ * @param address Set when FOUND; IP literals are found straight away
+ */
+BrokerLookup resolveBrokerAddress(const char *host, IPAddress &address);
+
+/**
+ * @brief Check a broker accepts TCP connections (no TLS/MQTT handshake)
+ * @return true if the connection opened within timeoutMs
+ */
+bool probeBrokerReachable(const IPAddress &address, int port, unsigned long timeoutMs);
+
+#endif // MQTT_BROKER_POOL_H
@@ -5,9 +5,16 @@
 #include "config_utils.h"
 #include "config_loader.h"
 #include "printer_discovery.h"
+#include "mqtt_multipart.h"
+#include "mqtt_topic_router.h"
+#include "message_dedup.h"
+#include "delivery_tracker.h"
+#include "mqtt_broker_pool.h"
+#include "log_level_table.h"
 #include <content/memo_handler.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
+#include <algorithm>
 
 // MQTT objects
 WiFiClientSecure wifiSecureClient;
@@ -27,8 +34,21 @@ static unsigned long stateChangeTime = 0;
 
 // MQTT connection management (using config.h values)
 unsigned long lastMQTTReconnectAttempt = 0;
-static int consecutiveFailures = 0;
-static unsigned long lastFailureTime = 0;
+static MqttBrokerPool brokerPool;
+static bool reconnectImmediately = false; // Set after failover so the next broker is tried at once
+
+// Start/stop requests from other tasks (config saves), carried out by handleMQTTConnection()
+enum MQTTClientRequest : uint8_t {
+    MQTT_REQUEST_NONE,
+    MQTT_REQUEST_START,
+    MQTT_REQUEST_STOP,
+    MQTT_REQUEST_RESTART
+};
+static MQTTClientRequest pendingClientRequest = MQTT_REQUEST_NONE;
+static bool pendingStartImmediate = true;
+static bool pendingLeaveScope = false;
+static char pendingLeaveScopeName[maxMqttGroupNameLength + 1];
+static portMUX_TYPE clientRequestMux = portMUX_INITIALIZER_UNLOCKED;
 
 // Track current subscription
 String currentSubscribedTopic = "";
@@ -39,6 +59,180 @@ static String caCertificateBuffer;
 // Guard to prevent duplicate MQTT initialization
 static bool mqttSetupCompleted = false;
 
+// Incoming topic dispatch (rebuilt whenever subscriptions change)
+static MQTTTopicRouter topicRouter;
+
+// Group names are a single topic level: letters, digits, '-' and '_'
+bool isValidMqttGroupName(const String &name)
+{
+    if (name.length() == 0 || name.length() > maxMqttGroupNameLength)
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < name.length(); i++)
+    {
+        char c = name[i];
+        if (!isalnum((unsigned char)c) && c != '-' && c != '_')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<String> getMqttGroupNames()
+{
+    std::vector<String> names;
+    const String &groups = getRuntimeConfig().mqttGroups;
+
+    int start = 0;
+    while (start <= (int)groups.length() && (int)names.size() < maxMqttGroups)
+    {
+        int comma = groups.indexOf(',', start);
+        if (comma < 0)
+        {
+            comma = groups.length();
+        }
+
+        String name = groups.substring(start, comma);
+        name.trim();
+        if (isValidMqttGroupName(name))
+        {
+            // A repeat ("kitchen, kitchen") would route each group message to two handlers
+            if (std::find(names.begin(), names.end(), name) == names.end())
+            {
+                names.push_back(name);
+            }
+        }
+        else if (name.length() > 0)
+        {
+            LOG_WARNING("MQTT", "Ignoring invalid MQTT group name: %s", name.c_str());
+        }
+        start = comma + 1;
+    }
+    return names;
+}
+
+// Group topics from config ("kitchen, office" -> scribe/group/kitchen, scribe/group/office)
+static std::vector<String> getMqttGroupTopics()
+{
+    std::vector<String> topics;
+    for (const String &name : getMqttGroupNames())
+    {
+        topics.push_back(String(mqttGroupTopicPrefix) + name);
+    }
+    return topics;
+}
+
+static void onPrintTopicMessage(const String &topic, const String &message)
+{
+    handleMQTTMessage(topic, message);
+}
+
+static String getAckTopic()
+{
+    return String(mqttAckTopicPrefix) + getPrinterId();
+}
+
+static void onDeliveryAckMessage(const String &topic, const String &message)
+{
+    DynamicJsonDocument doc(512);
+    DeserializationError error = deserializeJson(doc, message);
+    if (error)
+    {
+        LOG_WARNING("MQTT", "Failed to parse delivery ack: %s", error.c_str());
+        return;
+    }
+
+    const char *messageId = doc["id"] | "";
+    const char *printerId = doc["printer_id"] | "";
+    if (recordDeliveryAck(messageId, printerId, doc["status"] | "printed",
+                          doc["print_start_ms"] | 0UL, doc["print_done_ms"] | 0UL))
+    {
+        LOG_VERBOSE("MQTT", "Delivery ack for %s from %s", messageId, printerId);
+    }
+    else
+    {
+        LOG_VERBOSE("MQTT", "Ack for untracked message %s ignored", messageId);
+    }
+}
+
+static String getLogLevelTopic()
+{
+    return String(mqttLogLevelTopicPrefix) + getPrinterId();
+}
+
+// Same fields as the logging section of /api/config; saved, so they survive a restart
+static void onLogLevelMessage(const String &topic, const String &message)
+{
+    StaticJsonDocument<512> doc;
+    DeserializationError error = deserializeJson(doc, message);
+    if (error)
+    {
+        LOG_WARNING("MQTT", "Failed to parse log level message: %s", error.c_str());
+        return;
+    }
+
+    RuntimeConfig config = getRuntimeConfig();
+    JsonVariant level = doc["level"];
+    if (!level.isNull())
+    {
+        config.logLevel = level.is<const char *>() ? parseLogLevel(level.as<const char *>()) : level.as<int>();
+    }
+    if (doc.containsKey("componentLevels"))
+    {
+        config.logComponentLevels = doc["componentLevels"] | "";
+        config.logComponentLevels.trim();
+    }
+
+    if (config.logLevel < LOG_LEVEL_SILENT || config.logLevel > LOG_LEVEL_VERBOSE ||
+        config.logComponentLevels.length() > (size_t)maxLogComponentLevelsLength ||
+        !LogLevelTable::parse(config.logComponentLevels.c_str(), nullptr, 0, nullptr))
+    {
+        LOG_WARNING("MQTT", "Ignoring invalid log levels from %s", topic.c_str());
+        return;
+    }
+
+    // Retained, so the same levels arrive again on every reconnect - don't rewrite NVS for them
+    const RuntimeConfig &current = getRuntimeConfig();
+    if (config.logLevel == current.logLevel && config.logComponentLevels == current.logComponentLevels)
+    {
+        LOG_VERBOSE("MQTT", "Log levels from %s unchanged", topic.c_str());
+        return;
+    }
+
+    if (!saveNVSConfig(config))
+    {
+        LOG_ERROR("MQTT", "Failed to save log levels");
+        return;
+    }
+    setRuntimeConfig(config);
+    LOG_NOTICE("MQTT", "Log level %s, components: %s", getLogLevelString(config.logLevel).c_str(),
+               config.logComponentLevels.length() > 0 ? config.logComponentLevels.c_str() : "(none)");
+}
+
+static void rebuildTopicRoutes()
+{
+    topicRouter.clear();
+
+    if (currentSubscribedTopic.length() > 0)
+    {
+        topicRouter.addRoute(currentSubscribedTopic.c_str(), onPrintTopicMessage);
+    }
+    topicRouter.addRoute(getPrinterStatusFilter().c_str(), onPrinterStatusMessage);
+    topicRouter.addRoute(getPrinterPingFilter().c_str(), onPrinterPingMessage);
+    topicRouter.addRoute(mqttBroadcastTopic, onPrintTopicMessage);
+    topicRouter.addRoute(getAckTopic().c_str(), onDeliveryAckMessage);
+    topicRouter.addRoute(getLogLevelTopic().c_str(), onLogLevelMessage);
+
+    for (const String &groupTopic : getMqttGroupTopics())
+    {
+        topicRouter.addRoute(groupTopic.c_str(), onPrintTopicMessage);
+    }
+
+    LOG_VERBOSE("MQTT", "Topic router rebuilt with %d routes", topicRouter.getRouteCount());
+}
+
 // === MQTT Functions ===
 void setupMQTT()
 {
@@ -87,16 +281,15 @@ void setupMQTT()
     // Ensure MQTT client uses the refreshed secure client
     mqttClient.setClient(wifiSecureClient);
     
-    // Configure MQTT client
-    const RuntimeConfig &config = getRuntimeConfig();
-    mqttClient.setServer(config.mqttServer.c_str(), config.mqttPort);
+    // Configure MQTT client (server is set per attempt from the broker pool)
     mqttClient.setCallback(mqttCallback);
     mqttClient.setBufferSize(mqttBufferSize);
 
     // Don't call connectToMQTT() here anymore - let state machine handle it
 
     const char* tlsMode = mqttClient.connected() ? "Secure (TLS with CA verification)" : "Secure (TLS configured, connection pending)";
-    LOG_NOTICE("MQTT", "MQTT server configured: %s:%d | Inbox topic: %s | TLS mode: %s | Buffer size: %d bytes", config.mqttServer.c_str(), config.mqttPort, getLocalPrinterTopic(), tlsMode, mqttBufferSize);
+    const MqttBrokerHealth &broker = brokerPool.getActiveBroker();
+    LOG_NOTICE("MQTT", "MQTT server configured: %s:%d (%d brokers) | Inbox topic: %s | TLS mode: %s | Buffer size: %d bytes", broker.host.c_str(), broker.port, brokerPool.getBrokerCount(), getLocalPrinterTopic(), tlsMode, mqttBufferSize);
     
     // Mark setup as completed
     mqttSetupCompleted = true;
@@ -119,22 +312,17 @@ void connectToMQTT()
         return;
     }
     
-    // Check if we should skip connection due to consecutive failures
-    if (consecutiveFailures >= mqttMaxConsecutiveFailures)
+    // Skip connection while every broker is cooling down after failures
+    if (brokerPool.isInCooldown(millis()))
     {
-        if (millis() - lastFailureTime < mqttFailureCooldownMs)
-        {
-            LOG_VERBOSE("MQTT", "Still in cooldown period, returning to disconnected state");
-            mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
-            return;
-        }
-        else
-        {
-            LOG_NOTICE("MQTT", "Cooldown period expired, resetting failure count and attempting reconnection");
-            consecutiveFailures = 0;
-        }
+        LOG_VERBOSE("MQTT", "Still in cooldown period, returning to disconnected state");
+        mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
+        return;
     }
 
+    const MqttBrokerHealth &broker = brokerPool.getActiveBroker();
+    mqttClient.setServer(broker.host.c_str(), broker.port);
+
     // Debug socket state before connection attempt
     LOG_VERBOSE("MQTT", "Connection attempt - WiFi status: %d, wifiSecureClient.connected(): %d", 
                WiFi.status(), wifiSecureClient.connected());
@@ -162,7 +350,7 @@ void connectToMQTT()
     bool connected = false;
 
     // Set up LWT for printer discovery
-    String statusTopic = "scribe/printer-status/" + printerId;
+    String statusTopic = getPrinterStatusTopic(printerId);
 
     // Use the same offline payload format as graceful shutdown
     String lwtPayload = createOfflinePayload();
@@ -172,6 +360,8 @@ void connectToMQTT()
     
     // Set timeout to prevent blocking (already set above, but ensuring consistency)
     wifiSecureClient.setTimeout(mqttTlsHandshakeTimeoutMs);
+
+    unsigned long connectStart = millis();
     
     try {
         if (config.mqttUsername.length() > 0 && config.mqttPassword.length() > 0)
@@ -204,9 +394,9 @@ void connectToMQTT()
     {
         // Connection successful - update state
         mqttState = MQTT_STATE_CONNECTED;
-        consecutiveFailures = 0;
+        brokerPool.recordSuccess(millis() - connectStart, millis());
         
-        LOG_NOTICE("MQTT", "✅ Connected to broker");
+        LOG_NOTICE("MQTT", "✅ Connected to broker %s:%d", broker.host.c_str(), broker.port);
         
         // Subscribe to the inbox topic
         String newTopic = String(getLocalPrinterTopic());
@@ -221,15 +411,56 @@ void connectToMQTT()
         }
 
         // Subscribe to printer discovery topics to immediately process retained messages
-        if (!mqttClient.subscribe("scribe/printer-status/+"))
+        // (only this printer's discovery scope, so the retained backlog is bounded by the scope)
+        String statusFilter = getPrinterStatusFilter();
+        if (!mqttClient.subscribe(statusFilter.c_str()))
         {
             LOG_WARNING("MQTT", "Failed to subscribe to printer status topics");
         }
         else
         {
-            LOG_VERBOSE("MQTT", "Subscribed to printer discovery topics. Should receive retained messages immediately");
+            LOG_VERBOSE("MQTT", "Subscribed to %s. Should receive retained messages immediately", statusFilter.c_str());
         }
 
+        // Liveness pings keep discovered printers from expiring between status changes
+        if (!mqttClient.subscribe(getPrinterPingFilter().c_str()))
+        {
+            LOG_WARNING("MQTT", "Failed to subscribe to printer ping topics");
+        }
+
+        // Subscribe to delivery acks for remote prints we send
+        String ackTopic = getAckTopic();
+        if (!mqttClient.subscribe(ackTopic.c_str()))
+        {
+            LOG_WARNING("MQTT", "Failed to subscribe to ack topic: %s", ackTopic.c_str());
+        }
+
+        // Subscribe to runtime log level changes for this printer
+        String logLevelTopic = getLogLevelTopic();
+        if (!mqttClient.subscribe(logLevelTopic.c_str()))
+        {
+            LOG_WARNING("MQTT", "Failed to subscribe to log level topic: %s", logLevelTopic.c_str());
+        }
+
+        // Subscribe to broadcast and group print topics
+        if (!mqttClient.subscribe(mqttBroadcastTopic))
+        {
+            LOG_WARNING("MQTT", "Failed to subscribe to broadcast topic: %s", mqttBroadcastTopic);
+        }
+        for (const String &groupTopic : getMqttGroupTopics())
+        {
+            if (mqttClient.subscribe(groupTopic.c_str()))
+            {
+                LOG_VERBOSE("MQTT", "Subscribed to group topic: %s", groupTopic.c_str());
+            }
+            else
+            {
+                LOG_WARNING("MQTT", "Failed to subscribe to group topic: %s", groupTopic.c_str());
+            }
+        }
+
+        rebuildTopicRoutes();
+
         // Publish initial online status immediately after connection
         LOG_NOTICE("MQTT", "Publishing initial online status after connection");
         publishPrinterStatus();
@@ -238,17 +469,23 @@ void connectToMQTT()
     {
         // Connection failed - return to disconnected state
         mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
-        consecutiveFailures++;
-        lastFailureTime = millis();
         
         int state = mqttClient.state();
-        LOG_WARNING("MQTT", "MQTT connection failed (attempt %d/%d), state: %d - Will retry in %lums", 
-                   consecutiveFailures, mqttMaxConsecutiveFailures, state, mqttReconnectIntervalMs);
+        LOG_WARNING("MQTT", "MQTT connection to %s:%d failed (attempt %d/%d), state: %d", 
+                   broker.host.c_str(), broker.port, broker.roundFailures + 1, brokerPool.getFailureLimit(), state);
         
-        if (consecutiveFailures >= mqttMaxConsecutiveFailures)
+        switch (brokerPool.recordFailure(millis()))
         {
-            LOG_ERROR("MQTT", "Too many consecutive MQTT failures (%d), entering cooldown mode for %lums to prevent system instability", 
-                     mqttMaxConsecutiveFailures, mqttFailureCooldownMs);
+            case MqttFailoverAction::RETRY_SAME:
+                LOG_VERBOSE("MQTT", "Will retry in %lums", mqttReconnectIntervalMs);
+                break;
+            case MqttFailoverAction::FAILED_OVER:
+                reconnectImmediately = true;
+                break;
+            case MqttFailoverAction::COOLDOWN:
+                LOG_ERROR("MQTT", "All %d MQTT brokers failing, entering cooldown mode for %lums to prevent system instability", 
+                         brokerPool.getBrokerCount(), mqttFailureCooldownMs);
+                break;
         }
     }
 }
@@ -258,40 +495,71 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
     LOG_VERBOSE("MQTT", "MQTT message received on topic: %s", topic);
 
     // Convert payload to string
-    String message = "";
-    for (unsigned int i = 0; i < length; i++)
-    {
-        message += (char)payload[i];
-    }
+    String message;
+    message.reserve(length);
+    message.concat((const char *)payload, length);
 
     LOG_VERBOSE("MQTT", "MQTT payload: %s", message.c_str());
 
     String topicStr = String(topic);
 
-    // Check if this is a printer status message
-    if (topicStr.startsWith("scribe/printer-status/"))
-    {
-        onPrinterStatusMessage(topicStr, message);
-    }
-    else
+    if (topicRouter.dispatch(topicStr, message) == 0)
     {
-        // Handle regular print messages - pass topic to extract sender
-        handleMQTTMessage(topicStr, message);
+        LOG_WARNING("MQTT", "No handler for MQTT topic: %s", topic);
     }
 }
 
-void handleMQTTMessage(String topic, String message)
+// Size the parse document from the payload (strings are copied into the pool)
+static size_t mqttJsonCapacity(size_t payloadLength)
 {
-    // Parse JSON message
-    DynamicJsonDocument doc(4096); // Increased to match MQTT buffer size
-    DeserializationError error = deserializeJson(doc, message);
+    size_t capacity = payloadLength + 1024;
+    return capacity < 4096 ? 4096 : capacity;
+}
 
-    if (error)
+// Unique per sender: printer ID + uptime + wrapping counter
+String generateMessageId()
+{
+    static unsigned long messageCounter = 0;
+    return getPrinterId() + "-" + String(millis(), HEX) + "-" + String(++messageCounter % 1000);
+}
+
+// Reply to a sender that asked for an ack ("reply_to"); offsets are ms since receipt
+static void sendDeliveryAck(const char *replyTo, const char *messageId, const char *status,
+                            unsigned long printStartMs, unsigned long printDoneMs)
+{
+    if (!replyTo || replyTo[0] == '\0' || !messageId || messageId[0] == '\0')
+    {
+        return;
+    }
+
+    // Only answer on ack topics so a message can't make us publish anywhere else
+    String ackTopic = replyTo;
+    if (!ackTopic.startsWith(mqttAckTopicPrefix) || ackTopic.length() > maxMqttTopicLength ||
+        ackTopic.indexOf('+') >= 0 || ackTopic.indexOf('#') >= 0)
     {
-        LOG_ERROR("MQTT", "Failed to parse MQTT JSON: %s", error.c_str());
+        LOG_WARNING("MQTT", "Ignoring invalid reply_to topic: %s", replyTo);
         return;
     }
 
+    DynamicJsonDocument ackDoc(384);
+    ackDoc["id"] = messageId;
+    ackDoc["printer_id"] = getPrinterId();
+    ackDoc["status"] = status;
+    ackDoc["received_at"] = getFormattedDateTime();
+    ackDoc["print_start_ms"] = printStartMs;
+    ackDoc["print_done_ms"] = printDoneMs;
+
+    String payload;
+    serializeJson(ackDoc, payload);
+    if (!mqttClient.publish(ackTopic.c_str(), payload.c_str()))
+    {
+        LOG_WARNING("MQTT", "Failed to publish delivery ack to %s", ackTopic.c_str());
+    }
+}
+
+static void processStructuredMessage(JsonDocument &doc)
+{
+    unsigned long receivedAt = millis();
     String timestamp = getFormattedDateTime();
 
     // Only handle structured messages (header + body + sender)
@@ -301,6 +569,16 @@ void handleMQTTMessage(String topic, String message)
         return;
     }
 
+    // Drop repeats of an already-printed message before any processing
+    const char *messageId = doc["id"] | "";
+    const char *replyTo = doc["reply_to"] | "";
+    if (isDuplicateMessage(messageId))
+    {
+        LOG_NOTICE("MQTT", "Dropped duplicate message: %s", messageId);
+        sendDeliveryAck(replyTo, messageId, "duplicate", 0, 0);
+        return;
+    }
+
     String header = doc["header"].as<String>();
     String body = doc["body"].as<String>();
     String senderName = doc["sender"] | "";
@@ -323,15 +601,76 @@ void handleMQTTMessage(String topic, String message)
     String printMessage = finalHeader + "\n\n" + body;
 
     // Print immediately using the existing printWithHeader function
+    unsigned long printStartMs = millis() - receivedAt;
     printWithHeader(timestamp, printMessage);
 
+    if (replyTo[0] != '\0')
+    {
+        printer.flush(); // Count print-done once the last byte has left the UART
+        sendDeliveryAck(replyTo, messageId, "printed", printStartMs, millis() - receivedAt);
+    }
+
     LOG_VERBOSE("MQTT", "Processed structured message: %s (%d chars)",
                finalHeader.c_str(), printMessage.length());
 }
 
+void handleMQTTMessage(String topic, String message)
+{
+    String completedMessage;
+
+    {
+        // Parse JSON message
+        DynamicJsonDocument doc(mqttJsonCapacity(message.length()));
+        DeserializationError error = deserializeJson(doc, message);
+
+        if (error)
+        {
+            LOG_ERROR("MQTT", "Failed to parse MQTT JSON: %s", error.c_str());
+            return;
+        }
+
+        if (!doc.containsKey("part"))
+        {
+            processStructuredMessage(doc);
+            return;
+        }
+
+        // Multipart: collect the part, print once the whole message has arrived
+        JsonObjectConst part = doc["part"];
+        const char *chunk = doc["chunk"] | "";
+        MultipartResult result = acceptMultipartPart(part["id"] | "",
+                                                     part["seq"] | -1,
+                                                     part["total"] | 0,
+                                                     part["size"] | 0,
+                                                     chunk, strlen(chunk),
+                                                     completedMessage);
+        if (result != MultipartResult::COMPLETE)
+        {
+            return;
+        }
+    }
+
+    // Part document released above; parse the reassembled payload on its own
+    message = String();
+    DynamicJsonDocument doc(mqttJsonCapacity(completedMessage.length()));
+    DeserializationError error = deserializeJson(doc, completedMessage);
+
+    if (error)
+    {
+        LOG_ERROR("MQTT", "Failed to parse reassembled MQTT JSON: %s", error.c_str());
+        return;
+    }
+
+    processStructuredMessage(doc);
+}
+
 // === MQTT Connection Handler ===
+static void applyMQTTClientRequest();
+
 void handleMQTTConnection()
 {
+    applyMQTTClientRequest();
+
     switch(mqttState)
     {
         case MQTT_STATE_DISABLED:
@@ -340,9 +679,10 @@ void handleMQTTConnection()
             
         case MQTT_STATE_ENABLED_DISCONNECTED:
             // Check if it's time to reconnect
-            if (millis() - lastMQTTReconnectAttempt > mqttReconnectIntervalMs)
+            if (reconnectImmediately || millis() - lastMQTTReconnectAttempt > mqttReconnectIntervalMs)
             {
                 LOG_VERBOSE("MQTT", "Starting connection attempt");
+                reconnectImmediately = false;
                 mqttState = MQTT_STATE_CONNECTING;
                 stateChangeTime = millis();
                 
@@ -381,12 +721,39 @@ void handleMQTTConnection()
         case MQTT_STATE_CONNECTED:
             // Process MQTT messages
             mqttClient.loop();
+
+            // Drop multipart messages whose remaining parts never arrived
+            expireMultipartMessages();
             
             // Check if still connected
             if (!mqttClient.connected())
             {
                 LOG_WARNING("MQTT", "Connection lost");
                 mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
+                break;
+            }
+
+            // Running on a fallback - move back once the preferred broker is reachable again.
+            // Its name resolves in the background; only the TCP connect (mqttBrokerProbeTimeoutMs) blocks.
+            if (brokerPool.isProbeDue(millis()))
+            {
+                const MqttBrokerHealth &preferred = brokerPool.getBroker(0);
+                IPAddress address;
+                BrokerLookup lookup = resolveBrokerAddress(preferred.host.c_str(), address);
+                if (lookup == BrokerLookup::PENDING)
+                {
+                    break; // Probe on a later loop, once the address is known
+                }
+                bool reachable = lookup == BrokerLookup::FOUND &&
+                                 probeBrokerReachable(address, preferred.port, mqttBrokerProbeTimeoutMs);
+                if (brokerPool.recordProbe(reachable, millis()))
+                {
+                    LOG_NOTICE("MQTT", "Preferred broker %s:%d reachable again - switching back", preferred.host.c_str(), preferred.port);
+                    mqttClient.disconnect();
+                    wifiSecureClient.stop();
+                    mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
+                    reconnectImmediately = true;
+                }
             }
             break;
             
@@ -437,6 +804,8 @@ void updateMQTTSubscription()
         LOG_ERROR("MQTT", "Failed to subscribe to new topic: %s", newTopic.c_str());
         currentSubscribedTopic = ""; // Clear since subscription failed
     }
+
+    rebuildTopicRoutes();
 }
 
 
@@ -447,7 +816,7 @@ bool isMQTTEnabled()
     return config.mqttEnabled;
 }
 
-void startMQTTClient(bool immediate)
+static void enableMQTTClient(bool immediate)
 {
     if (!isMQTTEnabled())
     {
@@ -459,6 +828,9 @@ void startMQTTClient(bool immediate)
     {
         LOG_NOTICE("MQTT", "Enabling MQTT client (immediate=%s)", immediate ? "true" : "false");
         mqttState = MQTT_STATE_ENABLED_DISCONNECTED;
+
+        const RuntimeConfig &config = getRuntimeConfig();
+        brokerPool.configure(config.mqttServer, config.mqttPort, config.mqttFallbackServers);
         
         if (immediate)
         {
@@ -473,7 +845,7 @@ void startMQTTClient(bool immediate)
     }
 }
 
-void stopMQTTClient()
+static void disableMQTTClient()
 {
     LOG_NOTICE("MQTT", "Stopping MQTT client");
     mqttState = MQTT_STATE_DISCONNECTING;
@@ -493,25 +865,121 @@ void stopMQTTClient()
     // Reset ALL state variables
     mqttState = MQTT_STATE_DISABLED;
     currentSubscribedTopic = "";
-    consecutiveFailures = 0;
+    topicRouter.clear();
+    reconnectImmediately = false;
     lastMQTTReconnectAttempt = 0;
-    lastFailureTime = 0;
+    resetMultipartReassembly();
+
+    // Discovered printers may belong to another scope or broker after a restart
+    resetPrinterDiscovery();
+}
+
+// The router, reassembly buffers and discovery state belong to the main loop, and
+// PubSubClient isn't thread-safe - so callers on other tasks only leave a request
+static void requestMQTTClient(MQTTClientRequest request, bool immediate)
+{
+    portENTER_CRITICAL(&clientRequestMux);
+    if (request == MQTT_REQUEST_START && pendingClientRequest != MQTT_REQUEST_NONE &&
+        pendingClientRequest != MQTT_REQUEST_START)
+    {
+        request = MQTT_REQUEST_RESTART; // Stop then start before the loop got to it
+    }
+    pendingClientRequest = request;
+    pendingStartImmediate = immediate;
+    portEXIT_CRITICAL(&clientRequestMux);
+}
+
+static void applyMQTTClientRequest()
+{
+    portENTER_CRITICAL(&clientRequestMux);
+    MQTTClientRequest request = pendingClientRequest;
+    bool immediate = pendingStartImmediate;
+    bool leaveScope = pendingLeaveScope;
+    char scope[sizeof(pendingLeaveScopeName)];
+    memcpy(scope, pendingLeaveScopeName, sizeof(scope));
+    pendingClientRequest = MQTT_REQUEST_NONE;
+    pendingLeaveScope = false;
+    portEXIT_CRITICAL(&clientRequestMux);
+
+    if (request == MQTT_REQUEST_STOP || request == MQTT_REQUEST_RESTART)
+    {
+        if (leaveScope)
+        {
+            // Leave the old scope while still connected, or its printers keep seeing our retained status
+            clearRetainedPrinterStatus(scope);
+        }
+        disableMQTTClient();
+    }
+    if (request == MQTT_REQUEST_START || request == MQTT_REQUEST_RESTART)
+    {
+        enableMQTTClient(immediate);
+    }
+}
+
+void startMQTTClient(bool immediate)
+{
+    requestMQTTClient(MQTT_REQUEST_START, immediate);
+}
+
+void stopMQTTClient()
+{
+    requestMQTTClient(MQTT_REQUEST_STOP, true);
+}
+
+void restartMQTTClient(const String &leaveScope)
+{
+    portENTER_CRITICAL(&clientRequestMux);
+    pendingLeaveScope = true;
+    strncpy(pendingLeaveScopeName, isValidMqttGroupName(leaveScope) ? leaveScope.c_str() : "",
+            sizeof(pendingLeaveScopeName) - 1);
+    pendingLeaveScopeName[sizeof(pendingLeaveScopeName) - 1] = '\0';
+    portEXIT_CRITICAL(&clientRequestMux);
+
+    requestMQTTClient(MQTT_REQUEST_RESTART, true);
+}
+
+void restartMQTTClient()
+{
+    requestMQTTClient(MQTT_REQUEST_RESTART, true);
 }
 
 // ========================================
 // CENTRALIZED MQTT MESSAGE PUBLISHING
 // ========================================
 
-bool publishMQTTMessage(const String& topic, const String& header, const String& body)
+String buildRemotePrintPayload(const String &messageId, const String &header, const String &body, bool requestAck)
+{
+    // Header/body are copied into the document
+    DynamicJsonDocument payloadDoc(mqttJsonCapacity(header.length() + body.length()));
+    payloadDoc["id"] = messageId;
+    if (requestAck) {
+        payloadDoc["reply_to"] = getAckTopic();
+    }
+    payloadDoc["header"] = header;
+    payloadDoc["body"] = body;
+    payloadDoc["timestamp"] = getFormattedDateTime();
+    
+    // Add sender information (device owner)
+    const RuntimeConfig &config = getRuntimeConfig();
+    if (config.deviceOwner.length() > 0) {
+        payloadDoc["sender"] = config.deviceOwner;
+    }
+    
+    String payload;
+    serializeJson(payloadDoc, payload);
+    return payload;
+}
+
+bool publishRemotePrint(const String& topic, const String& messageId, const String& header, const String& body, bool requestAck)
 {
     // Validate inputs
     if (topic.length() == 0) {
-        LOG_ERROR("MQTT", "publishMQTTMessage: topic cannot be empty");
+        LOG_ERROR("MQTT", "publishRemotePrint: topic cannot be empty");
         return false;
     }
     
     if (header.length() == 0) {
-        LOG_ERROR("MQTT", "publishMQTTMessage: header cannot be empty");
+        LOG_ERROR("MQTT", "publishRemotePrint: header cannot be empty");
         return false;
     }
     
@@ -527,31 +995,64 @@ bool publishMQTTMessage(const String& topic, const String& header, const String&
     }
     
     // Create standardized JSON payload
-    DynamicJsonDocument payloadDoc(4096);
-    payloadDoc["header"] = header;
-    payloadDoc["body"] = body;
-    payloadDoc["timestamp"] = getFormattedDateTime();
+    String payload = buildRemotePrintPayload(messageId, header, body, requestAck);
     
-    // Add sender information (device owner)
-    const RuntimeConfig &config = getRuntimeConfig();
-    if (config.deviceOwner.length() > 0) {
-        payloadDoc["sender"] = config.deviceOwner;
+    bool success = true;
+
+    // Publish directly when the packet fits the client buffer (fixed header + topic + payload)
+    if (payload.length() + topic.length() + 7 <= (size_t)mqttBufferSize)
+    {
+        success = mqttClient.publish(topic.c_str(), payload.c_str());
+
+        if (success) {
+            LOG_VERBOSE("MQTT", "Published message to topic: %s (%d characters)",
+                       topic.c_str(), payload.length());
+        } else {
+            LOG_ERROR("MQTT", "Failed to publish message to topic: %s", topic.c_str());
+        }
     }
-    
-    // Serialize payload
-    String payload;
-    serializeJson(payloadDoc, payload);
-    
-    // Publish message
-    bool success = mqttClient.publish(topic.c_str(), payload.c_str());
-    
-    if (success) {
-        LOG_VERBOSE("MQTT", "Published message to topic: %s (%d characters)", 
-                   topic.c_str(), payload.length());
-    } else {
-        LOG_ERROR("MQTT", "Failed to publish message to topic: %s", topic.c_str());
+    else
+    {
+        // Too large for one packet - send as multipart (parts share the message ID)
+        std::vector<String> parts;
+        if (!buildMultipartPayloads(messageId, payload, mqttMultipartPartSize, parts)) {
+            LOG_ERROR("MQTT", "Message too large to publish to topic: %s (%d characters)",
+                     topic.c_str(), payload.length());
+            return false;
+        }
+        payload = String(); // Parts hold their own copies
+
+        for (size_t i = 0; i < parts.size() && success; i++) {
+            success = mqttClient.publish(topic.c_str(), parts[i].c_str());
+        }
+
+        if (success) {
+            LOG_VERBOSE("MQTT", "Published multipart message %s to topic: %s (%d parts)",
+                       messageId.c_str(), topic.c_str(), (int)parts.size());
+        } else {
+            LOG_ERROR("MQTT", "Failed to publish multipart message to topic: %s", topic.c_str());
+        }
     }
-    
+
     return success;
 }
 
+bool publishMQTTMessage(const String& topic, const String& header, const String& body, bool requestAck, String *messageIdOut)
+{
+    String messageId = generateMessageId();
+    bool success = publishRemotePrint(topic, messageId, header, body, requestAck);
+
+    if (success && requestAck) {
+        trackRemoteDelivery(messageId, topic);
+    }
+    if (messageIdOut) {
+        *messageIdOut = messageId;
+    }
+
+    return success;
+}
+
+const MqttBrokerPool &getMqttBrokerPool()
+{
+    return brokerPool;
+}
@@ -12,6 +12,7 @@
 #include <PubSubClient.h>
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
+#include <vector>
 #include <config/config.h>
 
 // External MQTT objects
@@ -29,12 +30,33 @@ void handleMQTTConnection();
 void updateMQTTSubscription();
 void setupMQTTWithDiscovery();
 
-// Dynamic MQTT control functions
+// Dynamic MQTT control functions - safe from any task; the main loop acts on them in handleMQTTConnection()
 bool isMQTTEnabled();
 void startMQTTClient(bool immediate = true);
 void stopMQTTClient();
+// Reconnect with the current config; the overload taking a scope clears our retained status there first
+void restartMQTTClient();
+void restartMQTTClient(const String &leaveScope);
+
+// Single topic level name: letters, digits, '-' and '_' (group names and discovery scopes)
+bool isValidMqttGroupName(const String &name);
+
+// Valid group names from mqtt.groups, in config order (invalid names and repeats skipped)
+std::vector<String> getMqttGroupNames();
+
+// Broker list and health (for diagnostics)
+class MqttBrokerPool;
+const MqttBrokerPool &getMqttBrokerPool();
 
 // Centralized MQTT message publishing
-bool publishMQTTMessage(const String& topic, const String& header, const String& body);
+// requestAck adds a reply_to so the receiver acks (see delivery_tracker.h); messageIdOut receives the message ID
+bool publishMQTTMessage(const String& topic, const String& header, const String& body,
+                        bool requestAck = false, String *messageIdOut = nullptr);
+
+// Lower-level pieces shared with the direct LAN print path (peer_print.h)
+String generateMessageId();
+String buildRemotePrintPayload(const String &messageId, const String &header, const String &body, bool requestAck);
+// Publish with a caller-chosen ID; does not track the delivery
+bool publishRemotePrint(const String& topic, const String& messageId, const String& header, const String& body, bool requestAck);
 
 #endif // MQTT_HANDLER_H
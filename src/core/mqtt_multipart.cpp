@@ -0,0 +1,345 @@
+/**
+ * @file mqtt_multipart.cpp
+ * @brief Implementation of MQTT multipart splitting and reassembly
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "mqtt_multipart.h"
+#include "logging.h"
+#include <utility>
+
+// Partial message slot - fixed count, buffer sized from the part header
+struct MultipartSlot
+{
+    bool inUse;
+    char messageId[mqttMultipartIdLength];
+    int total;
+    int nextSeq;
+    size_t expectedSize;
+    unsigned long startedAt;
+    String buffer;
+};
+
+static MultipartSlot multipartSlots[mqttMultipartMaxPending];
+
+// ========================================
+// SENDER SIDE
+// ========================================
+
+// Bytes a character occupies once escaped inside a JSON string
+static size_t jsonEscapedLength(unsigned char c)
+{
+    switch (c)
+    {
+    case '"':
+    case '\\':
+    case '\n':
+    case '\r':
+    case '\t':
+    case '\b':
+    case '\f':
+        return 2;
+    default:
+        return c < 0x20 ? 6 : 1;
+    }
+}
+
+static void appendJsonEscaped(String &out, const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)data[i];
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out += (char)c;
+            }
+            break;
+        }
+    }
+}
+
+static String buildPartHeader(const String &messageId, int seq, int total, size_t size)
+{
+    char header[96 + mqttMultipartIdLength];
+    snprintf(header, sizeof(header), "{\"part\":{\"id\":\"%s\",\"seq\":%d,\"total\":%d,\"size\":%u},\"chunk\":\"",
+             messageId.c_str(), seq, total, (unsigned int)size);
+    return String(header);
+}
+
+bool buildMultipartPayloads(const String &messageId, const String &payload, size_t maxPartSize, std::vector<String> &parts)
+{
+    parts.clear();
+
+    if (messageId.length() == 0 || messageId.length() >= (size_t)mqttMultipartIdLength)
+    {
+        LOG_ERROR("MQTT", "Multipart message ID must be 1-%d characters", mqttMultipartIdLength - 1);
+        return false;
+    }
+
+    size_t payloadLength = payload.length();
+    if (payloadLength == 0 || payloadLength > (size_t)mqttMultipartMaxMessageSize)
+    {
+        LOG_ERROR("MQTT", "Multipart payload size %u outside 1-%d bytes", (unsigned int)payloadLength, mqttMultipartMaxMessageSize);
+        return false;
+    }
+
+    // Worst-case header (largest seq/total) plus the closing quote and brace
+    size_t overhead = buildPartHeader(messageId, mqttMultipartMaxParts, mqttMultipartMaxParts, payloadLength).length() + 2;
+    if (maxPartSize <= overhead + 8)
+    {
+        LOG_ERROR("MQTT", "Multipart part size %u too small for header (%u bytes)", (unsigned int)maxPartSize, (unsigned int)overhead);
+        return false;
+    }
+    size_t chunkBudget = maxPartSize - overhead;
+
+    // Work out chunk boundaries by escaped size, never splitting a UTF-8 sequence
+    std::vector<size_t> chunkStarts;
+    const char *data = payload.c_str();
+    size_t pos = 0;
+    while (pos < payloadLength)
+    {
+        chunkStarts.push_back(pos);
+        if ((int)chunkStarts.size() > mqttMultipartMaxParts)
+        {
+            LOG_ERROR("MQTT", "Payload of %u bytes needs more than %d parts", (unsigned int)payloadLength, mqttMultipartMaxParts);
+            return false;
+        }
+
+        size_t used = 0;
+        size_t end = pos;
+        while (end < payloadLength && used + jsonEscapedLength((unsigned char)data[end]) <= chunkBudget)
+        {
+            used += jsonEscapedLength((unsigned char)data[end]);
+            end++;
+        }
+
+        // Back off to the start of a UTF-8 sequence if we stopped inside one
+        while (end < payloadLength && end > pos && ((unsigned char)data[end] & 0xC0) == 0x80)
+        {
+            end--;
+        }
+
+        if (end == pos)
+        {
+            LOG_ERROR("MQTT", "Unable to split payload into parts of %u bytes", (unsigned int)maxPartSize);
+            return false;
+        }
+        pos = end;
+    }
+
+    int total = chunkStarts.size();
+    parts.reserve(total);
+    for (int seq = 0; seq < total; seq++)
+    {
+        size_t start = chunkStarts[seq];
+        size_t end = (seq + 1 < total) ? chunkStarts[seq + 1] : payloadLength;
+
+        String part = buildPartHeader(messageId, seq, total, payloadLength);
+        part.reserve(maxPartSize);
+        appendJsonEscaped(part, data + start, end - start);
+        part += "\"}";
+        parts.push_back(part);
+    }
+
+    return true;
+}
+
+// ========================================
+// RECEIVER SIDE
+// ========================================
+
+static void releaseSlot(MultipartSlot &slot)
+{
+    slot.inUse = false;
+    slot.messageId[0] = '\0';
+    slot.buffer = String(); // Release the heap block, not just the contents
+}
+
+static MultipartSlot *findSlot(const char *messageId)
+{
+    for (int i = 0; i < mqttMultipartMaxPending; i++)
+    {
+        if (multipartSlots[i].inUse && strcmp(multipartSlots[i].messageId, messageId) == 0)
+        {
+            return &multipartSlots[i];
+        }
+    }
+    return nullptr;
+}
+
+static MultipartSlot *acquireSlot()
+{
+    MultipartSlot *oldest = nullptr;
+    for (int i = 0; i < mqttMultipartMaxPending; i++)
+    {
+        if (!multipartSlots[i].inUse)
+        {
+            return &multipartSlots[i];
+        }
+        if (!oldest || (long)(multipartSlots[i].startedAt - oldest->startedAt) < 0)
+        {
+            oldest = &multipartSlots[i];
+        }
+    }
+
+    LOG_WARNING("MQTT", "Multipart slots full - dropping oldest partial message %s", oldest->messageId);
+    releaseSlot(*oldest);
+    return oldest;
+}
+
+static MultipartResult rejectPart(MultipartSlot *slot, const char *reason, const char *messageId)
+{
+    LOG_WARNING("MQTT", "Multipart message %s rejected: %s", messageId, reason);
+    if (slot)
+    {
+        releaseSlot(*slot);
+    }
+    return MultipartResult::REJECTED;
+}
+
+MultipartResult acceptMultipartPart(const char *messageId, int seq, int total, size_t size,
+                                    const char *chunk, size_t chunkLength, String &completedMessage)
+{
+    if (!messageId || messageId[0] == '\0' || strlen(messageId) >= (size_t)mqttMultipartIdLength)
+    {
+        return rejectPart(nullptr, "invalid message ID", messageId ? messageId : "");
+    }
+
+    MultipartSlot *slot = findSlot(messageId);
+
+    if (total < 1 || total > mqttMultipartMaxParts || seq < 0 || seq >= total)
+    {
+        return rejectPart(slot, "invalid sequence header", messageId);
+    }
+    if (size == 0 || size > (size_t)mqttMultipartMaxMessageSize)
+    {
+        return rejectPart(slot, "message size over limit", messageId);
+    }
+
+    if (!slot)
+    {
+        if (seq != 0)
+        {
+            return rejectPart(nullptr, "first part missing", messageId);
+        }
+
+        slot = acquireSlot();
+        slot->inUse = true;
+        strncpy(slot->messageId, messageId, sizeof(slot->messageId) - 1);
+        slot->messageId[sizeof(slot->messageId) - 1] = '\0';
+        slot->total = total;
+        slot->nextSeq = 0;
+        slot->expectedSize = size;
+        slot->startedAt = millis();
+
+        if (!slot->buffer.reserve(size))
+        {
+            return rejectPart(slot, "out of memory", messageId);
+        }
+        LOG_VERBOSE("MQTT", "Multipart message %s started (%d parts, %u bytes)", messageId, total, (unsigned int)size);
+    }
+    else if (slot->total != total || slot->expectedSize != size)
+    {
+        return rejectPart(slot, "header changed between parts", messageId);
+    }
+
+    if (seq < slot->nextSeq)
+    {
+        // Redelivered part (QoS 1 / sender retry) - already have it
+        return MultipartResult::ACCEPTED;
+    }
+    if (seq > slot->nextSeq)
+    {
+        return rejectPart(slot, "part out of order", messageId);
+    }
+    if (slot->buffer.length() + chunkLength > slot->expectedSize)
+    {
+        return rejectPart(slot, "parts exceed declared size", messageId);
+    }
+
+    slot->buffer.concat(chunk, chunkLength);
+    slot->nextSeq++;
+
+    if (slot->nextSeq < slot->total)
+    {
+        return MultipartResult::ACCEPTED;
+    }
+
+    if (slot->buffer.length() != slot->expectedSize)
+    {
+        return rejectPart(slot, "reassembled size mismatch", messageId);
+    }
+
+    completedMessage = std::move(slot->buffer);
+    LOG_VERBOSE("MQTT", "Multipart message %s complete (%u bytes)", messageId, (unsigned int)completedMessage.length());
+    releaseSlot(*slot);
+    return MultipartResult::COMPLETE;
+}
+
+void expireMultipartMessages()
+{
+    unsigned long now = millis();
+    for (int i = 0; i < mqttMultipartMaxPending; i++)
+    {
+        MultipartSlot &slot = multipartSlots[i];
+        if (slot.inUse && now - slot.startedAt > mqttMultipartTimeoutMs)
+        {
+            LOG_WARNING("MQTT", "Multipart message %s timed out after %d/%d parts", slot.messageId, slot.nextSeq, slot.total);
+            releaseSlot(slot);
+        }
+    }
+}
+
+void resetMultipartReassembly()
+{
+    for (int i = 0; i < mqttMultipartMaxPending; i++)
+    {
+        releaseSlot(multipartSlots[i]);
+    }
+}
+
+int getPendingMultipartCount()
+{
+    int count = 0;
+    for (int i = 0; i < mqttMultipartMaxPending; i++)
+    {
+        if (multipartSlots[i].inUse)
+        {
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file mqtt_multipart.h
+ * @brief Split and reassemble MQTT messages larger than the MQTT buffer
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * PubSubClient drops anything larger than its buffer (mqttBufferSize), so large
+ * payloads travel as a sequence of small JSON parts:
+ *
+ *   {"part":{"id":"<message id>","seq":0,"total":3,"size":1234},"chunk":"..."}
+ *
+ * Concatenating every chunk in sequence order yields the original payload.
+ * Partial messages are held in a fixed number of slots with a size cap and a
+ * timeout, so a lost part can never pin memory.
+ */
+
+#ifndef MQTT_MULTIPART_H
+#define MQTT_MULTIPART_H
+
+#include <Arduino.h>
+#include <vector>
+#include <config/config.h>
+
+/**
+ * @brief Outcome of feeding one part to the reassembler
+ */
+enum class MultipartResult
+{
+    ACCEPTED, // Part stored (or harmless duplicate), message still incomplete
+    COMPLETE, // Final part received, message is available
+    REJECTED  // Part invalid, out of order or over limits - partial message dropped
+};
+
+/**
+ * @brief Split a serialized payload into multipart JSON payloads
+ * @param messageId Identifier shared by all parts (max mqttMultipartIdLength - 1 chars)
+ * @param payload Complete payload to split
+ * @param maxPartSize Maximum serialized size of each part payload
+ * @param parts Output list of part payloads, in sequence order
+ * @return true if the payload fits within mqttMultipartMaxParts / mqttMultipartMaxMessageSize
+ */
+bool buildMultipartPayloads(const String &messageId, const String &payload, size_t maxPartSize, std::vector<String> &parts);
+
+/**
+ * @brief Feed one received part to the reassembler
+ * @param messageId Message identifier from the part header
+ * @param seq Zero-based sequence number
+ * @param total Total number of parts
+ * @param size Total payload size in bytes
+ * @param chunk Part data (already JSON-unescaped)
+ * @param chunkLength Length of chunk in bytes
+ * @param completedMessage Receives the reassembled payload on COMPLETE
+ * @return MultipartResult describing what happened to the part
+ */
+MultipartResult acceptMultipartPart(const char *messageId, int seq, int total, size_t size,
+                                    const char *chunk, size_t chunkLength, String &completedMessage);
+
+/**
+ * @brief Drop partial messages older than mqttMultipartTimeoutMs
+ */
+void expireMultipartMessages();
+
+/**
+ * @brief Drop all partial messages (e.g. on MQTT disconnect)
+ */
+void resetMultipartReassembly();
+
+/**
+ * @brief Number of partial messages currently held
+ */
+int getPendingMultipartCount();
+
+#endif // MQTT_MULTIPART_H
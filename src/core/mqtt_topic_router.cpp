@@ -0,0 +1,175 @@
+/**
+ * @file mqtt_topic_router.cpp
+ * @brief Implementation of the MQTT topic-trie dispatcher
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "mqtt_topic_router.h"
+#include <string.h>
+
+static const int rootNode = 0;
+
+MQTTTopicRouter::MQTTTopicRouter()
+{
+    clear();
+}
+
+void MQTTTopicRouter::clear()
+{
+    nodes.clear();
+    nodes.push_back(Node());
+    nodes[rootNode].singleLevelChild = -1;
+    routeCount = 0;
+}
+
+int MQTTTopicRouter::findOrAddChild(int parent, const char *level, size_t length)
+{
+    bool singleLevel = (length == 1 && level[0] == '+');
+
+    if (singleLevel && nodes[parent].singleLevelChild >= 0)
+    {
+        return nodes[parent].singleLevelChild;
+    }
+
+    if (!singleLevel)
+    {
+        for (int child : nodes[parent].children)
+        {
+            const String &childLevel = nodes[child].level;
+            if (childLevel.length() == length && strncmp(childLevel.c_str(), level, length) == 0)
+            {
+                return child;
+            }
+        }
+    }
+
+    Node node;
+    node.singleLevelChild = -1;
+    if (!singleLevel)
+    {
+        node.level.concat(level, length);
+    }
+    nodes.push_back(node);
+
+    // Index rather than pointer - nodes may reallocate as the trie grows
+    int index = nodes.size() - 1;
+    if (singleLevel)
+    {
+        nodes[parent].singleLevelChild = index;
+    }
+    else
+    {
+        nodes[parent].children.push_back(index);
+    }
+    return index;
+}
+
+bool MQTTTopicRouter::addRoute(const char *filter, MQTTTopicHandler handler)
+{
+    if (!filter || filter[0] == '\0' || !handler)
+    {
+        return false;
+    }
+
+    // Validate first so a bad filter leaves the trie untouched
+    for (const char *p = filter; *p; p++)
+    {
+        bool levelStart = (p == filter || p[-1] == '/');
+        bool levelEnd = (p[1] == '\0' || p[1] == '/');
+        if (*p == '+' && !(levelStart && levelEnd))
+        {
+            return false;
+        }
+        if (*p == '#' && !(levelStart && p[1] == '\0'))
+        {
+            return false;
+        }
+    }
+
+    int node = rootNode;
+    const char *level = filter;
+    while (true)
+    {
+        const char *slash = strchr(level, '/');
+        size_t length = slash ? (size_t)(slash - level) : strlen(level);
+
+        if (length == 1 && level[0] == '#')
+        {
+            nodes[node].multiLevelHandlers.push_back(handler);
+            break;
+        }
+
+        node = findOrAddChild(node, level, length);
+
+        if (!slash)
+        {
+            nodes[node].handlers.push_back(handler);
+            break;
+        }
+        level = slash + 1;
+    }
+
+    routeCount++;
+    return true;
+}
+
+void MQTTTopicRouter::matchNode(int nodeIndex, const char *level, bool firstLevel,
+                                const String &topic, const String &message, int &called) const
+{
+    const Node &node = nodes[nodeIndex];
+
+    // Wildcards never match the first level of a '$' system topic
+    bool wildcardsAllowed = !(firstLevel && level && level[0] == '$');
+
+    // '#' matches the parent level and everything below it
+    if (wildcardsAllowed)
+    {
+        for (MQTTTopicHandler handler : node.multiLevelHandlers)
+        {
+            handler(topic, message);
+            called++;
+        }
+    }
+
+    if (!level)
+    {
+        for (MQTTTopicHandler handler : node.handlers)
+        {
+            handler(topic, message);
+            called++;
+        }
+        return;
+    }
+
+    const char *slash = strchr(level, '/');
+    size_t length = slash ? (size_t)(slash - level) : strlen(level);
+    const char *nextLevel = slash ? slash + 1 : nullptr;
+
+    for (int child : node.children)
+    {
+        const String &childLevel = nodes[child].level;
+        if (childLevel.length() == length && strncmp(childLevel.c_str(), level, length) == 0)
+        {
+            matchNode(child, nextLevel, false, topic, message, called);
+            break; // Literal levels are unique per node
+        }
+    }
+
+    if (wildcardsAllowed && node.singleLevelChild >= 0)
+    {
+        matchNode(node.singleLevelChild, nextLevel, false, topic, message, called);
+    }
+}
+
+int MQTTTopicRouter::dispatch(const String &topic, const String &message) const
+{
+    int called = 0;
+    if (topic.length() > 0)
+    {
+        matchNode(rootNode, topic.c_str(), true, topic, message, called);
+    }
+    return called;
+}
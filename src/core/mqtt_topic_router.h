@@ -0,0 +1,67 @@
+/**
+ * @file mqtt_topic_router.h
+ * @brief Topic-trie dispatcher for incoming MQTT messages
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Routes are MQTT topic filters (exact levels, '+' single-level and '#'
+ * multi-level wildcards) compiled into a trie when registered. Dispatch walks
+ * the topic one level at a time without allocating, so cost depends on topic
+ * depth rather than the number of routes.
+ */
+
+#ifndef MQTT_TOPIC_ROUTER_H
+#define MQTT_TOPIC_ROUTER_H
+
+#include <Arduino.h>
+#include <vector>
+
+typedef void (*MQTTTopicHandler)(const String &topic, const String &message);
+
+class MQTTTopicRouter
+{
+public:
+    MQTTTopicRouter();
+
+    /**
+     * @brief Register a handler for a topic filter
+     * @param filter MQTT topic filter, e.g. "scribe/printer-status/+" or "scribe/#"
+     * @param handler Function called for each matching message
+     * @return false if the filter is malformed ('+'/'#' not a whole level, '#' not last)
+     */
+    bool addRoute(const char *filter, MQTTTopicHandler handler);
+
+    /**
+     * @brief Call every handler whose filter matches the topic
+     * @return Number of handlers called (0 if unrouted)
+     */
+    int dispatch(const String &topic, const String &message) const;
+
+    /**
+     * @brief Remove all routes
+     */
+    void clear();
+
+    int getRouteCount() const { return routeCount; }
+
+private:
+    struct Node
+    {
+        String level;                                  // Literal level matched by this node
+        std::vector<int> children;                     // Literal child nodes
+        int singleLevelChild;                          // '+' child node, -1 if none
+        std::vector<MQTTTopicHandler> handlers;        // Filters ending at this node
+        std::vector<MQTTTopicHandler> multiLevelHandlers; // Filters ending in '/#' below this node
+    };
+
+    std::vector<Node> nodes;
+    int routeCount;
+
+    int findOrAddChild(int parent, const char *level, size_t length);
+    void matchNode(int nodeIndex, const char *level, bool firstLevel,
+                   const String &topic, const String &message, int &called) const;
+};
+
+#endif // MQTT_TOPIC_ROUTER_H
@@ -2,6 +2,7 @@
 #include "logging.h"
 #include "config_utils.h"
 #include "config_loader.h"
+#include "mdns_discovery.h"
 #include <content/content_generators.h>
 #include <utils/content_actions.h>
 #include <esp_task_wdt.h>
@@ -190,6 +191,9 @@ void setupmDNS()
 
         // Add service to MDNS-SD
         MDNS.addService("http", "tcp", webServerPort);
+
+        // Scribe service with TXT records for broker-less LAN discovery
+        setupMdnsDiscovery();
     }
     else
     {
@@ -34,10 +34,21 @@ constexpr const char *NVS_MQTT_SERVER = "mqtt_server";
 constexpr const char *NVS_MQTT_PORT = "mqtt_port";
 constexpr const char *NVS_MQTT_USERNAME = "mqtt_username";
 constexpr const char *NVS_MQTT_PASSWORD = "mqtt_password";
+constexpr const char *NVS_MQTT_GROUPS = "mqtt_groups";
+constexpr const char *NVS_MQTT_FALLBACKS = "mqtt_fallbacks";
+constexpr const char *NVS_MQTT_DISC_SCOPE = "mqtt_dscope";
+constexpr const char *NVS_MQTT_DISC_SUMMARY = "mqtt_dsummary";
+constexpr const char *NVS_MQTT_PEER_KEY = "mqtt_peerkey";
 
 // API Configuration Keys
 constexpr const char *NVS_CHATGPT_TOKEN = "chatgpt_token";
 
+// Logging Keys
+constexpr const char *NVS_LOG_RATE_LIMIT = "log_rate_min";
+constexpr const char *NVS_LOG_RATE_BURST = "log_rate_burst";
+constexpr const char *NVS_LOG_LEVEL = "log_level";
+constexpr const char *NVS_LOG_COMP_LEVELS = "log_comp_lvls";
+
 // Unbidden Ink Keys
 constexpr const char *NVS_UNBIDDEN_ENABLED = "unbid_enabled";
 constexpr const char *NVS_UNBIDDEN_FREQUENCY = "unbid_freq_min";
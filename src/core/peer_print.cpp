@@ -0,0 +1,383 @@
+/**
+ * @file peer_print.cpp
+ * @brief Implementation of direct LAN printing between printers
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "peer_print.h"
+#include "peer_print_auth.h"
+#include "config_loader.h"
+#include "config_utils.h"
+#include "delivery_tracker.h"
+#include "logging.h"
+#include "mqtt_handler.h"
+#include "printer_discovery.h"
+#include <config/config.h>
+#include <AsyncTCP.h>
+#include <ezTime.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+enum class PeerJobState : uint8_t
+{
+    FREE,
+    SENDING,  // Connecting or waiting for the peer's reply
+    ACCEPTED, // Peer replied 202
+    FAILED    // Error, non-202 reply or timeout - needs MQTT fallback
+};
+
+// Outgoing LAN job. Owned by the AsyncTCP task while the client is open;
+// the main loop settles it and frees the slot once the client has gone.
+struct PeerPrintJob
+{
+    volatile PeerJobState state;
+    volatile bool clientOpen;
+    bool settled;
+    bool requestAck;
+    unsigned long startedAt;
+    char messageId[maxMessageIdLength + 1];
+    char printerId[sizeof(DiscoveredPrinter::printerId)];
+    char response[16]; // Start of the status line
+    size_t responseLength;
+    String topic;
+    String header;
+    String body;
+    String request;
+    size_t sent;
+};
+
+static PeerPrintJob peerJobs[peerPrintMaxInFlight];
+
+// Guards job state changes between the AsyncTCP task and the main loop
+static portMUX_TYPE peerJobMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Verified peer prints waiting for the main loop (String* handed over)
+static QueueHandle_t receivedQueue = nullptr;
+
+bool isPeerPrintEnabled()
+{
+    return getRuntimeConfig().mqttPeerKey.length() > 0;
+}
+
+// ========================================
+// SENDER SIDE (AsyncTCP callbacks)
+// ========================================
+
+// Move job from SENDING to a final state; false if it was already settled elsewhere
+static bool finishJob(PeerPrintJob *job, PeerJobState state)
+{
+    bool changed = false;
+    portENTER_CRITICAL(&peerJobMux);
+    if (job->state == PeerJobState::SENDING)
+    {
+        job->state = state;
+        changed = true;
+    }
+    portEXIT_CRITICAL(&peerJobMux);
+    return changed;
+}
+
+static void writeRequest(PeerPrintJob *job, AsyncClient *client)
+{
+    size_t remaining = job->request.length() - job->sent;
+    size_t chunk = min(remaining, client->space());
+    if (chunk > 0)
+    {
+        client->add(job->request.c_str() + job->sent, chunk);
+        client->send();
+        job->sent += chunk;
+    }
+}
+
+static void onPeerData(void *arg, AsyncClient *client, void *data, size_t len)
+{
+    PeerPrintJob *job = static_cast<PeerPrintJob *>(arg);
+
+    // Only the status line matters: "HTTP/1.1 202 ..."
+    size_t room = sizeof(job->response) - 1 - job->responseLength;
+    size_t take = min(room, len);
+    memcpy(job->response + job->responseLength, data, take);
+    job->responseLength += take;
+    job->response[job->responseLength] = '\0';
+
+    if (job->responseLength < 12)
+    {
+        return;
+    }
+
+    bool accepted = strncmp(job->response + 9, "202", 3) == 0;
+    if (finishJob(job, accepted ? PeerJobState::ACCEPTED : PeerJobState::FAILED) && accepted && job->requestAck)
+    {
+        // Record here, not in the main loop, so a long print can't inflate the figure
+        recordDeliveryAck(job->messageId, job->printerId, "accepted", 0, 0);
+    }
+    client->close();
+}
+
+static void onPeerDisconnect(void *arg, AsyncClient *client)
+{
+    PeerPrintJob *job = static_cast<PeerPrintJob *>(arg);
+    finishJob(job, PeerJobState::FAILED); // No-op if already accepted
+    job->clientOpen = false;
+    delete client;
+}
+
+static AsyncClient *createPeerClient(PeerPrintJob *job)
+{
+    AsyncClient *client = new AsyncClient();
+    if (!client)
+    {
+        return nullptr;
+    }
+
+    client->setRxTimeout((peerPrintTimeoutMs + 999) / 1000 + 1); // Seconds; main loop falls back sooner
+    client->setAckTimeout(peerPrintTimeoutMs);
+    client->onConnect([](void *arg, AsyncClient *c)
+                      { writeRequest(static_cast<PeerPrintJob *>(arg), c); }, job);
+    client->onAck([](void *arg, AsyncClient *c, size_t, uint32_t)
+                  { writeRequest(static_cast<PeerPrintJob *>(arg), c); }, job);
+    client->onData(onPeerData, job);
+    client->onError([](void *arg, AsyncClient *, int8_t)
+                    { finishJob(static_cast<PeerPrintJob *>(arg), PeerJobState::FAILED); }, job);
+    client->onTimeout([](void *arg, AsyncClient *c, uint32_t)
+                      {
+                          finishJob(static_cast<PeerPrintJob *>(arg), PeerJobState::FAILED);
+                          c->close(); }, job);
+    client->onDisconnect(onPeerDisconnect, job);
+    return client;
+}
+
+// Online discovered printer whose print topic is this one, with a usable IP
+static bool findLanPeer(const String &topic, IPAddress &ip, char *printerId, size_t printerIdSize)
+{
+    // Runs on the web server's task, so it reads a copy rather than the main loop's table
+    std::unique_ptr<DiscoveredPrinterTable> printers = copyDiscoveredPrinters();
+    for (const DiscoveredPrinter &printer : *printers)
+    {
+        if (!printer.online || printer.ipAddress[0] == '\0' || topic != buildMqttTopic(printer.name))
+        {
+            continue;
+        }
+        if (!ip.fromString(printer.ipAddress))
+        {
+            return false;
+        }
+        strncpy(printerId, printer.printerId, printerIdSize - 1);
+        printerId[printerIdSize - 1] = '\0';
+        return true;
+    }
+    return false;
+}
+
+static PeerPrintJob *claimJob()
+{
+    PeerPrintJob *job = nullptr;
+    portENTER_CRITICAL(&peerJobMux);
+    for (int i = 0; i < peerPrintMaxInFlight; i++)
+    {
+        if (peerJobs[i].state == PeerJobState::FREE)
+        {
+            job = &peerJobs[i];
+            job->state = PeerJobState::SENDING;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&peerJobMux);
+    return job;
+}
+
+static void releaseJob(PeerPrintJob *job)
+{
+    job->topic = String();
+    job->header = String();
+    job->body = String();
+    job->request = String();
+    portENTER_CRITICAL(&peerJobMux);
+    job->state = PeerJobState::FREE;
+    portEXIT_CRITICAL(&peerJobMux);
+}
+
+bool sendPeerPrint(const String &topic, const String &header, const String &body,
+                   bool requestAck, String &messageIdOut)
+{
+    const String &key = getRuntimeConfig().mqttPeerKey;
+    if (key.length() == 0 || timeStatus() != timeSet)
+    {
+        return false; // LAN printing off, or no trustworthy clock to sign with
+    }
+
+    IPAddress peerIp;
+    char printerId[sizeof(DiscoveredPrinter::printerId)];
+    if (!findLanPeer(topic, peerIp, printerId, sizeof(printerId)))
+    {
+        return false;
+    }
+
+    PeerPrintJob *job = claimJob();
+    if (!job)
+    {
+        LOG_VERBOSE("PEER", "All LAN print slots busy - using MQTT for %s", topic.c_str());
+        return false;
+    }
+
+    String messageId = generateMessageId();
+    String payload = buildRemotePrintPayload(messageId, header, body, false);
+
+    String senderId = getPrinterId();
+    unsigned long timestamp = (unsigned long)UTC.now();
+    char signature[peerSignatureHexLength + 1];
+    if (!signPeerPrint(key.c_str(), timestamp, senderId.c_str(), printerId, payload.c_str(), payload.length(), signature))
+    {
+        LOG_ERROR("PEER", "Failed to sign LAN print");
+        releaseJob(job);
+        return false;
+    }
+
+    strncpy(job->messageId, messageId.c_str(), sizeof(job->messageId) - 1);
+    job->messageId[sizeof(job->messageId) - 1] = '\0';
+    memcpy(job->printerId, printerId, sizeof(job->printerId));
+    job->requestAck = requestAck;
+    job->settled = false;
+    job->responseLength = 0;
+    job->response[0] = '\0';
+    job->sent = 0;
+    job->topic = topic;
+    job->header = header;
+    job->body = body;
+
+    String peerHost = peerIp.toString();
+    job->request.reserve(payload.length() + 320);
+    job->request = "POST ";
+    job->request += peerPrintPath;
+    job->request += " HTTP/1.1\r\nHost: ";
+    job->request += peerHost;
+    job->request += "\r\nContent-Type: application/json\r\nContent-Length: ";
+    job->request += payload.length();
+    job->request += "\r\nX-Scribe-Printer: ";
+    job->request += senderId;
+    job->request += "\r\nX-Scribe-Target: ";
+    job->request += printerId;
+    job->request += "\r\nX-Scribe-Timestamp: ";
+    job->request += timestamp;
+    job->request += "\r\nX-Scribe-Signature: ";
+    job->request += signature;
+    job->request += "\r\nConnection: close\r\n\r\n";
+    job->request += payload;
+
+    AsyncClient *client = createPeerClient(job);
+    job->startedAt = millis();
+    job->clientOpen = true;
+    if (!client || !client->connect(peerIp, webServerPort))
+    {
+        // connect() fails before registering any callbacks, so the client is still ours
+        LOG_VERBOSE("PEER", "LAN connect to %s failed - using MQTT", peerHost.c_str());
+        delete client;
+        job->clientOpen = false;
+        releaseJob(job);
+        return false;
+    }
+
+    if (requestAck)
+    {
+        trackRemoteDelivery(messageId, topic, DeliveryPath::LAN);
+    }
+    messageIdOut = messageId;
+
+    LOG_VERBOSE("PEER", "Sending %s to %s (%s) over LAN", messageId.c_str(), printerId, peerHost.c_str());
+    return true;
+}
+
+// ========================================
+// RECEIVER SIDE
+// ========================================
+
+bool queueReceivedPeerPrint(String &payload)
+{
+    if (!receivedQueue)
+    {
+        receivedQueue = xQueueCreate(peerPrintMaxQueued, sizeof(String *));
+        if (!receivedQueue)
+        {
+            return false;
+        }
+    }
+
+    String *queued = new String(std::move(payload));
+    if (xQueueSend(receivedQueue, &queued, 0) != pdTRUE)
+    {
+        payload = std::move(*queued); // Give it back so the caller still owns it
+        delete queued;
+        return false;
+    }
+    return true;
+}
+
+int getQueuedPeerPrintCount()
+{
+    return receivedQueue ? (int)uxQueueMessagesWaiting(receivedQueue) : 0;
+}
+
+// ========================================
+// MAIN LOOP
+// ========================================
+
+static void settleJob(PeerPrintJob &job)
+{
+    job.settled = true;
+
+    if (job.state == PeerJobState::ACCEPTED)
+    {
+        LOG_VERBOSE("PEER", "LAN print %s accepted by %s in %lu ms", job.messageId, job.printerId, millis() - job.startedAt);
+        return;
+    }
+
+    // Same ID over MQTT: if the peer did get the LAN copy it drops this one as a duplicate
+    LOG_WARNING("PEER", "LAN print %s to %s failed - falling back to MQTT", job.messageId, job.printerId);
+    if (job.requestAck)
+    {
+        setDeliveryPath(job.messageId, DeliveryPath::LAN_FALLBACK);
+    }
+    if (!publishRemotePrint(job.topic, job.messageId, job.header, job.body, job.requestAck))
+    {
+        LOG_ERROR("PEER", "MQTT fallback for %s failed", job.messageId);
+    }
+}
+
+void handlePeerPrint()
+{
+    // Print messages received from peers (same handling as an MQTT print message)
+    String *received = nullptr;
+    while (receivedQueue && xQueueReceive(receivedQueue, &received, 0) == pdTRUE)
+    {
+        handleMQTTMessage(peerPrintPath, *received);
+        delete received;
+    }
+
+    unsigned long now = millis();
+    for (int i = 0; i < peerPrintMaxInFlight; i++)
+    {
+        PeerPrintJob &job = peerJobs[i];
+        if (job.state == PeerJobState::FREE)
+        {
+            continue;
+        }
+
+        if (job.state == PeerJobState::SENDING && now - job.startedAt > peerPrintTimeoutMs)
+        {
+            finishJob(&job, PeerJobState::FAILED); // AsyncTCP's own timeout closes the socket
+        }
+
+        if (job.state != PeerJobState::SENDING && !job.settled)
+        {
+            settleJob(job);
+        }
+
+        if (job.settled && !job.clientOpen)
+        {
+            releaseJob(&job);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file peer_print.h
+ * @brief Direct LAN printing between printers, falling back to MQTT
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * When mqtt.peerKey is set and the target of a remote print is an online
+ * discovered printer with a known IP, the message is POSTed straight to that
+ * printer's /api/peer-print instead of going out to the broker and back. The
+ * body is the same JSON as an MQTT print message, signed as described in
+ * peer_print_auth.h. The peer replies 202 once the message is queued.
+ *
+ * Sends are non-blocking (AsyncTCP). Anything other than a 202 within
+ * peerPrintTimeoutMs is republished over MQTT with the same message ID, so a
+ * peer that did get the message drops the repeat as a duplicate.
+ */
+
+#ifndef PEER_PRINT_H
+#define PEER_PRINT_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Whether a peer key is configured (LAN printing on)
+ */
+bool isPeerPrintEnabled();
+
+/**
+ * @brief Try to send a remote print directly to a LAN peer
+ * @param topic Print topic of the target printer (scribe/<name>/print)
+ * @param header Message header
+ * @param body Message body
+ * @param requestAck Track the delivery for latency reporting
+ * @param messageIdOut Receives the message ID when the send started
+ * @return true if the LAN send started (the caller must not publish it too);
+ *         false if the target isn't a known LAN peer or no slot is free
+ */
+bool sendPeerPrint(const String &topic, const String &header, const String &body,
+                   bool requestAck, String &messageIdOut);
+
+/**
+ * @brief Hand a verified peer print to the main loop for printing
+ * @param payload Request body (moved from on success)
+ * @return false if peerPrintMaxQueued messages are already waiting
+ */
+bool queueReceivedPeerPrint(String &payload);
+
+/**
+ * @brief Number of received peer prints waiting for the main loop
+ */
+int getQueuedPeerPrintCount();
+
+/**
+ * @brief Print received peer messages and settle finished or timed-out sends
+ * Call from the main loop.
+ */
+void handlePeerPrint();
+
+#endif // PEER_PRINT_H
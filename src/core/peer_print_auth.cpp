@@ -0,0 +1,89 @@
+/**
+ * @file peer_print_auth.cpp
+ * @brief Implementation of LAN print signing
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "peer_print_auth.h"
+#include <config/config.h>
+#include <mbedtls/md.h>
+
+static bool computeSignature(const char *key, unsigned long timestamp, const char *senderId, const char *targetId,
+                             const char *body, size_t bodyLength, unsigned char *digest)
+{
+    if (!key || key[0] == '\0' || !senderId || !targetId)
+    {
+        return false;
+    }
+
+    char prefix[24];
+    int prefixLength = snprintf(prefix, sizeof(prefix), "%lu\n", timestamp);
+
+    const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+
+    bool ok = mbedtls_md_setup(&ctx, info, 1) == 0 &&
+              mbedtls_md_hmac_starts(&ctx, (const unsigned char *)key, strlen(key)) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)prefix, prefixLength) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)senderId, strlen(senderId)) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)"\n", 1) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)targetId, strlen(targetId)) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)"\n", 1) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const unsigned char *)body, bodyLength) == 0 &&
+              mbedtls_md_hmac_finish(&ctx, digest) == 0;
+
+    mbedtls_md_free(&ctx);
+    return ok;
+}
+
+bool signPeerPrint(const char *key, unsigned long timestamp, const char *senderId, const char *targetId,
+                   const char *body, size_t bodyLength, char *signatureOut)
+{
+    unsigned char digest[32];
+    if (!computeSignature(key, timestamp, senderId, targetId, body, bodyLength, digest))
+    {
+        return false;
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < sizeof(digest); i++)
+    {
+        signatureOut[i * 2] = hex[digest[i] >> 4];
+        signatureOut[i * 2 + 1] = hex[digest[i] & 0x0F];
+    }
+    signatureOut[peerSignatureHexLength] = '\0';
+    return true;
+}
+
+bool verifyPeerPrintSignature(const char *key, unsigned long timestamp, const char *senderId, const char *targetId,
+                              const char *body, size_t bodyLength, const char *signature)
+{
+    if (!signature || strlen(signature) != peerSignatureHexLength)
+    {
+        return false;
+    }
+
+    char expected[peerSignatureHexLength + 1];
+    if (!signPeerPrint(key, timestamp, senderId, targetId, body, bodyLength, expected))
+    {
+        return false;
+    }
+
+    // Accumulate differences so timing doesn't reveal how much matched
+    unsigned char diff = 0;
+    for (size_t i = 0; i < peerSignatureHexLength; i++)
+    {
+        diff |= (unsigned char)(expected[i] ^ tolower((unsigned char)signature[i]));
+    }
+    return diff == 0;
+}
+
+bool isPeerTimestampFresh(unsigned long timestamp, unsigned long now)
+{
+    unsigned long skew = timestamp > now ? timestamp - now : now - timestamp;
+    return skew <= (unsigned long)peerPrintMaxClockSkewSeconds;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file peer_print_auth.h
+ * @brief HMAC-SHA256 signing of direct LAN prints between printers
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * A LAN print carries four headers:
+ *
+ *   X-Scribe-Printer:   sender printer ID
+ *   X-Scribe-Target:    receiving printer ID
+ *   X-Scribe-Timestamp: sender UTC time, seconds since the epoch
+ *   X-Scribe-Signature: hex HMAC-SHA256(mqtt.peerKey, "<timestamp>\n<printer>\n<target>\n<body>")
+ *
+ * The timestamp bounds replays to peerPrintMaxClockSkewSeconds; within that
+ * window the message ID is caught by duplicate suppression. Signing the
+ * target stops a captured print being replayed to the rest of the fleet,
+ * whose own dedup has never seen its ID.
+ */
+
+#ifndef PEER_PRINT_AUTH_H
+#define PEER_PRINT_AUTH_H
+
+#include <Arduino.h>
+
+static const size_t peerSignatureHexLength = 64; // SHA-256 as lowercase hex
+
+/**
+ * @brief Sign a LAN print request
+ * @param key Shared peer key
+ * @param timestamp Sender UTC seconds
+ * @param senderId Sender printer ID
+ * @param targetId Receiving printer ID
+ * @param body Request body exactly as sent
+ * @param bodyLength Body length in bytes
+ * @param signatureOut Receives peerSignatureHexLength hex chars plus terminator
+ * @return false if the key is empty or hashing failed
+ */
+bool signPeerPrint(const char *key, unsigned long timestamp, const char *senderId, const char *targetId,
+                   const char *body, size_t bodyLength, char *signatureOut);
+
+/**
+ * @brief Check a LAN print signature (constant time)
+ * @return true if the signature matches
+ */
+bool verifyPeerPrintSignature(const char *key, unsigned long timestamp, const char *senderId, const char *targetId,
+                              const char *body, size_t bodyLength, const char *signature);
+
+/**
+ * @brief Check a signed timestamp against our clock
+ * @param timestamp Timestamp from the request
+ * @param now Our UTC seconds
+ * @return true if within peerPrintMaxClockSkewSeconds either way
+ */
+bool isPeerTimestampFresh(unsigned long timestamp, unsigned long now);
+
+#endif // PEER_PRINT_AUTH_H
@@ -2,13 +2,56 @@
 #include "mqtt_handler.h"
 #include "config_utils.h"
 #include "logging.h"
+#include "mdns_discovery.h"
+#include "peer_print.h"
+#include "delivery_tracker.h"
+#include "fleet_balancer.h"
 #include <config/config.h>
 #include <utils/time_utils.h>
 #include <web/web_server.h>
 #include <WiFi.h>
 #include <esp_chip_info.h>
+#include <esp_random.h>
 
-std::vector<DiscoveredPrinter> discoveredPrinters;
+static DiscoveredPrinterTable discoveredPrinters;
+static portMUX_TYPE discoveredPrintersMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Heartbeat state - fingerprint of the last retained status and the ping back-off
+static uint32_t publishedStatusHash = 0;
+static unsigned long pingIntervalMs = printerDiscoveryHeartbeatIntervalMs;
+static unsigned long nextPingAt = 0;
+static uint32_t publishedSummaryHash = 0;
+static uint32_t advertisedTxtHash = 0;
+
+// "scribe/" when unscoped, "scribe/site/<scope>/" when scoped
+static String getDiscoveryTopicRoot(const String &scope)
+{
+    if (scope.length() == 0 || !isValidMqttGroupName(scope))
+    {
+        return discoveryRootTopic;
+    }
+    return String(discoverySiteTopicPrefix) + scope + "/";
+}
+
+static String getDiscoveryTopicRoot()
+{
+    return getDiscoveryTopicRoot(getRuntimeConfig().mqttDiscoveryScope);
+}
+
+String getPrinterStatusTopic(const String &printerId)
+{
+    return getDiscoveryTopicRoot() + printerStatusTopicLevel + printerId;
+}
+
+String getPrinterStatusFilter()
+{
+    return getDiscoveryTopicRoot() + printerStatusTopicLevel + "+";
+}
+
+String getPrinterPingFilter()
+{
+    return getDiscoveryTopicRoot() + printerPingTopicLevel + "+";
+}
 
 String getPrinterId()
 {
@@ -38,21 +81,53 @@ void setupPrinterDiscovery()
     LOG_VERBOSE("DISCOVERY", "Printer discovery system initialized");
 }
 
-void publishPrinterStatus()
+// 32-bit FNV-1a of the status payload - any field change alters it
+static uint32_t hashStatusPayload(const String &payload)
 {
-    LOG_VERBOSE("DISCOVERY", "publishPrinterStatus() called");
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < payload.length(); i++)
+    {
+        hash ^= (uint8_t)payload[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-    if (!mqttClient.connected())
+// Only the fields setServiceTxt() in mdns_discovery.cpp advertises, so queue depth changes leave mDNS alone
+static uint32_t hashAdvertisedTxt()
+{
+    String fields = getPrinterId() + "\n" + getLocalPrinterName() + "\n" + getFirmwareVersion() + "\n" +
+                    getRuntimeConfig().mqttDiscoveryScope + "\n" + getAdvertisedGroups();
+    return hashStatusPayload(fields);
+}
+
+String getAdvertisedGroups()
+{
+    // Whole names only, within what a discovered printer entry can hold
+    String groups;
+    for (const String &name : getMqttGroupNames())
     {
-        LOG_WARNING("DISCOVERY", "MQTT not connected, cannot publish status");
-        return;
+        if (groups.length() + name.length() + 1 >= sizeof(DiscoveredPrinter::groups))
+        {
+            break;
+        }
+        if (groups.length() > 0)
+        {
+            groups += ',';
+        }
+        groups += name;
     }
+    return groups;
+}
 
-    String printerId = getPrinterId();
-    String statusTopic = "scribe/printer-status/" + printerId;
-    LOG_VERBOSE("DISCOVERY", "Publishing status to topic: %s", statusTopic.c_str());
+int getLocalPrintQueueDepth()
+{
+    return (currentMessage.shouldPrintLocally ? 1 : 0) + getQueuedPeerPrintCount();
+}
 
-    DynamicJsonDocument doc(512);
+static String buildPrinterStatusPayload()
+{
+    DynamicJsonDocument doc(768);
     doc["name"] = getLocalPrinterName();
     doc["firmware_version"] = getFirmwareVersion();
     doc["mdns"] = String(getMdnsHostname()) + ".local";
@@ -60,15 +135,45 @@ void publishPrinterStatus()
     doc["status"] = "online";
     doc["last_power_on"] = getDeviceBootTime();
     doc["timezone"] = getTimezone();
+    doc["groups"] = getAdvertisedGroups();
+    doc["queue_depth"] = getLocalPrintQueueDepth();
 
     String payload;
     serializeJson(doc, payload);
+    return payload;
+}
+
+// Next ping after a jittered interval; the interval doubles each ping until a status publish resets it
+static void scheduleNextPing(unsigned long now, bool resetBackoff)
+{
+    pingIntervalMs = resetBackoff ? printerDiscoveryHeartbeatIntervalMs : min(pingIntervalMs * 2, printerPingMaxIntervalMs);
+
+    unsigned long jitterSpan = pingIntervalMs * printerPingJitterPercent / 100;
+    nextPingAt = now + pingIntervalMs - jitterSpan + esp_random() % (2 * jitterSpan + 1);
+}
+
+void publishPrinterStatus()
+{
+    LOG_VERBOSE("DISCOVERY", "publishPrinterStatus() called");
+
+    if (!mqttClient.connected())
+    {
+        LOG_WARNING("DISCOVERY", "MQTT not connected, cannot publish status");
+        return;
+    }
+
+    String statusTopic = getPrinterStatusTopic(getPrinterId());
+    LOG_VERBOSE("DISCOVERY", "Publishing status to topic: %s", statusTopic.c_str());
+
+    String payload = buildPrinterStatusPayload();
     LOG_VERBOSE("DISCOVERY", "Status payload: %s", payload.c_str());
 
     bool published = mqttClient.publish(statusTopic.c_str(), payload.c_str(), true);
     if (published)
     {
         LOG_VERBOSE("DISCOVERY", "Published status to %s", statusTopic.c_str());
+        publishedStatusHash = hashStatusPayload(payload);
+        scheduleNextPing(millis(), true);
     }
     else
     {
@@ -76,6 +181,23 @@ void publishPrinterStatus()
     }
 }
 
+static void publishPrinterPing()
+{
+    // Tiny non-retained liveness ping: the fingerprint of the retained status
+    String pingTopic = getDiscoveryTopicRoot() + printerPingTopicLevel + getPrinterId();
+    char payload[9];
+    snprintf(payload, sizeof(payload), "%08lx", (unsigned long)publishedStatusHash);
+
+    if (mqttClient.publish(pingTopic.c_str(), payload, false))
+    {
+        LOG_VERBOSE("DISCOVERY", "Published ping to %s", pingTopic.c_str());
+    }
+    else
+    {
+        LOG_WARNING("DISCOVERY", "Failed to publish ping to %s", pingTopic.c_str());
+    }
+}
+
 void onPrinterStatusMessage(const String &topic, const String &payload)
 {
     String printerId = topic.substring(topic.lastIndexOf('/') + 1);
@@ -87,16 +209,23 @@ void onPrinterStatusMessage(const String &topic, const String &payload)
     //     return; // Ignore our own status messages
     // }
 
-    // Check for empty payload
+    // Empty payload clears the retained status - the printer left this scope
     if (payload.length() == 0)
     {
-        LOG_WARNING("DISCOVERY", "Received empty status payload from printer %s - ignoring", printerId.c_str());
+        lockDiscoveredPrinters();
+        bool removed = discoveredPrinters.remove(printerId.c_str());
+        unlockDiscoveredPrinters();
+        if (removed)
+        {
+            LOG_VERBOSE("DISCOVERY", "Printer %s cleared its status - removed", printerId.c_str());
+            sendPrinterUpdate();
+        }
         return;
     }
 
     LOG_VERBOSE("DISCOVERY", "Received status from printer %s: %s", printerId.c_str(), payload.c_str());
 
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(768);
     DeserializationError error = deserializeJson(doc, payload);
 
     if (error)
@@ -108,79 +237,297 @@ void onPrinterStatusMessage(const String &topic, const String &payload)
     String status = doc["status"] | "unknown";
     unsigned long currentTime = millis();
 
-    // Find existing printer or create new entry
-    bool found = false;
-    for (auto &printer : discoveredPrinters)
+    if (status == "offline")
     {
-        if (printer.printerId == printerId)
+        DiscoveredPrinter *printer = discoveredPrinters.find(printerId.c_str());
+        if (printer && printer->online)
         {
-            // Update existing printer
-            if (status == "offline")
-            {
-                printer.status = "offline";
-                LOG_VERBOSE("DISCOVERY", "Printer %s went offline (payload: %s)", printer.name.c_str(), payload.c_str());
+            lockDiscoveredPrinters();
+            printer->online = false;
+            discoveredPrinters.markChanged(printer);
+            unlockDiscoveredPrinters();
+            LOG_VERBOSE("DISCOVERY", "Printer %s went offline (payload: %s)", printer->name, payload.c_str());
 
-                // Notify web clients via SSE
-                sendPrinterUpdate();
-            }
-            else
-            {
-                printer.name = doc["name"] | printer.name;
-                printer.firmwareVersion = doc["firmware_version"] | printer.firmwareVersion;
-                printer.mdns = doc["mdns"] | printer.mdns;
-                printer.ipAddress = doc["ip_address"] | printer.ipAddress;
-                printer.status = "online";
-                printer.lastPowerOn = doc["last_power_on"] | printer.lastPowerOn;
-                printer.timezone = doc["timezone"] | printer.timezone;
-                printer.lastSeen = currentTime;
-
-                LOG_VERBOSE("DISCOVERY", "Updated printer %s (%s)", printer.name.c_str(), printer.ipAddress.c_str());
-
-                // Notify web clients via SSE
-                sendPrinterUpdate();
-            }
-            found = true;
-            break;
+            // Notify web clients via SSE
+            sendPrinterUpdate();
         }
+        return;
     }
 
-    if (!found && status != "offline")
+    // Field lookups in the parsed document don't allocate, so they can run under the lock
+    bool added = false;
+    lockDiscoveredPrinters();
+    DiscoveredPrinter *printer = discoveredPrinters.findOrAdd(printerId.c_str(), currentTime, added);
+    if (!printer)
     {
-        // Add new printer
-        DiscoveredPrinter newPrinter;
-        newPrinter.printerId = printerId;
-        newPrinter.name = doc["name"] | "Unknown";
-        newPrinter.firmwareVersion = doc["firmware_version"] | "Unknown";
-        newPrinter.mdns = doc["mdns"] | "";
-        newPrinter.ipAddress = doc["ip_address"] | "";
-        newPrinter.status = "online";
-        newPrinter.lastPowerOn = doc["last_power_on"] | "";
-        newPrinter.timezone = doc["timezone"] | "";
-        newPrinter.lastSeen = currentTime;
+        unlockDiscoveredPrinters();
+        LOG_WARNING("DISCOVERY", "Invalid printer ID in topic %s - ignoring", topic.c_str());
+        return;
+    }
 
-        discoveredPrinters.push_back(newPrinter);
-        LOG_VERBOSE("DISCOVERY", "Discovered new printer %s (%s)", newPrinter.name.c_str(), newPrinter.ipAddress.c_str());
+    // New entries get defaults; existing entries keep fields the payload omits
+    bool changed = added || !printer->online;
+    changed |= copyPrinterField(printer->name, doc["name"] | (added ? "Unknown" : printer->name));
+    changed |= copyPrinterField(printer->firmwareVersion, doc["firmware_version"] | (added ? "Unknown" : printer->firmwareVersion));
+    changed |= copyPrinterField(printer->mdns, doc["mdns"] | printer->mdns);
+    changed |= copyPrinterField(printer->ipAddress, doc["ip_address"] | printer->ipAddress);
+    changed |= copyPrinterField(printer->lastPowerOn, doc["last_power_on"] | printer->lastPowerOn);
+    changed |= copyPrinterField(printer->timezone, doc["timezone"] | printer->timezone);
+    changed |= copyPrinterField(printer->groups, doc["groups"] | printer->groups);
+    uint8_t queueDepth = constrain(doc["queue_depth"] | (int)printer->queueDepth, 0, 255);
+    changed |= queueDepth != printer->queueDepth;
+    printer->queueDepth = queueDepth;
+    printer->online = true;
+    printer->lastSeen = currentTime;
+    printer->sources |= DISCOVERY_SOURCE_MQTT;
+    if (changed && !added)
+    {
+        discoveredPrinters.markChanged(printer);
+    }
+    unlockDiscoveredPrinters();
 
-        // Notify web clients via SSE
-        sendPrinterUpdate();
+    if (!changed)
+    {
+        // Plain heartbeat - refreshes lastSeen only, nothing for web clients
+        return;
+    }
+
+    LOG_VERBOSE("DISCOVERY", "%s printer %s (%s)", added ? "Discovered new" : "Updated", printer->name, printer->ipAddress);
+
+    // Notify web clients via SSE
+    sendPrinterUpdate();
+}
+
+void onPrinterPingMessage(const String &topic, const String &payload)
+{
+    String printerId = topic.substring(topic.lastIndexOf('/') + 1);
+
+    // A ping only keeps a known printer alive - status changes arrive as retained status
+    DiscoveredPrinter *printer = discoveredPrinters.find(printerId.c_str());
+    if (printer && printer->online)
+    {
+        lockDiscoveredPrinters();
+        printer->lastSeen = millis();
+        unlockDiscoveredPrinters();
+    }
+    else
+    {
+        LOG_VERBOSE("DISCOVERY", "Ping from unknown or offline printer %s ignored", printerId.c_str());
+    }
+}
+
+// Lowest online printer ID in the scope publishes the summary, so there is one writer
+static bool isDiscoverySummaryLeader(const String &ourPrinterId)
+{
+    for (const DiscoveredPrinter &printer : discoveredPrinters)
+    {
+        if (printer.online && strcmp(printer.printerId, ourPrinterId.c_str()) < 0)
+        {
+            return false;
+        }
     }
+    return true;
+}
+
+static void publishDiscoverySummary()
+{
+    String ourPrinterId = getPrinterId();
+    if (!isDiscoverySummaryLeader(ourPrinterId))
+    {
+        return;
+    }
+
+    int online = 0;
+    for (const DiscoveredPrinter &printer : discoveredPrinters)
+    {
+        if (printer.online)
+        {
+            online++;
+        }
+    }
+
+    DynamicJsonDocument doc(256);
+    doc["scope"] = getRuntimeConfig().mqttDiscoveryScope;
+    doc["online"] = online;
+    doc["known"] = discoveredPrinters.size();
+    doc["updated_by"] = ourPrinterId;
+
+    String payload;
+    serializeJson(doc, payload);
+    uint32_t summaryHash = hashStatusPayload(payload);
+    if (summaryHash == publishedSummaryHash)
+    {
+        return;
+    }
+
+    String summaryTopic = getDiscoveryTopicRoot() + discoverySummaryTopicLevel;
+    if (mqttClient.publish(summaryTopic.c_str(), payload.c_str(), true))
+    {
+        publishedSummaryHash = summaryHash;
+        LOG_VERBOSE("DISCOVERY", "Published discovery summary to %s: %s", summaryTopic.c_str(), payload.c_str());
+    }
+}
+
+void clearRetainedPrinterStatus(const String &scope)
+{
+    if (!mqttClient.connected())
+    {
+        return;
+    }
+
+    String statusTopic = getDiscoveryTopicRoot(scope) + printerStatusTopicLevel + getPrinterId();
+    if (mqttClient.publish(statusTopic.c_str(), "", true))
+    {
+        LOG_VERBOSE("DISCOVERY", "Cleared retained status on %s", statusTopic.c_str());
+    }
+}
+
+void resetPrinterDiscovery()
+{
+    lockDiscoveredPrinters();
+    discoveredPrinters.clear();
+    unlockDiscoveredPrinters();
+    publishedStatusHash = 0;
+    publishedSummaryHash = 0;
+    sendPrinterUpdate();
 }
 
 void handlePrinterDiscovery()
 {
-    // Periodic heartbeat publishing - keeps printer visible to others
     unsigned long currentTime = millis();
-    static unsigned long lastStatusPublish = 0;
-    const unsigned long STATUS_PUBLISH_INTERVAL = printerDiscoveryHeartbeatIntervalMs;
 
-    if (currentTime - lastStatusPublish > STATUS_PUBLISH_INTERVAL)
+    // Look for status changes (name, IP, timezone, firmware)
+    static unsigned long lastStatusCheck = 0;
+    if (currentTime - lastStatusCheck >= printerStatusCheckIntervalMs)
     {
-        publishPrinterStatus();
-        lastStatusPublish = currentTime;
+        lastStatusCheck = currentTime;
+        String payload = buildPrinterStatusPayload();
+
+        uint32_t advertisedHash = hashAdvertisedTxt();
+        if (advertisedHash != advertisedTxtHash)
+        {
+            advertisedTxtHash = advertisedHash;
+            updateMdnsServiceTxt();
+        }
+
+        if (mqttClient.connected())
+        {
+            // Publish the retained status as soon as anything in it changes
+            if (hashStatusPayload(payload) != publishedStatusHash)
+            {
+                LOG_VERBOSE("DISCOVERY", "Printer status changed - republishing");
+                publishPrinterStatus();
+            }
+
+            if (getRuntimeConfig().mqttDiscoverySummary)
+            {
+                publishDiscoverySummary();
+            }
+        }
+    }
+
+    // Otherwise just a backed-off liveness ping
+    if (mqttClient.connected() && (long)(currentTime - nextPingAt) >= 0)
+    {
+        publishPrinterPing();
+        scheduleNextPing(currentTime, false);
     }
+
+    // LAN discovery over mDNS runs with or without MQTT
+    if (handleMdnsDiscovery(discoveredPrinters))
+    {
+        sendPrinterUpdate();
+    }
+
+    // Forget printers that stopped sending heartbeats
+    static unsigned long lastExpiryCheck = 0;
+    if (currentTime - lastExpiryCheck > printerDiscoveryHeartbeatIntervalMs)
+    {
+        lastExpiryCheck = currentTime;
+        lockDiscoveredPrinters();
+        int expired = discoveredPrinters.expire(currentTime, discoveredPrinterTtlMs);
+        unlockDiscoveredPrinters();
+        if (expired > 0)
+        {
+            LOG_VERBOSE("DISCOVERY", "Expired %d stale printer(s)", expired);
+            sendPrinterUpdate();
+        }
+    }
+}
+
+uint32_t getDiscoveredPrintersVersion()
+{
+    lockDiscoveredPrinters();
+    uint32_t version = discoveredPrinters.getVersion();
+    unlockDiscoveredPrinters();
+    return version;
 }
 
-std::vector<DiscoveredPrinter> getDiscoveredPrinters()
+std::unique_ptr<DiscoveredPrinterTable> copyDiscoveredPrinters()
 {
-    return discoveredPrinters;
+    // Allocated before the lock is taken
+    std::unique_ptr<DiscoveredPrinterTable> copy = std::make_unique<DiscoveredPrinterTable>();
+    lockDiscoveredPrinters();
+    *copy = discoveredPrinters;
+    unlockDiscoveredPrinters();
+    return copy;
+}
+
+void lockDiscoveredPrinters()
+{
+    portENTER_CRITICAL(&discoveredPrintersMux);
+}
+
+void unlockDiscoveredPrinters()
+{
+    portEXIT_CRITICAL(&discoveredPrintersMux);
+}
+
+bool pickGroupPrinter(const String &group, String &topicOut, String &printerIdOut)
+{
+    FleetCandidate candidates[maxOtherPrinters + 1];
+    const char *topics[maxOtherPrinters + 1];
+    char topicBuffers[maxOtherPrinters + 1][topicBufferSize];
+    int count = 0;
+
+    // This printer competes too if it belongs to the group
+    String ourId = getPrinterId();
+    bool weAreMember = false;
+    for (const String &name : getMqttGroupNames())
+    {
+        weAreMember |= name == group;
+    }
+    if (weAreMember)
+    {
+        snprintf(topicBuffers[count], topicBufferSize, "%s", getLocalPrinterTopic());
+        topics[count] = topicBuffers[count];
+        candidates[count] = {ourId.c_str(), getLocalPrintQueueDepth(), countPendingDeliveries(topics[count])};
+        count++;
+    }
+
+    // Called from web handlers, so candidates come from a copy the main loop can't change underneath
+    std::unique_ptr<DiscoveredPrinterTable> printers = copyDiscoveredPrinters();
+    for (const DiscoveredPrinter &printer : *printers)
+    {
+        if (!printer.online || !isInGroupList(printer.groups, group.c_str()) || ourId == printer.printerId)
+        {
+            continue;
+        }
+        snprintf(topicBuffers[count], topicBufferSize, "%s", buildMqttTopic(printer.name));
+        topics[count] = topicBuffers[count];
+        candidates[count] = {printer.printerId, printer.queueDepth, countPendingDeliveries(topics[count])};
+        count++;
+    }
+
+    int chosen = pickLeastLoadedPrinter(candidates, count);
+    if (chosen < 0)
+    {
+        return false;
+    }
+
+    topicOut = topics[chosen];
+    printerIdOut = candidates[chosen].printerId;
+    LOG_VERBOSE("DISCOVERY", "Group %s: %d candidates, chose %s (load %d)", group.c_str(), count,
+                candidates[chosen].printerId, candidates[chosen].queueDepth + candidates[chosen].pendingJobs);
+    return true;
 }
@@ -3,18 +3,45 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <vector>
-#include "shared_types.h"
+#include "discovered_printer_table.h"
+#include <memory>
 
 void setupPrinterDiscovery();
 void handlePrinterDiscovery();
 void publishPrinterStatus();
 void onPrinterStatusMessage(const String &topic, const String &payload);
-std::vector<DiscoveredPrinter> getDiscoveredPrinters();
+void onPrinterPingMessage(const String &topic, const String &payload);
+
+// Copy of the table for other tasks (web handlers), taken under the table lock
+std::unique_ptr<DiscoveredPrinterTable> copyDiscoveredPrinters();
+
+// Table version, read under the lock - check it before paying for a copy
+uint32_t getDiscoveredPrintersVersion();
+
+// Held around every change to the table; keep it short - no logging or allocation inside
+void lockDiscoveredPrinters();
+void unlockDiscoveredPrinters();
+
 String getPrinterId();
 String getFirmwareVersion();
 String createOfflinePayload();
 
-extern std::vector<DiscoveredPrinter> discoveredPrinters;
+// Discovery topics, under "scribe/site/<scope>/" when mqtt.discoveryScope is set
+String getPrinterStatusTopic(const String &printerId);
+String getPrinterStatusFilter();
+String getPrinterPingFilter();
+
+// Publish an empty retained status for a scope (removes this printer from it)
+void clearRetainedPrinterStatus(const String &scope);
+
+// Forget all discovered printers (e.g. when the MQTT client is restarted)
+void resetPrinterDiscovery();
+
+// Load advertised in our status: groups we belong to and jobs waiting to print
+String getAdvertisedGroups();
+int getLocalPrintQueueDepth();
+
+// Least loaded online printer in a group (including this one if a member), see fleet_balancer.h
+bool pickGroupPrinter(const String &group, String &topicOut, String &printerIdOut);
 
 #endif
@@ -37,20 +37,31 @@ struct Message
 
 /**
  * @brief Structure to hold discovered printer information
+ *
+ * Fixed-size fields so the discovery table never allocates per printer.
+ * Longer values from status messages are truncated.
  */
 struct DiscoveredPrinter
 {
-    String printerId;
-    String name;
-    String firmwareVersion;
-    String mdns;
-    String ipAddress;
-    String status;
-    String lastPowerOn;
-    String timezone;
+    char printerId[17];
+    char name[48];
+    char firmwareVersion[24];
+    char mdns[64];
+    char ipAddress[40];
+    char lastPowerOn[32];
+    char timezone[64];
+    char groups[96]; ///< Comma-separated MQTT groups the printer belongs to
+    bool online;
     unsigned long lastSeen;
+    uint32_t version; ///< Table version of the last visible change
+    uint8_t sources;  ///< DISCOVERY_SOURCE_* bits - how this printer has been seen
+    uint8_t queueDepth; ///< Jobs waiting to print, as last advertised
 };
 
+/// DiscoveredPrinter::sources bits
+static const uint8_t DISCOVERY_SOURCE_MQTT = 0x01;
+static const uint8_t DISCOVERY_SOURCE_MDNS = 0x02;
+
 /// Global variable to store current message for printing
 extern Message currentMessage;
 
@@ -157,3 +157,41 @@ export async function loadRoutes() {
     throw error;
   }
 }
+
+/**
+ * Load log lines from the device
+ * @param {Object} options - Query options
+ * @param {number} [options.since] - Cursor from the previous call; only newer lines are returned
+ * @param {string} [options.level] - Most verbose level to include (e.g. 'WARNING')
+ * @param {string} [options.component] - Only this component (e.g. 'MQTT')
+ * @param {string} [options.source] - 'ring' (recent, default), 'file' or 'all'
+ * @returns {Promise<Object>} { lines, next, missed } - pass next back as since to follow the log
+ */
+export async function loadLogs({ since, level, component, source } = {}) {
+  try {
+    const params = new URLSearchParams();
+    if (since !== undefined) params.set("since", since);
+    if (level) params.set("level", level);
+    if (component) params.set("component", component);
+    if (source) params.set("source", source);
+
+    const response = await fetch(`/api/logs?${params}`);
+    if (!response.ok) {
+      throw new Error(
+        `Logs API returned ${response.status}: ${response.statusText}`,
+      );
+    }
+
+    // Newline-delimited JSON; the last object is the cursor
+    const text = await response.text();
+    const lines = text
+      .split("\n")
+      .filter((line) => line.length > 0)
+      .map((line) => JSON.parse(line));
+    const trailer = lines.pop() || {};
+    return { lines, next: trailer.next, missed: trailer.missed || 0 };
+  } catch (error) {
+    console.error("API: Failed to load logs:", error);
+    throw error;
+  }
+}
@@ -59,20 +59,25 @@ export async function printLocalContent(content) {
  * Print content via MQTT to remote printer
  * @param {string} header - Content header (e.g., "JOKE", "RIDDLE")
  * @param {string} body - Content body
- * @param {string} topic - MQTT topic for the target printer
+ * @param {string} topic - MQTT topic for the target printer, or "group:<name>"
+ *   to let the device pick the least busy printer in that group
  * @returns {Promise<Object>} Print response from server
  */
 export async function printMQTT(header, body, topic) {
   try {
     console.log(`API: Sending content to MQTT printer on topic: ${topic}`);
 
+    const target = topic.startsWith("group:")
+      ? { group: topic.slice("group:".length) }
+      : { topic: topic };
+
     const response = await fetch("/api/print-mqtt", {
       method: "POST",
       headers: { "Content-Type": "application/json" },
       body: JSON.stringify({
         header: header,
         body: body,
-        topic: topic,
+        ...target,
       }),
     });
 
@@ -171,3 +176,17 @@ export async function loadMemos() {
     throw error;
   }
 }
+
+/**
+ * Load the discovered printer snapshot (used to resync after a missed SSE delta)
+ * @returns {Promise<Object>} Snapshot with discovered_printers and version
+ */
+export async function loadDiscoveredPrinters() {
+  const response = await fetch("/api/discovered-printers");
+  if (!response.ok) {
+    throw new Error(
+      `Discovered printers API returned ${response.status}: ${response.statusText}`,
+    );
+  }
+  return await response.json();
+}
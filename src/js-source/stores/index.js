@@ -10,6 +10,7 @@ import {
   printLocalContent,
   printMQTT,
   executeQuickAction,
+  loadDiscoveredPrinters,
 } from "../api/index.js";
 
 // Confetti helpers to enforce consistent per-container parameters
@@ -59,6 +60,8 @@ export function createIndexStore() {
 
     // Printer state
     printers: [],
+    discoveredPrinters: {}, // printer_id -> printer, kept in sync by SSE deltas
+    printersVersion: 0,
     localPrinterName: "Unknown",
 
     // UI state
@@ -234,6 +237,26 @@ export function createIndexStore() {
           selected: this.selectedPrinter === topic,
         });
       });
+
+      // One entry per advertised group - the device sends to its least busy printer
+      const groups = new Set();
+      discoveredPrinters.forEach((printer) => {
+        (printer.groups || "")
+          .split(",")
+          .filter((group) => group)
+          .forEach((group) => groups.add(group));
+      });
+      [...groups].sort().forEach((group) => {
+        const value = `group:${group}`;
+        this.printers.push({
+          value,
+          icon: "megaphone",
+          name: `Group: ${group}`,
+          isLocal: false,
+          isGroup: true,
+          selected: this.selectedPrinter === value,
+        });
+      });
     },
 
     // Setup event listeners
@@ -967,7 +990,7 @@ export function createIndexStore() {
         // Create new SSE connection
         eventSource = new EventSource("/mqtt-printers");
 
-        // Handle remote printer (MQTT) updates
+        // Handle remote printer (MQTT) updates - full snapshot
         eventSource.addEventListener("printer-update", (event) => {
           try {
             const data = JSON.parse(event.data);
@@ -977,6 +1000,16 @@ export function createIndexStore() {
           }
         });
 
+        // Handle remote printer (MQTT) changes since the previous version
+        eventSource.addEventListener("printer-delta", (event) => {
+          try {
+            const data = JSON.parse(event.data);
+            this.applyPrinterDelta(data);
+          } catch (error) {
+            console.error("Error parsing remote printer (MQTT) delta:", error);
+          }
+        });
+
         // Handle system status updates (pipe into inline error state)
         eventSource.addEventListener("system-status", (event) => {
           try {
@@ -1032,19 +1065,58 @@ export function createIndexStore() {
 
     updatePrintersFromData(data) {
       if (data && data.discovered_printers) {
-        // Update the store's printers array directly
-        this.printers = data.discovered_printers;
-
-        // Also dispatch custom event for backward compatibility if needed
-        const event = new CustomEvent("printersUpdated", {
-          detail: {
-            printers: data.discovered_printers,
-          },
+        this.discoveredPrinters = {};
+        data.discovered_printers.forEach((printer) => {
+          this.discoveredPrinters[printer.printer_id] = printer;
         });
-        document.dispatchEvent(event);
+        this.printersVersion = data.version || 0;
+        this.publishPrinters();
       }
     },
 
+    applyPrinterDelta(data) {
+      if (!data || data.version <= this.printersVersion) {
+        return; // Already have these changes (e.g. snapshot raced the delta)
+      }
+      if (data.from_version > this.printersVersion) {
+        // Missed a delta - fetch a fresh snapshot
+        this.resyncPrinters();
+        return;
+      }
+
+      (data.removed || []).forEach((printerId) => {
+        delete this.discoveredPrinters[printerId];
+      });
+      (data.printers || []).forEach((printer) => {
+        this.discoveredPrinters[printer.printer_id] = printer;
+      });
+      this.printersVersion = data.version;
+      this.publishPrinters();
+    },
+
+    async resyncPrinters() {
+      try {
+        this.updatePrintersFromData(await loadDiscoveredPrinters());
+      } catch (error) {
+        console.error("Failed to resync remote printers (MQTT):", error);
+      }
+    },
+
+    publishPrinters() {
+      const printers = Object.values(this.discoveredPrinters);
+
+      // Update the store's printers array directly
+      this.printers = printers;
+
+      // Also dispatch custom event for backward compatibility if needed
+      const event = new CustomEvent("printersUpdated", {
+        detail: {
+          printers,
+        },
+      });
+      document.dispatchEvent(event);
+    },
+
     // Removed SSE notification popups; using inline error state instead
   };
 
@@ -35,6 +35,7 @@
 #include "hardware/printer.h"
 #include "core/mqtt_handler.h"
 #include "core/printer_discovery.h"
+#include "core/peer_print.h"
 #include "utils/time_utils.h"
 #include "core/logging.h"
 #include "hardware/hardware_buttons.h"
@@ -116,7 +117,7 @@ void setup()
 
   // Log logging system configuration
   LOG_VERBOSE("BOOT", "Logging system initialized - Level: %s, Serial: %s, File: %s, MQTT: %s, BetterStack: %s",
-              getLogLevelString(logLevel).c_str(),
+              getLogLevelString(getLogLevel()).c_str(),
               enableSerialLogging ? "ON" : "OFF",
               enableFileLogging ? "ON" : "OFF",
               enableMQTTLogging ? "ON" : "OFF",
@@ -269,15 +270,22 @@ void loop()
   // Handle web server requests - AsyncWebServer handles this automatically
   // No need to call server.handleClient() with async server
 
-  if (currentWiFiMode == WIFI_MODE_STA_CONNECTED && isMQTTEnabled())
+  if (currentWiFiMode == WIFI_MODE_STA_CONNECTED)
   {
-    // Handle MQTT connection and messages (only in STA mode when MQTT enabled)
+    // Handle MQTT connection and messages (STA mode only). Runs with MQTT disabled
+    // too, so a stop requested by a config save still takes effect
     handleMQTTConnection();
 
-    // Handle printer discovery (only in STA mode when MQTT enabled)
+    // Handle printer discovery (STA mode; mDNS works without MQTT)
     handlePrinterDiscovery();
+
+    // Print messages from LAN peers, settle outgoing LAN sends
+    handlePeerPrint();
   }
 
+  // Publish MQTT log lines queued by the log sink task
+  handleLogging();
+
   // Check if we have a new message to print
   if (currentMessage.shouldPrintLocally)
   {
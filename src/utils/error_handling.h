@@ -64,7 +64,8 @@ struct Result {
     // Log error if present
     void logIfError(const char* component) const {
         if (isError()) {
-            LOG_ERROR(component, "%s: %s", errorCodeToString(error), message.c_str());
+            // Runtime component name, so not filterable at compile time
+            structuredLog(component, LOG_LEVEL_ERROR, "%s: %s", errorCodeToString(error), message.c_str());
         }
     }
 };
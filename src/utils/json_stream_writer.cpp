@@ -0,0 +1,220 @@
+/**
+ * @file json_stream_writer.cpp
+ * @brief Implementation of the fixed-buffer JSON stream writer
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "json_stream_writer.h"
+#include <math.h>
+
+void JsonStreamWriter::append(const char *text, size_t length)
+{
+    bytesWritten += length;
+    while (length > 0)
+    {
+        if (buffered == sizeof(buffer))
+        {
+            flush();
+        }
+        size_t chunk = min(length, sizeof(buffer) - buffered);
+        memcpy(buffer + buffered, text, chunk);
+        buffered += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+void JsonStreamWriter::flush()
+{
+    if (buffered > 0)
+    {
+        out.write((const uint8_t *)buffer, buffered);
+        buffered = 0;
+    }
+}
+
+size_t JsonStreamWriter::write(uint8_t c)
+{
+    append((const char *)&c, 1);
+    return 1;
+}
+
+size_t JsonStreamWriter::write(const uint8_t *data, size_t length)
+{
+    append((const char *)data, length);
+    return length;
+}
+
+void JsonStreamWriter::separate(const char *key)
+{
+    // Nesting deeper than the bitmask shares its last bit - still valid JSON as long as levels close in order
+    uint32_t bit = 1UL << min(depth, jsonStreamMaxDepth - 1);
+    if (depth > 0 && (hasMembers & bit))
+    {
+        append(",", 1);
+    }
+    hasMembers |= bit;
+
+    if (key)
+    {
+        writeString(key);
+        append(":", 1);
+    }
+}
+
+void JsonStreamWriter::open(const char *key, char bracket)
+{
+    separate(key);
+    append(&bracket, 1);
+    depth++;
+    hasMembers &= ~(1UL << min(depth, jsonStreamMaxDepth - 1));
+}
+
+void JsonStreamWriter::close(char bracket)
+{
+    if (depth > 0)
+    {
+        depth--;
+    }
+    append(&bracket, 1);
+}
+
+void JsonStreamWriter::beginObject(const char *key)
+{
+    open(key, '{');
+}
+
+void JsonStreamWriter::endObject()
+{
+    close('}');
+}
+
+void JsonStreamWriter::beginArray(const char *key)
+{
+    open(key, '[');
+}
+
+void JsonStreamWriter::endArray()
+{
+    close(']');
+}
+
+void JsonStreamWriter::writeString(const char *text)
+{
+    append("\"", 1);
+    const char *run = text;
+    for (const char *p = text; *p; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue; // UTF-8 passes through untouched
+        }
+
+        append(run, p - run);
+        run = p + 1;
+
+        char escape[7];
+        switch (c)
+        {
+        case '"':
+            append("\\\"", 2);
+            break;
+        case '\\':
+            append("\\\\", 2);
+            break;
+        case '\n':
+            append("\\n", 2);
+            break;
+        case '\r':
+            append("\\r", 2);
+            break;
+        case '\t':
+            append("\\t", 2);
+            break;
+        case '\b':
+            append("\\b", 2);
+            break;
+        case '\f':
+            append("\\f", 2);
+            break;
+        default:
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            append(escape, 6);
+            break;
+        }
+    }
+    append(run, strlen(run));
+    append("\"", 1);
+}
+
+void JsonStreamWriter::field(const char *key, const char *value)
+{
+    separate(key);
+    if (value)
+    {
+        writeString(value);
+    }
+    else
+    {
+        append("null", 4);
+    }
+}
+
+void JsonStreamWriter::field(const char *key, bool value)
+{
+    separate(key);
+    append(value ? "true" : "false");
+}
+
+void JsonStreamWriter::field(const char *key, double value)
+{
+    separate(key);
+    if (!isfinite(value))
+    {
+        append("null", 4);
+        return;
+    }
+    char number[24];
+    int length = snprintf(number, sizeof(number), "%.7g", value);
+    append(number, length);
+}
+
+void JsonStreamWriter::field(const char *key, std::nullptr_t)
+{
+    separate(key);
+    append("null", 4);
+}
+
+void JsonStreamWriter::writeSigned(const char *key, long long value)
+{
+    separate(key);
+    if (value < 0)
+    {
+        append("-", 1);
+    }
+    // Negated as unsigned so the most negative value doesn't overflow
+    appendDigits(value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value);
+}
+
+void JsonStreamWriter::writeUnsigned(const char *key, unsigned long long value)
+{
+    separate(key);
+    appendDigits(value);
+}
+
+void JsonStreamWriter::appendDigits(unsigned long long value)
+{
+    // By hand rather than snprintf - not every libc build formats 64-bit integers
+    char digits[20];
+    size_t count = 0;
+    do
+    {
+        digits[sizeof(digits) - 1 - count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    append(digits + sizeof(digits) - count, count);
+}
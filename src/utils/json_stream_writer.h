@@ -0,0 +1,103 @@
+/**
+ * @file json_stream_writer.h
+ * @brief JSON written straight to a Print through a small fixed buffer
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * For payloads too big to build as a JsonDocument and then copy into a String:
+ * each field is escaped into a jsonStreamBufferBytes buffer as it is written,
+ * and the buffer goes to the output whenever it fills, so the only RAM used is
+ * the buffer and whatever the output keeps.
+ *
+ * Commas and nesting are tracked, so callers only say what goes where:
+ *
+ *   json.beginObject();
+ *   json.field("ssid", config.wifiSSID);
+ *   json.beginArray("pins");
+ *   json.value(4);
+ *   json.endArray();
+ *   json.endObject();
+ *   json.flush();
+ *
+ * The writer is itself a Print: after key(), a value can be written by other
+ * code, e.g. serializeJson(smallDoc, json).
+ */
+
+#ifndef JSON_STREAM_WRITER_H
+#define JSON_STREAM_WRITER_H
+
+#include <Arduino.h>
+#include <config/config.h>
+#include <cstddef>
+
+class JsonStreamWriter : public Print
+{
+public:
+    explicit JsonStreamWriter(Print &out) : out(out) {}
+
+    /**
+     * @brief Open an object or array; key is nullptr at the top level and inside arrays
+     */
+    void beginObject(const char *key = nullptr);
+    void endObject();
+    void beginArray(const char *key = nullptr);
+    void endArray();
+
+    /**
+     * @brief Write one member (key) or array element (key nullptr)
+     * A nullptr string is written as null; so is a NaN or infinite number.
+     */
+    void field(const char *key, const char *value);
+    void field(const char *key, const String &value) { field(key, value.c_str()); }
+    void field(const char *key, bool value);
+    void field(const char *key, int value) { writeSigned(key, value); }
+    void field(const char *key, long value) { writeSigned(key, value); }
+    void field(const char *key, long long value) { writeSigned(key, value); }
+    void field(const char *key, unsigned int value) { writeUnsigned(key, value); }
+    void field(const char *key, unsigned long value) { writeUnsigned(key, value); }
+    void field(const char *key, unsigned long long value) { writeUnsigned(key, value); }
+    void field(const char *key, double value);
+    void field(const char *key, std::nullptr_t);
+
+    template <typename T>
+    void value(const T &value) { field(nullptr, value); }
+
+    /**
+     * @brief Start a member whose value the caller writes through Print
+     */
+    void key(const char *key) { separate(key); }
+
+    /**
+     * @brief Pass everything buffered to the output
+     */
+    void flush() override;
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *data, size_t length) override;
+    using Print::write;
+
+    size_t getBytesWritten() const { return bytesWritten; }
+    int getDepth() const { return depth; }
+
+private:
+    void separate(const char *key);
+    void open(const char *key, char bracket);
+    void close(char bracket);
+    void writeString(const char *text);
+    void writeSigned(const char *key, long long value);
+    void writeUnsigned(const char *key, unsigned long long value);
+    void appendDigits(unsigned long long value);
+    void append(const char *text, size_t length);
+    void append(const char *text) { append(text, strlen(text)); }
+
+    Print &out;
+    char buffer[jsonStreamBufferBytes];
+    size_t buffered = 0;
+    size_t bytesWritten = 0;
+    int depth = 0;
+    uint32_t hasMembers = 0; // Bit per level: something already written there, so the next needs a comma
+};
+
+#endif // JSON_STREAM_WRITER_H
@@ -31,6 +31,19 @@ String getFormattedDateTime()
     }
 }
 
+String getFormattedDateTime(time_t utcTime)
+{
+    // Same format as above, for a moment other than now
+    if (timezoneConfigured)
+    {
+        return localTZ.dateTime(utcTime, UTC_TIME, "D d M Y H:i");
+    }
+    else
+    {
+        return dateTime(utcTime, UTC_TIME, "D d M Y H:i");
+    }
+}
+
 String formatCustomDate(String customDate)
 {
     // Use ezTime's makeTime for robust date parsing with minimal custom logic
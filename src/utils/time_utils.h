@@ -11,6 +11,7 @@ extern Timezone localTZ;
 
 // Function declarations
 String getFormattedDateTime();
+String getFormattedDateTime(time_t utcTime);
 String formatCustomDate(String customDate);
 String formatRFC2822Date(const String &rfc2822Date);
 String getISOTimestamp();
@@ -10,12 +10,15 @@
 #include "api_config_handlers.h"
 #include "api_handlers.h" // For shared utilities
 #include "validation.h"
+#include "json_stream_response.h"
+#include "web_server.h" // For deserializeRequestBody
 #include <config/config.h>
 #include <core/nvs_keys.h>
 #include <core/config_loader.h>
 #include <core/config_utils.h>
 #include <core/led_config_loader.h>
 #include <core/logging.h>
+#include <core/log_level_table.h>
 #include <core/printer_discovery.h>
 #include <utils/time_utils.h>
 #include <core/network.h>
@@ -50,6 +53,7 @@ String maskSecret(const String &secret)
 #include <Preferences.h>
 #include <utils/api_client.h>
 #include <config/system_constants.h>
+#include <initializer_list>
 
 // External references
 extern PubSubClient mqttClient;
@@ -63,92 +67,57 @@ extern LedEffects ledEffects;
 // CONFIGURATION API HANDLERS
 // ========================================
 
-void handleConfigGet(AsyncWebServerRequest *request)
+// Device configuration - main section matching settings.html
+static void writeDeviceConfig(JsonStreamWriter &json, const RuntimeConfig &config)
 {
-    if (isAPMode())
-    {
-        // DEBUG: handleConfigGet() called
-    }
-
-    // Check rate limiting
-    if (isRateLimited())
-    {
-        if (isAPMode())
-        {
-            // DEBUG: handleConfigGet - rate limited
-        }
-        DynamicJsonDocument errorResponse(256);
-        errorResponse["error"] = getRateLimitReason();
-
-        String errorString;
-        serializeJson(errorResponse, errorString);
-        request->send(429, "application/json", errorString);
-        return;
-    }
-
-    if (isAPMode())
-    {
-        // DEBUG: handleConfigGet - getting runtime config
-    }
-
-    // Get current runtime configuration (from NVS or defaults)
-    const RuntimeConfig &config = getRuntimeConfig();
-
-    // Feed watchdog to prevent timeout during JSON construction
-    delay(1);
-
-    // Create response with runtime configuration data
-    DynamicJsonDocument configDoc(largeJsonDocumentSize);
-
-    // Device configuration - main section matching settings.html
-    JsonObject device = configDoc.createNestedObject("device");
-    device["owner"] = config.deviceOwner;
-    device["timezone"] = config.timezone;
+    json.beginObject("device");
+    json.field("owner", config.deviceOwner);
+    json.field("timezone", config.timezone);
 
     // Move maxCharacters from validation to device section
-    device["maxCharacters"] = config.maxCharacters;
+    json.field("maxCharacters", config.maxCharacters);
 
     // Add runtime device information
-    device["firmware_version"] = getFirmwareVersion();
-    device["boot_time"] = getDeviceBootTime();
-    device["mdns"] = String(getMdnsHostname()) + ".local";
-    device["ip_address"] = WiFi.localIP().toString();
-    device["printer_name"] = getLocalPrinterName();
-    device["mqtt_topic"] = getLocalPrinterTopic();
-    device["type"] = "local";
+    json.field("firmware_version", getFirmwareVersion());
+    json.field("boot_time", getDeviceBootTime());
+    json.field("mdns", String(getMdnsHostname()) + ".local");
+    json.field("ip_address", WiFi.localIP().toString());
+    json.field("printer_name", getLocalPrinterName());
+    json.field("mqtt_topic", getLocalPrinterTopic());
+    json.field("type", "local");
 
     // Hardware GPIO configuration
-    device["printerTxPin"] = config.printerTxPin;
+    json.field("printerTxPin", config.printerTxPin);
 
     // WiFi configuration - nested under device to match settings structure
-    JsonObject wifi = device.createNestedObject("wifi");
+    json.beginObject("wifi");
 
     // In AP mode, encourage fresh setup by showing generic placeholders
     if (isAPMode())
     {
-        wifi["ssid"] = "AP_MODE";
-        wifi["password"] = ""; // Blank to encourage manual entry
+        json.field("ssid", "AP_MODE");
+        json.field("password", ""); // Blank to encourage manual entry
     }
     else
     {
-        wifi["ssid"] = config.wifiSSID;
-        wifi["password"] = maskSecret(config.wifiPassword);
+        json.field("ssid", config.wifiSSID);
+        json.field("password", maskSecret(config.wifiPassword));
     }
 
     // Include fallback AP details for client use - always available regardless of current mode
-    wifi["fallback_ap_ssid"] = fallbackAPSSID;
-    wifi["fallback_ap_password"] = fallbackAPPassword;
+    json.field("fallback_ap_ssid", fallbackAPSSID);
+    json.field("fallback_ap_password", fallbackAPPassword);
     // Always provide mDNS hostname as it's consistent and preferred
-    wifi["fallback_ap_mdns"] = String(getMdnsHostname()) + ".local";
+    json.field("fallback_ap_mdns", String(getMdnsHostname()) + ".local");
 
     // WiFi status information
-    JsonObject wifiStatus = wifi.createNestedObject("status");
-    wifiStatus["connected"] = (WiFi.status() == WL_CONNECTED);
-    wifiStatus["ap_sta_mode"] = isAPMode(); // Indicate if device is in AP-STA setup mode
-    wifiStatus["ip_address"] = WiFi.localIP().toString();
-    wifiStatus["mac_address"] = WiFi.macAddress();
-    wifiStatus["gateway"] = WiFi.gatewayIP().toString();
-    wifiStatus["dns"] = WiFi.dnsIP().toString();
+    json.beginObject("status");
+    json.field("connected", WiFi.status() == WL_CONNECTED);
+    json.field("ap_sta_mode", isAPMode()); // Indicate if device is in AP-STA setup mode
+    json.field("ip_address", WiFi.localIP().toString());
+    json.field("mac_address", WiFi.macAddress());
+    json.field("gateway", WiFi.gatewayIP().toString());
+    json.field("dns", WiFi.dnsIP().toString());
 
     // Format signal strength
     int rssi = WiFi.RSSI();
@@ -169,38 +138,63 @@ void handleConfigGet(AsyncWebServerRequest *request)
     {
         signalStrength += " (Weak)";
     }
-    wifiStatus["signal_strength"] = signalStrength;
-
-    // Feed watchdog after WiFi processing
-    delay(1);
+    json.field("signal_strength", signalStrength);
+    json.endObject(); // status
+    json.endObject(); // wifi
+    json.endObject(); // device
+}
 
-    // MQTT configuration - top-level section matching settings.html
-    JsonObject mqtt = configDoc.createNestedObject("mqtt");
-    mqtt["enabled"] = config.mqttEnabled;
-    mqtt["server"] = config.mqttServer;
-    mqtt["port"] = config.mqttPort;
-    mqtt["username"] = config.mqttUsername;
-    mqtt["password"] = maskSecret(config.mqttPassword);
+// MQTT configuration - top-level section matching settings.html
+static void writeMqttConfig(JsonStreamWriter &json, const RuntimeConfig &config)
+{
+    json.beginObject("mqtt");
+    json.field("enabled", config.mqttEnabled);
+    json.field("server", config.mqttServer);
+    json.field("port", config.mqttPort);
+    json.field("username", config.mqttUsername);
+    json.field("password", maskSecret(config.mqttPassword));
+    json.field("groups", config.mqttGroups);
+    json.field("fallbackServers", config.mqttFallbackServers);
+    json.field("discoveryScope", config.mqttDiscoveryScope);
+    json.field("discoverySummary", config.mqttDiscoverySummary);
+    json.field("peerKey", maskSecret(config.mqttPeerKey));
     // Skip MQTT connection check in AP mode to avoid potential blocking
-    mqtt["connected"] = (isAPMode() || !config.mqttEnabled) ? false : mqttClient.connected();
+    json.field("connected", (isAPMode() || !config.mqttEnabled) ? false : mqttClient.connected());
+    json.endObject();
+}
+
+// Logging configuration - limits apply as soon as they are saved
+static void writeLoggingConfig(JsonStreamWriter &json, const RuntimeConfig &config)
+{
+    json.beginObject("logging");
+    json.field("rateLimitPerMinute", config.logRateLimitPerMinute);
+    json.field("rateLimitBurst", config.logRateLimitBurst);
+    json.field("level", config.logLevel);
+    json.field("componentLevels", config.logComponentLevels);
+    json.endObject();
+}
 
-    // Unbidden Ink configuration - top-level section matching settings.html
-    JsonObject unbiddenInk = configDoc.createNestedObject("unbiddenInk");
-    unbiddenInk["enabled"] = config.unbiddenInkEnabled;
-    unbiddenInk["startHour"] = config.unbiddenInkStartHour;
-    unbiddenInk["endHour"] = config.unbiddenInkEndHour;
-    unbiddenInk["frequencyMinutes"] = config.unbiddenInkFrequencyMinutes;
-    unbiddenInk["prompt"] = config.unbiddenInkPrompt;
-    unbiddenInk["chatgptApiToken"] = maskSecret(config.chatgptApiToken);
+// Unbidden Ink configuration - top-level section matching settings.html
+static void writeUnbiddenInkConfig(JsonStreamWriter &json, const RuntimeConfig &config)
+{
+    json.beginObject("unbiddenInk");
+    json.field("enabled", config.unbiddenInkEnabled);
+    json.field("startHour", config.unbiddenInkStartHour);
+    json.field("endHour", config.unbiddenInkEndHour);
+    json.field("frequencyMinutes", config.unbiddenInkFrequencyMinutes);
+    json.field("prompt", config.unbiddenInkPrompt);
+    json.field("chatgptApiToken", maskSecret(config.chatgptApiToken));
 
     // Add prompt presets for quick selection
-    JsonObject prompts = unbiddenInk.createNestedObject("promptPresets");
-    prompts["creative"] = unbiddenInkPromptCreative;
-    prompts["wisdom"] = unbiddenInkPromptWisdom;
-    prompts["humor"] = unbiddenInkPromptHumor;
-    prompts["doctorwho"] = unbiddenInkPromptDoctorWho;
+    json.beginObject("promptPresets");
+    json.field("creative", unbiddenInkPromptCreative);
+    json.field("wisdom", unbiddenInkPromptWisdom);
+    json.field("humor", unbiddenInkPromptHumor);
+    json.field("doctorwho", unbiddenInkPromptDoctorWho);
+    json.endObject();
 
     // Add runtime status for Unbidden Ink
+    String nextScheduled = "-";
     if (config.unbiddenInkEnabled)
     {
         unsigned long nextTime = getNextUnbiddenInkTime();
@@ -211,177 +205,194 @@ void handleConfigGet(AsyncWebServerRequest *request)
             unsigned long minutesUntil = (nextTime - currentTime) / (60 * 1000);
             if (minutesUntil == 0)
             {
-                unbiddenInk["nextScheduled"] = "< 1 min";
+                nextScheduled = "< 1 min";
             }
             else
             {
-                unbiddenInk["nextScheduled"] = String(minutesUntil) + (minutesUntil == 1 ? " min" : " mins");
+                nextScheduled = String(minutesUntil) + (minutesUntil == 1 ? " min" : " mins");
             }
         }
-        else
-        {
-            unbiddenInk["nextScheduled"] = "-";
-        }
-    }
-    else
-    {
-        unbiddenInk["nextScheduled"] = "-";
     }
+    json.field("nextScheduled", nextScheduled);
+    json.endObject();
 
     // Memos are now handled by separate /api/memos endpoint
+}
 
-    // Buttons configuration - top-level section matching settings.html
-    JsonObject buttons = configDoc.createNestedObject("buttons");
+// Buttons configuration - top-level section matching settings.html
+static void writeButtonsConfig(JsonStreamWriter &json, const RuntimeConfig &config)
+{
+    json.beginObject("buttons");
 
     // Hardware button status information
-    buttons["count"] = numHardwareButtons;
-    buttons["debounce_time"] = buttonDebounceMs;
-    buttons["long_press_time"] = buttonLongPressMs;
-    buttons["active_low"] = buttonActiveLow;
-    buttons["min_interval"] = buttonMinInterval;
-    buttons["max_per_minute"] = buttonMaxPerMinute;
+    json.field("count", numHardwareButtons);
+    json.field("debounce_time", buttonDebounceMs);
+    json.field("long_press_time", buttonLongPressMs);
+    json.field("active_low", buttonActiveLow);
+    json.field("min_interval", buttonMinInterval);
+    json.field("max_per_minute", buttonMaxPerMinute);
 
     // Button action configuration
     for (int i = 0; i < numHardwareButtons; i++)
     {
         String buttonKey = "button" + String(i + 1);
-        JsonObject button = buttons.createNestedObject(buttonKey);
+        json.beginObject(buttonKey.c_str());
 
         // Add GPIO pin information for each button
-        button["gpio"] = config.buttonGpios[i];
+        json.field("gpio", config.buttonGpios[i]);
 
-        button["shortAction"] = config.buttonShortActions[i];
-        button["shortMqttTopic"] = config.buttonShortMqttTopics[i];
-        button["longAction"] = config.buttonLongActions[i];
-        button["longMqttTopic"] = config.buttonLongMqttTopics[i];
+        json.field("shortAction", config.buttonShortActions[i]);
+        json.field("shortMqttTopic", config.buttonShortMqttTopics[i]);
+        json.field("longAction", config.buttonLongActions[i]);
+        json.field("longMqttTopic", config.buttonLongMqttTopics[i]);
 
         // Add LED effect configuration
-        button["shortLedEffect"] = config.buttonShortLedEffects[i];
-        button["longLedEffect"] = config.buttonLongLedEffects[i];
+        json.field("shortLedEffect", config.buttonShortLedEffects[i]);
+        json.field("longLedEffect", config.buttonLongLedEffects[i]);
+        json.endObject();
     }
+    json.endObject();
+}
 
 #if ENABLE_LEDS
-    // LEDs configuration - top-level section matching settings.html
-    JsonObject leds = configDoc.createNestedObject("leds");
-    leds["enabled"] = true; // LED support is compiled in
-    leds["pin"] = config.ledPin;
-    leds["count"] = config.ledCount;
-    leds["brightness"] = config.ledBrightness;
-    leds["refreshRate"] = config.ledRefreshRate;
+// Defaults for one effect in the frontend LED playground (10-100 scale)
+static void writeLedEffectDefaults(JsonStreamWriter &json, const char *name,
+                                   std::initializer_list<const char *> colors)
+{
+    json.beginObject(name);
+    json.field("speed", 50);
+    json.field("intensity", 50);
+    json.field("cycles", DEFAULT_LED_EFFECT_CYCLES);
+    json.beginArray("colors");
+    for (const char *color : colors)
+    {
+        json.value(color);
+    }
+    json.endArray();
+    json.endObject();
+}
+#endif
+
+// LEDs configuration - top-level section matching settings.html
+static void writeLedsConfig(JsonStreamWriter &json, const RuntimeConfig &config)
+{
+    json.beginObject("leds");
+#if ENABLE_LEDS
+    json.field("enabled", true); // LED support is compiled in
+    json.field("pin", config.ledPin);
+    json.field("count", config.ledCount);
+    json.field("brightness", config.ledBrightness);
+    json.field("refreshRate", config.ledRefreshRate);
 
     // Add effectDefaults structure for frontend LED playground (10-100 scale)
-    JsonObject effectDefaults = leds.createNestedObject("effectDefaults");
-
-    // Chase Single defaults
-    JsonObject chaseSingle = effectDefaults.createNestedObject("chase_single");
-    chaseSingle["speed"] = 50;
-    chaseSingle["intensity"] = 50;
-    chaseSingle["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray chaseSingleColors = chaseSingle.createNestedArray("colors");
-    chaseSingleColors.add(config.ledEffects.chaseSingle.defaultColor);
-
-    // Chase Multi defaults
-    JsonObject chaseMulti = effectDefaults.createNestedObject("chase_multi");
-    chaseMulti["speed"] = 50;
-    chaseMulti["intensity"] = 50;
-    chaseMulti["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray chaseMultiColors = chaseMulti.createNestedArray("colors");
-    chaseMultiColors.add(config.ledEffects.chaseMulti.color1);
-    chaseMultiColors.add(config.ledEffects.chaseMulti.color2);
-    chaseMultiColors.add(config.ledEffects.chaseMulti.color3);
-
-    // Matrix defaults
-    JsonObject matrix = effectDefaults.createNestedObject("matrix");
-    matrix["speed"] = 50;
-    matrix["intensity"] = 50;
-    matrix["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray matrixColors = matrix.createNestedArray("colors");
-    matrixColors.add(config.ledEffects.matrix.defaultColor);
-
-    // Twinkle defaults
-    JsonObject twinkle = effectDefaults.createNestedObject("twinkle");
-    twinkle["speed"] = 50;
-    twinkle["intensity"] = 50;
-    twinkle["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray twinkleColors = twinkle.createNestedArray("colors");
-    twinkleColors.add(config.ledEffects.twinkle.defaultColor);
-
-    // Pulse defaults
-    JsonObject pulse = effectDefaults.createNestedObject("pulse");
-    pulse["speed"] = 50;
-    pulse["intensity"] = 50;
-    pulse["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray pulseColors = pulse.createNestedArray("colors");
-    pulseColors.add(config.ledEffects.pulse.defaultColor);
-
-    // Rainbow defaults
-    JsonObject rainbow = effectDefaults.createNestedObject("rainbow");
-    rainbow["speed"] = 50;
-    rainbow["intensity"] = 50;
-    rainbow["cycles"] = DEFAULT_LED_EFFECT_CYCLES;
-    JsonArray rainbowColors = rainbow.createNestedArray("colors");
-    rainbowColors.add("#ff0000"); // Rainbow doesn't use colors but needs array
+    const LedEffectsConfig &effects = config.ledEffects;
+    json.beginObject("effectDefaults");
+    writeLedEffectDefaults(json, "chase_single", {effects.chaseSingle.defaultColor.c_str()});
+    writeLedEffectDefaults(json, "chase_multi", {effects.chaseMulti.color1.c_str(), effects.chaseMulti.color2.c_str(), effects.chaseMulti.color3.c_str()});
+    writeLedEffectDefaults(json, "matrix", {effects.matrix.defaultColor.c_str()});
+    writeLedEffectDefaults(json, "twinkle", {effects.twinkle.defaultColor.c_str()});
+    writeLedEffectDefaults(json, "pulse", {effects.pulse.defaultColor.c_str()});
+    writeLedEffectDefaults(json, "rainbow", {"#ff0000"}); // Rainbow doesn't use colors but needs array
+    json.endObject();
 #else
     // LEDs disabled at compile time - provide minimal config to inform frontend
-    JsonObject leds = configDoc.createNestedObject("leds");
-    leds["enabled"] = false; // LED support is NOT compiled in
+    (void)config;
+    json.field("enabled", false); // LED support is NOT compiled in
 #endif
+    json.endObject();
+}
 
-    // GPIO information for frontend validation
-    JsonObject gpio = configDoc.createNestedObject("gpio");
-    JsonArray availablePins = gpio.createNestedArray("availablePins");
-    JsonArray safePins = gpio.createNestedArray("safePins");
-    JsonObject pinDescriptions = gpio.createNestedObject("pinDescriptions");
-
-    LOG_VERBOSE("CONFIG", "Adding GPIO info, ESP32C3_GPIO_COUNT: %d", ESP32C3_GPIO_COUNT);
+// GPIO information for frontend validation
+static void writeGpioInfo(JsonStreamWriter &json)
+{
+    json.beginObject("gpio");
 
-    // Add all ESP32-C3 GPIO information
+    json.beginArray("availablePins");
     for (int i = 0; i < ESP32C3_GPIO_COUNT; i++)
     {
-        int pin = ESP32C3_GPIO_MAP[i].pin;
-        availablePins.add(pin);
-        pinDescriptions[String(pin)] = ESP32C3_GPIO_MAP[i].description;
+        json.value(ESP32C3_GPIO_MAP[i].pin);
+    }
+    json.endArray();
 
-        if (isSafeGPIO(pin))
+    int safeCount = 0;
+    json.beginArray("safePins");
+    for (int i = 0; i < ESP32C3_GPIO_COUNT; i++)
+    {
+        if (isSafeGPIO(ESP32C3_GPIO_MAP[i].pin))
         {
-            safePins.add(pin);
-            LOG_VERBOSE("CONFIG", "Added safe GPIO pin: %d", pin);
+            json.value(ESP32C3_GPIO_MAP[i].pin);
+            safeCount++;
         }
     }
+    json.endArray();
 
-    LOG_VERBOSE("CONFIG", "GPIO info complete - %d available pins, %d safe pins", availablePins.size(), safePins.size());
-
-    // Check if JSON document has overflowed before serialization
-    if (configDoc.overflowed())
+    json.beginObject("pinDescriptions");
+    for (int i = 0; i < ESP32C3_GPIO_COUNT; i++)
     {
-        LOG_ERROR("CONFIG", "JSON document overflow detected! Size: %d bytes, Capacity: %d bytes",
-                  configDoc.memoryUsage(), configDoc.capacity());
-        sendErrorResponse(request, 500, "Configuration too large for buffer - increase largeJsonDocumentSize");
-        return;
+        char pin[8];
+        snprintf(pin, sizeof(pin), "%d", ESP32C3_GPIO_MAP[i].pin);
+        json.field(pin, ESP32C3_GPIO_MAP[i].description);
     }
+    json.endObject();
 
-    // Feed watchdog before JSON serialization
-    delay(1);
+    json.endObject();
 
-    String configString;
-    size_t jsonSize = serializeJson(configDoc, configString);
+    LOG_VERBOSE("CONFIG", "GPIO info complete - %d available pins, %d safe pins", ESP32C3_GPIO_COUNT, safeCount);
+}
 
-    LOG_VERBOSE("CONFIG", "JSON serialized: %d bytes, buffer usage: %d/%d bytes",
-                jsonSize, configDoc.memoryUsage(), configDoc.capacity());
+void handleConfigGet(AsyncWebServerRequest *request)
+{
+    if (isAPMode())
+    {
+        // DEBUG: handleConfigGet() called
+    }
 
-    if (jsonSize == 0)
+    // Check rate limiting
+    if (isRateLimited())
     {
-        LOG_ERROR("WEB", "Failed to serialize config JSON");
-        DynamicJsonDocument errorDoc(256);
-        errorDoc["error"] = "JSON serialization failed";
+        if (isAPMode())
+        {
+            // DEBUG: handleConfigGet - rate limited
+        }
+        DynamicJsonDocument errorResponse(256);
+        errorResponse["error"] = getRateLimitReason();
+
         String errorString;
-        serializeJson(errorDoc, errorString);
-        request->send(500, "application/json", errorString);
+        serializeJson(errorResponse, errorString);
+        request->send(429, "application/json", errorString);
         return;
     }
 
-    LOG_VERBOSE("WEB", "Configuration from NVS, returning %d bytes", configString.length());
-    request->send(200, "application/json", configString);
+    // One section per step, each read from the runtime config when its chunk is due
+    request->send(beginJsonStreamResponse(request, "GET /api/config", [](JsonStreamWriter &json, int step)
+                                          {
+        const RuntimeConfig &config = getRuntimeConfig();
+        switch (step)
+        {
+        case 0:
+            writeDeviceConfig(json, config);
+            return true;
+        case 1:
+            writeMqttConfig(json, config);
+            return true;
+        case 2:
+            writeLoggingConfig(json, config);
+            return true;
+        case 3:
+            writeUnbiddenInkConfig(json, config);
+            return true;
+        case 4:
+            writeButtonsConfig(json, config);
+            return true;
+        case 5:
+            writeLedsConfig(json, config);
+            return true;
+        case 6:
+            writeGpioInfo(json);
+            return true;
+        default:
+            return false;
+        } }));
 }
 
 #include "config_field_registry.h"
@@ -394,26 +405,17 @@ void handleConfigPost(AsyncWebServerRequest *request)
         return;
     }
 
-    // Get and validate JSON body
-    extern String getRequestBody(AsyncWebServerRequest * request);
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON to validate structure - in place in the request's body buffer, without a String copy
+    DynamicJsonDocument doc(largeJsonDocumentSize);
+    DeserializationError error = deserializeRequestBody(request, doc);
+    if (error == DeserializationError::EmptyInput)
     {
         sendValidationError(request, ValidationResult(false, "No JSON body provided"));
         return;
     }
-
-    // Parse JSON to validate structure
-    DynamicJsonDocument doc(largeJsonDocumentSize);
-
-    LOG_VERBOSE("WEB", "Config POST body length: %d", body.length());
-    LOG_VERBOSE("WEB", "Config POST body (first 200 chars): %s", body.substring(0, 200).c_str());
-
-    DeserializationError error = deserializeJson(doc, body);
     if (error)
     {
         LOG_ERROR("WEB", "JSON deserialization failed: %s", error.c_str());
-        LOG_ERROR("WEB", "JSON body length: %d", body.length());
         sendValidationError(request, ValidationResult(false, "Invalid JSON format: " + String(error.c_str())));
         return;
     }
@@ -437,6 +439,23 @@ void handleConfigPost(AsyncWebServerRequest *request)
     LOG_VERBOSE("WEB", "MQTT Debug - Current password length: %d", newConfig.mqttPassword.length());
     LOG_VERBOSE("WEB", "MQTT Debug - NewConfig password length after processing: %d", newConfig.mqttPassword.length());
 
+    // Discovery scope becomes a topic level, so it must be a valid level name
+    newConfig.mqttDiscoveryScope.trim();
+    if (newConfig.mqttDiscoveryScope.length() > 0 && !isValidMqttGroupName(newConfig.mqttDiscoveryScope))
+    {
+        sendValidationError(request, ValidationResult(false, "mqtt.discoveryScope may only contain letters, digits, '-' and '_' (max " + String(maxMqttGroupNameLength) + " characters)"));
+        return;
+    }
+
+    // Component levels are applied on save and at every boot, so reject anything that won't parse
+    newConfig.logComponentLevels.trim();
+    if (newConfig.logComponentLevels.length() > (size_t)maxLogComponentLevelsLength ||
+        !LogLevelTable::parse(newConfig.logComponentLevels.c_str(), nullptr, 0, nullptr))
+    {
+        sendValidationError(request, ValidationResult(false, "logging.componentLevels must be COMPONENT=LEVEL pairs separated by commas (max " + String(maxLogLevelOverrides) + ")"));
+        return;
+    }
+
     // MQTT password fix: If frontend didn't send password, preserve existing one
     if (doc.containsKey("mqtt") && doc["mqtt"].is<JsonObject>())
     {
@@ -450,6 +469,20 @@ void handleConfigPost(AsyncWebServerRequest *request)
         {
             LOG_NOTICE("WEB", "MQTT password provided in request");
         }
+
+        // Peer key is masked in GET like the password, so keep it unless sent
+        if (!mqttObj.containsKey("peerKey"))
+        {
+            newConfig.mqttPeerKey = currentConfig.mqttPeerKey;
+        }
+    }
+
+    // Peer key signs LAN prints - refuse keys too short to be worth having
+    if (newConfig.mqttPeerKey.length() > 0 &&
+        (newConfig.mqttPeerKey.length() < (size_t)minPeerKeyLength || newConfig.mqttPeerKey.length() > (size_t)maxPeerKeyLength))
+    {
+        sendValidationError(request, ValidationResult(false, "mqtt.peerKey must be empty or " + String(minPeerKeyLength) + "-" + String(maxPeerKeyLength) + " characters"));
+        return;
     }
 
     // Non-user configurable APIs remain as constants (always set regardless of sections present)
@@ -479,7 +512,11 @@ void handleConfigPost(AsyncWebServerRequest *request)
             currentConfig.mqttServer != newConfig.mqttServer ||
             currentConfig.mqttPort != newConfig.mqttPort ||
             currentConfig.mqttUsername != newConfig.mqttUsername ||
-            currentConfig.mqttPassword != newConfig.mqttPassword
+            currentConfig.mqttPassword != newConfig.mqttPassword ||
+            currentConfig.mqttGroups != newConfig.mqttGroups ||
+            currentConfig.mqttFallbackServers != newConfig.mqttFallbackServers ||
+            currentConfig.mqttDiscoveryScope != newConfig.mqttDiscoveryScope ||
+            currentConfig.mqttDiscoverySummary != newConfig.mqttDiscoverySummary
         );
     }
     
@@ -566,9 +603,15 @@ void handleConfigPost(AsyncWebServerRequest *request)
     {
         // MQTT settings changed but was already enabled - restart cleanly
         LOG_NOTICE("WEB", "MQTT settings updated - restarting client");
-        stopMQTTClient();
-        delay(100);  // Brief cleanup delay
-        startMQTTClient(true);  // true = immediate reconnection
+        if (currentConfig.mqttDiscoveryScope != newConfig.mqttDiscoveryScope)
+        {
+            // Leave the old scope, or its printers keep seeing our retained status
+            restartMQTTClient(currentConfig.mqttDiscoveryScope);
+        }
+        else
+        {
+            restartMQTTClient();
+        }
     }
 
     // Handle dynamic UnbiddenInk start/stop
@@ -626,6 +669,7 @@ void handleConfigPost(AsyncWebServerRequest *request)
         delay(2000);  // Give frontend time to show overlay
         LOG_NOTICE("WEB", "Restarting to connect to new WiFi network: %s", 
                    newConfig.wifiSSID.c_str());
+        flushLogs();
         ESP.restart();
         return;
     }
@@ -636,6 +680,7 @@ void handleConfigPost(AsyncWebServerRequest *request)
         LOG_NOTICE("WEB", "Device in AP-STA mode - rebooting to connect to new WiFi configuration");
         request->send(200);
         delay(1000);
+        flushLogs();
         ESP.restart();
         return;
     }
@@ -652,57 +697,31 @@ void handleMemosGet(AsyncWebServerRequest *request)
 {
     LOG_VERBOSE("WEB", "handleMemosGet() called");
 
-    // Create JSON response with all memos
-    DynamicJsonDocument memosDoc(2048);
-
-    // Get memo values from centralized config system
-    const RuntimeConfig &config = getRuntimeConfig();
-
-    memosDoc["memo1"] = config.memos[0];
-    memosDoc["memo2"] = config.memos[1];
-    memosDoc["memo3"] = config.memos[2];
-    memosDoc["memo4"] = config.memos[3];
-
-    // Check for overflow
-    if (memosDoc.overflowed())
-    {
-        LOG_ERROR("MEMOS", "Memos JSON document overflow detected!");
-        sendErrorResponse(request, 500, "Memos too large for buffer");
-        return;
-    }
-
-    // Serialize and send
-    String memosString;
-    size_t jsonSize = serializeJson(memosDoc, memosString);
-
-    if (jsonSize == 0)
-    {
-        LOG_ERROR("WEB", "Failed to serialize memos JSON");
-        sendErrorResponse(request, 500, "Failed to serialize memos");
-        return;
-    }
-
-    LOG_VERBOSE("WEB", "Memos sent to client (%zu bytes)", jsonSize);
-    request->send(200, "application/json", memosString);
+    // A memo per step, each read from the runtime config when its chunk is due
+    request->send(beginJsonStreamResponse(request, "GET /api/memos", [](JsonStreamWriter &json, int step)
+                                          {
+        if (step >= MEMO_COUNT)
+        {
+            return false;
+        }
+        char key[8];
+        snprintf(key, sizeof(key), "memo%d", step + 1);
+        json.field(key, getRuntimeConfig().memos[step]);
+        return true; }));
 }
 
 void handleMemosPost(AsyncWebServerRequest *request)
 {
-    extern String getRequestBody(AsyncWebServerRequest * request);
-
     LOG_VERBOSE("WEB", "handleMemosPost() called");
 
-    // Get request body
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON straight from the request body
+    DynamicJsonDocument memosDoc(2048);
+    DeserializationError error = deserializeRequestBody(request, memosDoc);
+    if (error == DeserializationError::EmptyInput)
     {
         sendErrorResponse(request, 400, "No JSON body provided");
         return;
     }
-
-    // Parse JSON
-    DynamicJsonDocument memosDoc(2048);
-    DeserializationError error = deserializeJson(memosDoc, body);
     if (error)
     {
         LOG_ERROR("WEB", "Failed to parse memos JSON: %s", error.c_str());
@@ -751,25 +770,17 @@ void handleMemosPost(AsyncWebServerRequest *request)
 
 void handleSetupPost(AsyncWebServerRequest *request)
 {
-    extern String getRequestBody(AsyncWebServerRequest * request);
-
     LOG_VERBOSE("WEB", "handleSetupPost() called - initial device setup");
 
-    // Get request body
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON straight from the request body - minimal buffer since setup only has device config
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeRequestBody(request, doc);
+    if (error == DeserializationError::EmptyInput)
     {
         LOG_ERROR("WEB", "Setup request body is empty");
         sendErrorResponse(request, 400, "Request body is empty");
         return;
     }
-
-    // Parse JSON - minimal buffer since setup only has device config
-    DynamicJsonDocument doc(1024);
-
-    LOG_VERBOSE("WEB", "Setup POST body: %s", body.c_str());
-
-    DeserializationError error = deserializeJson(doc, body);
     if (error)
     {
         LOG_ERROR("WEB", "Setup JSON deserialization failed: %s", error.c_str());
@@ -927,25 +938,17 @@ void handleSetupGet(AsyncWebServerRequest *request)
 
 void handleTestMQTT(AsyncWebServerRequest *request)
 {
-    extern String getRequestBody(AsyncWebServerRequest * request);
-
     LOG_VERBOSE("WEB", "handleTestMQTT() called - testing MQTT connection");
 
-    // Get request body
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON straight from the request body - small buffer for test data
+    DynamicJsonDocument doc(512);
+    DeserializationError error = deserializeRequestBody(request, doc);
+    if (error == DeserializationError::EmptyInput)
     {
         LOG_ERROR("WEB", "MQTT test request body is empty");
         sendErrorResponse(request, 400, "Request body is empty");
         return;
     }
-
-    // Parse JSON - small buffer for test data
-    DynamicJsonDocument doc(512);
-
-    LOG_VERBOSE("WEB", "MQTT test POST body: %s", body.c_str());
-
-    DeserializationError error = deserializeJson(doc, body);
     if (error)
     {
         LOG_ERROR("WEB", "MQTT test JSON deserialization failed: %s", error.c_str());
@@ -1094,20 +1097,15 @@ void handleTestMQTT(AsyncWebServerRequest *request)
 
 void handleTestChatGPT(AsyncWebServerRequest *request)
 {
-    extern String getRequestBody(AsyncWebServerRequest * request);
-
     LOG_VERBOSE("WEB", "handleTestChatGPT() called - testing ChatGPT API token");
 
-    // Read body
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    DynamicJsonDocument doc(512);
+    DeserializationError err = deserializeRequestBody(request, doc);
+    if (err == DeserializationError::EmptyInput)
     {
         sendErrorResponse(request, 400, "Request body is empty");
         return;
     }
-
-    DynamicJsonDocument doc(512);
-    DeserializationError err = deserializeJson(doc, body);
     if (err)
     {
         sendValidationError(request, ValidationResult(false, "Invalid JSON format: " + String(err.c_str())));
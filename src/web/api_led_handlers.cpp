@@ -12,7 +12,7 @@
 #if ENABLE_LEDS
 
 #include "api_handlers.h" // For sendErrorResponse
-#include "web_server.h"   // For getRequestBody function
+#include "web_server.h"   // For deserializeRequestBody function
 #include <config/config.h>
 #include <core/config_loader.h>
 #include <core/led_config.h>
@@ -37,18 +37,15 @@ void handleLedEffect(AsyncWebServerRequest *request)
         return;
     }
 
-    // Get request body using the proper method
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON body straight from the request's body buffer
+    DynamicJsonDocument doc(512);
+    DeserializationError error = deserializeRequestBody(request, doc);
+    if (error == DeserializationError::EmptyInput)
     {
         sendErrorResponse(request, 400, "Missing JSON body with effect configuration");
         return;
     }
 
-    // Parse JSON body
-    DynamicJsonDocument doc(512);
-    DeserializationError error = deserializeJson(doc, body);
-
     if (error)
     {
         LOG_ERROR("API", "Failed to parse LED effect JSON: %s", error.c_str());
@@ -0,0 +1,359 @@
+/**
+ * @file api_log_handlers.cpp
+ * @brief Log query API endpoint handlers
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "api_log_handlers.h"
+#include "api_handlers.h" // For sendErrorResponse
+#include <config/config.h>
+#include <core/logging.h>
+#include <core/log_level_table.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <memory>
+
+enum class LogQuerySource
+{
+    Ring,
+    File,
+    All
+};
+
+enum class LogQueryPhase
+{
+    Files,
+    Ring,
+    Trailer,
+    Done
+};
+
+// State carried between calls of the chunked response filler
+struct LogQuery
+{
+    LogQuerySource source = LogQuerySource::Ring;
+    LogQueryPhase phase = LogQueryPhase::Ring;
+    int maxLevel = LOG_LEVEL_VERBOSE;
+    String component; // Empty matches every component
+    uint32_t skipped = 0;
+
+    // RAM records; those logged after the request started are left for the next one
+    LogHistoryCursor cursor;
+    uint32_t endSequence = 0;
+    alignas(LogRecord) uint8_t record[sizeof(LogRecord) + logRecordMaxArgBytes];
+
+    // Text log segments, oldest first
+    String segments[logFileSegmentCount];
+    int segmentCount = 0;
+    int segmentIndex = 0;
+    File file;
+    uint8_t readBuffer[256];
+    size_t readLength = 0;
+    size_t readOffset = 0;
+    char line[logMessageMaxLength + 128];
+    size_t lineLength = 0;
+
+    // One JSON line, handed out across as many chunks as it takes
+    char output[logQueryLineBytes];
+    size_t outputLength = 0;
+    size_t outputOffset = 0;
+};
+
+struct LogLineFields
+{
+    const char *time;
+    const char *level;
+    const char *component;
+    const char *message;
+};
+
+static bool matchesLogQuery(const LogQuery &query, int level, const char *component)
+{
+    return level <= query.maxLevel &&
+           (query.component.length() == 0 || query.component.equalsIgnoreCase(component));
+}
+
+// Split "[time] [LEVEL] [owner] [COMPONENT] message" in place, as written by logging.cpp
+static bool parseLogLine(char *line, LogLineFields &fields)
+{
+    const char *parts[4];
+    char *p = line;
+    for (int i = 0; i < 4; i++)
+    {
+        char *end = *p == '[' ? strchr(p, ']') : nullptr;
+        if (!end)
+        {
+            return false;
+        }
+        *end = '\0';
+        parts[i] = p + 1;
+        p = end + 1;
+        if (*p == ' ')
+        {
+            p++;
+        }
+    }
+
+    fields.time = parts[0];
+    fields.level = parts[1];
+    fields.component = parts[3];
+    fields.message = p;
+    return true;
+}
+
+// Serialize into the output buffer with a trailing newline; false if it won't fit
+static bool setOutputLine(LogQuery &query, const JsonDocument &doc)
+{
+    size_t length = measureJson(doc);
+    if (length + 1 > sizeof(query.output))
+    {
+        query.skipped++;
+        return false;
+    }
+    serializeJson(doc, query.output, sizeof(query.output));
+    query.output[length] = '\n';
+    query.outputLength = length + 1;
+    query.outputOffset = 0;
+    return true;
+}
+
+// Next whole line of the open file; a last line without its newline is still being written
+static bool readFileLine(LogQuery &query)
+{
+    query.lineLength = 0;
+    for (;;)
+    {
+        if (query.readOffset == query.readLength)
+        {
+            int read = query.file.read(query.readBuffer, sizeof(query.readBuffer));
+            if (read <= 0)
+            {
+                return false;
+            }
+            query.readLength = read;
+            query.readOffset = 0;
+        }
+
+        const uint8_t *start = query.readBuffer + query.readOffset;
+        size_t available = query.readLength - query.readOffset;
+        const uint8_t *newline = (const uint8_t *)memchr(start, '\n', available);
+        size_t span = newline ? newline - start : available;
+
+        // Overlong lines are cut rather than split
+        size_t room = sizeof(query.line) - 1 - query.lineLength;
+        size_t copy = min(span, room);
+        memcpy(query.line + query.lineLength, start, copy);
+        query.lineLength += copy;
+        query.readOffset += newline ? span + 1 : span;
+
+        if (newline)
+        {
+            if (query.lineLength > 0 && query.line[query.lineLength - 1] == '\r')
+            {
+                query.lineLength--;
+            }
+            query.line[query.lineLength] = '\0';
+            return true;
+        }
+    }
+}
+
+static bool emitNextFileLine(LogQuery &query)
+{
+    for (;;)
+    {
+        if (!query.file)
+        {
+            if (query.segmentIndex >= query.segmentCount)
+            {
+                query.phase = query.source == LogQuerySource::File ? LogQueryPhase::Trailer : LogQueryPhase::Ring;
+                return false;
+            }
+            if (query.segmentIndex == query.segmentCount - 1)
+            {
+                // Records from here on may not have reached the newest segment - read them from RAM.
+                // Taken before opening it, so a flush in between repeats lines rather than losing them.
+                query.cursor = LogHistoryCursor(getLogFileFlushedSequence());
+            }
+            query.file = LittleFS.open(query.segments[query.segmentIndex++].c_str(), "r");
+            query.readLength = 0;
+            query.readOffset = 0;
+            continue;
+        }
+
+        if (!readFileLine(query))
+        {
+            query.file.close();
+            continue;
+        }
+
+        LogLineFields fields;
+        if (parseLogLine(query.line, fields))
+        {
+            if (!matchesLogQuery(query, parseLogLevel(fields.level), fields.component))
+            {
+                continue;
+            }
+        }
+        else if (query.maxLevel < LOG_LEVEL_VERBOSE || query.component.length() > 0)
+        {
+            continue; // Can't tell whether it matches
+        }
+        else
+        {
+            fields = {"", "", "", query.line};
+        }
+
+        StaticJsonDocument<256> doc;
+        doc["time"] = fields.time;
+        doc["level"] = fields.level;
+        doc["component"] = fields.component;
+        doc["message"] = fields.message;
+        if (setOutputLine(query, doc))
+        {
+            return true;
+        }
+    }
+}
+
+static bool emitNextRingRecord(LogQuery &query)
+{
+    const LogHistory &history = getLogHistory();
+    LogRecord *record = reinterpret_cast<LogRecord *>(query.record);
+    char message[logMessageMaxLength];
+
+    while (query.cursor.sequence < query.endSequence && history.read(query.cursor, record, sizeof(query.record)))
+    {
+        const char *component = getLogComponentName(record->componentId);
+        if (!matchesLogQuery(query, record->level, component))
+        {
+            continue;
+        }
+
+        formatLogMessage(*record, message, sizeof(message));
+        StaticJsonDocument<256> doc;
+        doc["seq"] = query.cursor.sequence - 1;
+        doc["uptime_ms"] = record->timestampMs;
+        doc["level"] = getLogLevelString(record->level);
+        doc["component"] = component;
+        doc["message"] = (const char *)message;
+        if (setOutputLine(query, doc))
+        {
+            return true;
+        }
+    }
+
+    query.phase = LogQueryPhase::Trailer;
+    return false;
+}
+
+// Fill the output buffer with the next line; false once the trailer has gone
+static bool nextLogQueryLine(LogQuery &query)
+{
+    if (query.phase == LogQueryPhase::Files && emitNextFileLine(query))
+    {
+        return true;
+    }
+    if (query.phase == LogQueryPhase::Ring && emitNextRingRecord(query))
+    {
+        return true;
+    }
+    if (query.phase == LogQueryPhase::Trailer)
+    {
+        StaticJsonDocument<128> doc;
+        doc["next"] = query.cursor.sequence;
+        doc["missed"] = query.cursor.missed;
+        doc["skipped"] = query.skipped;
+        query.phase = LogQueryPhase::Done;
+        return setOutputLine(query, doc);
+    }
+    return false;
+}
+
+static size_t fillLogResponse(LogQuery &query, uint8_t *buffer, size_t maxLen)
+{
+    size_t filled = 0;
+    while (filled < maxLen)
+    {
+        if (query.outputOffset == query.outputLength && !nextLogQueryLine(query))
+        {
+            break;
+        }
+        size_t chunk = min(maxLen - filled, query.outputLength - query.outputOffset);
+        memcpy(buffer + filled, query.output + query.outputOffset, chunk);
+        query.outputOffset += chunk;
+        filled += chunk;
+    }
+    return filled; // 0 ends the response
+}
+
+void handleLogs(AsyncWebServerRequest *request)
+{
+    std::shared_ptr<LogQuery> query = std::make_shared<LogQuery>();
+
+    if (request->hasParam("source"))
+    {
+        String source = request->getParam("source")->value();
+        if (source == "ring")
+        {
+            query->source = LogQuerySource::Ring;
+        }
+        else if (source == "file")
+        {
+            query->source = LogQuerySource::File;
+        }
+        else if (source == "all")
+        {
+            query->source = LogQuerySource::All;
+        }
+        else
+        {
+            sendErrorResponse(request, 400, "source must be ring, file or all");
+            return;
+        }
+    }
+
+    if (request->hasParam("level"))
+    {
+        query->maxLevel = parseLogLevel(request->getParam("level")->value().c_str());
+        if (query->maxLevel < LOG_LEVEL_SILENT || query->maxLevel > LOG_LEVEL_VERBOSE)
+        {
+            sendErrorResponse(request, 400, "Unknown log level");
+            return;
+        }
+    }
+
+    if (request->hasParam("component"))
+    {
+        query->component = request->getParam("component")->value();
+    }
+
+    const LogHistory &history = getLogHistory();
+    query->endSequence = history.getNextSequence();
+    query->cursor = LogHistoryCursor(history.getFirstSequence());
+
+    if (request->hasParam("since"))
+    {
+        // A cursor from before a reboot is ahead of every record - start again from the oldest
+        uint32_t since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+        if (since <= query->endSequence)
+        {
+            query->cursor = LogHistoryCursor(since);
+        }
+        query->phase = query->source == LogQuerySource::File ? LogQueryPhase::Trailer : LogQueryPhase::Ring;
+    }
+    else if (query->source != LogQuerySource::Ring)
+    {
+        query->segmentCount = getLogFileSegmentNames(query->segments, logFileSegmentCount);
+        query->phase = LogQueryPhase::Files;
+    }
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "application/x-ndjson", [query](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+        { return fillLogResponse(*query, buffer, maxLen); });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file api_log_handlers.h
+ * @brief Log query API endpoint handlers
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#ifndef API_LOG_HANDLERS_H
+#define API_LOG_HANDLERS_H
+
+#include <ESPAsyncWebServer.h>
+
+/**
+ * @brief Handle log query request
+ * @param request The HTTP request
+ *
+ * Endpoint: GET /api/logs?source=ring|file|all&level=WARNING&component=MQTT&since=1234
+ * Streams matching log lines as newline-delimited JSON in a chunked
+ * response, one line at a time through a fixed buffer. source=ring (the
+ * default) reads recent records from RAM; file reads the text log segments;
+ * all reads the segments and then the records not yet in them. level keeps
+ * that level and more severe. The last line is {"next":N,...}: pass N back
+ * as since to get only newer records. since reads RAM only.
+ */
+void handleLogs(AsyncWebServerRequest *request);
+
+#endif // API_LOG_HANDLERS_H
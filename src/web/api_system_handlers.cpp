@@ -10,17 +10,28 @@
 #include "api_system_handlers.h"
 #include "api_handlers.h" // For shared utilities
 #include "validation.h"
-#include "web_server.h" // For addRegisteredRoutesToJson
+#include "web_server.h" // For writeRegisteredRoute, deserializeRequestBody
+#include "json_stream_response.h"
 #include <config/config.h>
 #include <core/config_loader.h>
 #include <core/config_utils.h>
 #include <core/logging.h>
 #include <core/network.h>
 #include <core/mqtt_handler.h>
+#include <core/message_dedup.h>
+#include <core/mqtt_multipart.h>
+#include <core/delivery_tracker.h>
+#include <core/mqtt_broker_pool.h>
+#include <core/peer_print.h>
+#include <core/peer_print_auth.h>
+#include <core/printer_discovery.h>
+#include <utils/time_utils.h>
+#include <utils/json_stream_writer.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
+#include <memory>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <WiFi.h>
@@ -34,67 +45,19 @@ extern PubSubClient mqttClient;
 // SYSTEM API HANDLERS
 // ========================================
 
-void handleDiagnostics(AsyncWebServerRequest *request)
+// === MICROCONTROLLER SECTION ===
+static void writeMicrocontrollerDiagnostics(JsonStreamWriter &json)
 {
-    // Get flash storage information
-    size_t totalBytes = 0;
-    size_t usedBytes = 0;
-    totalBytes = LittleFS.totalBytes();
-    usedBytes = LittleFS.usedBytes();
-
-    const RuntimeConfig &runtimeConfig = getRuntimeConfig();
-
-    DynamicJsonDocument doc(4096);
-
-    // === MICROCONTROLLER SECTION ===
-    JsonObject microcontroller = doc.createNestedObject("microcontroller");
+    json.beginObject("microcontroller");
 
     // Hardware information
-    microcontroller["chip_model"] = ESP.getChipModel();
-    microcontroller["chip_revision"] = ESP.getChipRevision();
-    microcontroller["cpu_frequency_mhz"] = ESP.getCpuFreqMHz();
-    microcontroller["sdk_version"] = ESP.getSdkVersion();
+    json.field("chip_model", ESP.getChipModel());
+    json.field("chip_revision", ESP.getChipRevision());
+    json.field("cpu_frequency_mhz", ESP.getCpuFreqMHz());
+    json.field("sdk_version", ESP.getSdkVersion());
 
     // Reset reason
-    esp_reset_reason_t resetReason = esp_reset_reason();
-    const char *resetReasonStr = "Unknown";
-    switch (resetReason)
-    {
-    case ESP_RST_POWERON:
-        resetReasonStr = "Power-on";
-        break;
-    case ESP_RST_EXT:
-        resetReasonStr = "External reset";
-        break;
-    case ESP_RST_SW:
-        resetReasonStr = "Software reset";
-        break;
-    case ESP_RST_PANIC:
-        resetReasonStr = "Panic/exception";
-        break;
-    case ESP_RST_INT_WDT:
-        resetReasonStr = "Interrupt watchdog";
-        break;
-    case ESP_RST_TASK_WDT:
-        resetReasonStr = "Task watchdog";
-        break;
-    case ESP_RST_WDT:
-        resetReasonStr = "Other watchdog";
-        break;
-    case ESP_RST_DEEPSLEEP:
-        resetReasonStr = "Deep sleep";
-        break;
-    case ESP_RST_BROWNOUT:
-        resetReasonStr = "Brownout";
-        break;
-    case ESP_RST_SDIO:
-        resetReasonStr = "SDIO reset";
-        break;
-    default:
-        resetReasonStr = "Unknown";
-        break;
-    }
-    microcontroller["reset_reason"] = resetReasonStr;
+    json.field("reset_reason", getResetReasonString());
 
     // Temperature (ESP32-C3 internal sensor)
     float temp = temperatureRead();
@@ -103,34 +66,34 @@ void handleDiagnostics(AsyncWebServerRequest *request)
 
     if (isfinite(temp) && temp > -100 && temp < 200) // Very lenient range for debugging
     {
-        microcontroller["temperature"] = temp;
+        json.field("temperature", temp);
         LOG_VERBOSE("WEB", "Temperature added to JSON: %.2f°C", temp);
     }
     else
     {
-        microcontroller["temperature"] = nullptr; // Explicitly set to null for JSON
+        json.field("temperature", nullptr); // Explicitly set to null for JSON
         LOG_WARNING("WEB", "Invalid temperature reading filtered out: %.2f°C (isnan: %s, isfinite: %s)",
                     temp, isnan(temp) ? "true" : "false", isfinite(temp) ? "true" : "false");
     }
 
     // System status
-    microcontroller["uptime_ms"] = millis();
+    json.field("uptime_ms", millis());
 
     // Memory information
-    JsonObject memory = microcontroller.createNestedObject("memory");
-    memory["free_heap"] = ESP.getFreeHeap();
-    memory["total_heap"] = ESP.getHeapSize();
-    memory["used_heap"] = ESP.getHeapSize() - ESP.getFreeHeap();
+    json.beginObject("memory");
+    json.field("free_heap", ESP.getFreeHeap());
+    json.field("total_heap", ESP.getHeapSize());
+    json.field("used_heap", ESP.getHeapSize() - ESP.getFreeHeap());
+    json.endObject();
 
     // Flash storage breakdown
-    JsonObject flash = microcontroller.createNestedObject("flash");
+    json.beginObject("flash");
 
     // Total flash chip size (4MB on ESP32-C3)
     uint32_t totalFlashSize = ESP.getFlashChipSize();
-    flash["total_chip_size"] = totalFlashSize;
+    json.field("total_chip_size", totalFlashSize);
 
     // App partition (firmware)
-    JsonObject app_partition = flash.createNestedObject("app_partition");
     uint32_t appUsed = ESP.getSketchSize();
 
     // Get accurate partition size using ESP-IDF APIs
@@ -148,55 +111,172 @@ void handleDiagnostics(AsyncWebServerRequest *request)
 
     uint32_t appFree = appTotal - appUsed;
 
-    app_partition["used"] = appUsed;
-    app_partition["free"] = appFree;
-    app_partition["total"] = appTotal;
-    app_partition["percent_of_total_flash"] = (appTotal * 100) / totalFlashSize;
+    json.beginObject("app_partition");
+    json.field("used", appUsed);
+    json.field("free", appFree);
+    json.field("total", appTotal);
+    json.field("percent_of_total_flash", (appTotal * 100) / totalFlashSize);
+    json.endObject();
 
     // File system (LittleFS)
-    JsonObject filesystem = flash.createNestedObject("filesystem");
-    filesystem["used"] = usedBytes;
-    filesystem["free"] = totalBytes - usedBytes;
-    filesystem["total"] = totalBytes;
-    filesystem["percent_of_total_flash"] = (totalBytes * 100) / totalFlashSize;
-
-    // === LOGGING CONFIGURATION ===
-    JsonObject logging = doc.createNestedObject("logging");
-    logging["level"] = logLevel;
-    logging["level_name"] = getLogLevelString(logLevel);
-    logging["serial_enabled"] = enableSerialLogging;
-    logging["file_enabled"] = enableFileLogging;
-    logging["mqtt_enabled"] = enableMQTTLogging;
-    logging["betterstack_enabled"] = enableBetterStackLogging;
-
-    // Pages and endpoints moved to separate /api/routes endpoint
-
-    // Serialize and send
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    size_t totalBytes = LittleFS.totalBytes();
+    size_t usedBytes = LittleFS.usedBytes();
+    json.beginObject("filesystem");
+    json.field("used", usedBytes);
+    json.field("free", totalBytes - usedBytes);
+    json.field("total", totalBytes);
+    json.field("percent_of_total_flash", (totalBytes * 100) / totalFlashSize);
+    json.endObject();
+
+    json.endObject(); // flash
+    json.endObject(); // microcontroller
+}
+
+// === LOGGING CONFIGURATION ===
+static void writeLoggingDiagnostics(JsonStreamWriter &json)
+{
+    json.beginObject("logging");
+    json.field("level", getLogLevel());
+    json.field("level_name", getLogLevelString(getLogLevel()));
+    json.field("component_levels", getRuntimeConfig().logComponentLevels);
+    json.field("serial_enabled", enableSerialLogging);
+    json.field("file_enabled", enableFileLogging);
+    json.field("mqtt_enabled", enableMQTTLogging);
+    json.field("betterstack_enabled", enableBetterStackLogging);
+    LoggingStats logStats = getLoggingStats();
+    json.field("records_written", logStats.recordsWritten);
+    json.field("records_dropped", logStats.recordsDropped);
+    json.field("records_queued", logStats.recordsQueued);
+    json.field("mqtt_dropped", logStats.mqttDropped);
+    json.field("betterstack_sent", logStats.betterStackSent);
+    json.field("betterstack_dropped", logStats.betterStackDropped);
+    json.field("file_writes", logStats.fileWrites);
+    json.field("records_suppressed", logStats.recordsSuppressed);
+    json.field("sink_stack_free", logStats.sinkStackFree);
+    json.endObject();
+}
+
+// === MESSAGING ===
+static void writeMessagingDiagnostics(JsonStreamWriter &json)
+{
+    json.beginObject("messaging");
+    json.field("duplicates_dropped", getDuplicateMessageCount());
+    json.field("tracked_message_ids", getTrackedMessageIdCount());
+    json.field("multipart_pending", getPendingMultipartCount());
+    json.endObject();
+}
+
+// === MQTT BROKERS (preference order) ===
+static void writeBrokerDiagnostics(JsonStreamWriter &json)
+{
+    const MqttBrokerPool &brokerPool = getMqttBrokerPool();
+    json.beginArray("mqtt_brokers");
+    for (int i = 0; i < brokerPool.getBrokerCount(); i++)
+    {
+        const MqttBrokerHealth &broker = brokerPool.getBroker(i);
+        json.beginObject();
+        json.field("host", broker.host);
+        json.field("port", broker.port);
+        json.field("active", i == brokerPool.getActiveIndex());
+        json.field("health", brokerPool.getHealthScore(i));
+        json.field("avg_connect_ms", broker.avgConnectMs);
+        json.field("consecutive_failures", broker.consecutiveFailures);
+        json.field("successes", broker.totalSuccesses);
+        json.field("failures", broker.totalFailures);
+        json.field("last_success_age_ms", broker.hasSucceeded ? millis() - broker.lastSuccessAt : 0UL);
+        json.endObject();
+    }
+    json.endArray();
+}
+
+// === WEB (streamed responses, POST body buffers) ===
+static void writeWebDiagnostics(JsonStreamWriter &json)
+{
+    const JsonStreamStats &stats = getJsonStreamStats();
+    json.beginObject("web");
+    json.field("streamed_responses", stats.responses);
+    json.field("streamed_peak_heap", stats.peakHeapBytes);
+    json.field("streamed_largest_body", stats.largestBody);
+
+    // Pooled POST body buffers
+    RequestBodyPoolStats bodies = getRequestBodyPoolStats();
+    json.field("body_buffers_in_use", bodies.inUse);
+    json.field("body_buffers_peak", bodies.peakInUse);
+    json.field("bodies_too_large", bodies.refusedTooLarge);
+    json.field("bodies_refused_busy", bodies.refusedBusy);
+    json.endObject();
+}
+
+void handleDiagnostics(AsyncWebServerRequest *request)
+{
+    // One section per step - see json_stream_response.h
+    request->send(beginJsonStreamResponse(request, "GET /api/diagnostics", [](JsonStreamWriter &json, int step)
+                                          {
+        switch (step)
+        {
+        case 0:
+            writeMicrocontrollerDiagnostics(json);
+            return true;
+        case 1:
+            writeLoggingDiagnostics(json);
+            return true;
+        case 2:
+            writeMessagingDiagnostics(json);
+            return true;
+        case 3:
+            writeBrokerDiagnostics(json);
+            return true;
+        case 4:
+            writeWebDiagnostics(json);
+            return true;
+        default:
+            return false; // Pages and endpoints moved to separate /api/routes endpoint
+        } }));
+}
+
+void handlePreviousBootLog(AsyncWebServerRequest *request)
+{
+    const CrashLog &crashLog = getCrashLog();
+    int count = crashLog.getPreviousCount();
+
+    // Written as it goes; the stream holds the body once, with no JsonDocument beside it
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    JsonStreamWriter json(*response);
+    json.beginObject();
+    json.field("reset_reason", getResetReasonString());
+    json.field("count", count);
+    json.beginArray("lines");
+
+    char message[logMessageMaxLength];
+    for (int i = 0; i < count; i++)
+    {
+        const CrashLogSlot &slot = crashLog.getPrevious(i);
+        crashLog.formatPrevious(i, message, sizeof(message));
+
+        json.beginObject();
+        json.field("uptime_ms", slot.timestampMs);
+        json.field("level", getLogLevelString(slot.level));
+        json.field("component", crashLog.getPreviousComponent(i));
+        json.field("message", (const char *)message);
+        json.endObject();
+    }
+
+    json.endArray();
+    json.endObject();
+    json.flush();
+    request->send(response);
 }
 
 void handleRoutes(AsyncWebServerRequest *request)
 {
     LOG_VERBOSE("WEB", "handleRoutes() called - listing pages and API endpoints");
 
-    // Use heap allocation for large JSON documents to prevent stack overflow
-    std::unique_ptr<DynamicJsonDocument> doc(new DynamicJsonDocument(8192));
-    JsonObject routes = doc->to<JsonObject>();
-
     // === PAGES AND ENDPOINTS ===
-    addRegisteredRoutesToJson(routes);
-
-    // Serialize and send
-    String response;
-    serializeJson(*doc, response);
-    
-    AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+    // A route per step, web pages first; steps past the last route return false
+    AsyncWebServerResponse *res = beginJsonStreamResponse(request, "GET /api/routes", [](JsonStreamWriter &json, int step)
+                                                          { return writeRegisteredRoute(json, step); });
     res->addHeader("Access-Control-Allow-Origin", "*");
     request->send(res);
-    
-    LOG_VERBOSE("WEB", "Routes data sent (%zu bytes)", response.length());
 }
 
 void handlePrintMQTT(AsyncWebServerRequest *request)
@@ -207,18 +287,6 @@ void handlePrintMQTT(AsyncWebServerRequest *request)
         return;
     }
 
-    if (!isMQTTEnabled())
-    {
-        sendErrorResponse(request, 503, "MQTT is disabled");
-        return;
-    }
-    
-    if (!mqttClient.connected())
-    {
-        sendErrorResponse(request, 503, "MQTT client not connected");
-        return;
-    }
-
     // Get and validate JSON body
     extern String getRequestBody(AsyncWebServerRequest * request);
     String body = getRequestBody(request);
@@ -229,8 +297,8 @@ void handlePrintMQTT(AsyncWebServerRequest *request)
     }
 
     // Validate JSON structure - only support structured format (header+body)
-    const char *requiredFields[] = {"topic", "header", "body"};
-    ValidationResult jsonValidation = validateJSON(body, requiredFields, 3);
+    const char *requiredFields[] = {"header", "body"};
+    ValidationResult jsonValidation = validateJSON(body, requiredFields, 2);
     if (!jsonValidation.isValid)
     {
         sendValidationError(request, jsonValidation);
@@ -241,7 +309,27 @@ void handlePrintMQTT(AsyncWebServerRequest *request)
     DynamicJsonDocument doc(4096);
     deserializeJson(doc, body);
 
-    String topic = doc["topic"].as<String>();
+    // Target is a printer topic, or a group to hand to its least busy printer
+    String topic;
+    String group = doc["group"] | "";
+    String chosenPrinterId;
+    if (group.length() > 0)
+    {
+        if (!pickGroupPrinter(group, topic, chosenPrinterId))
+        {
+            sendErrorResponse(request, 404, "No online printer in group " + group);
+            return;
+        }
+    }
+    else if (doc.containsKey("topic"))
+    {
+        topic = doc["topic"].as<String>();
+    }
+    else
+    {
+        sendValidationError(request, ValidationResult(false, "Missing required field 'topic' or 'group'"));
+        return;
+    }
     
     // Validate MQTT topic
     ValidationResult topicValidation = validateMQTTTopic(topic);
@@ -266,18 +354,158 @@ void handlePrintMQTT(AsyncWebServerRequest *request)
         return;
     }
     
+    // Delivery ack requested unless the caller opts out; group prints always
+    // track it, since unacked jobs count towards each printer's load
+    bool requestAck = (doc["ack"] | true) || group.length() > 0;
+
+    // Known LAN peer: send directly, the peer module falls back to MQTT itself
+    String messageId;
+    if (sendPeerPrint(topic, header, bodyContent, requestAck, messageId))
+    {
+        DynamicJsonDocument response(256);
+        response["id"] = messageId;
+        response["ack_requested"] = requestAck;
+        response["path"] = "lan";
+        if (group.length() > 0)
+        {
+            response["topic"] = topic;
+            response["printer_id"] = chosenPrinterId;
+        }
+        String responseStr;
+        serializeJson(response, responseStr);
+        request->send(200, "application/json", responseStr);
+        return;
+    }
+
+    if (!isMQTTEnabled())
+    {
+        sendErrorResponse(request, 503, "MQTT is disabled");
+        return;
+    }
+    
+    if (!mqttClient.connected())
+    {
+        sendErrorResponse(request, 503, "MQTT client not connected");
+        return;
+    }
+
     // Use centralized MQTT publishing function
-    bool success = publishMQTTMessage(topic, header, bodyContent);
+    bool success = publishMQTTMessage(topic, header, bodyContent, requestAck, &messageId);
     
     if (success) {
         LOG_VERBOSE("WEB", "MQTT message sent via centralized function to topic: %s", topic.c_str());
-        request->send(200);
+
+        DynamicJsonDocument response(256);
+        response["id"] = messageId;
+        response["ack_requested"] = requestAck;
+        response["path"] = "mqtt";
+        if (group.length() > 0)
+        {
+            response["topic"] = topic;
+            response["printer_id"] = chosenPrinterId;
+        }
+        String responseStr;
+        serializeJson(response, responseStr);
+        request->send(200, "application/json", responseStr);
     } else {
         LOG_ERROR("WEB", "Failed to send MQTT message to topic: %s", topic.c_str());
         sendErrorResponse(request, 500, "Failed to send MQTT message - broker error");
     }
 }
 
+void handlePeerPrintRequest(AsyncWebServerRequest *request)
+{
+    if (!isPeerPrintEnabled())
+    {
+        sendErrorResponse(request, 404, "LAN printing is disabled");
+        return;
+    }
+
+    if (!request->hasHeader("X-Scribe-Printer") || !request->hasHeader("X-Scribe-Target") ||
+        !request->hasHeader("X-Scribe-Timestamp") || !request->hasHeader("X-Scribe-Signature"))
+    {
+        sendErrorResponse(request, 401, "Missing signature headers");
+        return;
+    }
+
+    // Signed for another printer - a replay of a print captured on its way there
+    String ourPrinterId = getPrinterId();
+    if (request->header("X-Scribe-Target") != ourPrinterId)
+    {
+        sendErrorResponse(request, 403, "Addressed to another printer");
+        return;
+    }
+
+    // Without a synced clock we can't bound replays - the sender falls back to MQTT
+    if (timeStatus() != timeSet)
+    {
+        sendErrorResponse(request, 503, "Clock not synchronised");
+        return;
+    }
+
+    unsigned long timestamp = strtoul(request->header("X-Scribe-Timestamp").c_str(), nullptr, 10);
+    if (!isPeerTimestampFresh(timestamp, (unsigned long)UTC.now()))
+    {
+        sendErrorResponse(request, 401, "Stale or future timestamp");
+        return;
+    }
+
+    extern String getRequestBody(AsyncWebServerRequest * request);
+    String body = getRequestBody(request);
+    if (body.length() == 0 || body.length() > (size_t)mqttMultipartMaxMessageSize)
+    {
+        sendErrorResponse(request, 413, "Body missing or too large");
+        return;
+    }
+
+    String senderId = request->header("X-Scribe-Printer");
+    if (!verifyPeerPrintSignature(getRuntimeConfig().mqttPeerKey.c_str(), timestamp, senderId.c_str(),
+                                  ourPrinterId.c_str(), body.c_str(), body.length(), request->header("X-Scribe-Signature").c_str()))
+    {
+        LOG_WARNING("PEER", "Rejected LAN print with bad signature from %s", request->client()->remoteIP().toString().c_str());
+        sendErrorResponse(request, 401, "Invalid signature");
+        return;
+    }
+
+    // Dedup by id is what stops a captured body being replayed inside the timestamp
+    // window, and an empty id is never a duplicate - so one is required here
+    StaticJsonDocument<32> idFilter;
+    idFilter["id"] = true;
+    StaticJsonDocument<128> idDoc;
+    DeserializationError error = deserializeJson(idDoc, body, DeserializationOption::Filter(idFilter));
+    const char *messageId = idDoc["id"] | "";
+    if (error || messageId[0] == '\0' || strlen(messageId) > maxMessageIdLength)
+    {
+        sendErrorResponse(request, 400, "Message ID missing or invalid");
+        return;
+    }
+
+    if (!queueReceivedPeerPrint(body))
+    {
+        sendErrorResponse(request, 503, "Print queue full");
+        return;
+    }
+
+    LOG_VERBOSE("PEER", "Queued LAN print from %s", senderId.c_str());
+    request->send(202, "application/json", "{\"status\":\"queued\"}");
+}
+
+void handlePrintMQTTLatency(AsyncWebServerRequest *request)
+{
+    // A job per step - see json_stream_response.h
+    std::shared_ptr<DeliveryLatencyReport> report = std::make_shared<DeliveryLatencyReport>();
+    request->send(beginJsonStreamResponse(request, "GET /api/print-mqtt/latency", [report](JsonStreamWriter &json, int step)
+                                          { return report->writeStep(json, step); }));
+}
+
+void handleDiscoveredPrinters(AsyncWebServerRequest *request)
+{
+    // A printer per step, all from one copy of the table - see json_stream_response.h
+    std::shared_ptr<DiscoveredPrinterTable> printers = copyDiscoveredPrinters();
+    request->send(beginJsonStreamResponse(request, "GET /api/discovered-printers", [printers](JsonStreamWriter &json, int step)
+                                          { return writeDiscoveredPrintersStep(json, *printers, step); }));
+}
+
 void handleWiFiScan(AsyncWebServerRequest *request)
 {
     LOG_VERBOSE("WEB", "WiFi scan requested");
@@ -437,18 +665,15 @@ void handleTestWiFi(AsyncWebServerRequest *request)
         }
     };
 
-    // Parse JSON body
-    extern String getRequestBody(AsyncWebServerRequest * request);
-    String body = getRequestBody(request);
-    if (body.length() == 0)
+    // Parse JSON body in place
+    DynamicJsonDocument doc(512);
+    DeserializationError err = deserializeRequestBody(request, doc);
+    if (err == DeserializationError::EmptyInput)
     {
         releaseMutex();
         sendErrorResponse(request, 422, "No JSON body provided");
         return;
     }
-
-    DynamicJsonDocument doc(512);
-    DeserializationError err = deserializeJson(doc, body);
     if (err)
     {
         releaseMutex();
@@ -23,6 +23,16 @@
  */
 void handleDiagnostics(AsyncWebServerRequest *request);
 
+/**
+ * @brief Handle previous boot log request
+ * @param request The HTTP request
+ *
+ * Endpoint: GET /api/previous-boot-log
+ * Returns the last log lines written before the most recent reset, kept in
+ * no-init RAM, with the reset reason. Empty after a power-on.
+ */
+void handlePreviousBootLog(AsyncWebServerRequest *request);
+
 /**
  * @brief Handle routes listing request
  * @param request The HTTP request
@@ -37,13 +47,47 @@ void handleRoutes(AsyncWebServerRequest *request);
  * @param request The HTTP request containing MQTT topic and message
  *
  * Endpoint: POST /api/print-mqtt
- * Body: JSON with "topic" and "message" fields
+ * Body: JSON with "topic" (or "group"), "header" and "body" fields, optional "ack" (default true)
+ *
+ * A "group" sends to the least busy online printer in that group (see
+ * fleet_balancer.h); the response then names the chosen topic and printer.
  *
- * Validates MQTT connectivity, topic format, and message content
- * before publishing to the MQTT broker
+ * Validates topic format and message content, then sends directly to the
+ * printer over the LAN when it is a known peer (see peer_print.h), otherwise
+ * publishes to the MQTT broker. Returns the message ID and the path used.
  */
 void handlePrintMQTT(AsyncWebServerRequest *request);
 
+/**
+ * @brief Handle a direct print from another printer on the LAN
+ * @param request The HTTP request
+ *
+ * Endpoint: POST /api/peer-print
+ * Body: the same JSON as an MQTT print message. Authenticated by the
+ * X-Scribe-* signature headers (peer_print_auth.h) rather than a session.
+ * Replies 202 once the message is queued for printing.
+ */
+void handlePeerPrintRequest(AsyncWebServerRequest *request);
+
+/**
+ * @brief Handle remote print latency request
+ * @param request The HTTP request
+ *
+ * Endpoint: GET /api/print-mqtt/latency
+ * Returns recent remote prints with round-trip, print and network latency.
+ */
+void handlePrintMQTTLatency(AsyncWebServerRequest *request);
+
+/**
+ * @brief Handle discovered printer snapshot request
+ * @param request The HTTP request
+ *
+ * Endpoint: GET /api/discovered-printers
+ * Returns the same snapshot as the SSE "printer-update" event, including the
+ * table version. Clients use it to resync after missing a "printer-delta".
+ */
+void handleDiscoveredPrinters(AsyncWebServerRequest *request);
+
 /**
  * @brief Handle WiFi network scanning request
  * @details Scans for available WiFi networks and returns them with signal strength
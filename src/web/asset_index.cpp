@@ -0,0 +1,211 @@
+/**
+ * @file asset_index.cpp
+ * @brief Implementation of the in-RAM static asset index
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "asset_index.h"
+#include <algorithm>
+
+// Copy one space-separated ETag field; "-" means that form isn't stored
+static bool parseEtagField(const char *&p, char *out)
+{
+    const char *end = strchr(p, ' ');
+    if (!end)
+    {
+        return false;
+    }
+
+    size_t length = end - p;
+    if (length == 1 && *p == '-')
+    {
+        out[0] = '\0';
+    }
+    else if (length == (size_t)assetEtagLength)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            if (!isxdigit((unsigned char)p[i]))
+            {
+                return false;
+            }
+        }
+        memcpy(out, p, length);
+        out[length] = '\0';
+    }
+    else
+    {
+        return false;
+    }
+
+    p = end + 1;
+    return true;
+}
+
+bool AssetIndex::addLine(const char *line)
+{
+    AssetEntry entry;
+    const char *p = line;
+    if (!parseEtagField(p, entry.plainEtag) || !parseEtagField(p, entry.gzipEtag))
+    {
+        return false;
+    }
+
+    size_t length = strcspn(p, "\r\n");
+    if (*p != '/' || length > (size_t)maxAssetPathLength || (!entry.plainEtag[0] && !entry.gzipEtag[0]))
+    {
+        return false;
+    }
+    entry.path = String(p).substring(0, length);
+
+    auto position = std::lower_bound(entries.begin(), entries.end(), entry.path,
+                                     [](const AssetEntry &a, const String &path)
+                                     { return strcmp(a.path.c_str(), path.c_str()) < 0; });
+    if (position != entries.end() && position->path == entry.path)
+    {
+        *position = entry; // Listed twice - the later line wins
+    }
+    else
+    {
+        entries.insert(position, entry);
+    }
+    return true;
+}
+
+bool AssetIndex::load(fs::FS &fs, const char *manifestPath)
+{
+    entries.clear();
+
+    File file = fs.open(manifestPath, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    // Line by line through a small buffer; overlong lines are dropped whole
+    char line[2 * assetEtagLength + maxAssetPathLength + 8];
+    size_t length = 0;
+    bool overlong = false;
+    uint8_t buffer[128];
+    size_t read;
+    while ((read = file.read(buffer, sizeof(buffer))) > 0)
+    {
+        for (size_t i = 0; i < read; i++)
+        {
+            char c = (char)buffer[i];
+            if (c == '\n')
+            {
+                line[length] = '\0';
+                if (!overlong && length > 0)
+                {
+                    addLine(line);
+                }
+                length = 0;
+                overlong = false;
+            }
+            else if (length < sizeof(line) - 1)
+            {
+                line[length++] = c;
+            }
+            else
+            {
+                overlong = true;
+            }
+        }
+    }
+    if (length > 0 && !overlong)
+    {
+        line[length] = '\0';
+        addLine(line);
+    }
+
+    file.close();
+    return true;
+}
+
+const AssetEntry *AssetIndex::find(const char *path) const
+{
+    auto position = std::lower_bound(entries.begin(), entries.end(), path,
+                                     [](const AssetEntry &a, const char *p)
+                                     { return strcmp(a.path.c_str(), p) < 0; });
+    if (position != entries.end() && strcmp(position->path.c_str(), path) == 0)
+    {
+        return &*position;
+    }
+    return nullptr;
+}
+
+bool AssetIndex::etagMatches(const char *ifNoneMatch, const char *etag)
+{
+    if (!ifNoneMatch || !etag || !etag[0])
+    {
+        return false;
+    }
+
+    // A list of quoted tags, any of them possibly W/-prefixed; If-None-Match compares weakly
+    size_t etagLength = strlen(etag);
+    for (const char *p = ifNoneMatch; *p; p++)
+    {
+        if (*p == '*')
+        {
+            return true;
+        }
+        if (*p == '"')
+        {
+            const char *end = strchr(p + 1, '"');
+            if (!end)
+            {
+                return false;
+            }
+            if ((size_t)(end - p - 1) == etagLength && strncmp(p + 1, etag, etagLength) == 0)
+            {
+                return true;
+            }
+            p = end;
+        }
+    }
+    return false;
+}
+
+bool AssetIndex::isFingerprinted(const char *path)
+{
+    // "<name>.<hash>.<ext>": the hash is the second-last dot-separated part of the file name
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    const char *extension = strrchr(name, '.');
+    if (!extension || extension - name < assetFingerprintLength + 2)
+    {
+        return false; // No room for a name, a dot and the hash
+    }
+
+    const char *hash = extension - assetFingerprintLength;
+    if (hash[-1] != '.')
+    {
+        return false;
+    }
+    for (const char *c = hash; c < extension; c++)
+    {
+        if (!isxdigit((unsigned char)*c))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char *AssetIndex::getCacheControl(const char *path)
+{
+    if (isFingerprinted(path))
+    {
+        return assetCacheFingerprinted;
+    }
+    size_t length = strlen(path);
+    if (length >= 5 && strcmp(path + length - 5, ".html") == 0)
+    {
+        return assetCacheHtml;
+    }
+    return assetCacheDefault;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file asset_index.h
+ * @brief In-RAM index of the static web assets and their ETags
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * The build writes a manifest (assetManifestPath) listing every file under
+ * data/ with a content hash of each stored form - plain and .gz. It is read
+ * once at boot, so serving an asset needs no LittleFS.exists() probing for
+ * the .gz variant, and a browser revalidating with If-None-Match can be
+ * answered 304 without touching the filesystem at all.
+ *
+ * Manifest lines are "<plain etag|-> <gzip etag|-> <url path>", e.g.
+ * "- 3f2a9c0d1b7e4a66 /css/app.1a2b3c4d.css".
+ *
+ * JS and CSS bundles carry a content hash in their name, so a new build gives
+ * them a new URL and they can be cached as immutable; the HTML that names
+ * them is revalidated on every load instead.
+ */
+
+#ifndef ASSET_INDEX_H
+#define ASSET_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <config/config.h>
+#include <vector>
+
+struct AssetEntry
+{
+    String path;                           // URL path, e.g. "/index.html"
+    char plainEtag[assetEtagLength + 1];   // Empty if only the .gz is stored
+    char gzipEtag[assetEtagLength + 1];    // Empty if there is no .gz
+};
+
+class AssetIndex
+{
+public:
+    /**
+     * @brief Replace the index with the manifest's contents
+     * @return false if the manifest is missing; the index is then empty
+     */
+    bool load(fs::FS &fs, const char *manifestPath);
+
+    /**
+     * @brief Add one manifest line (kept sorted for lookup)
+     * @return false if the line is malformed
+     */
+    bool addLine(const char *line);
+
+    /**
+     * @brief Entry for a URL path, or nullptr if the build didn't list it
+     */
+    const AssetEntry *find(const char *path) const;
+
+    size_t size() const { return entries.size(); }
+    void clear() { entries.clear(); }
+
+    /**
+     * @brief Whether an If-None-Match header names this ETag (weak or strong, or "*")
+     * @param etag Bare hex, as stored in AssetEntry
+     */
+    static bool etagMatches(const char *ifNoneMatch, const char *etag);
+
+    /**
+     * @brief Whether a path names a content-hashed bundle, e.g. "/js/app.1a2b3c4d.js"
+     */
+    static bool isFingerprinted(const char *path);
+
+    /**
+     * @brief Cache-Control for an asset: immutable for bundles, revalidated for HTML
+     */
+    static const char *getCacheControl(const char *path);
+
+private:
+    std::vector<AssetEntry> entries; // Sorted by path
+};
+
+#endif // ASSET_INDEX_H
@@ -87,7 +87,18 @@ const ConfigFieldDef CONFIG_FIELDS[] = {
     {"mqtt.port", ValidationType::RANGE_INT, offsetof(RuntimeConfig, mqttPort), 1, 65535, nullptr, 0},
     {"mqtt.username", ValidationType::STRING, offsetof(RuntimeConfig, mqttUsername), 0, 0, nullptr, 0},
     {"mqtt.password", ValidationType::STRING, offsetof(RuntimeConfig, mqttPassword), 0, 0, nullptr, 0},
+    {"mqtt.groups", ValidationType::STRING, offsetof(RuntimeConfig, mqttGroups), 0, 0, nullptr, 0},
+    {"mqtt.fallbackServers", ValidationType::STRING, offsetof(RuntimeConfig, mqttFallbackServers), 0, 0, nullptr, 0},
+    {"mqtt.discoveryScope", ValidationType::STRING, offsetof(RuntimeConfig, mqttDiscoveryScope), 0, 0, nullptr, 0},
+    {"mqtt.discoverySummary", ValidationType::BOOLEAN, offsetof(RuntimeConfig, mqttDiscoverySummary), 0, 0, nullptr, 0},
+    {"mqtt.peerKey", ValidationType::STRING, offsetof(RuntimeConfig, mqttPeerKey), 0, 0, nullptr, 0},
     
+    // Logging configuration
+    {"logging.rateLimitPerMinute", ValidationType::RANGE_INT, offsetof(RuntimeConfig, logRateLimitPerMinute), 0, maxLogRateLimitPerMinute, nullptr, 0},
+    {"logging.rateLimitBurst", ValidationType::RANGE_INT, offsetof(RuntimeConfig, logRateLimitBurst), 1, maxLogRateLimitBurst, nullptr, 0},
+    {"logging.level", ValidationType::RANGE_INT, offsetof(RuntimeConfig, logLevel), LOG_LEVEL_SILENT, LOG_LEVEL_VERBOSE, nullptr, 0},
+    {"logging.componentLevels", ValidationType::STRING, offsetof(RuntimeConfig, logComponentLevels), 0, 0, nullptr, 0},
+
     // Unbidden Ink configuration
     {"unbiddenInk.enabled", ValidationType::BOOLEAN, offsetof(RuntimeConfig, unbiddenInkEnabled), 0, 0, nullptr, 0},
     {"unbiddenInk.startHour", ValidationType::RANGE_INT, offsetof(RuntimeConfig, unbiddenInkStartHour), 0, 24, nullptr, 0},
@@ -0,0 +1,146 @@
+/**
+ * @file json_stream_response.cpp
+ * @brief Implementation of step-at-a-time chunked JSON responses
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "json_stream_response.h"
+#include <config/config.h>
+#include <core/logging.h>
+#include <memory>
+#include <vector>
+
+static JsonStreamStats jsonStreamStats = {};
+
+// One step's output, handed out across as many chunks as it takes
+class PendingOutput : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        bytes.push_back(c);
+        return 1;
+    }
+
+    size_t write(const uint8_t *data, size_t length) override
+    {
+        bytes.insert(bytes.end(), data, data + length);
+        return length;
+    }
+
+    std::vector<uint8_t> bytes; // Cleared between steps, so capacity settles at the largest step
+    size_t offset = 0;
+};
+
+// State carried between calls of the chunked response filler
+struct JsonStream
+{
+    JsonStream(const char *label, JsonResponseStep step, uint32_t startFreeHeap)
+        : label(label), step(std::move(step)), json(pending),
+          startFreeHeap(startFreeHeap), lowestFreeHeap(startFreeHeap)
+    {
+        pending.bytes.reserve(jsonStreamPendingBytes);
+    }
+
+    // Runs when AsyncWebServer frees the response - sent in full or the client went away
+    ~JsonStream()
+    {
+        uint32_t peakHeap = startFreeHeap - lowestFreeHeap;
+        jsonStreamStats.responses++;
+        jsonStreamStats.peakHeapBytes = max(jsonStreamStats.peakHeapBytes, peakHeap);
+        jsonStreamStats.largestBody = max(jsonStreamStats.largestBody, (uint32_t)json.getBytesWritten());
+
+        LOG_VERBOSE("WEB", "%s: %u bytes in %u chunks over %d steps, peak heap %u bytes%s",
+                    label, (unsigned)json.getBytesWritten(), (unsigned)chunks, nextStep,
+                    (unsigned)peakHeap, finished ? "" : " (client left early)");
+    }
+
+    void sampleHeap()
+    {
+        lowestFreeHeap = min(lowestFreeHeap, (uint32_t)ESP.getFreeHeap());
+    }
+
+    const char *label;
+    JsonResponseStep step;
+    PendingOutput pending;
+    JsonStreamWriter json; // Writes into pending, so declared after it
+    int nextStep = 0;
+    bool finished = false;
+    size_t chunks = 0;
+    uint32_t startFreeHeap;
+    uint32_t lowestFreeHeap;
+};
+
+// Put the next step's output in pending; false once the closing brace has gone
+static bool writeNextStep(JsonStream &stream)
+{
+    if (stream.finished)
+    {
+        return false;
+    }
+
+    if (stream.nextStep == 0)
+    {
+        stream.json.beginObject();
+    }
+    if (!stream.step(stream.json, stream.nextStep++))
+    {
+        stream.json.endObject();
+        stream.finished = true;
+    }
+    stream.json.flush();
+    stream.sampleHeap();
+    return true;
+}
+
+static size_t fillJsonStream(JsonStream &stream, uint8_t *buffer, size_t maxLen)
+{
+    PendingOutput &pending = stream.pending;
+    size_t filled = 0;
+    while (filled < maxLen)
+    {
+        if (pending.offset == pending.bytes.size())
+        {
+            pending.bytes.clear();
+            pending.offset = 0;
+            if (!writeNextStep(stream))
+            {
+                break;
+            }
+            continue; // A step may write nothing, e.g. a route of the other kind
+        }
+
+        size_t chunk = min(maxLen - filled, pending.bytes.size() - pending.offset);
+        memcpy(buffer + filled, pending.bytes.data() + pending.offset, chunk);
+        pending.offset += chunk;
+        filled += chunk;
+    }
+
+    if (filled > 0)
+    {
+        stream.chunks++;
+    }
+    return filled; // 0 ends the response
+}
+
+AsyncWebServerResponse *beginJsonStreamResponse(AsyncWebServerRequest *request, const char *label,
+                                                JsonResponseStep step)
+{
+    // Measured from before anything for this response is allocated
+    uint32_t startFreeHeap = ESP.getFreeHeap();
+    std::shared_ptr<JsonStream> stream = std::make_shared<JsonStream>(label, std::move(step), startFreeHeap);
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "application/json", [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+        { return fillJsonStream(*stream, buffer, maxLen); });
+    response->addHeader("Cache-Control", "no-store");
+    return response;
+}
+
+const JsonStreamStats &getJsonStreamStats()
+{
+    return jsonStreamStats;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file json_stream_response.h
+ * @brief Chunked JSON responses written a step at a time
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Large endpoints (/api/config, /api/diagnostics, /api/nvs-dump, /api/routes,
+ * /api/memos, /api/discovered-printers, /api/print-mqtt/latency) split their
+ * body into steps - a section, an NVS key, a route, a printer, a job - and each
+ * step is written with a JsonStreamWriter only when AsyncWebServer wants the
+ * next chunk. The body never exists in RAM whole: the cost is one step's output
+ * plus the writer's buffer, instead of a JsonDocument and a String copy of it.
+ *
+ * Free heap is sampled around every step, and the drop from where the request
+ * started is reported per response (LOG_VERBOSE) and as a running maximum in
+ * /api/diagnostics.
+ */
+
+#ifndef JSON_STREAM_RESPONSE_H
+#define JSON_STREAM_RESPONSE_H
+
+#include <ESPAsyncWebServer.h>
+#include <utils/json_stream_writer.h>
+#include <functional>
+
+/**
+ * @brief Writes step number `step` (from 0) inside the top-level object
+ * @return false once there are no more steps; nothing may be written then
+ */
+using JsonResponseStep = std::function<bool(JsonStreamWriter &json, int step)>;
+
+struct JsonStreamStats
+{
+    uint32_t responses;     // Streamed responses finished since boot
+    uint32_t peakHeapBytes; // Largest drop in free heap during one of them
+    uint32_t largestBody;   // Longest body sent, in bytes
+};
+
+/**
+ * @brief Start a chunked application/json response built by `step`
+ * @param label Name for the log line, e.g. "GET /api/config" - kept, so a literal
+ * @return Response for the caller to add headers to and send
+ */
+AsyncWebServerResponse *beginJsonStreamResponse(AsyncWebServerRequest *request, const char *label,
+                                                JsonResponseStep step);
+
+const JsonStreamStats &getJsonStreamStats();
+
+#endif // JSON_STREAM_RESPONSE_H
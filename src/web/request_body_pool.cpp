@@ -0,0 +1,123 @@
+/**
+ * @file request_body_pool.cpp
+ * @brief Implementation of the pooled POST body buffers
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ */
+
+#include "request_body_pool.h"
+
+// Shared stand-ins for refused bodies: they hold nothing and are never released
+static RequestBody tooLargeBody = {nullptr, 0, 413, false};
+static RequestBody busyBody = {nullptr, 0, 503, false};
+
+RequestBodyPool::RequestBodyPool()
+{
+    for (RequestBody &body : buffers)
+    {
+        body = {nullptr, 0, 0, false};
+    }
+}
+
+RequestBodyPool::~RequestBodyPool()
+{
+    for (RequestBody &body : buffers)
+    {
+        free(body.data);
+    }
+}
+
+RequestBody *RequestBodyPool::refuse(int status)
+{
+    if (status == 413)
+    {
+        refusedTooLarge++;
+        return &tooLargeBody;
+    }
+    refusedBusy++;
+    return &busyBody;
+}
+
+RequestBody *RequestBodyPool::acquire(size_t declaredLength)
+{
+    if (declaredLength > requestBodyCapacity)
+    {
+        return refuse(413);
+    }
+
+    // A buffer allocated by an earlier request first, so the pool only grows when it has to
+    RequestBody *chosen = nullptr;
+    for (RequestBody &body : buffers)
+    {
+        if (!body.inUse && (!chosen || (body.data && !chosen->data)))
+        {
+            chosen = &body;
+        }
+    }
+    if (!chosen)
+    {
+        return refuse(503);
+    }
+    if (!chosen->data)
+    {
+        chosen->data = (char *)malloc(requestBodyCapacity + 1);
+        if (!chosen->data)
+        {
+            return refuse(503);
+        }
+    }
+
+    chosen->data[0] = '\0';
+    chosen->length = 0;
+    chosen->status = 0;
+    chosen->inUse = true;
+
+    int inUse = getStats().inUse;
+    peakInUse = max(peakInUse, inUse);
+    return chosen;
+}
+
+RequestBody *RequestBodyPool::append(RequestBody *body, const uint8_t *chunk, size_t length, size_t offset)
+{
+    if (!body || body->status != 0)
+    {
+        return body; // Refused - the rest of the body is dropped as it arrives
+    }
+    if (offset > requestBodyCapacity || length > requestBodyCapacity - offset)
+    {
+        // Longer than its Content-Length said
+        release(body);
+        return refuse(413);
+    }
+
+    memcpy(body->data + offset, chunk, length);
+    body->length = max(body->length, offset + length);
+    body->data[body->length] = '\0';
+    return body;
+}
+
+void RequestBodyPool::release(RequestBody *body)
+{
+    if (!body || body == &tooLargeBody || body == &busyBody)
+    {
+        return;
+    }
+    body->inUse = false;
+    body->length = 0;
+    body->status = 0;
+}
+
+RequestBodyPoolStats RequestBodyPool::getStats() const
+{
+    RequestBodyPoolStats stats = {0, peakInUse, refusedTooLarge, refusedBusy};
+    for (const RequestBody &body : buffers)
+    {
+        if (body.inUse)
+        {
+            stats.inUse++;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file request_body_pool.h
+ * @brief Reusable fixed-size buffers for POST bodies
+ * @author Adam Knowles
+ * @date 2025
+ * @copyright Copyright (c) 2025 Adam Knowles. All rights reserved.
+ * @license Creative Commons Attribution-NonCommercial-ShareAlike 4.0 International
+ *
+ * Each POST body is copied into one of requestBodyBufferCount buffers as its
+ * chunks arrive, rather than into a String grown for it and copied again for
+ * the handler. A buffer holds maxJsonPayloadSize bytes, is allocated the first
+ * time it is needed and is kept for the next request, so bodies cause no heap
+ * churn and never use more than the pool between them.
+ *
+ * Bodies declared larger than a buffer are refused before any of them is
+ * stored, as are bodies arriving while every buffer is in use.
+ *
+ * Used from the async_tcp task only - body chunks, handlers and disconnects
+ * all run there - so there is no locking.
+ */
+
+#ifndef REQUEST_BODY_POOL_H
+#define REQUEST_BODY_POOL_H
+
+#include <Arduino.h>
+#include <config/config.h>
+
+struct RequestBody
+{
+    char *data;     // requestBodyCapacity bytes plus a terminating NUL
+    size_t length;  // Bytes received so far
+    int status;     // 0 while usable, else the HTTP status to refuse the request with
+    bool inUse;
+};
+
+struct RequestBodyPoolStats
+{
+    int inUse;
+    int peakInUse;
+    uint32_t refusedTooLarge; // 413s
+    uint32_t refusedBusy;     // 503s - every buffer was in use
+};
+
+static const size_t requestBodyCapacity = maxJsonPayloadSize;
+
+class RequestBodyPool
+{
+public:
+    RequestBodyPool();
+    ~RequestBodyPool();
+
+    /**
+     * @brief Take a buffer for a body of declaredLength bytes
+     * @return An empty buffer, or a shared placeholder whose status says why there isn't one
+     */
+    RequestBody *acquire(size_t declaredLength);
+
+    /**
+     * @brief Copy a chunk in at offset; a body that outgrows its buffer becomes a 413
+     * @return The buffer to use from now on (the placeholder if it was refused)
+     */
+    RequestBody *append(RequestBody *body, const uint8_t *chunk, size_t length, size_t offset);
+
+    /**
+     * @brief Return a buffer for reuse (placeholders and nullptr are ignored)
+     */
+    void release(RequestBody *body);
+
+    RequestBodyPoolStats getStats() const;
+
+private:
+    RequestBody *refuse(int status);
+
+    RequestBody buffers[requestBodyBufferCount];
+    int peakInUse = 0;
+    uint32_t refusedTooLarge = 0;
+    uint32_t refusedBusy = 0;
+};
+
+#endif // REQUEST_BODY_POOL_H
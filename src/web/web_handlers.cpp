@@ -9,6 +9,7 @@
 
 #include "web_handlers.h"
 #include "validation.h"
+#include "asset_index.h"
 #include <config/config.h>
 #include <core/config_utils.h>
 #include <core/logging.h>
@@ -20,10 +21,112 @@
 // External declarations
 extern AsyncWebServer server;
 
+// Assets listed by the build, with their ETags
+static AssetIndex staticAssets;
+
 // ========================================
 // STATIC FILE HANDLERS
 // ========================================
 
+static bool acceptsGzip(AsyncWebServerRequest *request)
+{
+    return request->hasHeader("Accept-Encoding") && request->header("Accept-Encoding").indexOf("gzip") >= 0;
+}
+
+// The .gz, unless there is also a plain copy and the client can't take gzip
+static bool useGzip(AsyncWebServerRequest *request, const AssetEntry &entry)
+{
+    return entry.gzipEtag[0] && (!entry.plainEtag[0] || acceptsGzip(request));
+}
+
+static AsyncWebServerResponse *beginAssetFileResponse(AsyncWebServerRequest *request, const AssetEntry &entry, bool gzip)
+{
+    String storedPath = gzip ? entry.path + ".gz" : entry.path;
+    File file = LittleFS.open(storedPath.c_str(), "r");
+    if (!file)
+    {
+        LOG_WARNING("WEB", "Asset %s is in the manifest but not on the filesystem", storedPath.c_str());
+        return nullptr;
+    }
+    // A .gz file name makes AsyncWebServer add Content-Encoding; the type comes from the URL path
+    return request->beginResponse(file, entry.path);
+}
+
+size_t loadStaticAssetIndex()
+{
+    if (!staticAssets.load(LittleFS, assetManifestPath))
+    {
+        LOG_WARNING("WEB", "No %s - static files served without ETags", assetManifestPath);
+        return 0;
+    }
+    LOG_VERBOSE("WEB", "Asset manifest lists %d files", (int)staticAssets.size());
+    return staticAssets.size();
+}
+
+AsyncWebServerResponse *beginStaticAssetResponse(AsyncWebServerRequest *request, const char *path, const char *cacheControl)
+{
+    const AssetEntry *entry = staticAssets.find(path);
+    if (!entry)
+    {
+        return nullptr;
+    }
+
+    bool gzip = useGzip(request, *entry);
+    const char *etag = gzip ? entry->gzipEtag : entry->plainEtag;
+
+    AsyncWebServerResponse *response;
+    if (request->hasHeader("If-None-Match") && AssetIndex::etagMatches(request->header("If-None-Match").c_str(), etag))
+    {
+        response = request->beginResponse(304); // Browser's copy is current - no filesystem access
+    }
+    else
+    {
+        response = beginAssetFileResponse(request, *entry, gzip);
+        if (!response)
+        {
+            return nullptr;
+        }
+    }
+
+    response->addHeader("ETag", String('"') + etag + '"');
+    response->addHeader("Cache-Control", cacheControl);
+    if (entry->plainEtag[0] && entry->gzipEtag[0])
+    {
+        response->addHeader("Vary", "Accept-Encoding");
+    }
+    return response;
+}
+
+String StaticAssetHandler::getAssetPath(AsyncWebServerRequest *request) const
+{
+    String path = request->url();
+    if (path.endsWith("/"))
+    {
+        path += defaultFile;
+    }
+    return path;
+}
+
+bool StaticAssetHandler::canHandle(AsyncWebServerRequest *request)
+{
+    return request->method() == HTTP_GET && staticAssets.find(getAssetPath(request).c_str());
+}
+
+void StaticAssetHandler::handleRequest(AsyncWebServerRequest *request)
+{
+    String path = getAssetPath(request);
+    AsyncWebServerResponse *response = beginStaticAssetResponse(request, path.c_str(),
+                                                                cacheControl ? cacheControl : AssetIndex::getCacheControl(path.c_str()));
+    if (response)
+    {
+        request->send(response);
+    }
+    else
+    {
+        handleNotFound(request);
+    }
+}
+
 void handleNotFound(AsyncWebServerRequest *request)
 {
     // Rate limit 404 requests to prevent abuse
@@ -72,18 +175,20 @@ void handleNotFound(AsyncWebServerRequest *request)
 
     LOG_WARNING("WEB", "%s", errorDetails.c_str());
 
-    // Serve static 404 page with correct status and headers - let AsyncWebServer handle compression
-    if (LittleFS.exists("/404.html") || LittleFS.exists("/404.html.gz"))
+    // Serve static 404 page with correct status and headers
+    const AssetEntry *page = staticAssets.find("/404.html");
+    AsyncWebServerResponse *resp = page ? beginAssetFileResponse(request, *page, useGzip(request, *page)) : nullptr;
+    if (resp)
     {
-        AsyncWebServerResponse *resp = request->beginResponse(LittleFS, "/404.html", "text/html");
         resp->setCode(404);
         resp->addHeader("Cache-Control", "no-cache");
         request->send(resp);
         return;
     }
-    if (LittleFS.exists("/404.html"))
+    // No manifest - let AsyncWebServer find the .gz
+    if (LittleFS.exists("/404.html") || LittleFS.exists("/404.html.gz"))
     {
-        AsyncWebServerResponse *resp = request->beginResponse(LittleFS, "/404.html", "text/html");
+        resp = request->beginResponse(LittleFS, "/404.html", "text/html");
         resp->setCode(404);
         resp->addHeader("Cache-Control", "no-cache");
         request->send(resp);
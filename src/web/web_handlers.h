@@ -22,6 +22,43 @@
  */
 void handleNotFound(AsyncWebServerRequest *request);
 
+/**
+ * @brief Read the asset manifest into RAM (call before adding routes)
+ * @return Number of assets listed; 0 if the filesystem image has no manifest
+ */
+size_t loadStaticAssetIndex();
+
+/**
+ * @brief Response for a listed asset: 304 if If-None-Match names its ETag, otherwise the stored file
+ * @param path URL path, e.g. "/index.html"
+ * @return nullptr if the asset isn't listed or its file is missing
+ */
+AsyncWebServerResponse *beginStaticAssetResponse(AsyncWebServerRequest *request, const char *path, const char *cacheControl);
+
+/**
+ * @brief Serves GET requests for assets listed in the manifest, ahead of serveStatic()
+ * Unlisted paths fall through to the next handler.
+ */
+class StaticAssetHandler : public AsyncWebHandler
+{
+public:
+    /**
+     * @param defaultFile Appended to paths ending in '/'
+     * @param cacheControl Same for every asset, or nullptr for AssetIndex::getCacheControl() per path
+     */
+    StaticAssetHandler(const char *defaultFile, const char *cacheControl = nullptr)
+        : defaultFile(defaultFile), cacheControl(cacheControl) {}
+
+    bool canHandle(AsyncWebServerRequest *request) override;
+    void handleRequest(AsyncWebServerRequest *request) override;
+
+private:
+    String getAssetPath(AsyncWebServerRequest *request) const;
+
+    const char *defaultFile;
+    const char *cacheControl;
+};
+
 // ========================================
 // UTILITY FUNCTIONS
 // ========================================
@@ -23,6 +23,7 @@
 #include "api_handlers.h"
 #include "api_system_handlers.h"
 #include "api_nvs_handlers.h"
+#include "api_log_handlers.h"
 #include "api_config_handlers.h"
 #include "api_memo_handlers.h"
 #if ENABLE_LEDS
@@ -34,6 +35,7 @@
 #include <config/config.h>
 #include <core/logging.h>
 #include <core/network.h>
+#include <core/config_loader.h>
 #include <core/printer_discovery.h>
 #include <vector>
 #include <ESPAsyncWebServer.h>
@@ -58,46 +60,87 @@ void handleCaptivePortal(AsyncWebServerRequest *request)
     request->redirect("/setup.html");
 }
 
-// Helper functions for POST body handling using request's built-in storage
-void storeRequestBody(AsyncWebServerRequest *request, const String &body)
+// ========================================
+// POST BODIES (pooled buffers)
+// ========================================
+
+static RequestBodyPool requestBodyPool;
+
+// Kept in _tempObject from the body's first chunk until the connection closes
+static RequestBody *getRequestBodyBuffer(AsyncWebServerRequest *request)
 {
-    // Use the request's built-in _tempObject to store the body
-    // This automatically cleans up when the request is destroyed
-    request->_tempObject = new String(body);
+    return static_cast<RequestBody *>(request->_tempObject);
 }
 
 String getRequestBody(AsyncWebServerRequest *request)
 {
-    if (request->_tempObject)
+    const RequestBody *body = getRequestBodyBuffer(request);
+    if (!body || body->status != 0)
+    {
+        return "";
+    }
+    return String(body->data);
+}
+
+DeserializationError deserializeRequestBody(AsyncWebServerRequest *request, JsonDocument &doc)
+{
+    RequestBody *body = getRequestBodyBuffer(request);
+    if (!body || body->status != 0 || body->length == 0)
     {
-        String *bodyPtr = static_cast<String *>(request->_tempObject);
-        String body = *bodyPtr;
-        delete bodyPtr; // Clean up the allocated memory
-        request->_tempObject = nullptr;
-        return body;
+        return DeserializationError::EmptyInput;
     }
-    return "";
+    // Non-const char* - ArduinoJson's zero-copy mode, so strings in doc point into the buffer
+    return deserializeJson(doc, body->data, body->length);
+}
+
+RequestBodyPoolStats getRequestBodyPoolStats()
+{
+    return requestBodyPool.getStats();
 }
 
 // Helper function for chunked upload handling (DRY principle)
 void handleChunkedUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
 {
-    String *bodyPtr = static_cast<String *>(request->_tempObject);
     if (index == 0)
     {
-        // First chunk - create new string
-        if (bodyPtr)
-            delete bodyPtr;
-        bodyPtr = new String();
-        request->_tempObject = bodyPtr;
-        bodyPtr->reserve(total); // Reserve space for entire body
+        RequestBody *body = requestBodyPool.acquire(total);
+        request->_tempObject = body;
+
+        // Every request ends here, after its handler and response, or early if the client goes away.
+        // _tempObject is cleared too - AsyncWebServer would free() it otherwise.
+        request->onDisconnect([request]()
+                              {
+            requestBodyPool.release(getRequestBodyBuffer(request));
+            request->_tempObject = nullptr; });
+
+        if (body->status != 0)
+        {
+            LOG_WARNING("WEB", "Refusing %u-byte body for %s with %d", (unsigned)total, request->url().c_str(), body->status);
+        }
     }
 
-    // Append this chunk
-    for (size_t i = 0; i < len; i++)
+    request->_tempObject = requestBodyPool.append(getRequestBodyBuffer(request), data, len, index);
+}
+
+// onRequest for routes that take a body: one refused while arriving is answered here, not by the handler
+static ArRequestHandlerFunction withRequestBody(ArRequestHandlerFunction handler)
+{
+    return [handler](AsyncWebServerRequest *request)
     {
-        *bodyPtr += (char)data[i];
-    }
+        const RequestBody *body = getRequestBodyBuffer(request);
+        if (body && body->status == 413)
+        {
+            sendErrorResponse(request, 413, "Request body too large (max " + String(maxJsonPayloadSize / 1024) + "KB)");
+        }
+        else if (body && body->status != 0)
+        {
+            sendErrorResponse(request, 503, "Too many requests in progress - try again");
+        }
+        else
+        {
+            handler(request);
+        }
+    };
 }
 
 // ========================================
@@ -125,34 +168,60 @@ void registerRoute(const char *method, const char *path, const char *description
     LOG_VERBOSE("WEB", "Registered route: %s %s - %s", method, path, description);
 }
 
-void addRegisteredRoutesToJson(JsonObject &endpoints)
+bool writeRegisteredRoute(JsonStreamWriter &json, int step)
 {
-    JsonArray webPages = endpoints.createNestedArray("web_pages");
-    JsonArray apiEndpoints = endpoints.createNestedArray("api_endpoints");
-
-    for (const auto &route : registeredRoutes)
+    // Two passes over the registry: [0] opens web_pages, [1..n] pages, [n+1] switches to api_endpoints,
+    // [n+2..2n+1] endpoints, [2n+2] closes
+    int count = (int)registeredRoutes.size();
+    if (step == 0)
     {
-        if (route.isAPI)
+        json.beginArray("web_pages");
+    }
+    else if (step <= count)
+    {
+        const RouteInfo &route = registeredRoutes[step - 1];
+        if (!route.isAPI)
         {
-            JsonObject api = apiEndpoints.createNestedObject();
-            api["method"] = route.method;
-            api["path"] = route.path;
-            api["description"] = route.description;
+            json.beginObject();
+            json.field("path", route.path);
+            json.field("description", route.description);
+            json.endObject();
         }
-        else
+    }
+    else if (step == count + 1)
+    {
+        json.endArray();
+        json.beginArray("api_endpoints");
+    }
+    else if (step <= 2 * count + 1)
+    {
+        const RouteInfo &route = registeredRoutes[step - count - 2];
+        if (route.isAPI)
         {
-            JsonObject page = webPages.createNestedObject();
-            page["path"] = route.path;
-            page["description"] = route.description;
+            json.beginObject();
+            json.field("method", route.method);
+            json.field("path", route.path);
+            json.field("description", route.description);
+            json.endObject();
         }
     }
+    else if (step == 2 * count + 2)
+    {
+        json.endArray();
+    }
+    else
+    {
+        return false;
+    }
+    return true;
 }
 
 static void setupStaticFileServing(bool isAP)
 {
     if (isAP)
     {
-        // AP mode - serve files for captive portal
+        // AP mode - serve files for captive portal (listed assets from the RAM index, with ETags)
+        server.addHandler(new StaticAssetHandler("setup.html", "no-cache"));
         server.serveStatic("/", LittleFS, "/")
             .setDefaultFile("setup.html")
             .setCacheControl("no-cache");
@@ -164,15 +233,17 @@ static void setupStaticFileServing(bool isAP)
             IPAddress clientIP = request->client()->remoteIP();
             String sessionToken = createSession(clientIP);
 
-            // Let AsyncWebServer handle compression automatically
-            if (!LittleFS.exists("/index.html") && !LittleFS.exists("/index.html.gz")) {
-                request->send(404, "text/plain", "index.html not found");
-                return;
+            // Build response so we can add Set-Cookie - from the asset index (304 if unchanged) when
+            // the filesystem has a manifest, else let AsyncWebServer find the .gz
+            AsyncWebServerResponse* response = beginStaticAssetResponse(request, "/index.html", assetCacheHtml);
+            if (!response) {
+                if (!LittleFS.exists("/index.html") && !LittleFS.exists("/index.html.gz")) {
+                    request->send(404, "text/plain", "index.html not found");
+                    return;
+                }
+                response = request->beginResponse(LittleFS, "/index.html", "text/html");
             }
 
-            // Build response so we can add Set-Cookie - AsyncWebServer will find .gz automatically
-            AsyncWebServerResponse* response = request->beginResponse(LittleFS, "/index.html", "text/html");
-
             if (sessionToken.length() > 0) {
                 String sessionCookie = getSessionCookieValue(sessionToken);
                 if (sessionCookie.length() > 0) {
@@ -190,10 +261,12 @@ static void setupStaticFileServing(bool isAP)
             request->send(response);
         });
 
-        // Serve all other static files with compression (no session needed)
+        // Serve all other static files with compression (no session needed) - listed assets from
+        // the RAM index with ETags (hashed bundles immutable, HTML revalidated), anything else through serveStatic
+        server.addHandler(new StaticAssetHandler("index.html"));
         server.serveStatic("/", LittleFS, "/")
             .setDefaultFile("index.html")
-            .setCacheControl("max-age=31536000");
+            .setCacheControl(assetCacheDefault);
     }
 }
 
@@ -205,6 +278,9 @@ void setupWebServerRoutes(int maxChars)
     // Initialize authentication system
     initAuthSystem();
 
+    // Asset manifest from the filesystem image, so static requests don't probe LittleFS
+    loadStaticAssetIndex();
+
     LOG_NOTICE("WEB", "Setting up %s mode routes", isAP ? "AP (captive portal)" : "STA (full web interface)");
 
     if (isAP)
@@ -227,11 +303,11 @@ void setupAPModeRoutes()
 
     // Setup API endpoints
     server.on("/api/setup", HTTP_GET, handleSetupGet);
-    server.on("/api/setup", HTTP_POST, [](AsyncWebServerRequest *request)
-              { handleSetupPost(request); }, NULL, handleChunkedUpload);
+    server.on("/api/setup", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request)
+              { handleSetupPost(request); }), NULL, handleChunkedUpload);
     server.on("/api/wifi-scan", HTTP_GET, handleWiFiScan);
-    server.on("/api/test-wifi", HTTP_POST, [](AsyncWebServerRequest *request)
-              { handleTestWiFi(request); }, NULL, handleChunkedUpload);
+    server.on("/api/test-wifi", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request)
+              { handleTestWiFi(request); }), NULL, handleChunkedUpload);
 
     // Captive portal detection - redirect to setup
     const char *captiveUrls[] = {"/hotspot-detect.html", "/generate_204", "/connectivity-check.html", "/ncsi.txt"};
@@ -295,9 +371,9 @@ void setupAPIRoutes()
         authenticatedHandler(request, handlePrintLocal);
     });
     registerRoute("GET", "/api/print-local", "Print custom message");
-    server.on("/api/print-local", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/print-local", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handlePrintLocal);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/print-local", "Print custom message");
 
     // Content generation (with authentication)
@@ -339,17 +415,17 @@ void setupAPIRoutes()
         authenticatedHandler(request, handleMemoGet);
     });
     registerRoute("GET", "/api/memo/{id}", "Get processed memo content");
-    server.on("^\\/api\\/memo\\/([1-4])$", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("^\\/api\\/memo\\/([1-4])$", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleMemoUpdate);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/memo/{id}", "Update specific memo");
     server.on("/api/memos", HTTP_GET, [](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleMemosGet);
     });
     registerRoute("GET", "/api/memos", "Get all memos");
-    server.on("/api/memos", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/memos", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleMemosPost);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/memos", "Update all memos");
 
     // System endpoints
@@ -357,6 +433,14 @@ void setupAPIRoutes()
         authenticatedHandler(request, handleDiagnostics);
     });
     registerRoute("GET", "/api/diagnostics", "System diagnostics");
+    server.on("/api/previous-boot-log", HTTP_GET, [](AsyncWebServerRequest *request) {
+        authenticatedHandler(request, handlePreviousBootLog);
+    });
+    registerRoute("GET", "/api/previous-boot-log", "Log lines from before the last reset");
+    server.on("/api/logs", HTTP_GET, [](AsyncWebServerRequest *request) {
+        authenticatedHandler(request, handleLogs);
+    });
+    registerRoute("GET", "/api/logs", "Recent and file log lines (NDJSON, filterable)");
     server.on("/api/routes", HTTP_GET, [](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleRoutes);
     });
@@ -369,9 +453,9 @@ void setupAPIRoutes()
         authenticatedHandler(request, handleConfigGet);
     });
     registerRoute("GET", "/api/config", "Get configuration");
-    server.on("/api/config", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/config", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleConfigPost);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/config", "Update configuration");
     server.on("/api/wifi-scan", HTTP_GET, [](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleWiFiScan);
@@ -379,49 +463,63 @@ void setupAPIRoutes()
     registerRoute("GET", "/api/wifi-scan", "Scan WiFi networks");
 
     // MQTT endpoints
-    server.on("/api/print-mqtt", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/print-mqtt", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handlePrintMQTT);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/print-mqtt", "Send MQTT message");
-    server.on("/api/test-mqtt", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/print-mqtt/latency", HTTP_GET, [](AsyncWebServerRequest *request) {
+        authenticatedHandler(request, handlePrintMQTTLatency);
+    });
+    registerRoute("GET", "/api/print-mqtt/latency", "Remote print delivery latency");
+    server.on("/api/discovered-printers", HTTP_GET, [](AsyncWebServerRequest *request) {
+        authenticatedHandler(request, handleDiscoveredPrinters);
+    });
+    registerRoute("GET", "/api/discovered-printers", "Discovered printer snapshot (SSE resync)");
+
+    // Printer-to-printer LAN print: signed with the shared peer key instead of a session
+    server.on(peerPrintPath, HTTP_POST, withRequestBody(handlePeerPrintRequest), NULL, handleChunkedUpload);
+    registerRoute("POST", peerPrintPath, "Direct LAN print from another printer");
+    server.on("/api/test-mqtt", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleTestMQTT);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/test-mqtt", "Test MQTT connection");
 
     // ChatGPT test endpoint
-    server.on("/api/test-chatgpt", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/test-chatgpt", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleTestChatGPT);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/test-chatgpt", "Test ChatGPT API token");
 
 
 #if ENABLE_LEDS
-    server.on("/api/leds/test", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/leds/test", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleLedEffect);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/leds/test", "Trigger LED Effect");
-    server.on("/api/leds/off", HTTP_POST, [](AsyncWebServerRequest *request) {
+    server.on("/api/leds/off", HTTP_POST, withRequestBody([](AsyncWebServerRequest *request) {
         authenticatedHandler(request, handleLedOff);
-    }, NULL, handleChunkedUpload);
+    }), NULL, handleChunkedUpload);
     registerRoute("POST", "/api/leds/off", "Turn LEDs Off");
 #endif
 
     // Debug endpoint to list LittleFS contents (only in STA mode)
     server.on("/debug/filesystem", HTTP_GET, [](AsyncWebServerRequest *request)
               {
-        String output = "LittleFS Debug:\n\nTotal space: " + String(LittleFS.totalBytes()) + " bytes\n";
-        output += "Used space: " + String(LittleFS.usedBytes()) + " bytes\n";
-        output += "Free space: " + String(LittleFS.totalBytes() - LittleFS.usedBytes()) + " bytes\n\n";
-        output += "Files:\n";
+        // Printed straight into the response stream rather than built up in a String first
+        AsyncResponseStream *response = request->beginResponseStream("text/plain");
+        response->printf("LittleFS Debug:\n\nTotal space: %u bytes\n", (unsigned)LittleFS.totalBytes());
+        response->printf("Used space: %u bytes\n", (unsigned)LittleFS.usedBytes());
+        response->printf("Free space: %u bytes\n\n", (unsigned)(LittleFS.totalBytes() - LittleFS.usedBytes()));
+        response->print("Files:\n");
         
         File root = LittleFS.open("/");
         if (!root || !root.isDirectory()) {
-            output += "Failed to open root directory\n";
+            response->print("Failed to open root directory\n");
         } else {
-            listDirectory(root, output, 0);
+            listDirectory(root, *response, 0);
         }
         
-        request->send(200, "text/plain", output); });
+        request->send(response); });
     registerRoute("GET", "/debug/filesystem", "LittleFS debug info");
 }
 
@@ -458,7 +556,7 @@ void setupStaticAssets()
 }
 
 // Helper function to recursively list directory contents
-void listDirectory(File dir, String &output, int level)
+void listDirectory(File dir, Print &output, int level)
 {
     while (true)
     {
@@ -471,56 +569,157 @@ void listDirectory(File dir, String &output, int level)
         // Add indentation
         for (int i = 0; i < level; i++)
         {
-            output += "  ";
+            output.print("  ");
         }
 
         if (entry.isDirectory())
         {
-            output += "[DIR] " + String(entry.name()) + "/\n";
+            output.printf("[DIR] %s/\n", entry.name());
             listDirectory(entry, output, level + 1);
         }
         else
         {
-            output += "[FILE] " + String(entry.name()) + " (" + String(entry.size()) + " bytes)\n";
+            output.printf("[FILE] %s (%u bytes)\n", entry.name(), (unsigned)entry.size());
         }
         entry.close();
     }
 }
 
-// Simple, robust real-time updates via smart polling
-static String lastPrinterListHash = "";
+// Table version last pushed to SSE clients - deltas are built from here
+static uint32_t lastBroadcastPrinterVersion = 0;
 
-// Helper function to get printer JSON data for SSE
-String getDiscoveredPrintersJson()
+static void writePrinter(JsonStreamWriter &json, const DiscoveredPrinter &printer)
+{
+    json.beginObject();
+    json.field("printer_id", printer.printerId);
+    json.field("name", printer.name);
+    json.field("firmware_version", printer.firmwareVersion);
+    json.field("mdns", printer.mdns);
+    json.field("ip_address", printer.ipAddress);
+    json.field("status", "online");
+    json.field("last_power_on", printer.lastPowerOn);
+    json.field("timezone", printer.timezone);
+    json.field("groups", printer.groups);
+    json.field("queue_depth", (int)printer.queueDepth);
+    json.endObject();
+}
+
+bool writeDiscoveredPrintersStep(JsonStreamWriter &json, const DiscoveredPrinterTable &printers, int step)
 {
-    DynamicJsonDocument doc(2048);
-    JsonArray printersArray = doc.createNestedArray("discovered_printers");
+    if (step > printers.size())
+    {
+        return false;
+    }
 
-    std::vector<DiscoveredPrinter> discovered = getDiscoveredPrinters();
-    for (const auto &printer : discovered)
+    if (step == 0)
+    {
+        json.beginArray("discovered_printers");
+    }
+    if (step < printers.size())
     {
-        if (printer.status == "online")
+        if (printers[step].online)
         {
-            JsonObject printerObj = printersArray.createNestedObject();
-            printerObj["printer_id"] = printer.printerId;
-            printerObj["name"] = printer.name;
-            printerObj["firmware_version"] = printer.firmwareVersion;
-            printerObj["mdns"] = printer.mdns;
-            printerObj["ip_address"] = printer.ipAddress;
-            printerObj["status"] = printer.status;
-            printerObj["last_power_on"] = printer.lastPowerOn;
-            printerObj["timezone"] = printer.timezone;
+            writePrinter(json, printers[step]);
         }
+        return true;
+    }
+    json.endArray();
+
+    int online = 0;
+    for (const DiscoveredPrinter &printer : printers)
+    {
+        online += printer.online ? 1 : 0;
     }
+    json.field("count", online);
+    json.field("our_printer_id", getPrinterId());
+    json.field("discovery_scope", getRuntimeConfig().mqttDiscoveryScope); // Empty when unscoped
+    json.field("version", printers.getVersion());
+    return true;
+}
+
+// SSE events go out as one string, so their JSON is written straight into it
+class StringPrint : public Print
+{
+public:
+    explicit StringPrint(String &text) : text(text) {}
 
-    doc["count"] = printersArray.size();
-    doc["our_printer_id"] = getPrinterId();
+    size_t write(uint8_t c) override
+    {
+        text += (char)c;
+        return 1;
+    }
+
+    String &text;
+};
 
+// Built from a copy of the table: SSE connects run on the web server's task
+static String buildDiscoveredPrintersJson(const DiscoveredPrinterTable &printers)
+{
     String response;
-    serializeJson(doc, response);
+    StringPrint out(response);
+    JsonStreamWriter json(out);
+    json.beginObject();
+    for (int step = 0; writeDiscoveredPrintersStep(json, printers, step); step++)
+    {
+    }
+    json.endObject();
+    json.flush();
     return response;
 }
 
+static String buildDiscoveredPrintersDeltaJson(const DiscoveredPrinterTable &printers, uint32_t sinceVersion)
+{
+    String response;
+    StringPrint out(response);
+    JsonStreamWriter json(out);
+    json.beginObject();
+    json.field("from_version", sinceVersion);
+    json.field("version", printers.getVersion());
+
+    json.beginArray("printers");
+    for (const DiscoveredPrinter &printer : printers)
+    {
+        if (printer.version > sinceVersion && printer.online)
+        {
+            writePrinter(json, printer);
+        }
+    }
+    json.endArray();
+
+    json.beginArray("removed");
+    for (const DiscoveredPrinter &printer : printers)
+    {
+        if (printer.version > sinceVersion && !printer.online)
+        {
+            json.value(printer.printerId);
+        }
+    }
+    for (int i = 0; i < printers.getTombstoneCount(); i++)
+    {
+        const DiscoveredPrinterTombstone &tombstone = printers.getTombstone(i);
+        if (tombstone.version > sinceVersion)
+        {
+            json.value(tombstone.printerId);
+        }
+    }
+    json.endArray();
+
+    json.endObject();
+    json.flush();
+    return response;
+}
+
+// Helper function to get printer JSON data for SSE
+String getDiscoveredPrintersJson()
+{
+    return buildDiscoveredPrintersJson(*copyDiscoveredPrinters());
+}
+
+String getDiscoveredPrintersDeltaJson(uint32_t sinceVersion)
+{
+    return buildDiscoveredPrintersDeltaJson(*copyDiscoveredPrinters(), sinceVersion);
+}
+
 // Removed handlePrinterUpdates (unused)
 
 // ========================================
@@ -529,12 +728,36 @@ String getDiscoveredPrintersJson()
 
 void sendPrinterUpdate()
 {
+    // Nothing changed since the last push - checked before paying for a copy
+    if (getDiscoveredPrintersVersion() == lastBroadcastPrinterVersion)
+    {
+        return;
+    }
+
+    // Also called from a config save on the web server's task, so it works on a copy
+    std::unique_ptr<DiscoveredPrinterTable> printers = copyDiscoveredPrinters();
+    uint32_t version = printers->getVersion();
+
     if (sseEvents.count() > 0) // Only send if there are connected clients
     {
-        String printerData = getDiscoveredPrintersJson();
-        sseEvents.send(printerData.c_str(), "printer-update", millis());
-        LOG_VERBOSE("WEB", "Sent SSE printer update to %d clients", sseEvents.count());
+        if (printers->canDeltaFrom(lastBroadcastPrinterVersion))
+        {
+            String delta = buildDiscoveredPrintersDeltaJson(*printers, lastBroadcastPrinterVersion);
+            sseEvents.send(delta.c_str(), "printer-delta", millis());
+            LOG_VERBOSE("WEB", "Sent SSE printer delta v%lu->v%lu to %d clients",
+                        (unsigned long)lastBroadcastPrinterVersion, (unsigned long)version, sseEvents.count());
+        }
+        else
+        {
+            // Removals since the last push are no longer known - resend everything
+            String printerData = buildDiscoveredPrintersJson(*printers);
+            sseEvents.send(printerData.c_str(), "printer-update", millis());
+            LOG_VERBOSE("WEB", "Sent SSE printer snapshot v%lu to %d clients", (unsigned long)version, sseEvents.count());
+        }
     }
+
+    // Clients that connect later get a snapshot, so skipped versions need no delta
+    lastBroadcastPrinterVersion = version;
 }
 
 void sendSystemStatus(const String &status, const String &message)
@@ -24,6 +24,10 @@
 #include <ESPAsyncWebServer.h>
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include <utils/json_stream_writer.h>
+#include "request_body_pool.h"
+
+class DiscoveredPrinterTable;
 
 // External declarations
 extern AsyncEventSource sseEvents;
@@ -37,10 +41,23 @@ void setupWebServerRoutes(int maxChars);
 /**
  * @brief Get stored request body for POST requests
  * @param request The request to get the body for
- * @return The stored request body, or empty string if none
+ * @return A copy of the stored request body, or empty string if none
  */
 String getRequestBody(AsyncWebServerRequest *request);
 
+/**
+ * @brief Parse a POST body straight from its pooled buffer, without copying it first
+ * Strings in doc point into the buffer (ArduinoJson zero-copy), so doc must not outlive
+ * the request, and the body can't be read as text afterwards.
+ * @return DeserializationError::EmptyInput if there is no body
+ */
+DeserializationError deserializeRequestBody(AsyncWebServerRequest *request, JsonDocument &doc);
+
+/**
+ * @brief Use of the pooled POST body buffers, for diagnostics
+ */
+RequestBodyPoolStats getRequestBodyPoolStats();
+
 /**
  * @brief Register a route for documentation purposes
  * @param method HTTP method (GET, POST, etc.)
@@ -51,10 +68,12 @@ String getRequestBody(AsyncWebServerRequest *request);
 void registerRoute(const char* method, const char* path, const char* description, bool isAPI = true);
 
 /**
- * @brief Get registered routes as JSON for diagnostics
- * @return JSON object containing all registered web pages and API endpoints
+ * @brief Write one step of the registered routes for /api/routes
+ * Steps cover a "web_pages" array then an "api_endpoints" array, a route per step.
+ * @param step Step number from 0 (see beginJsonStreamResponse)
+ * @return false once every route has been written
  */
-void addRegisteredRoutesToJson(JsonObject &endpoints);
+bool writeRegisteredRoute(JsonStreamWriter &json, int step);
 
 /**
  * @brief Setup AP mode routes (captive portal)
@@ -76,12 +95,29 @@ void setupAPIRoutes();
  */
 void setupStaticAssets();
 
+/**
+ * @brief Write one step of the discovered printers for /api/discovered-printers
+ * Steps cover a "discovered_printers" array, a table entry per step (offline
+ * ones write nothing), then "count", "our_printer_id", "discovery_scope" and "version".
+ * @param printers Copy of the table, taken once for the whole response
+ * @param step Step number from 0 (see beginJsonStreamResponse)
+ * @return false once every step has been written
+ */
+bool writeDiscoveredPrintersStep(JsonStreamWriter &json, const DiscoveredPrinterTable &printers, int step);
+
 /**
  * @brief Get JSON data for discovered printers (includes self via MQTT)
  * @return JSON string containing discovered printers
  */
 String getDiscoveredPrintersJson();
 
+/**
+ * @brief Get JSON for printers changed or removed since a table version
+ * @param sinceVersion Version the receiver already has
+ * @return JSON with "from_version", "version", changed "printers" and "removed" IDs
+ */
+String getDiscoveredPrintersDeltaJson(uint32_t sinceVersion);
+
 // Removed: handlePrinterUpdates (no longer used)
 
 /**
@@ -91,6 +127,8 @@ void handleCaptivePortal(AsyncWebServerRequest *request);
 
 /**
  * @brief Helper function for handling chunked uploads (DRY principle)
+ * Copies each chunk into a pooled buffer; bodies over maxJsonPayloadSize, or arriving
+ * while every buffer is busy, are dropped and answered 413/503 instead of the handler.
  */
 void handleChunkedUpload(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
@@ -103,10 +141,10 @@ void handleChunkedUpload(AsyncWebServerRequest *request, uint8_t *data, size_t l
 /**
  * @brief Helper function to recursively list directory contents for debugging
  * @param dir Directory file handle
- * @param output String to append directory listing to
+ * @param output Where to print the listing, e.g. an AsyncResponseStream
  * @param level Indentation level for nested directories
  */
-void listDirectory(File dir, String &output, int level);
+void listDirectory(File dir, Print &output, int level);
 
 // ========================================
 // SSE (Server-Sent Events) Functions
@@ -114,7 +152,8 @@ void listDirectory(File dir, String &output, int level);
 
 /**
  * @brief Send real-time printer discovery updates via SSE
- * Notifies all connected clients when printer status changes
+ * Pushes a "printer-delta" event with entries changed since the last push,
+ * or a full "printer-update" snapshot if the delta can't be built
  */
 void sendPrinterUpdate();
 
@@ -0,0 +1,106 @@
+/**
+ * @file test_asset_index.cpp
+ * @brief Unit tests for the static asset manifest index
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../src/web/asset_index.h"
+
+static const char *testManifestPath = "/test_assets.manifest";
+
+void test_asset_index_parses_lines()
+{
+    AssetIndex index;
+    TEST_ASSERT_TRUE(index.addLine("- 0123456789abcdef /index.html"));
+    TEST_ASSERT_TRUE(index.addLine("fedcba9876543210 0011223344556677 /css/app.css\r\n"));
+    TEST_ASSERT_TRUE(index.addLine("aaaaaaaaaaaaaaaa - /favicon.ico"));
+
+    // Malformed: no path, short ETag, neither form stored, relative path
+    TEST_ASSERT_FALSE(index.addLine("- 0123456789abcdef"));
+    TEST_ASSERT_FALSE(index.addLine("- 0123 /short.html"));
+    TEST_ASSERT_FALSE(index.addLine("- - /nothing.html"));
+    TEST_ASSERT_FALSE(index.addLine("- 0123456789abcdef index.html"));
+    TEST_ASSERT_EQUAL(3, index.size());
+
+    const AssetEntry *css = index.find("/css/app.css");
+    TEST_ASSERT_NOT_NULL(css);
+    TEST_ASSERT_EQUAL_STRING("fedcba9876543210", css->plainEtag);
+    TEST_ASSERT_EQUAL_STRING("0011223344556677", css->gzipEtag);
+
+    const AssetEntry *page = index.find("/index.html");
+    TEST_ASSERT_NOT_NULL(page);
+    TEST_ASSERT_EQUAL_STRING("", page->plainEtag);
+
+    TEST_ASSERT_NULL(index.find("/missing.js"));
+    TEST_ASSERT_NULL(index.find("/index.htm"));
+}
+
+void test_asset_index_later_line_wins()
+{
+    AssetIndex index;
+    index.addLine("- 0000000000000000 /app.js");
+    index.addLine("- 1111111111111111 /app.js");
+    TEST_ASSERT_EQUAL(1, index.size());
+    TEST_ASSERT_EQUAL_STRING("1111111111111111", index.find("/app.js")->gzipEtag);
+}
+
+void test_asset_index_loads_manifest()
+{
+    File file = LittleFS.open(testManifestPath, "w");
+    const char *manifest = "- 0123456789abcdef /index.html\n"
+                           "not a manifest line\n"
+                           "aaaaaaaaaaaaaaaa - /fonts/outfit-variable.woff2";
+    file.write((const uint8_t *)manifest, strlen(manifest));
+    file.close();
+
+    AssetIndex index;
+    TEST_ASSERT_TRUE(index.load(LittleFS, testManifestPath));
+    TEST_ASSERT_EQUAL(2, index.size());
+    TEST_ASSERT_NOT_NULL(index.find("/fonts/outfit-variable.woff2")); // Last line has no newline
+    LittleFS.remove(testManifestPath);
+
+    TEST_ASSERT_FALSE(index.load(LittleFS, testManifestPath));
+    TEST_ASSERT_EQUAL(0, index.size());
+}
+
+void test_asset_index_matches_if_none_match()
+{
+    const char *etag = "0123456789abcdef";
+    TEST_ASSERT_TRUE(AssetIndex::etagMatches("\"0123456789abcdef\"", etag));
+    TEST_ASSERT_TRUE(AssetIndex::etagMatches("W/\"0123456789abcdef\"", etag));
+    TEST_ASSERT_TRUE(AssetIndex::etagMatches("\"ffffffffffffffff\", \"0123456789abcdef\"", etag));
+    TEST_ASSERT_TRUE(AssetIndex::etagMatches("*", etag));
+
+    TEST_ASSERT_FALSE(AssetIndex::etagMatches("\"0123456789abcde\"", etag));
+    TEST_ASSERT_FALSE(AssetIndex::etagMatches("\"0123456789abcdef0\"", etag));
+    TEST_ASSERT_FALSE(AssetIndex::etagMatches("\"*\"", etag));
+    TEST_ASSERT_FALSE(AssetIndex::etagMatches("", etag));
+    TEST_ASSERT_FALSE(AssetIndex::etagMatches("\"0123456789abcdef\"", "")); // Form not stored
+}
+
+void test_asset_index_cache_policy()
+{
+    TEST_ASSERT_TRUE(AssetIndex::isFingerprinted("/js/app-common.1a2b3c4d.js"));
+    TEST_ASSERT_TRUE(AssetIndex::isFingerprinted("/css/app.0123abcd.css"));
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/js/app-common.js"));
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/js/.1a2b3c4d.js"));      // No name before the hash
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/js/app.1a2b3c4.js"));    // Hash too short
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/js/app.1a2b3c4dz.js"));  // Not all hex / too long
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/images/x1a2b3c4d.svg")); // No dot before the hash
+    TEST_ASSERT_FALSE(AssetIndex::isFingerprinted("/a.js"));
+
+    TEST_ASSERT_EQUAL_STRING(assetCacheFingerprinted, AssetIndex::getCacheControl("/js/page-index.1a2b3c4d.js"));
+    TEST_ASSERT_EQUAL_STRING(assetCacheHtml, AssetIndex::getCacheControl("/settings/mqtt.html"));
+    TEST_ASSERT_EQUAL_STRING(assetCacheDefault, AssetIndex::getCacheControl("/images/scribe_magic.svg"));
+}
+
+void run_asset_index_tests()
+{
+    RUN_TEST(test_asset_index_parses_lines);
+    RUN_TEST(test_asset_index_later_line_wins);
+    RUN_TEST(test_asset_index_loads_manifest);
+    RUN_TEST(test_asset_index_matches_if_none_match);
+    RUN_TEST(test_asset_index_cache_policy);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_crash_log.cpp
+ * @brief Unit tests for the reset-surviving log ring
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/crash_log.h"
+
+static CrashLogStorage crashStorage; // Stands in for the no-init RAM
+static const uint8_t firmwareA[crashLogFirmwareIdBytes] = {1, 2, 3, 4, 5, 6, 7, 8};
+static const uint8_t firmwareB[crashLogFirmwareIdBytes] = {8, 7, 6, 5, 4, 3, 2, 1};
+
+static void addLine(CrashLog &log, const char *component, int level, uint32_t timestampMs, const char *format, ...)
+{
+    alignas(LogRecord) uint8_t scratch[sizeof(LogRecord) + logRecordMaxArgBytes];
+    LogRecord *record = reinterpret_cast<LogRecord *>(scratch);
+    va_list args;
+    va_start(args, format);
+    buildLogRecord(record, 0, level, timestampMs, format, args);
+    va_end(args);
+    log.add(component, *record);
+}
+
+static const char *previousText(const CrashLog &log, int index)
+{
+    static char text[logMessageMaxLength];
+    log.formatPrevious(index, text, sizeof(text));
+    return text;
+}
+
+void test_crash_log_keeps_previous_boot()
+{
+    memset(&crashStorage, 0xA5, sizeof(crashStorage)); // Power-on garbage
+
+    CrashLog firstBoot;
+    firstBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(0, firstBoot.getPreviousCount());
+    addLine(firstBoot, "MQTT", LOG_LEVEL_NOTICE, 1000, "Connected to %s:%d", "broker", 1883);
+    addLine(firstBoot, "WEB", LOG_LEVEL_ERROR, 2000, "Heap low: %u bytes", 4096u);
+
+    // Watchdog reset: same storage, same build
+    CrashLog secondBoot;
+    secondBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(2, secondBoot.getPreviousCount());
+    TEST_ASSERT_EQUAL_STRING("MQTT", secondBoot.getPreviousComponent(0));
+    TEST_ASSERT_EQUAL_STRING("Connected to broker:1883", previousText(secondBoot, 0));
+    TEST_ASSERT_EQUAL(2000, secondBoot.getPrevious(1).timestampMs);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, secondBoot.getPrevious(1).level);
+    TEST_ASSERT_EQUAL_STRING("Heap low: 4096 bytes", previousText(secondBoot, 1));
+
+    // This boot writes the other bank, so the previous lines stay put
+    addLine(secondBoot, "BOOT", LOG_LEVEL_NOTICE, 10, "Booted");
+    TEST_ASSERT_EQUAL_STRING("Connected to broker:1883", previousText(secondBoot, 0));
+
+    CrashLog thirdBoot;
+    thirdBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(1, thirdBoot.getPreviousCount());
+    TEST_ASSERT_EQUAL_STRING("Booted", previousText(thirdBoot, 0));
+}
+
+void test_crash_log_keeps_newest_lines()
+{
+    CrashLog firstBoot;
+    firstBoot.begin(&crashStorage, firmwareA, false);
+    for (int i = 0; i < crashLogSlotCount + 8; i++)
+    {
+        addLine(firstBoot, "LOOP", LOG_LEVEL_NOTICE, i, "line %d", i);
+    }
+
+    CrashLog secondBoot;
+    secondBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(crashLogSlotCount, secondBoot.getPreviousCount());
+    TEST_ASSERT_EQUAL_STRING("line 8", previousText(secondBoot, 0));
+
+    char expected[32];
+    snprintf(expected, sizeof(expected), "line %d", crashLogSlotCount + 7);
+    TEST_ASSERT_EQUAL_STRING(expected, previousText(secondBoot, crashLogSlotCount - 1));
+}
+
+void test_crash_log_discards_untrusted_storage()
+{
+    CrashLog firstBoot;
+    firstBoot.begin(&crashStorage, firmwareA, false);
+    addLine(firstBoot, "MQTT", LOG_LEVEL_NOTICE, 1, "one");
+    addLine(firstBoot, "MQTT", LOG_LEVEL_NOTICE, 2, "two");
+
+    // A slot caught mid-write by the reset is skipped
+    crashStorage.banks[crashStorage.activeBank].slots[0].sequence = 0;
+
+    // Different build: the stored pointers mean nothing
+    CrashLog otherBuild;
+    otherBuild.begin(&crashStorage, firmwareB, true);
+    TEST_ASSERT_EQUAL(0, otherBuild.getPreviousCount());
+
+    CrashLog sameBuild;
+    addLine(otherBuild, "MQTT", LOG_LEVEL_NOTICE, 1, "one");
+    addLine(otherBuild, "MQTT", LOG_LEVEL_NOTICE, 2, "two");
+    crashStorage.banks[crashStorage.activeBank].slots[0].sequence = 0;
+    sameBuild.begin(&crashStorage, firmwareB, true);
+    TEST_ASSERT_EQUAL(1, sameBuild.getPreviousCount());
+    TEST_ASSERT_EQUAL_STRING("two", previousText(sameBuild, 0));
+
+    // Power-on: RAM content is random whatever it looks like
+    CrashLog powerOn;
+    powerOn.begin(&crashStorage, firmwareB, false);
+    TEST_ASSERT_EQUAL(0, powerOn.getPreviousCount());
+}
+
+void test_crash_log_truncates_long_arguments()
+{
+    CrashLog firstBoot;
+    firstBoot.begin(&crashStorage, firmwareA, false);
+
+    char longText[crashLogSlotArgBytes * 2];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    addLine(firstBoot, "API", LOG_LEVEL_NOTICE, 1, "%d %s", 7, longText);
+
+    CrashLog secondBoot;
+    secondBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(1, secondBoot.getPreviousCount());
+    TEST_ASSERT_TRUE(secondBoot.getPrevious(0).flags & LOG_RECORD_TRUNCATED);
+
+    // The int fits; the string lost its end, so it shows as missing
+    TEST_ASSERT_EQUAL_STRING("7 ?", previousText(secondBoot, 0));
+}
+
+void test_crash_log_copies_component_names()
+{
+    CrashLog firstBoot;
+    firstBoot.begin(&crashStorage, firmwareA, false);
+
+    // Built at run time and gone by the next boot, like a per-printer component
+    char component[32];
+    strcpy(component, "PEER");
+    addLine(firstBoot, component, LOG_LEVEL_NOTICE, 1, "first");
+    strcpy(component, "PRINTERDISCOVERY");
+    addLine(firstBoot, component, LOG_LEVEL_NOTICE, 2, "second");
+    memset(component, 0, sizeof(component));
+
+    CrashLog secondBoot;
+    secondBoot.begin(&crashStorage, firmwareA, true);
+    TEST_ASSERT_EQUAL(2, secondBoot.getPreviousCount());
+    TEST_ASSERT_EQUAL_STRING("PEER", secondBoot.getPreviousComponent(0));
+    TEST_ASSERT_EQUAL_STRING("PRINTERDISC", secondBoot.getPreviousComponent(1)); // Cut to crashLogComponentBytes - 1
+}
+
+void run_crash_log_tests()
+{
+    RUN_TEST(test_crash_log_keeps_previous_boot);
+    RUN_TEST(test_crash_log_keeps_newest_lines);
+    RUN_TEST(test_crash_log_discards_untrusted_storage);
+    RUN_TEST(test_crash_log_truncates_long_arguments);
+    RUN_TEST(test_crash_log_copies_component_names);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_delivery_tracker.cpp
+ * @brief Unit tests for remote print delivery tracking
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../src/config/config.h"
+#include "../src/core/delivery_tracker.h"
+
+// Runs the latency report to the end and parses it back
+class LatencyReportText : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        text += (char)c;
+        return 1;
+    }
+
+    String text;
+};
+
+static void readLatencyReport(JsonDocument &doc)
+{
+    LatencyReportText out;
+    JsonStreamWriter json(out);
+    DeliveryLatencyReport report;
+    json.beginObject();
+    for (int step = 0; report.writeStep(json, step); step++)
+    {
+    }
+    json.endObject();
+    json.flush();
+    TEST_ASSERT_FALSE(deserializeJson(doc, out.text));
+}
+
+static JsonObject findJob(JsonDocument &doc, const char *messageId, const char *printerId)
+{
+    for (JsonObject job : doc["jobs"].as<JsonArray>())
+    {
+        if (strcmp(job["id"] | "", messageId) == 0 && strcmp(job["printer_id"] | "", printerId) == 0)
+        {
+            return job;
+        }
+    }
+    return JsonObject();
+}
+
+void test_delivery_ack_records_latency()
+{
+    trackRemoteDelivery("lat-1", "scribe/test/print");
+    delay(20);
+    TEST_ASSERT_TRUE(recordDeliveryAck("lat-1", "aabbccddeeff", "printed", 5, 10));
+
+    DynamicJsonDocument doc(largeJsonDocumentSize);
+    readLatencyReport(doc);
+
+    JsonObject job = findJob(doc, "lat-1", "aabbccddeeff");
+    TEST_ASSERT_FALSE(job.isNull());
+    TEST_ASSERT_EQUAL_STRING("printed", job["status"]);
+    TEST_ASSERT_GREATER_OR_EQUAL(20, job["round_trip_ms"].as<unsigned long>());
+    TEST_ASSERT_EQUAL(10, job["print_done_ms"].as<unsigned long>());
+    TEST_ASSERT_EQUAL(job["round_trip_ms"].as<unsigned long>() - 10, job["network_ms"].as<unsigned long>());
+}
+
+void test_delivery_unknown_ack_ignored()
+{
+    TEST_ASSERT_FALSE(recordDeliveryAck("never-sent", "aabbccddeeff", "printed", 1, 2));
+    TEST_ASSERT_FALSE(recordDeliveryAck("", "aabbccddeeff", "printed", 1, 2));
+}
+
+void test_delivery_group_acks_recorded_separately()
+{
+    trackRemoteDelivery("grp-1", "scribe/group/kitchen");
+    TEST_ASSERT_TRUE(recordDeliveryAck("grp-1", "111111111111", "printed", 1, 2));
+    TEST_ASSERT_TRUE(recordDeliveryAck("grp-1", "222222222222", "duplicate", 0, 0));
+
+    DynamicJsonDocument doc(largeJsonDocumentSize);
+    readLatencyReport(doc);
+
+    TEST_ASSERT_FALSE(findJob(doc, "grp-1", "111111111111").isNull());
+    TEST_ASSERT_EQUAL_STRING("duplicate", findJob(doc, "grp-1", "222222222222")["status"]);
+}
+
+void test_delivery_pending_reported()
+{
+    trackRemoteDelivery("pend-1", "scribe/test/print");
+
+    DynamicJsonDocument doc(largeJsonDocumentSize);
+    readLatencyReport(doc);
+
+    // Newest job is listed first
+    JsonObject job = doc["jobs"][0];
+    TEST_ASSERT_EQUAL_STRING("pend-1", job["id"]);
+    TEST_ASSERT_EQUAL_STRING("pending", job["status"]);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, doc["summary"]["pending"].as<int>());
+}
+
+void test_delivery_paths_reported_separately()
+{
+    trackRemoteDelivery("path-lan", "scribe/test/print", DeliveryPath::LAN);
+    TEST_ASSERT_TRUE(recordDeliveryAck("path-lan", "333333333333", "accepted", 0, 0));
+    trackRemoteDelivery("path-fb", "scribe/test/print", DeliveryPath::LAN);
+    setDeliveryPath("path-fb", DeliveryPath::LAN_FALLBACK);
+
+    DynamicJsonDocument doc(largeJsonDocumentSize);
+    readLatencyReport(doc);
+
+    JsonObject lanJob = findJob(doc, "path-lan", "333333333333");
+    TEST_ASSERT_EQUAL_STRING("lan", lanJob["path"]);
+    TEST_ASSERT_EQUAL(lanJob["round_trip_ms"].as<unsigned long>(), lanJob["network_ms"].as<unsigned long>());
+    TEST_ASSERT_EQUAL_STRING("lan_fallback", doc["jobs"][0]["path"]);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, doc["paths"]["lan"]["acked"].as<int>());
+    TEST_ASSERT_TRUE(doc["paths"].containsKey("mqtt"));
+}
+
+void test_delivery_pending_counted_per_topic()
+{
+    int before = countPendingDeliveries("scribe/count/print");
+    trackRemoteDelivery("count-1", "scribe/count/print");
+    trackRemoteDelivery("count-2", "scribe/count/print");
+    trackRemoteDelivery("count-3", "scribe/other/print");
+    TEST_ASSERT_EQUAL(before + 2, countPendingDeliveries("scribe/count/print"));
+
+    recordDeliveryAck("count-1", "444444444444", "printed", 1, 2);
+    TEST_ASSERT_EQUAL(before + 1, countPendingDeliveries("scribe/count/print"));
+}
+
+void run_delivery_tracker_tests()
+{
+    RUN_TEST(test_delivery_ack_records_latency);
+    RUN_TEST(test_delivery_unknown_ack_ignored);
+    RUN_TEST(test_delivery_group_acks_recorded_separately);
+    RUN_TEST(test_delivery_pending_reported);
+    RUN_TEST(test_delivery_paths_reported_separately);
+    RUN_TEST(test_delivery_pending_counted_per_topic);
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_discovered_printer_table.cpp
+ * @brief Unit tests for the fixed-capacity discovered printer table
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/discovered_printer_table.h"
+
+static void addPrinter(DiscoveredPrinterTable &table, const char *printerId, unsigned long seenAt)
+{
+    bool added = false;
+    DiscoveredPrinter *printer = table.findOrAdd(printerId, seenAt, added);
+    TEST_ASSERT_NOT_NULL(printer);
+    printer->lastSeen = seenAt;
+}
+
+void test_printer_table_add_and_find()
+{
+    DiscoveredPrinterTable table;
+    bool added = false;
+
+    DiscoveredPrinter *printer = table.findOrAdd("a1b2c3d4", 1000, added);
+    TEST_ASSERT_NOT_NULL(printer);
+    TEST_ASSERT_TRUE(added);
+    copyPrinterField(printer->name, "Kitchen");
+
+    TEST_ASSERT_TRUE(table.findOrAdd("a1b2c3d4", 2000, added) == printer);
+    TEST_ASSERT_FALSE(added);
+    TEST_ASSERT_EQUAL_STRING("Kitchen", table.find("a1b2c3d4")->name);
+    TEST_ASSERT_NULL(table.find("ffffffff"));
+    TEST_ASSERT_EQUAL(1, table.size());
+
+    // IDs that don't fit are rejected rather than truncated
+    TEST_ASSERT_NULL(table.findOrAdd("0123456789abcdef0", 1000, added));
+    TEST_ASSERT_NULL(table.findOrAdd("", 1000, added));
+}
+
+void test_printer_table_evicts_least_recently_seen()
+{
+    DiscoveredPrinterTable table;
+    char printerId[8];
+    for (int i = 0; i < table.capacity(); i++)
+    {
+        snprintf(printerId, sizeof(printerId), "p%d", i);
+        addPrinter(table, printerId, 1000 + i);
+    }
+
+    // Refresh p0 so p1 becomes the oldest
+    addPrinter(table, "p0", 5000);
+    addPrinter(table, "new", 6000);
+
+    TEST_ASSERT_EQUAL(table.capacity(), table.size());
+    TEST_ASSERT_EQUAL(1, table.getEvictionCount());
+    TEST_ASSERT_NULL(table.find("p1"));
+    TEST_ASSERT_NOT_NULL(table.find("p0"));
+    TEST_ASSERT_NOT_NULL(table.find("new"));
+}
+
+void test_printer_table_expires_stale_entries()
+{
+    DiscoveredPrinterTable table;
+    addPrinter(table, "old1", 1000);
+    addPrinter(table, "fresh", 9000);
+    addPrinter(table, "old2", 2000);
+
+    TEST_ASSERT_EQUAL(2, table.expire(10000, 5000));
+    TEST_ASSERT_EQUAL(1, table.size());
+    TEST_ASSERT_NOT_NULL(table.find("fresh"));
+    TEST_ASSERT_NULL(table.find("old1"));
+
+    // Every remaining entry is still reachable through the index
+    for (const DiscoveredPrinter &printer : table)
+    {
+        TEST_ASSERT_TRUE(table.find(printer.printerId) == &printer);
+    }
+}
+
+void test_printer_table_remove_keeps_index_consistent()
+{
+    DiscoveredPrinterTable table;
+    char printerId[8];
+    for (int i = 0; i < table.capacity(); i++)
+    {
+        snprintf(printerId, sizeof(printerId), "r%d", i);
+        addPrinter(table, printerId, 1000);
+    }
+
+    for (int i = 0; i < table.capacity(); i += 2)
+    {
+        snprintf(printerId, sizeof(printerId), "r%d", i);
+        TEST_ASSERT_TRUE(table.remove(printerId));
+    }
+    TEST_ASSERT_FALSE(table.remove("r0"));
+
+    for (int i = 0; i < table.capacity(); i++)
+    {
+        snprintf(printerId, sizeof(printerId), "r%d", i);
+        TEST_ASSERT_EQUAL(i % 2 == 1, table.find(printerId) != nullptr);
+    }
+}
+
+void test_printer_field_truncates_on_utf8_boundary()
+{
+    char field[6];
+    copyPrinterField(field, "abcd\xC3\xA9"); // "abcdé" needs 7 bytes
+    TEST_ASSERT_EQUAL_STRING("abcd", field);
+
+    TEST_ASSERT_FALSE(copyPrinterField(field, "abcd"));
+    TEST_ASSERT_TRUE(copyPrinterField(field, nullptr));
+    TEST_ASSERT_EQUAL_STRING("", field);
+}
+
+void test_printer_table_versions_changes_and_removals()
+{
+    DiscoveredPrinterTable table;
+    bool added = false;
+    uint32_t start = table.getVersion();
+
+    DiscoveredPrinter *first = table.findOrAdd("one", 1000, added);
+    DiscoveredPrinter *second = table.findOrAdd("two", 1000, added);
+    TEST_ASSERT_TRUE(first->version > start);
+    TEST_ASSERT_TRUE(second->version > first->version);
+
+    // Lookup alone is not a change
+    uint32_t beforeLookup = table.getVersion();
+    table.findOrAdd("one", 2000, added);
+    TEST_ASSERT_EQUAL(beforeLookup, table.getVersion());
+
+    table.markChanged(first);
+    TEST_ASSERT_EQUAL(table.getVersion(), first->version);
+
+    uint32_t beforeRemove = table.getVersion();
+    table.remove("two");
+    TEST_ASSERT_EQUAL(1, table.getTombstoneCount());
+    TEST_ASSERT_EQUAL_STRING("two", table.getTombstone(0).printerId);
+    TEST_ASSERT_TRUE(table.getTombstone(0).version > beforeRemove);
+    TEST_ASSERT_TRUE(table.canDeltaFrom(start));
+}
+
+void test_printer_table_delta_floor_after_tombstone_overflow()
+{
+    DiscoveredPrinterTable table;
+    uint32_t start = table.getVersion();
+    char printerId[8];
+
+    // One more removal than there are tombstones
+    for (int i = 0; i <= table.capacity(); i++)
+    {
+        snprintf(printerId, sizeof(printerId), "t%d", i);
+        addPrinter(table, printerId, 1000);
+        table.remove(printerId);
+    }
+
+    TEST_ASSERT_EQUAL(table.capacity(), table.getTombstoneCount());
+    TEST_ASSERT_FALSE(table.canDeltaFrom(start));
+    TEST_ASSERT_TRUE(table.canDeltaFrom(table.getVersion()));
+
+    // Clearing loses removals, so only the new version can be a delta base
+    uint32_t beforeClear = table.getVersion();
+    table.clear();
+    TEST_ASSERT_FALSE(table.canDeltaFrom(beforeClear));
+    TEST_ASSERT_TRUE(table.canDeltaFrom(table.getVersion()));
+}
+
+void run_discovered_printer_table_tests()
+{
+    RUN_TEST(test_printer_table_add_and_find);
+    RUN_TEST(test_printer_table_evicts_least_recently_seen);
+    RUN_TEST(test_printer_table_expires_stale_entries);
+    RUN_TEST(test_printer_table_remove_keeps_index_consistent);
+    RUN_TEST(test_printer_field_truncates_on_utf8_boundary);
+    RUN_TEST(test_printer_table_versions_changes_and_removals);
+    RUN_TEST(test_printer_table_delta_floor_after_tombstone_overflow);
+}
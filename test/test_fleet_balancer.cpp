@@ -0,0 +1,75 @@
+/**
+ * @file test_fleet_balancer.cpp
+ * @brief Unit tests for picking the least busy printer in a group
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/fleet_balancer.h"
+
+void test_fleet_picks_lowest_load()
+{
+    FleetCandidate candidates[] = {
+        {"aaaa", 2, 0},
+        {"bbbb", 0, 1},
+        {"cccc", 0, 0},
+    };
+    TEST_ASSERT_EQUAL(2, pickLeastLoadedPrinter(candidates, 3));
+}
+
+void test_fleet_tie_goes_to_lowest_id()
+{
+    FleetCandidate candidates[] = {
+        {"cccc", 1, 0},
+        {"aaaa", 0, 1},
+        {"bbbb", 1, 0},
+    };
+    // All loads equal - every sender must agree on the same printer
+    TEST_ASSERT_EQUAL(1, pickLeastLoadedPrinter(candidates, 3));
+}
+
+void test_fleet_burst_spreads_across_printers()
+{
+    FleetCandidate candidates[] = {
+        {"aaaa", 0, 0},
+        {"bbbb", 0, 0},
+        {"cccc", 0, 0},
+    };
+
+    // Each job sent counts as pending on its printer until acked
+    int sent[3] = {0, 0, 0};
+    for (int job = 0; job < 9; job++)
+    {
+        int chosen = pickLeastLoadedPrinter(candidates, 3);
+        candidates[chosen].pendingJobs++;
+        sent[chosen]++;
+    }
+    TEST_ASSERT_EQUAL(3, sent[0]);
+    TEST_ASSERT_EQUAL(3, sent[1]);
+    TEST_ASSERT_EQUAL(3, sent[2]);
+}
+
+void test_fleet_no_candidates()
+{
+    TEST_ASSERT_EQUAL(-1, pickLeastLoadedPrinter(nullptr, 0));
+}
+
+void test_fleet_group_list_matching()
+{
+    TEST_ASSERT_TRUE(isInGroupList("kitchen,office", "kitchen"));
+    TEST_ASSERT_TRUE(isInGroupList("kitchen,office", "office"));
+    TEST_ASSERT_FALSE(isInGroupList("kitchen,office", "kitch"));
+    TEST_ASSERT_FALSE(isInGroupList("kitchen,office", "office2"));
+    TEST_ASSERT_FALSE(isInGroupList("", "kitchen"));
+    TEST_ASSERT_FALSE(isInGroupList("kitchen", ""));
+    TEST_ASSERT_FALSE(isInGroupList(nullptr, "kitchen"));
+}
+
+void run_fleet_balancer_tests()
+{
+    RUN_TEST(test_fleet_picks_lowest_load);
+    RUN_TEST(test_fleet_tie_goes_to_lowest_id);
+    RUN_TEST(test_fleet_burst_spreads_across_printers);
+    RUN_TEST(test_fleet_no_candidates);
+    RUN_TEST(test_fleet_group_list_matching);
+}
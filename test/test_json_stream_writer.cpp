@@ -0,0 +1,136 @@
+/**
+ * @file test_json_stream_writer.cpp
+ * @brief Unit tests for the fixed-buffer JSON stream writer
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/utils/json_stream_writer.h"
+
+// Collects output and counts how often the writer hands it over
+class CapturePrint : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        text += (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t *data, size_t length) override
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            text += (char)data[i];
+        }
+        writes++;
+        return length;
+    }
+
+    String text;
+    int writes = 0;
+};
+
+void test_json_stream_writer_nests_with_commas()
+{
+    CapturePrint out;
+    JsonStreamWriter json(out);
+    json.beginObject();
+    json.field("name", "scribe");
+    json.field("port", 1883);
+    json.field("enabled", true);
+    json.field("missing", nullptr);
+    json.beginArray("pins");
+    json.value(4);
+    json.value(5);
+    json.beginObject();
+    json.field("empty", "");
+    json.endObject();
+    json.endArray();
+    json.beginObject("inner");
+    json.endObject();
+    json.endObject();
+    json.flush();
+
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"name\":\"scribe\",\"port\":1883,\"enabled\":true,\"missing\":null,"
+        "\"pins\":[4,5,{\"empty\":\"\"}],\"inner\":{}}",
+        out.text.c_str());
+    TEST_ASSERT_EQUAL(0, json.getDepth());
+    TEST_ASSERT_EQUAL(out.text.length(), json.getBytesWritten());
+}
+
+void test_json_stream_writer_escapes_strings()
+{
+    CapturePrint out;
+    JsonStreamWriter json(out);
+    json.beginObject();
+    json.field("say \"hi\"", "a\\b\nc\td\x01 ✅");
+    json.field("owner", String("Adam"));
+    json.endObject();
+    json.flush();
+
+    TEST_ASSERT_EQUAL_STRING("{\"say \\\"hi\\\"\":\"a\\\\b\\nc\\td\\u0001 ✅\",\"owner\":\"Adam\"}",
+                             out.text.c_str());
+}
+
+void test_json_stream_writer_formats_numbers()
+{
+    CapturePrint out;
+    JsonStreamWriter json(out);
+    json.beginArray();
+    json.value(-42);
+    json.value(4294967295UL);
+    json.value(-9223372036854775807LL - 1);
+    json.value(18446744073709551615ULL);
+    json.value(23.5f);
+    json.value(0.0 / 0.0);
+    json.endArray();
+    json.flush();
+
+    TEST_ASSERT_EQUAL_STRING("[-42,4294967295,-9223372036854775808,18446744073709551615,23.5,null]",
+                             out.text.c_str());
+}
+
+void test_json_stream_writer_flushes_through_small_buffer()
+{
+    CapturePrint out;
+    JsonStreamWriter json(out);
+    json.beginArray();
+    for (int i = 0; i < 200; i++)
+    {
+        json.value("0123456789");
+    }
+    json.endArray();
+
+    // Most of it has already gone out a buffer at a time
+    TEST_ASSERT_TRUE(out.text.length() >= json.getBytesWritten() - jsonStreamBufferBytes);
+    TEST_ASSERT_TRUE(out.writes >= (int)(json.getBytesWritten() / jsonStreamBufferBytes));
+
+    json.flush();
+    TEST_ASSERT_EQUAL(2 + 200 * 12 + 199, out.text.length());
+    TEST_ASSERT_EQUAL(out.text.length(), json.getBytesWritten());
+}
+
+void test_json_stream_writer_takes_raw_values()
+{
+    CapturePrint out;
+    JsonStreamWriter json(out);
+    json.beginObject();
+    json.field("a", 1);
+    json.key("doc");
+    json.print("{\"b\":2}"); // As serializeJson(doc, json) would
+    json.field("c", 3);
+    json.endObject();
+    json.flush();
+
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"doc\":{\"b\":2},\"c\":3}", out.text.c_str());
+}
+
+void run_json_stream_writer_tests()
+{
+    RUN_TEST(test_json_stream_writer_nests_with_commas);
+    RUN_TEST(test_json_stream_writer_escapes_strings);
+    RUN_TEST(test_json_stream_writer_formats_numbers);
+    RUN_TEST(test_json_stream_writer_flushes_through_small_buffer);
+    RUN_TEST(test_json_stream_writer_takes_raw_values);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file test_log_batch.cpp
+ * @brief Unit tests for log record batching and retry policy
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_batch.h"
+
+static bool addEntry(LogBatch &batch, const char *entry, unsigned long now)
+{
+    return batch.add(entry, strlen(entry), now);
+}
+
+void test_log_batch_builds_json_array()
+{
+    LogBatch batch;
+    TEST_ASSERT_FALSE(batch.isDue(0));
+
+    TEST_ASSERT_TRUE(addEntry(batch, "{\"a\":1}", 1000));
+    TEST_ASSERT_TRUE(addEntry(batch, "{\"b\":2}", 1100));
+    TEST_ASSERT_EQUAL_STRING("[{\"a\":1},{\"b\":2}]", batch.getPayload().c_str());
+
+    // Still accepts records after the payload was built (send in progress or failed)
+    TEST_ASSERT_TRUE(addEntry(batch, "{\"c\":3}", 1200));
+    TEST_ASSERT_EQUAL_STRING("[{\"a\":1},{\"b\":2},{\"c\":3}]", batch.getPayload().c_str());
+
+    batch.onSent();
+    TEST_ASSERT_EQUAL(0, batch.getCount());
+    TEST_ASSERT_EQUAL(3, batch.getSentCount());
+    TEST_ASSERT_EQUAL_STRING("[]", batch.getPayload().c_str());
+}
+
+void test_log_batch_due_on_age_or_count()
+{
+    LogBatch batch;
+    addEntry(batch, "{}", 1000);
+    TEST_ASSERT_FALSE(batch.isDue(1000 + betterStackFlushIntervalMs - 1));
+    TEST_ASSERT_TRUE(batch.isDue(1000 + betterStackFlushIntervalMs));
+
+    batch.onSent();
+    for (int i = 0; i < betterStackBatchMaxRecords; i++)
+    {
+        TEST_ASSERT_TRUE(addEntry(batch, "{}", 5000));
+    }
+    TEST_ASSERT_TRUE(batch.isDue(5000));
+
+    // Full by count - further records are dropped, not queued
+    TEST_ASSERT_FALSE(addEntry(batch, "{}", 5000));
+    TEST_ASSERT_EQUAL(1, batch.getDroppedCount());
+}
+
+void test_log_batch_backs_off_then_drops()
+{
+    LogBatch batch;
+    addEntry(batch, "{}", 0);
+    addEntry(batch, "{}", 0);
+    unsigned long now = betterStackFlushIntervalMs;
+    TEST_ASSERT_TRUE(batch.isDue(now));
+
+    // Each failure doubles the wait before the next attempt
+    unsigned long wait = betterStackRetryBaseMs;
+    for (int attempt = 1; attempt < betterStackMaxAttempts; attempt++)
+    {
+        batch.onSendFailed(now);
+        TEST_ASSERT_EQUAL(2, batch.getCount());
+        TEST_ASSERT_FALSE(batch.isDue(now + wait - 1));
+        TEST_ASSERT_TRUE(batch.isDue(now + wait));
+        now += wait;
+        wait *= 2;
+    }
+
+    // Last allowed attempt fails - the batch is given up
+    batch.onSendFailed(now);
+    TEST_ASSERT_EQUAL(0, batch.getCount());
+    TEST_ASSERT_EQUAL(2, batch.getDroppedCount());
+    TEST_ASSERT_FALSE(batch.isDue(now + betterStackRetryMaxMs));
+}
+
+void test_log_batch_drops_entries_that_do_not_fit()
+{
+    LogBatch batch;
+    static char big[betterStackBatchMaxBytes];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    TEST_ASSERT_FALSE(addEntry(batch, big, 0));
+    TEST_ASSERT_EQUAL(1, batch.getDroppedCount());
+    TEST_ASSERT_EQUAL(0, batch.getCount());
+
+    // Nearly full by bytes counts as due straight away
+    big[betterStackBatchMaxBytes - logMessageMaxLength] = '\0';
+    TEST_ASSERT_TRUE(addEntry(batch, big, 0));
+    TEST_ASSERT_TRUE(batch.isDue(0));
+}
+
+void run_log_batch_tests()
+{
+    RUN_TEST(test_log_batch_builds_json_array);
+    RUN_TEST(test_log_batch_due_on_age_or_count);
+    RUN_TEST(test_log_batch_backs_off_then_drops);
+    RUN_TEST(test_log_batch_drops_entries_that_do_not_fit);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_log_file_writer.cpp
+ * @brief Unit tests for the buffered, segmented log file writer
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../src/core/log_file_writer.h"
+
+static const char *testLogBase = "/test_log_writer";
+
+static void removeTestLogs(int segmentCount)
+{
+    for (int i = 0; i < segmentCount; i++)
+    {
+        String name = String(testLogBase) + "." + String(i);
+        if (LittleFS.exists(name.c_str()))
+        {
+            LittleFS.remove(name.c_str());
+        }
+    }
+    String index = String(testLogBase) + ".idx";
+    if (LittleFS.exists(index.c_str()))
+    {
+        LittleFS.remove(index.c_str());
+    }
+}
+
+static size_t getFileSize(const String &name)
+{
+    File file = LittleFS.open(name.c_str(), "r");
+    size_t size = file ? file.size() : 0;
+    file.close();
+    return size;
+}
+
+static void writeLine(LogFileWriter &writer, char fill, size_t length, unsigned long now = 0)
+{
+    static uint8_t line[512];
+    memset(line, fill, length);
+    writer.prepare(length);
+    writer.write(line, length, now);
+}
+
+void test_log_file_writer_buffers_to_block_boundaries()
+{
+    removeTestLogs(logFileSegmentCount);
+    LogFileWriter writer(LittleFS, testLogBase);
+    TEST_ASSERT_TRUE(writer.begin());
+    TEST_ASSERT_TRUE(writer.prepare(100)); // Empty segment - caller would write a header
+
+    writeLine(writer, 'a', 100);
+    TEST_ASSERT_EQUAL(0, writer.getFlashWrites());
+    TEST_ASSERT_EQUAL(100, writer.getBufferedBytes());
+    TEST_ASSERT_FALSE(writer.prepare(100));
+
+    writer.flush();
+    TEST_ASSERT_EQUAL(1, writer.getFlashWrites());
+    TEST_ASSERT_EQUAL(100, getFileSize(writer.getSegmentName(0)));
+
+    // Lines that cross the block boundary are split so the write ends on it
+    for (int i = 0; i < logFileBufferBytes / 400; i++)
+    {
+        writeLine(writer, 'b', 400);
+    }
+    TEST_ASSERT_EQUAL(2, writer.getFlashWrites());
+    TEST_ASSERT_EQUAL(logFileBufferBytes, getFileSize(writer.getSegmentName(0)));
+    TEST_ASSERT_EQUAL(100 + (logFileBufferBytes / 400) * 400 - logFileBufferBytes, writer.getBufferedBytes());
+
+    writer.end();
+    removeTestLogs(logFileSegmentCount);
+}
+
+void test_log_file_writer_flushes_on_age()
+{
+    removeTestLogs(logFileSegmentCount);
+    LogFileWriter writer(LittleFS, testLogBase);
+    TEST_ASSERT_TRUE(writer.begin());
+
+    TEST_ASSERT_FALSE(writer.isFlushDue(0));
+    writeLine(writer, 'a', 10, 1000);
+    writeLine(writer, 'b', 10, 3000);
+
+    // Age is measured from the oldest buffered line
+    TEST_ASSERT_FALSE(writer.isFlushDue(1000 + logFileFlushIntervalMs - 1));
+    TEST_ASSERT_TRUE(writer.isFlushDue(1000 + logFileFlushIntervalMs));
+
+    writer.flush();
+    TEST_ASSERT_FALSE(writer.isFlushDue(1000 + logFileFlushIntervalMs));
+
+    writer.end();
+    removeTestLogs(logFileSegmentCount);
+}
+
+void test_log_file_writer_rotates_through_segments()
+{
+    const int segments = 3;
+    const size_t segmentBytes = 1000;
+    removeTestLogs(segments);
+
+    LogFileWriter writer(LittleFS, testLogBase, segments, segmentBytes);
+    TEST_ASSERT_TRUE(writer.begin());
+
+    // Three 300-byte lines per segment; the fourth starts the next one
+    for (int i = 0; i < 4; i++)
+    {
+        writeLine(writer, 'a', 300);
+    }
+    TEST_ASSERT_EQUAL(1, writer.getActiveSegment());
+    TEST_ASSERT_EQUAL(900, getFileSize(writer.getSegmentName(0)));
+
+    // Wrap around: segment 0 is reused from empty
+    for (int i = 0; i < 6; i++)
+    {
+        writeLine(writer, 'b', 300);
+    }
+    TEST_ASSERT_EQUAL(0, writer.getActiveSegment());
+    TEST_ASSERT_EQUAL(3, writer.getSequence());
+    writer.end();
+    TEST_ASSERT_EQUAL(300, getFileSize(writer.getSegmentName(0)));
+
+    // The index brings a new writer back to the same segment
+    LogFileWriter reopened(LittleFS, testLogBase, segments, segmentBytes);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL(0, reopened.getActiveSegment());
+    TEST_ASSERT_EQUAL(3, reopened.getSequence());
+    TEST_ASSERT_FALSE(reopened.prepare(300));
+    reopened.end();
+
+    removeTestLogs(segments);
+}
+
+void run_log_file_writer_tests()
+{
+    RUN_TEST(test_log_file_writer_buffers_to_block_boundaries);
+    RUN_TEST(test_log_file_writer_flushes_on_age);
+    RUN_TEST(test_log_file_writer_rotates_through_segments);
+}
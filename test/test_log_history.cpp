@@ -0,0 +1,101 @@
+/**
+ * @file test_log_history.cpp
+ * @brief Unit tests for the in-RAM log history read by /api/logs
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_history.h"
+
+alignas(LogRecord) static uint8_t historyScratch[sizeof(LogRecord) + logRecordMaxArgBytes];
+
+static uint32_t addRecord(LogHistory &history, int level, const char *format, ...)
+{
+    LogRecord *record = reinterpret_cast<LogRecord *>(historyScratch);
+    va_list args;
+    va_start(args, format);
+    buildLogRecord(record, 1, level, 0, format, args);
+    va_end(args);
+    return history.add(*record);
+}
+
+// Text of the record at the cursor, or nullptr if there isn't one
+static const char *readText(LogHistory &history, LogHistoryCursor &cursor)
+{
+    alignas(LogRecord) static uint8_t out[sizeof(LogRecord) + logRecordMaxArgBytes];
+    static char text[logMessageMaxLength];
+    LogRecord *record = reinterpret_cast<LogRecord *>(out);
+    if (!history.read(cursor, record, sizeof(out)))
+    {
+        return nullptr;
+    }
+    formatLogMessage(*record, text, sizeof(text));
+    return text;
+}
+
+void test_log_history_follows_with_cursor()
+{
+    LogHistory history;
+    TEST_ASSERT_EQUAL(0, addRecord(history, LOG_LEVEL_NOTICE, "first %d", 1));
+    TEST_ASSERT_EQUAL(1, addRecord(history, LOG_LEVEL_ERROR, "second %s", "line"));
+
+    LogHistoryCursor cursor;
+    TEST_ASSERT_EQUAL_STRING("first 1", readText(history, cursor));
+    TEST_ASSERT_EQUAL_STRING("second line", readText(history, cursor));
+    TEST_ASSERT_NULL(readText(history, cursor));
+    TEST_ASSERT_EQUAL(2, cursor.sequence);
+
+    // The same cursor picks up only what was added since
+    addRecord(history, LOG_LEVEL_NOTICE, "third");
+    TEST_ASSERT_EQUAL_STRING("third", readText(history, cursor));
+    TEST_ASSERT_NULL(readText(history, cursor));
+    TEST_ASSERT_EQUAL(0, cursor.missed);
+
+    // A fresh cursor can start part-way through
+    LogHistoryCursor middle(1);
+    TEST_ASSERT_EQUAL_STRING("second line", readText(history, middle));
+}
+
+void test_log_history_overwrites_oldest()
+{
+    LogHistory history;
+    const int total = logHistoryBytes / 8; // Far more than fit
+    for (int i = 0; i < total; i++)
+    {
+        addRecord(history, LOG_LEVEL_NOTICE, "line %d %s", i, i % 3 ? "short" : "a much longer piece of text");
+    }
+
+    uint32_t first = history.getFirstSequence();
+    TEST_ASSERT_TRUE(first > 0);
+    TEST_ASSERT_EQUAL(total, history.getNextSequence());
+
+    // A cursor that fell behind moves to the oldest record and counts the gap
+    LogHistoryCursor cursor;
+    char expected[64];
+    for (int i = first; i < total; i++)
+    {
+        snprintf(expected, sizeof(expected), "line %d %s", i, i % 3 ? "short" : "a much longer piece of text");
+        TEST_ASSERT_EQUAL_STRING(expected, readText(history, cursor));
+    }
+    TEST_ASSERT_NULL(readText(history, cursor));
+    TEST_ASSERT_EQUAL(first, cursor.missed);
+}
+
+void test_log_history_restarts_stale_cursor()
+{
+    LogHistory history;
+    addRecord(history, LOG_LEVEL_NOTICE, "after reboot");
+
+    // Sequence from the previous boot, ahead of everything kept now
+    LogHistoryCursor cursor(5000);
+    TEST_ASSERT_EQUAL_STRING("after reboot", readText(history, cursor));
+    TEST_ASSERT_EQUAL(1, cursor.sequence);
+    TEST_ASSERT_EQUAL(0, cursor.missed);
+}
+
+void run_log_history_tests()
+{
+    RUN_TEST(test_log_history_follows_with_cursor);
+    RUN_TEST(test_log_history_overwrites_oldest);
+    RUN_TEST(test_log_history_restarts_stale_cursor);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file test_log_level_table.cpp
+ * @brief Unit tests for runtime per-component log levels
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_level_table.h"
+
+void test_log_level_table_parses_overrides()
+{
+    LogLevelOverride overrides[maxLogLevelOverrides];
+    int count = -1;
+    TEST_ASSERT_TRUE(LogLevelTable::parse(" MQTT = verbose, WEB=2,", overrides, maxLogLevelOverrides, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL_STRING("MQTT", overrides[0].component);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_VERBOSE, overrides[0].level);
+    TEST_ASSERT_EQUAL_STRING("WEB", overrides[1].component);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, overrides[1].level);
+
+    TEST_ASSERT_TRUE(LogLevelTable::parse("", nullptr, 0, &count));
+    TEST_ASSERT_EQUAL(0, count);
+
+    TEST_ASSERT_FALSE(LogLevelTable::parse("MQTT", nullptr, 0, nullptr));
+    TEST_ASSERT_FALSE(LogLevelTable::parse("MQTT=LOUD", nullptr, 0, nullptr));
+    TEST_ASSERT_FALSE(LogLevelTable::parse("MQTT=7", nullptr, 0, nullptr));
+    TEST_ASSERT_FALSE(LogLevelTable::parse("=NOTICE", nullptr, 0, nullptr));
+    TEST_ASSERT_FALSE(LogLevelTable::parse("AVERYLONGCOMPONENTNAME=NOTICE", nullptr, 0, nullptr));
+}
+
+void test_log_level_table_applies_per_component()
+{
+    LogLevelTable table;
+    TEST_ASSERT_TRUE(table.configure(LOG_LEVEL_WARNING, "MQTT=VERBOSE,WEB=ERROR"));
+
+    TEST_ASSERT_TRUE(table.mayLog(LOG_LEVEL_VERBOSE)); // MQTT may
+    TEST_ASSERT_TRUE(table.allows(3, "MQTT", LOG_LEVEL_VERBOSE));
+    TEST_ASSERT_FALSE(table.allows(4, "WEB", LOG_LEVEL_WARNING));
+    TEST_ASSERT_TRUE(table.allows(4, "WEB", LOG_LEVEL_ERROR));
+
+    // Components without an override use the default; names match in any case
+    TEST_ASSERT_TRUE(table.allows(5, "BOOT", LOG_LEVEL_WARNING));
+    TEST_ASSERT_FALSE(table.allows(5, "BOOT", LOG_LEVEL_NOTICE));
+    TEST_ASSERT_TRUE(table.allows(6, "mqtt", LOG_LEVEL_VERBOSE));
+
+    // Unknown IDs (component table full) use the default
+    TEST_ASSERT_FALSE(table.allows(0xFF, "MQTT", LOG_LEVEL_VERBOSE));
+}
+
+void test_log_level_table_reconfigure_replaces_thresholds()
+{
+    LogLevelTable table;
+    TEST_ASSERT_TRUE(table.configure(LOG_LEVEL_NOTICE, "MQTT=VERBOSE"));
+    TEST_ASSERT_TRUE(table.allows(3, "MQTT", LOG_LEVEL_VERBOSE));
+
+    TEST_ASSERT_TRUE(table.configure(LOG_LEVEL_ERROR, ""));
+    TEST_ASSERT_FALSE(table.mayLog(LOG_LEVEL_WARNING));
+    TEST_ASSERT_FALSE(table.allows(3, "MQTT", LOG_LEVEL_VERBOSE));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, table.getDefaultLevel());
+
+    // A bad update changes nothing
+    TEST_ASSERT_FALSE(table.configure(LOG_LEVEL_VERBOSE, "MQTT=LOUD"));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, table.getDefaultLevel());
+    TEST_ASSERT_FALSE(table.allows(3, "MQTT", LOG_LEVEL_WARNING));
+}
+
+void test_log_level_names_round_trip()
+{
+    for (int level = LOG_LEVEL_SILENT; level <= LOG_LEVEL_VERBOSE; level++)
+    {
+        TEST_ASSERT_EQUAL(level, parseLogLevel(getLogLevelName(level)));
+    }
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARNING, parseLogLevel("warning"));
+    TEST_ASSERT_EQUAL(-1, parseLogLevel("3x"));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", getLogLevelName(9));
+}
+
+void run_log_level_table_tests()
+{
+    RUN_TEST(test_log_level_table_parses_overrides);
+    RUN_TEST(test_log_level_table_applies_per_component);
+    RUN_TEST(test_log_level_table_reconfigure_replaces_thresholds);
+    RUN_TEST(test_log_level_names_round_trip);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file test_log_rate_limiter.cpp
+ * @brief Unit tests for per-component log rate limiting
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_rate_limiter.h"
+
+void test_log_rate_limiter_allows_burst_then_refills()
+{
+    LogRateLimiter limiter;
+    limiter.configure(60, 3); // One line a second after three
+
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_WARNING, 1000));
+    }
+    TEST_ASSERT_FALSE(limiter.allow(1, LOG_LEVEL_WARNING, 1000));
+    TEST_ASSERT_FALSE(limiter.allow(1, LOG_LEVEL_WARNING, 1999));
+
+    // A second later there is one more token, and only one
+    TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_WARNING, 2000));
+    TEST_ASSERT_FALSE(limiter.allow(1, LOG_LEVEL_WARNING, 2000));
+
+    // A long quiet spell refills no more than the burst
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_WARNING, 600000));
+    }
+    TEST_ASSERT_FALSE(limiter.allow(1, LOG_LEVEL_WARNING, 600000));
+    TEST_ASSERT_EQUAL(4, limiter.getSuppressedCount());
+}
+
+void test_log_rate_limiter_keeps_pairs_apart()
+{
+    LogRateLimiter limiter;
+    limiter.configure(60, 1);
+
+    TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_WARNING, 0));
+    TEST_ASSERT_FALSE(limiter.allow(1, LOG_LEVEL_WARNING, 0));
+
+    // Same component at another level, and another component, have their own buckets
+    TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_ERROR, 0));
+    TEST_ASSERT_TRUE(limiter.allow(2, LOG_LEVEL_WARNING, 0));
+}
+
+void test_log_rate_limiter_reports_suppressed_counts()
+{
+    LogRateLimiter limiter;
+    limiter.configure(60, 1);
+
+    limiter.allow(5, LOG_LEVEL_NOTICE, 100);
+    for (int i = 0; i < 7; i++)
+    {
+        limiter.allow(5, LOG_LEVEL_NOTICE, 200 + i);
+    }
+
+    LogSuppression suppressions[4];
+    TEST_ASSERT_EQUAL(1, limiter.takeSuppressions(suppressions, 4));
+    TEST_ASSERT_EQUAL(5, suppressions[0].componentId);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_NOTICE, suppressions[0].level);
+    TEST_ASSERT_EQUAL(7, suppressions[0].count);
+    TEST_ASSERT_EQUAL(200, suppressions[0].sinceMs);
+
+    // Counts start again after each report
+    TEST_ASSERT_EQUAL(0, limiter.takeSuppressions(suppressions, 4));
+}
+
+void test_log_rate_limiter_off_when_zero()
+{
+    LogRateLimiter limiter;
+    limiter.configure(0, 1);
+    for (int i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_TRUE(limiter.allow(1, LOG_LEVEL_ERROR, 0));
+    }
+    TEST_ASSERT_EQUAL(0, limiter.getSuppressedCount());
+}
+
+void run_log_rate_limiter_tests()
+{
+    RUN_TEST(test_log_rate_limiter_allows_burst_then_refills);
+    RUN_TEST(test_log_rate_limiter_keeps_pairs_apart);
+    RUN_TEST(test_log_rate_limiter_reports_suppressed_counts);
+    RUN_TEST(test_log_rate_limiter_off_when_zero);
+}
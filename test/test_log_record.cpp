@@ -0,0 +1,118 @@
+/**
+ * @file test_log_record.cpp
+ * @brief Unit tests for binary log record encoding and deferred formatting
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_record.h"
+
+static size_t encodeArgs(uint8_t *out, size_t outSize, bool &truncated, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    size_t used = encodeLogArgs(format, args, out, outSize, truncated);
+    va_end(args);
+    return used;
+}
+
+// Encode then format, as a log call and the sink task would
+static const char *roundTrip(bool &truncated, size_t argBytes, const char *format, ...)
+{
+    alignas(LogRecord) static uint8_t storage[sizeof(LogRecord) + 256];
+    static char text[logMessageMaxLength];
+    LogRecord *record = reinterpret_cast<LogRecord *>(storage);
+
+    va_list args;
+    va_start(args, format);
+    record->argLength = (uint8_t)encodeLogArgs(format, args, record->args, argBytes, truncated);
+    va_end(args);
+    record->format = format;
+
+    formatLogMessage(*record, text, sizeof(text));
+    return text;
+}
+
+void test_log_record_formats_like_printf()
+{
+    bool truncated;
+    char expected[logMessageMaxLength];
+    unsigned long heap = 123456;
+    size_t length = 42;
+
+    const char *text = roundTrip(truncated, 200, "%s=%d heap %lu len %zu %u %.2f [%02d] %x %c 100%%",
+                                 "wifi", -7, heap, length, 3u, 3.14159, 5, 255, 'Z');
+    snprintf(expected, sizeof(expected), "%s=%d heap %lu len %zu %u %.2f [%02d] %x %c 100%%",
+             "wifi", -7, heap, length, 3u, 3.14159, 5, 255, 'Z');
+    TEST_ASSERT_FALSE(truncated);
+    TEST_ASSERT_EQUAL_STRING(expected, text);
+}
+
+void test_log_record_precision_and_star()
+{
+    bool truncated;
+    TEST_ASSERT_EQUAL_STRING("[   42] abc", roundTrip(truncated, 200, "[%*d] %.*s", 5, 42, 3, "abcdef"));
+
+    // %.50s only keeps what will be printed
+    char longText[120];
+    memset(longText, 'q', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    uint8_t args[200];
+    TEST_ASSERT_EQUAL(51, encodeArgs(args, sizeof(args), truncated, "%.50s", longText));
+    TEST_ASSERT_FALSE(truncated);
+}
+
+void test_log_record_marks_missing_arguments()
+{
+    bool truncated;
+
+    // Room for the first int only
+    const char *text = roundTrip(truncated, sizeof(int), "%d and %d and %s", 1, 2, "three");
+    TEST_ASSERT_TRUE(truncated);
+    TEST_ASSERT_EQUAL_STRING("1 and ? and ?", text);
+
+    // Null strings print as printf does on the ESP32
+    text = roundTrip(truncated, 200, "name=%s", (const char *)nullptr);
+    TEST_ASSERT_EQUAL_STRING("name=(null)", text);
+}
+
+void test_log_component_table_interns_names()
+{
+    LogComponentTable table;
+    char copy[] = "MQTT"; // Same text, different address
+
+    uint8_t mqtt = table.intern("MQTT");
+    uint8_t web = table.intern("WEB");
+    TEST_ASSERT_NOT_EQUAL(mqtt, web);
+    TEST_ASSERT_EQUAL(mqtt, table.intern("MQTT"));
+    TEST_ASSERT_EQUAL(mqtt, table.intern(copy));
+    TEST_ASSERT_EQUAL_STRING("WEB", table.getName(web));
+    TEST_ASSERT_EQUAL(2, table.size());
+    TEST_ASSERT_EQUAL_STRING("?", table.getName(logUnknownComponentId));
+}
+
+void test_log_component_table_copies_names()
+{
+    LogComponentTable table;
+    char runtime[32] = "SENSOR";
+    uint8_t sensor = table.intern(runtime);
+
+    // The caller's buffer can be reused; the table kept its own copy
+    strcpy(runtime, "OTHER");
+    TEST_ASSERT_EQUAL_STRING("SENSOR", table.getName(sensor));
+    TEST_ASSERT_EQUAL(sensor, table.intern("SENSOR"));
+
+    // Long names are cut, and names sharing the kept prefix share an ID
+    uint8_t longName = table.intern("A_VERY_LONG_COMPONENT_NAME");
+    TEST_ASSERT_EQUAL(logComponentNameLength, strlen(table.getName(longName)));
+    TEST_ASSERT_EQUAL(longName, table.intern("A_VERY_LONG_COMPONENT_NAME_TOO"));
+}
+
+void run_log_record_tests()
+{
+    RUN_TEST(test_log_record_formats_like_printf);
+    RUN_TEST(test_log_record_precision_and_star);
+    RUN_TEST(test_log_record_marks_missing_arguments);
+    RUN_TEST(test_log_component_table_interns_names);
+    RUN_TEST(test_log_component_table_copies_names);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_log_ring.cpp
+ * @brief Unit tests for the lock-free log record ring
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/log_ring.h"
+
+static const char *formatRecord(const LogRecord *record)
+{
+    static char text[logMessageMaxLength];
+    formatLogMessage(*record, text, sizeof(text));
+    return text;
+}
+
+void test_log_ring_keeps_order()
+{
+    LogRing ring;
+    TEST_ASSERT_NULL(ring.peek());
+
+    TEST_ASSERT_TRUE(ring.push(1, LOG_LEVEL_NOTICE, 100, "first %d", 1));
+    TEST_ASSERT_TRUE(ring.push(2, LOG_LEVEL_ERROR, 200, "second"));
+    TEST_ASSERT_EQUAL(2, ring.size());
+
+    const LogRecord *record = ring.peek();
+    TEST_ASSERT_NOT_NULL(record);
+    TEST_ASSERT_EQUAL(1, record->componentId);
+    TEST_ASSERT_EQUAL_STRING("first 1", formatRecord(record));
+    TEST_ASSERT_EQUAL(100, record->timestampMs);
+    ring.release();
+
+    record = ring.peek();
+    TEST_ASSERT_NOT_NULL(record);
+    TEST_ASSERT_EQUAL_STRING("second", formatRecord(record));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, record->level);
+    ring.release();
+
+    TEST_ASSERT_NULL(ring.peek());
+    TEST_ASSERT_EQUAL(0, ring.size());
+    TEST_ASSERT_EQUAL(0, ring.getUsedBytes());
+}
+
+void test_log_ring_drops_when_full()
+{
+    LogRing ring;
+    int accepted = 0;
+    while (ring.push(0, LOG_LEVEL_NOTICE, accepted, "%d", accepted))
+    {
+        accepted++;
+    }
+
+    // A no-argument record is header plus one int
+    TEST_ASSERT_EQUAL(logRingBytes / getLogRecordSize(sizeof(int)), accepted);
+    TEST_ASSERT_FALSE(ring.push(0, LOG_LEVEL_NOTICE, 0, "overflow"));
+    TEST_ASSERT_EQUAL(accepted, ring.getPushedCount());
+    TEST_ASSERT_EQUAL(2, ring.getDroppedCount());
+
+    // Oldest record is still the first one - drops never overwrite
+    TEST_ASSERT_EQUAL_STRING("0", formatRecord(ring.peek()));
+}
+
+void test_log_ring_reuses_slots_after_release()
+{
+    LogRing ring;
+    char text[64];
+    char expected[80];
+
+    // Several laps with uneven record sizes, so records land across the wrap point
+    for (int i = 0; i < logRingBytes / 8; i++)
+    {
+        int length = i % 40;
+        memset(text, 'a' + i % 26, length);
+        text[length] = '\0';
+
+        TEST_ASSERT_TRUE(ring.push(0, LOG_LEVEL_NOTICE, i, "%d:%s", i, text));
+        TEST_ASSERT_TRUE(ring.push(0, LOG_LEVEL_NOTICE, i, "%s", "next"));
+
+        snprintf(expected, sizeof(expected), "%d:%s", i, text);
+        TEST_ASSERT_EQUAL_STRING(expected, formatRecord(ring.peek()));
+        ring.release();
+        TEST_ASSERT_EQUAL_STRING("next", formatRecord(ring.peek()));
+        ring.release();
+    }
+    TEST_ASSERT_EQUAL(0, ring.getDroppedCount());
+    TEST_ASSERT_NULL(ring.peek());
+}
+
+void test_log_ring_truncates_long_fields()
+{
+    LogRing ring;
+    char longMessage[logRecordMaxArgBytes * 2];
+    memset(longMessage, 'x', sizeof(longMessage) - 1);
+    longMessage[sizeof(longMessage) - 1] = '\0';
+
+    TEST_ASSERT_TRUE(ring.push(0, LOG_LEVEL_NOTICE, 0, "%s then %d", longMessage, 5));
+
+    const LogRecord *record = ring.peek();
+    TEST_ASSERT_EQUAL(logRecordMaxArgBytes, record->argLength);
+    TEST_ASSERT_TRUE(record->flags & LOG_RECORD_TRUNCATED);
+
+    // String cut to what fits; the int after it is lost
+    const char *text = formatRecord(record);
+    TEST_ASSERT_EQUAL(logRecordMaxArgBytes - 1 + strlen(" then ?"), strlen(text));
+    TEST_ASSERT_EQUAL_STRING(" then ?", text + logRecordMaxArgBytes - 1);
+}
+
+void run_log_ring_tests()
+{
+    RUN_TEST(test_log_ring_keeps_order);
+    RUN_TEST(test_log_ring_drops_when_full);
+    RUN_TEST(test_log_ring_reuses_slots_after_release);
+    RUN_TEST(test_log_ring_truncates_long_fields);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_mdns_record_merge.cpp
+ * @brief Unit tests for merging mDNS browse results into the printer table
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/mdns_record_merge.h"
+
+static MdnsServiceRecord makeRecord(const char *printerId, const char *name, const char *scope, const char *ipAddress)
+{
+    MdnsServiceRecord record;
+    record.printerId = printerId;
+    record.name = name;
+    record.version = "1.2.0";
+    record.scope = scope;
+    record.groups = nullptr;
+    record.hostname = "scribe-test";
+    record.ipAddress = ipAddress;
+    return record;
+}
+
+void test_mdns_merge_adds_printers_in_scope()
+{
+    DiscoveredPrinterTable table;
+    MdnsServiceRecord records[] = {
+        makeRecord("a1", "Kitchen", "", "192.168.1.10"),
+        makeRecord("b2", "Office", "work", "192.168.1.11"), // Other scope
+        makeRecord(nullptr, "Broken", "", "192.168.1.12"),  // No ID
+    };
+
+    TEST_ASSERT_EQUAL(1, mergeMdnsServiceRecords(table, records, 3, "", 1000));
+    TEST_ASSERT_EQUAL(1, table.size());
+
+    const DiscoveredPrinter *printer = table.find("a1");
+    TEST_ASSERT_NOT_NULL(printer);
+    TEST_ASSERT_EQUAL_STRING("Kitchen", printer->name);
+    TEST_ASSERT_EQUAL_STRING("scribe-test.local", printer->mdns);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.10", printer->ipAddress);
+    TEST_ASSERT_TRUE(printer->online);
+    TEST_ASSERT_EQUAL(DISCOVERY_SOURCE_MDNS, printer->sources);
+}
+
+void test_mdns_merge_unchanged_refreshes_without_new_version()
+{
+    DiscoveredPrinterTable table;
+    MdnsServiceRecord record = makeRecord("a1", "Kitchen", "", "192.168.1.10");
+    mergeMdnsServiceRecords(table, &record, 1, "", 1000);
+    uint32_t version = table.getVersion();
+
+    TEST_ASSERT_EQUAL(0, mergeMdnsServiceRecords(table, &record, 1, "", 5000));
+    TEST_ASSERT_EQUAL(version, table.getVersion());
+    TEST_ASSERT_EQUAL(5000, table.find("a1")->lastSeen);
+
+    record.ipAddress = "192.168.1.20";
+    TEST_ASSERT_EQUAL(1, mergeMdnsServiceRecords(table, &record, 1, "", 6000));
+    TEST_ASSERT_TRUE(table.getVersion() > version);
+}
+
+void test_mdns_merge_keeps_mqtt_fields()
+{
+    DiscoveredPrinterTable table;
+    bool added = false;
+    DiscoveredPrinter *printer = table.findOrAdd("a1", 1000, added);
+    copyPrinterField(printer->name, "Kitchen");
+    copyPrinterField(printer->timezone, "Europe/London");
+    copyPrinterField(printer->groups, "kitchen");
+    printer->online = false; // MQTT LWT fired
+    printer->sources = DISCOVERY_SOURCE_MQTT;
+
+    MdnsServiceRecord record = makeRecord("a1", nullptr, "", nullptr);
+    TEST_ASSERT_EQUAL(1, mergeMdnsServiceRecords(table, &record, 1, "", 2000));
+
+    TEST_ASSERT_EQUAL_STRING("Kitchen", printer->name);
+    TEST_ASSERT_EQUAL_STRING("Europe/London", printer->timezone);
+    TEST_ASSERT_EQUAL_STRING("kitchen", printer->groups); // Not advertised - kept
+    TEST_ASSERT_TRUE(printer->online); // Answering mDNS means it's up
+    TEST_ASSERT_EQUAL(DISCOVERY_SOURCE_MQTT | DISCOVERY_SOURCE_MDNS, printer->sources);
+
+    record.groups = "kitchen,office";
+    TEST_ASSERT_EQUAL(1, mergeMdnsServiceRecords(table, &record, 1, "", 3000));
+    TEST_ASSERT_EQUAL_STRING("kitchen,office", printer->groups);
+}
+
+void test_mdns_expiry_only_drops_mdns_only_printers()
+{
+    DiscoveredPrinterTable table;
+    MdnsServiceRecord records[] = {
+        makeRecord("lan", "LAN only", "", "192.168.1.10"),
+        makeRecord("both", "Both", "", "192.168.1.11"),
+    };
+    mergeMdnsServiceRecords(table, records, 2, "", 1000);
+    table.find("both")->sources |= DISCOVERY_SOURCE_MQTT;
+
+    TEST_ASSERT_EQUAL(0, expireMdnsOnlyPrinters(table, 5000, 10000));
+    TEST_ASSERT_EQUAL(1, expireMdnsOnlyPrinters(table, 20000, 10000));
+    TEST_ASSERT_NULL(table.find("lan"));
+    TEST_ASSERT_NOT_NULL(table.find("both"));
+}
+
+void run_mdns_record_merge_tests()
+{
+    RUN_TEST(test_mdns_merge_adds_printers_in_scope);
+    RUN_TEST(test_mdns_merge_unchanged_refreshes_without_new_version);
+    RUN_TEST(test_mdns_merge_keeps_mqtt_fields);
+    RUN_TEST(test_mdns_expiry_only_drops_mdns_only_printers);
+}
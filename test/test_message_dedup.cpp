@@ -0,0 +1,79 @@
+/**
+ * @file test_message_dedup.cpp
+ * @brief Unit tests for duplicate message suppression
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/config/config.h"
+#include "../src/core/message_dedup.h"
+
+void test_dedup_detects_repeat()
+{
+    resetMessageDedup();
+
+    TEST_ASSERT_FALSE(isDuplicateMessage("msg-1"));
+    TEST_ASSERT_TRUE(isDuplicateMessage("msg-1"));
+    TEST_ASSERT_FALSE(isDuplicateMessage("msg-2"));
+    TEST_ASSERT_EQUAL(1, getDuplicateMessageCount());
+    TEST_ASSERT_EQUAL(2, getTrackedMessageIdCount());
+}
+
+void test_dedup_ignores_missing_id()
+{
+    resetMessageDedup();
+
+    TEST_ASSERT_FALSE(isDuplicateMessage(""));
+    TEST_ASSERT_FALSE(isDuplicateMessage(""));
+    TEST_ASSERT_FALSE(isDuplicateMessage(nullptr));
+    TEST_ASSERT_EQUAL(0, getDuplicateMessageCount());
+    TEST_ASSERT_EQUAL(0, getTrackedMessageIdCount());
+}
+
+void test_dedup_evicts_oldest_when_full()
+{
+    resetMessageDedup();
+
+    char messageId[16];
+    for (int i = 0; i <= messageDedupCapacity; i++)
+    {
+        snprintf(messageId, sizeof(messageId), "fill-%d", i);
+        TEST_ASSERT_FALSE(isDuplicateMessage(messageId));
+    }
+    TEST_ASSERT_EQUAL(messageDedupCapacity, getTrackedMessageIdCount());
+
+    // fill-0 was pushed out by the last insert; everything newer is still remembered
+    TEST_ASSERT_FALSE(isDuplicateMessage("fill-0"));
+    for (int i = 2; i <= messageDedupCapacity; i++)
+    {
+        snprintf(messageId, sizeof(messageId), "fill-%d", i);
+        TEST_ASSERT_TRUE(isDuplicateMessage(messageId));
+    }
+}
+
+void test_dedup_survives_heavy_churn()
+{
+    resetMessageDedup();
+
+    // Cycle far more IDs than slots to exercise hash deletion and probe chains
+    char messageId[16];
+    for (int i = 0; i < messageDedupCapacity * 20; i++)
+    {
+        snprintf(messageId, sizeof(messageId), "churn-%d", i);
+        TEST_ASSERT_FALSE(isDuplicateMessage(messageId));
+        TEST_ASSERT_TRUE(isDuplicateMessage(messageId));
+    }
+    TEST_ASSERT_EQUAL(messageDedupCapacity, getTrackedMessageIdCount());
+    TEST_ASSERT_EQUAL(messageDedupCapacity * 20, getDuplicateMessageCount());
+
+    resetMessageDedup();
+    TEST_ASSERT_EQUAL(0, getTrackedMessageIdCount());
+}
+
+void run_message_dedup_tests()
+{
+    RUN_TEST(test_dedup_detects_repeat);
+    RUN_TEST(test_dedup_ignores_missing_id);
+    RUN_TEST(test_dedup_evicts_oldest_when_full);
+    RUN_TEST(test_dedup_survives_heavy_churn);
+}
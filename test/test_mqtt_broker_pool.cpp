@@ -0,0 +1,196 @@
+/**
+ * @file test_mqtt_broker_pool.cpp
+ * @brief Unit tests for MQTT broker failover and health scoring
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <WiFi.h>
+#include "../src/config/config.h"
+#include "../src/core/mqtt_broker_pool.h"
+
+// Broker stand-in: each host either accepts or refuses connections
+struct BrokerStandIn
+{
+    const char *host;
+    bool up;
+    unsigned long connectMs;
+};
+
+// Drive one connect attempt against the stand-ins, as connectToMQTT() does
+static MqttFailoverAction attemptConnect(MqttBrokerPool &pool, BrokerStandIn *standIns, int count, unsigned long now)
+{
+    const MqttBrokerHealth &active = pool.getActiveBroker();
+    for (int i = 0; i < count; i++)
+    {
+        if (active.host == standIns[i].host && standIns[i].up)
+        {
+            pool.recordSuccess(standIns[i].connectMs, now);
+            return MqttFailoverAction::RETRY_SAME; // Connected - no change
+        }
+    }
+    return pool.recordFailure(now);
+}
+
+void test_broker_pool_parses_fallbacks()
+{
+    MqttBrokerPool pool;
+    TEST_ASSERT_EQUAL(3, pool.configure("primary.example", 8883, " backup1.example:1883, bad:0 ,backup2.example"));
+    TEST_ASSERT_EQUAL_STRING("primary.example", pool.getBroker(0).host.c_str());
+    TEST_ASSERT_EQUAL(1883, pool.getBroker(1).port);
+    TEST_ASSERT_EQUAL(8883, pool.getBroker(2).port); // Port defaults to the primary's
+    TEST_ASSERT_EQUAL(0, pool.getActiveIndex());
+}
+
+void test_broker_pool_fails_over_without_cooldown()
+{
+    MqttBrokerPool pool;
+    pool.configure("primary", 8883, "backup1:8883,backup2:8883");
+    BrokerStandIn standIns[] = {{"primary", false, 0}, {"backup1", false, 0}, {"backup2", true, 400}};
+
+    unsigned long now = 1000;
+    TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 3, now) == MqttFailoverAction::RETRY_SAME);
+    TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 3, now) == MqttFailoverAction::FAILED_OVER);
+    TEST_ASSERT_EQUAL(1, pool.getActiveIndex());
+
+    attemptConnect(pool, standIns, 3, now);
+    TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 3, now) == MqttFailoverAction::FAILED_OVER);
+    TEST_ASSERT_EQUAL(2, pool.getActiveIndex());
+
+    // Third broker accepts - no cooldown at any point
+    attemptConnect(pool, standIns, 3, now);
+    TEST_ASSERT_FALSE(pool.isInCooldown(now));
+    TEST_ASSERT_EQUAL(400, pool.getBroker(2).avgConnectMs);
+    TEST_ASSERT_GREATER_THAN(pool.getHealthScore(0), pool.getHealthScore(2));
+}
+
+void test_broker_pool_cools_down_when_all_fail()
+{
+    MqttBrokerPool pool;
+    pool.configure("primary", 8883, "backup1:8883");
+    BrokerStandIn standIns[] = {{"primary", false, 0}, {"backup1", false, 0}};
+
+    unsigned long now = 1000;
+    MqttFailoverAction action = MqttFailoverAction::RETRY_SAME;
+    for (int i = 0; i < mqttFailoverThreshold + mqttMaxConsecutiveFailures; i++)
+    {
+        action = attemptConnect(pool, standIns, 2, now);
+    }
+    TEST_ASSERT_TRUE(action == MqttFailoverAction::COOLDOWN);
+    TEST_ASSERT_TRUE(pool.isInCooldown(now + 1));
+
+    // After the cooldown every broker gets a fresh round, preferred first on equal health
+    TEST_ASSERT_FALSE(pool.isInCooldown(now + mqttFailureCooldownMs + 1));
+    TEST_ASSERT_EQUAL(0, pool.getActiveIndex());
+    standIns[0].up = true;
+    attemptConnect(pool, standIns, 2, now);
+    TEST_ASSERT_EQUAL(0, pool.getBroker(0).consecutiveFailures);
+}
+
+void test_broker_pool_single_broker_keeps_cooldown_threshold()
+{
+    MqttBrokerPool pool;
+    pool.configure("primary", 8883, "");
+    BrokerStandIn standIns[] = {{"primary", false, 0}};
+
+    // Nowhere to fail over to, so the broker gets the full count before cooling down
+    unsigned long now = 1000;
+    TEST_ASSERT_EQUAL(mqttMaxConsecutiveFailures, pool.getFailureLimit());
+    for (int i = 1; i < mqttMaxConsecutiveFailures; i++)
+    {
+        TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 1, now) == MqttFailoverAction::RETRY_SAME);
+    }
+    TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 1, now) == MqttFailoverAction::COOLDOWN);
+}
+
+void test_broker_pool_returns_to_preferred()
+{
+    MqttBrokerPool pool;
+    pool.configure("primary", 8883, "backup1:8883");
+    BrokerStandIn standIns[] = {{"primary", false, 0}, {"backup1", true, 300}};
+
+    unsigned long now = 1000;
+    for (int i = 0; i < mqttFailoverThreshold; i++)
+    {
+        attemptConnect(pool, standIns, 2, now);
+    }
+    attemptConnect(pool, standIns, 2, now);
+    TEST_ASSERT_EQUAL(1, pool.getActiveIndex());
+
+    // No probe until the interval passes, and an unreachable preferred broker keeps us on the fallback
+    TEST_ASSERT_FALSE(pool.isProbeDue(now + 1000));
+    now += mqttPreferredProbeIntervalMs;
+    TEST_ASSERT_TRUE(pool.isProbeDue(now));
+    TEST_ASSERT_FALSE(pool.recordProbe(false, now));
+    TEST_ASSERT_EQUAL(1, pool.getActiveIndex());
+
+    now += mqttPreferredProbeIntervalMs;
+    TEST_ASSERT_TRUE(pool.recordProbe(true, now));
+    TEST_ASSERT_EQUAL(0, pool.getActiveIndex());
+    TEST_ASSERT_FALSE(pool.isProbeDue(now + mqttPreferredProbeIntervalMs)); // Never probe while on the preferred broker
+}
+
+void test_broker_pool_backs_off_failed_switch_back()
+{
+    MqttBrokerPool pool;
+    pool.configure("primary", 8883, "backup1:8883");
+    BrokerStandIn standIns[] = {{"primary", false, 0}, {"backup1", true, 300}};
+
+    unsigned long now = 1000;
+    for (int i = 0; i <= mqttFailoverThreshold; i++)
+    {
+        attemptConnect(pool, standIns, 2, now);
+    }
+    TEST_ASSERT_EQUAL(1, pool.getActiveIndex());
+
+    // Primary takes TCP but refuses MQTT: straight back to the fallback, probed half as often
+    now += mqttPreferredProbeIntervalMs;
+    TEST_ASSERT_TRUE(pool.recordProbe(true, now));
+    TEST_ASSERT_TRUE(attemptConnect(pool, standIns, 2, now) == MqttFailoverAction::FAILED_OVER);
+    TEST_ASSERT_EQUAL(1, pool.getActiveIndex());
+    TEST_ASSERT_EQUAL(mqttPreferredProbeIntervalMs * 2, pool.getProbeIntervalMs());
+    attemptConnect(pool, standIns, 2, now);
+    TEST_ASSERT_FALSE(pool.isProbeDue(now + mqttPreferredProbeIntervalMs));
+    TEST_ASSERT_TRUE(pool.isProbeDue(now + mqttPreferredProbeIntervalMs * 2));
+
+    // A switch back that connects restores the normal interval
+    now += mqttPreferredProbeIntervalMs * 2;
+    standIns[0].up = true;
+    TEST_ASSERT_TRUE(pool.recordProbe(true, now));
+    attemptConnect(pool, standIns, 2, now);
+    TEST_ASSERT_EQUAL(0, pool.getActiveIndex());
+    TEST_ASSERT_EQUAL(mqttPreferredProbeIntervalMs, pool.getProbeIntervalMs());
+}
+
+#ifndef TEST_SKIP_NETWORK_TESTS
+void test_broker_probe_against_local_listener()
+{
+    // Local TCP listener stands in for a reachable broker
+    const int standInPort = 18830;
+    WiFiServer standIn(standInPort);
+    standIn.begin();
+
+    // An IP literal resolves without a lookup
+    IPAddress localIp;
+    TEST_ASSERT_TRUE(resolveBrokerAddress(WiFi.localIP().toString().c_str(), localIp) == BrokerLookup::FOUND);
+    TEST_ASSERT_TRUE(probeBrokerReachable(localIp, standInPort, mqttBrokerProbeTimeoutMs));
+
+    standIn.end();
+    TEST_ASSERT_FALSE(probeBrokerReachable(localIp, standInPort, mqttBrokerProbeTimeoutMs));
+}
+#endif
+
+void run_mqtt_broker_pool_tests()
+{
+    RUN_TEST(test_broker_pool_parses_fallbacks);
+    RUN_TEST(test_broker_pool_fails_over_without_cooldown);
+    RUN_TEST(test_broker_pool_cools_down_when_all_fail);
+    RUN_TEST(test_broker_pool_single_broker_keeps_cooldown_threshold);
+    RUN_TEST(test_broker_pool_returns_to_preferred);
+    RUN_TEST(test_broker_pool_backs_off_failed_switch_back);
+#ifndef TEST_SKIP_NETWORK_TESTS
+    RUN_TEST(test_broker_probe_against_local_listener);
+#else
+    Serial.println("Skipping broker probe test (TEST_SKIP_NETWORK_TESTS)");
+#endif
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_mqtt_multipart.cpp
+ * @brief Unit tests for MQTT multipart splitting and reassembly
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../src/config/config.h"
+#include "../src/core/mqtt_multipart.h"
+
+// Feed a serialized part through the reassembler the same way the MQTT handler does
+static MultipartResult feedPart(const String &partPayload, String &completed)
+{
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeJson(doc, partPayload);
+    TEST_ASSERT_FALSE(error);
+
+    JsonObjectConst part = doc["part"];
+    const char *chunk = doc["chunk"] | "";
+    return acceptMultipartPart(part["id"] | "", part["seq"] | -1, part["total"] | 0,
+                               part["size"] | 0, chunk, strlen(chunk), completed);
+}
+
+static String buildLargePayload(int length)
+{
+    // Mix of quotes, newlines and multi-byte UTF-8 to exercise escaping and split points
+    String payload;
+    payload.reserve(length + 4);
+    for (int i = 0; payload.length() < (unsigned int)length; i++)
+    {
+        if (i % 7 == 0)
+            payload += "\"";
+        else if (i % 11 == 0)
+            payload += "é";
+        else if (i % 13 == 0)
+            payload += "\n";
+        else
+            payload += (char)('a' + (i % 26));
+    }
+    return payload;
+}
+
+void test_multipart_round_trip()
+{
+    resetMultipartReassembly();
+
+    String payload = buildLargePayload(3000);
+    std::vector<String> parts;
+    TEST_ASSERT_TRUE(buildMultipartPayloads("test-1", payload, mqttMultipartPartSize, parts));
+    TEST_ASSERT_GREATER_THAN(1, parts.size());
+
+    String completed;
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(mqttMultipartPartSize, parts[i].length());
+        MultipartResult result = feedPart(parts[i], completed);
+        TEST_ASSERT_TRUE(result == (i + 1 < parts.size() ? MultipartResult::ACCEPTED : MultipartResult::COMPLETE));
+    }
+
+    TEST_ASSERT_EQUAL_STRING(payload.c_str(), completed.c_str());
+    TEST_ASSERT_EQUAL(0, getPendingMultipartCount());
+}
+
+void test_multipart_duplicate_part_ignored()
+{
+    resetMultipartReassembly();
+
+    String completed;
+    TEST_ASSERT_TRUE(acceptMultipartPart("dup", 0, 2, 6, "abc", 3, completed) == MultipartResult::ACCEPTED);
+    TEST_ASSERT_TRUE(acceptMultipartPart("dup", 0, 2, 6, "abc", 3, completed) == MultipartResult::ACCEPTED);
+    TEST_ASSERT_TRUE(acceptMultipartPart("dup", 1, 2, 6, "def", 3, completed) == MultipartResult::COMPLETE);
+    TEST_ASSERT_EQUAL_STRING("abcdef", completed.c_str());
+}
+
+void test_multipart_out_of_order_rejected()
+{
+    resetMultipartReassembly();
+
+    String completed;
+    TEST_ASSERT_TRUE(acceptMultipartPart("gap", 0, 3, 9, "abc", 3, completed) == MultipartResult::ACCEPTED);
+    TEST_ASSERT_TRUE(acceptMultipartPart("gap", 2, 3, 9, "ghi", 3, completed) == MultipartResult::REJECTED);
+    TEST_ASSERT_EQUAL(0, getPendingMultipartCount());
+
+    // A message that starts mid-sequence is never buffered
+    TEST_ASSERT_TRUE(acceptMultipartPart("late", 1, 3, 9, "def", 3, completed) == MultipartResult::REJECTED);
+    TEST_ASSERT_EQUAL(0, getPendingMultipartCount());
+}
+
+void test_multipart_limits_enforced()
+{
+    resetMultipartReassembly();
+
+    String completed;
+    TEST_ASSERT_TRUE(acceptMultipartPart("big", 0, 2, mqttMultipartMaxMessageSize + 1, "a", 1, completed) == MultipartResult::REJECTED);
+    TEST_ASSERT_TRUE(acceptMultipartPart("many", 0, mqttMultipartMaxParts + 1, 10, "a", 1, completed) == MultipartResult::REJECTED);
+
+    // Chunks may not exceed the declared size
+    TEST_ASSERT_TRUE(acceptMultipartPart("over", 0, 2, 4, "abc", 3, completed) == MultipartResult::ACCEPTED);
+    TEST_ASSERT_TRUE(acceptMultipartPart("over", 1, 2, 4, "def", 3, completed) == MultipartResult::REJECTED);
+    TEST_ASSERT_EQUAL(0, getPendingMultipartCount());
+
+    // Sender refuses payloads over the reassembly limit
+    String tooLarge = buildLargePayload(mqttMultipartMaxMessageSize + 1);
+    std::vector<String> parts;
+    TEST_ASSERT_FALSE(buildMultipartPayloads("too-large", tooLarge, mqttMultipartPartSize, parts));
+}
+
+void test_multipart_slots_bounded()
+{
+    resetMultipartReassembly();
+
+    String completed;
+    char messageId[8];
+    for (int i = 0; i <= mqttMultipartMaxPending; i++)
+    {
+        snprintf(messageId, sizeof(messageId), "slot%d", i);
+        TEST_ASSERT_TRUE(acceptMultipartPart(messageId, 0, 2, 4, "ab", 2, completed) == MultipartResult::ACCEPTED);
+    }
+    TEST_ASSERT_EQUAL(mqttMultipartMaxPending, getPendingMultipartCount());
+
+    resetMultipartReassembly();
+    TEST_ASSERT_EQUAL(0, getPendingMultipartCount());
+}
+
+void run_mqtt_multipart_tests()
+{
+    RUN_TEST(test_multipart_round_trip);
+    RUN_TEST(test_multipart_duplicate_part_ignored);
+    RUN_TEST(test_multipart_out_of_order_rejected);
+    RUN_TEST(test_multipart_limits_enforced);
+    RUN_TEST(test_multipart_slots_bounded);
+}
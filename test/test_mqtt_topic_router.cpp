@@ -0,0 +1,119 @@
+/**
+ * @file test_mqtt_topic_router.cpp
+ * @brief Unit tests for the MQTT topic-trie dispatcher
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/core/mqtt_topic_router.h"
+
+static int inboxCalls = 0;
+static int statusCalls = 0;
+static int wildcardCalls = 0;
+static String lastStatusTopic;
+
+static void onInbox(const String &topic, const String &message) { inboxCalls++; }
+static void onStatus(const String &topic, const String &message)
+{
+    statusCalls++;
+    lastStatusTopic = topic;
+}
+static void onWildcard(const String &topic, const String &message) { wildcardCalls++; }
+
+static void resetRouterCounters()
+{
+    inboxCalls = 0;
+    statusCalls = 0;
+    wildcardCalls = 0;
+    lastStatusTopic = "";
+}
+
+void test_router_exact_match()
+{
+    MQTTTopicRouter router;
+    resetRouterCounters();
+
+    TEST_ASSERT_TRUE(router.addRoute("scribe/alice/print", onInbox));
+    TEST_ASSERT_EQUAL(1, router.dispatch("scribe/alice/print", "{}"));
+    TEST_ASSERT_EQUAL(1, inboxCalls);
+
+    // Prefixes, extensions and other owners do not match
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/alice", "{}"));
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/alice/print/extra", "{}"));
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/bob/print", "{}"));
+    TEST_ASSERT_EQUAL(1, inboxCalls);
+}
+
+void test_router_single_level_wildcard()
+{
+    MQTTTopicRouter router;
+    resetRouterCounters();
+
+    TEST_ASSERT_TRUE(router.addRoute("scribe/printer-status/+", onStatus));
+    TEST_ASSERT_EQUAL(1, router.dispatch("scribe/printer-status/abc123", "{}"));
+    TEST_ASSERT_EQUAL_STRING("scribe/printer-status/abc123", lastStatusTopic.c_str());
+
+    // '+' is exactly one level
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/printer-status", "{}"));
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/printer-status/abc/def", "{}"));
+    TEST_ASSERT_EQUAL(1, statusCalls);
+}
+
+void test_router_multi_level_wildcard()
+{
+    MQTTTopicRouter router;
+    resetRouterCounters();
+
+    TEST_ASSERT_TRUE(router.addRoute("scribe/group/#", onWildcard));
+    TEST_ASSERT_EQUAL(1, router.dispatch("scribe/group/kitchen", "{}"));
+    TEST_ASSERT_EQUAL(1, router.dispatch("scribe/group/kitchen/extra", "{}"));
+    TEST_ASSERT_EQUAL(1, router.dispatch("scribe/group", "{}")); // '#' includes the parent level
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/broadcast", "{}"));
+    TEST_ASSERT_EQUAL(3, wildcardCalls);
+
+    // Wildcards never match '$' system topics at the first level
+    TEST_ASSERT_TRUE(router.addRoute("#", onWildcard));
+    TEST_ASSERT_EQUAL(0, router.dispatch("$SYS/broker/uptime", "{}"));
+}
+
+void test_router_overlapping_routes()
+{
+    MQTTTopicRouter router;
+    resetRouterCounters();
+
+    TEST_ASSERT_TRUE(router.addRoute("scribe/alice/print", onInbox));
+    TEST_ASSERT_TRUE(router.addRoute("scribe/+/print", onStatus));
+    TEST_ASSERT_TRUE(router.addRoute("scribe/#", onWildcard));
+
+    TEST_ASSERT_EQUAL(3, router.dispatch("scribe/alice/print", "{}"));
+    TEST_ASSERT_EQUAL(1, inboxCalls);
+    TEST_ASSERT_EQUAL(1, statusCalls);
+    TEST_ASSERT_EQUAL(1, wildcardCalls);
+}
+
+void test_router_rejects_malformed_filters()
+{
+    MQTTTopicRouter router;
+
+    TEST_ASSERT_FALSE(router.addRoute("", onInbox));
+    TEST_ASSERT_FALSE(router.addRoute("scribe/a+", onInbox));
+    TEST_ASSERT_FALSE(router.addRoute("scribe/#/print", onInbox));
+    TEST_ASSERT_FALSE(router.addRoute("scribe/print#", onInbox));
+    TEST_ASSERT_FALSE(router.addRoute("scribe/print", nullptr));
+    TEST_ASSERT_EQUAL(0, router.getRouteCount());
+
+    TEST_ASSERT_TRUE(router.addRoute("scribe/broadcast", onInbox));
+    TEST_ASSERT_EQUAL(1, router.getRouteCount());
+    router.clear();
+    TEST_ASSERT_EQUAL(0, router.getRouteCount());
+    TEST_ASSERT_EQUAL(0, router.dispatch("scribe/broadcast", "{}"));
+}
+
+void run_mqtt_topic_router_tests()
+{
+    RUN_TEST(test_router_exact_match);
+    RUN_TEST(test_router_single_level_wildcard);
+    RUN_TEST(test_router_multi_level_wildcard);
+    RUN_TEST(test_router_overlapping_routes);
+    RUN_TEST(test_router_rejects_malformed_filters);
+}
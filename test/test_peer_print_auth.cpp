@@ -0,0 +1,65 @@
+/**
+ * @file test_peer_print_auth.cpp
+ * @brief Unit tests for LAN print signing and timestamp checks
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/config/config.h"
+#include "../src/core/peer_print_auth.h"
+
+static const char *testKey = "scribe-peer-test-key";
+static const char *testSender = "aabbccdd";
+static const char *testTarget = "11223344";
+static const char *testBody = "{\"id\":\"m1\",\"header\":\"MESSAGE\",\"body\":\"Hello\"}";
+
+void test_peer_signature_matches_reference()
+{
+    // Reference: hmac.new(key, b"1700000000\naabbccdd\n11223344\n" + body, hashlib.sha256).hexdigest()
+    char signature[peerSignatureHexLength + 1];
+    TEST_ASSERT_TRUE(signPeerPrint(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature));
+    TEST_ASSERT_EQUAL_STRING("f3b5bdf6a022901e95bb258935a594db406af2f33fe05970fdc869f3ca1a6f64", signature);
+}
+
+void test_peer_signature_verifies_and_rejects_tampering()
+{
+    char signature[peerSignatureHexLength + 1];
+    signPeerPrint(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature);
+
+    TEST_ASSERT_TRUE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000001UL, testSender, testTarget, testBody, strlen(testBody), signature));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, "aabbccde", testTarget, testBody, strlen(testBody), signature));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, "11223345", testBody, strlen(testBody), signature)); // Replayed to another printer
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody) - 1, signature));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature("another-peer-test-key", 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature));
+
+    signature[10] = signature[10] == 'a' ? 'b' : 'a';
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature));
+}
+
+void test_peer_signature_rejects_bad_input()
+{
+    char signature[peerSignatureHexLength + 1];
+    TEST_ASSERT_FALSE(signPeerPrint("", 1700000000UL, testSender, testTarget, testBody, strlen(testBody), signature));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), "f3b5bdf6"));
+    TEST_ASSERT_FALSE(verifyPeerPrintSignature(testKey, 1700000000UL, testSender, testTarget, testBody, strlen(testBody), nullptr));
+}
+
+void test_peer_timestamp_window()
+{
+    const unsigned long now = 1700000000UL;
+    TEST_ASSERT_TRUE(isPeerTimestampFresh(now, now));
+    TEST_ASSERT_TRUE(isPeerTimestampFresh(now - peerPrintMaxClockSkewSeconds, now));
+    TEST_ASSERT_TRUE(isPeerTimestampFresh(now + peerPrintMaxClockSkewSeconds, now));
+    TEST_ASSERT_FALSE(isPeerTimestampFresh(now - peerPrintMaxClockSkewSeconds - 1, now));
+    TEST_ASSERT_FALSE(isPeerTimestampFresh(now + peerPrintMaxClockSkewSeconds + 1, now));
+    TEST_ASSERT_FALSE(isPeerTimestampFresh(0, now));
+}
+
+void run_peer_print_auth_tests()
+{
+    RUN_TEST(test_peer_signature_matches_reference);
+    RUN_TEST(test_peer_signature_verifies_and_rejects_tampering);
+    RUN_TEST(test_peer_signature_rejects_bad_input);
+    RUN_TEST(test_peer_timestamp_window);
+}
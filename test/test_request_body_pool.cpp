@@ -0,0 +1,81 @@
+/**
+ * @file test_request_body_pool.cpp
+ * @brief Unit tests for pooled POST body buffers
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "../src/web/request_body_pool.h"
+
+void test_request_body_pool_assembles_chunks()
+{
+    RequestBodyPool pool;
+    RequestBody *body = pool.acquire(11);
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_EQUAL(0, body->status);
+
+    body = pool.append(body, (const uint8_t *)"{\"a\":", 5, 0);
+    body = pool.append(body, (const uint8_t *)"\"bcd\"}", 6, 5);
+    TEST_ASSERT_EQUAL(0, body->status);
+    TEST_ASSERT_EQUAL(11, body->length);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":\"bcd\"}", body->data);
+
+    pool.release(body);
+    TEST_ASSERT_EQUAL(0, pool.getStats().inUse);
+}
+
+void test_request_body_pool_refuses_oversized_bodies()
+{
+    RequestBodyPool pool;
+
+    // Declared too large: refused before anything is stored or allocated
+    RequestBody *body = pool.acquire(requestBodyCapacity + 1);
+    TEST_ASSERT_EQUAL(413, body->status);
+    TEST_ASSERT_EQUAL(0, pool.getStats().inUse);
+    TEST_ASSERT_EQUAL(body, pool.append(body, (const uint8_t *)"x", 1, 0));
+
+    // Declared small but keeps coming: the buffer goes back and the body becomes a 413
+    static uint8_t chunk[requestBodyCapacity];
+    memset(chunk, 'x', sizeof(chunk));
+    body = pool.acquire(10);
+    body = pool.append(body, chunk, sizeof(chunk), 0);
+    TEST_ASSERT_EQUAL(0, body->status);
+    body = pool.append(body, chunk, 1, requestBodyCapacity);
+    TEST_ASSERT_EQUAL(413, body->status);
+    TEST_ASSERT_EQUAL(0, pool.getStats().inUse);
+
+    pool.release(body); // Placeholders are ignored
+    TEST_ASSERT_EQUAL(2, pool.getStats().refusedTooLarge);
+}
+
+void test_request_body_pool_reuses_buffers_and_refuses_when_busy()
+{
+    RequestBodyPool pool;
+    RequestBody *bodies[requestBodyBufferCount];
+    for (int i = 0; i < requestBodyBufferCount; i++)
+    {
+        bodies[i] = pool.acquire(1);
+        TEST_ASSERT_EQUAL(0, bodies[i]->status);
+    }
+
+    RequestBody *busy = pool.acquire(1);
+    TEST_ASSERT_EQUAL(503, busy->status);
+    TEST_ASSERT_EQUAL(1, pool.getStats().refusedBusy);
+    TEST_ASSERT_EQUAL(requestBodyBufferCount, pool.getStats().peakInUse);
+
+    // A returned buffer is handed out again with its memory, empty
+    char *data = bodies[1]->data;
+    pool.append(bodies[1], (const uint8_t *)"old", 3, 0);
+    pool.release(bodies[1]);
+    RequestBody *again = pool.acquire(1);
+    TEST_ASSERT_EQUAL(data, again->data);
+    TEST_ASSERT_EQUAL(0, again->length);
+    TEST_ASSERT_EQUAL_STRING("", again->data);
+}
+
+void run_request_body_pool_tests()
+{
+    RUN_TEST(test_request_body_pool_assembles_chunks);
+    RUN_TEST(test_request_body_pool_refuses_oversized_bodies);
+    RUN_TEST(test_request_body_pool_reuses_buffers_and_refuses_when_busy);
+}
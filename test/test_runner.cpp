@@ -24,6 +24,26 @@ extern void run_time_utils_tests();
 extern void run_endpoint_integration_tests();
 extern void run_nvs_config_tests();
 extern void run_memo_handler_tests();
+extern void run_mqtt_multipart_tests();
+extern void run_mqtt_topic_router_tests();
+extern void run_message_dedup_tests();
+extern void run_delivery_tracker_tests();
+extern void run_mqtt_broker_pool_tests();
+extern void run_discovered_printer_table_tests();
+extern void run_mdns_record_merge_tests();
+extern void run_peer_print_auth_tests();
+extern void run_fleet_balancer_tests();
+extern void run_log_record_tests();
+extern void run_log_ring_tests();
+extern void run_log_batch_tests();
+extern void run_log_file_writer_tests();
+extern void run_crash_log_tests();
+extern void run_log_history_tests();
+extern void run_log_rate_limiter_tests();
+extern void run_log_level_table_tests();
+extern void run_asset_index_tests();
+extern void run_json_stream_writer_tests();
+extern void run_request_body_pool_tests();
 
 // Test stubs for variables normally defined in main.cpp
 String deviceBootTime = "2025-08-17T12:00:00Z"; // Test stub
@@ -115,6 +135,66 @@ void setup()
     Serial.println("=== Running Memo Handler Tests ===");
     run_memo_handler_tests();
 
+    Serial.println("=== Running MQTT Multipart Tests ===");
+    run_mqtt_multipart_tests();
+
+    Serial.println("=== Running MQTT Topic Router Tests ===");
+    run_mqtt_topic_router_tests();
+
+    Serial.println("=== Running Message Dedup Tests ===");
+    run_message_dedup_tests();
+
+    Serial.println("=== Running Delivery Tracker Tests ===");
+    run_delivery_tracker_tests();
+
+    Serial.println("=== Running MQTT Broker Pool Tests ===");
+    run_mqtt_broker_pool_tests();
+
+    Serial.println("=== Running Discovered Printer Table Tests ===");
+    run_discovered_printer_table_tests();
+
+    Serial.println("=== Running mDNS Record Merge Tests ===");
+    run_mdns_record_merge_tests();
+
+    Serial.println("=== Running Peer Print Auth Tests ===");
+    run_peer_print_auth_tests();
+
+    Serial.println("=== Running Fleet Balancer Tests ===");
+    run_fleet_balancer_tests();
+
+    Serial.println("=== Running Log Record Tests ===");
+    run_log_record_tests();
+
+    Serial.println("=== Running Log Ring Tests ===");
+    run_log_ring_tests();
+
+    Serial.println("=== Running Log Batch Tests ===");
+    run_log_batch_tests();
+
+    Serial.println("=== Running Log File Writer Tests ===");
+    run_log_file_writer_tests();
+
+    Serial.println("=== Running Crash Log Tests ===");
+    run_crash_log_tests();
+
+    Serial.println("=== Running Log History Tests ===");
+    run_log_history_tests();
+
+    Serial.println("=== Running Log Rate Limiter Tests ===");
+    run_log_rate_limiter_tests();
+
+    Serial.println("=== Running Log Level Table Tests ===");
+    run_log_level_table_tests();
+
+    Serial.println("=== Running Asset Index Tests ===");
+    run_asset_index_tests();
+
+    Serial.println("=== Running JSON Stream Writer Tests ===");
+    run_json_stream_writer_tests();
+
+    Serial.println("=== Running Request Body Pool Tests ===");
+    run_request_body_pool_tests();
+
 #ifndef TEST_SKIP_NETWORK_TESTS
     Serial.println("=== Running Endpoint Integration Tests ===");
     run_endpoint_integration_tests();
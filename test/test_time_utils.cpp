@@ -18,6 +18,13 @@ void test_formatted_datetime()
     // Note: Without a working clock, this might return a default string
 }
 
+void test_formatted_datetime_for_given_time()
+{
+    // 2025-01-15 12:00 UTC is still 15 Jan from UTC-12 to UTC+14
+    String datetime = getFormattedDateTime((time_t)1736942400);
+    TEST_ASSERT_TRUE(datetime.indexOf("15 Jan 2025") >= 0);
+}
+
 void test_custom_date_formatting()
 {
     // Test formatCustomDate function with simple input
@@ -75,6 +82,7 @@ void test_time_constants_from_config()
 void run_time_utils_tests()
 {
     RUN_TEST(test_formatted_datetime);
+    RUN_TEST(test_formatted_datetime_for_given_time);
     RUN_TEST(test_custom_date_formatting);
     #ifndef TEST_SKIP_NETWORK_TESTS
     RUN_TEST(test_timezone_setup);